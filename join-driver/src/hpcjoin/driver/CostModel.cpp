@@ -0,0 +1,219 @@
+/**
+ * @author  Claude Barthels <claudeb@inf.ethz.ch>
+ * (c) 2016, ETH Zurich, Systems Group
+ *
+ */
+
+#include "CostModel.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+
+#define HISTORY_LINE_LENGTH 1024
+
+namespace hpcjoin {
+namespace driver {
+
+typedef struct {
+
+	const char *name;
+	double defaultCoefficient;
+
+} phase_t;
+
+// Microseconds per tuple, the defaults are only used until an algorithm has been calibrated
+static const phase_t PHASES[NUMBER_OF_ALGORITHMS][CostModel::MAX_PHASES] = {
+	{ { "Histogram", 0.005 }, { "Network", 0.05 }, { "Local", 0.03 }, { NULL, 0 }, { NULL, 0 } },
+	{ { "Histogram", 0.005 }, { "Network", 0.03 }, { "Local", 0.03 }, { NULL, 0 }, { NULL, 0 } },
+	{ { "Partition", 0.01 }, { "Sorting", 0.05 }, { "Waiting", 0.03 }, { "Merging", 0.02 }, { "Matching", 0.005 } }
+};
+
+static const char *ALGORITHM_NAMES[NUMBER_OF_ALGORITHMS] = { "radix", "broadcast", "sort" };
+
+CostModel::CostModel(uint32_t numberOfNodes, hpcjoin::driver::Workload *workload) {
+
+	this->numberOfNodes = numberOfNodes;
+	this->workload = workload;
+
+	for (uint32_t a = 0; a < NUMBER_OF_ALGORITHMS; ++a) {
+		for (uint32_t p = 0; p < MAX_PHASES; ++p) {
+			this->coefficients[a][p] = PHASES[a][p].defaultCoefficient;
+		}
+		this->calibrationRuns[a] = 0;
+	}
+
+}
+
+CostModel::~CostModel() {
+
+}
+
+void CostModel::calibrate(const char *historyFileName) {
+
+	FILE *historyFile = fopen(historyFileName, "r");
+	if (historyFile == NULL) {
+		return;
+	}
+
+	double products[NUMBER_OF_ALGORITHMS][MAX_PHASES];
+	double squares[NUMBER_OF_ALGORITHMS][MAX_PHASES];
+	memset(products, 0, sizeof(products));
+	memset(squares, 0, sizeof(squares));
+
+	// Every line holds one phase of one run: algorithm,nodes,inner,outer,skew,phase,volume,predicted,actual
+	char line[HISTORY_LINE_LENGTH];
+	while (fgets(line, HISTORY_LINE_LENGTH, historyFile) != NULL) {
+		char algorithmName[64];
+		char phaseName[64];
+		uint32_t nodes;
+		uint64_t inner;
+		uint64_t outer;
+		double skew;
+		double volume;
+		double predicted;
+		double actual;
+		algorithm_t algorithm;
+		if (sscanf(line, "%63[^,],%u,%lu,%lu,%lf,%63[^,],%lf,%lf,%lf", algorithmName, &nodes, &inner, &outer, &skew, phaseName, &volume, &predicted, &actual) != 9
+				|| !parseAlgorithmName(algorithmName, &algorithm)) {
+			continue;
+		}
+		// The volume is recomputed, the history stays valid when the volume definitions change
+		for (uint32_t p = 0; p < getNumberOfPhases(algorithm); ++p) {
+			if (strcmp(phaseName, PHASES[algorithm][p].name) == 0) {
+				volume = computeVolume(algorithm, p, inner, outer, nodes, skew);
+				products[algorithm][p] += volume * actual;
+				squares[algorithm][p] += volume * volume;
+				if (p == 0) {
+					++(this->calibrationRuns[algorithm]);
+				}
+			}
+		}
+	}
+	fclose(historyFile);
+
+	for (uint32_t a = 0; a < NUMBER_OF_ALGORITHMS; ++a) {
+		for (uint32_t p = 0; p < getNumberOfPhases((algorithm_t) a); ++p) {
+			if (squares[a][p] > 0) {
+				this->coefficients[a][p] = products[a][p] / squares[a][p];
+			}
+		}
+	}
+
+}
+
+double CostModel::predict(algorithm_t algorithm) {
+
+	double time = 0;
+	for (uint32_t p = 0; p < getNumberOfPhases(algorithm); ++p) {
+		time += predictPhase(algorithm, p);
+	}
+	return time;
+
+}
+
+double CostModel::predictPhase(algorithm_t algorithm, uint32_t phase) {
+
+	return this->coefficients[algorithm][phase]
+			* computeVolume(algorithm, phase, this->workload->getInnerRelationSize(), this->workload->getOuterRelationSize(), this->numberOfNodes, this->workload->getHeavyKeyShare());
+
+}
+
+uint32_t CostModel::getNumberOfPhases(algorithm_t algorithm) {
+
+	uint32_t phases = 0;
+	while (phases < MAX_PHASES && PHASES[algorithm][phases].name != NULL) {
+		++phases;
+	}
+	return phases;
+
+}
+
+const char* CostModel::getPhaseName(algorithm_t algorithm, uint32_t phase) {
+
+	return PHASES[algorithm][phase].name;
+
+}
+
+uint32_t CostModel::getNumberOfCalibrationRuns(algorithm_t algorithm) {
+
+	return this->calibrationRuns[algorithm];
+
+}
+
+void CostModel::record(const char *historyFileName, algorithm_t algorithm, std::map<std::string, double> *phaseTimes) {
+
+	FILE *historyFile = fopen(historyFileName, "a");
+	if (historyFile == NULL) {
+		fprintf(stderr, "Could not open history file %s\n", historyFileName);
+		exit(-1);
+	}
+
+	uint64_t const inner = this->workload->getInnerRelationSize();
+	uint64_t const outer = this->workload->getOuterRelationSize();
+	double const skew = this->workload->getHeavyKeyShare();
+
+	for (uint32_t p = 0; p < getNumberOfPhases(algorithm); ++p) {
+		std::map<std::string, double>::iterator it = phaseTimes->find(PHASES[algorithm][p].name);
+		if (it != phaseTimes->end()) {
+			fprintf(historyFile, "%s,%u,%lu,%lu,%.9f,%s,%.0f,%.0f,%.0f\n", ALGORITHM_NAMES[algorithm], this->numberOfNodes, inner, outer, skew, PHASES[algorithm][p].name,
+					computeVolume(algorithm, p, inner, outer, this->numberOfNodes, skew), predictPhase(algorithm, p), it->second);
+		}
+	}
+
+	// The total is only logged, it is not used for the calibration
+	std::map<std::string, double>::iterator it = phaseTimes->find("Join");
+	if (it != phaseTimes->end()) {
+		fprintf(historyFile, "%s,%u,%lu,%lu,%.9f,%s,%.0f,%.0f,%.0f\n", ALGORITHM_NAMES[algorithm], this->numberOfNodes, inner, outer, skew, "Join", 0.0, predict(algorithm), it->second);
+	}
+
+	fclose(historyFile);
+
+}
+
+const char* CostModel::getAlgorithmName(algorithm_t algorithm) {
+
+	return ALGORITHM_NAMES[algorithm];
+
+}
+
+bool CostModel::parseAlgorithmName(const char *name, algorithm_t *algorithm) {
+
+	for (uint32_t a = 0; a < NUMBER_OF_ALGORITHMS; ++a) {
+		if (strcmp(name, ALGORITHM_NAMES[a]) == 0) {
+			*algorithm = (algorithm_t) a;
+			return true;
+		}
+	}
+	return false;
+
+}
+
+double CostModel::computeVolume(algorithm_t algorithm, uint32_t phase, uint64_t innerRelationSize, uint64_t outerRelationSize, uint32_t numberOfNodes, double heavyKeyShare) {
+
+	double const localTuples = ((double) (innerRelationSize + outerRelationSize)) / numberOfNodes;
+
+	// The range partitioning of the sort-merge join sends all tuples of a key to the same
+	// process. The hash join replicates heavy partitions, the broadcast does not move the
+	// outer relation.
+	double const imbalance = std::max(1.0, heavyKeyShare * numberOfNodes);
+
+	switch (algorithm) {
+		case ALGORITHM_RADIX:
+			// Histogram, Network, Local
+			return localTuples;
+		case ALGORITHM_BROADCAST:
+			// Histogram of the local tuples, gathering and partitioning the whole inner relation
+			return (phase == 0) ? localTuples : innerRelationSize + ((double) outerRelationSize) / numberOfNodes;
+		case ALGORITHM_SORT:
+			// Partition, Sorting, Waiting, Merging, Matching
+			return (phase == 0) ? localTuples : localTuples * imbalance;
+		default:
+			return 0;
+	}
+
+}
+
+} /* namespace driver */
+} /* namespace hpcjoin */
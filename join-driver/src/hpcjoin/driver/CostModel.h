@@ -0,0 +1,80 @@
+/**
+ * @author  Claude Barthels <claudeb@inf.ethz.ch>
+ * (c) 2016, ETH Zurich, Systems Group
+ *
+ */
+
+#ifndef HPCJOIN_DRIVER_COSTMODEL_H_
+#define HPCJOIN_DRIVER_COSTMODEL_H_
+
+#include <stdint.h>
+#include <map>
+#include <string>
+
+#include <hpcjoin/driver/Workload.h>
+
+enum algorithm_t {
+	ALGORITHM_RADIX,
+	ALGORITHM_BROADCAST,
+	ALGORITHM_SORT,
+	NUMBER_OF_ALGORITHMS
+};
+
+namespace hpcjoin {
+namespace driver {
+
+/**
+ * Predicts the execution time of every join algorithm as the sum of its phases. The time of
+ * a phase is a coefficient times the number of tuples the phase handles on the slowest
+ * process. The phases have the names of the statistics file of the algorithm (see
+ * Measurements::printStatistics). The coefficients start from fixed defaults and are fitted
+ * (least squares through the origin) to the measured phase times in the history file.
+ */
+
+class CostModel {
+
+public:
+
+	static const uint32_t MAX_PHASES = 5;
+
+public:
+
+	CostModel(uint32_t numberOfNodes, hpcjoin::driver::Workload *workload);
+	~CostModel();
+
+public:
+
+	void calibrate(const char *historyFileName);
+
+	double predict(algorithm_t algorithm);
+	double predictPhase(algorithm_t algorithm, uint32_t phase);
+
+	uint32_t getNumberOfPhases(algorithm_t algorithm);
+	const char *getPhaseName(algorithm_t algorithm, uint32_t phase);
+	uint32_t getNumberOfCalibrationRuns(algorithm_t algorithm);
+
+	void record(const char *historyFileName, algorithm_t algorithm, std::map<std::string, double> *phaseTimes);
+
+public:
+
+	static const char *getAlgorithmName(algorithm_t algorithm);
+	static bool parseAlgorithmName(const char *name, algorithm_t *algorithm);
+
+protected:
+
+	double computeVolume(algorithm_t algorithm, uint32_t phase, uint64_t innerRelationSize, uint64_t outerRelationSize, uint32_t numberOfNodes, double heavyKeyShare);
+
+protected:
+
+	uint32_t numberOfNodes;
+	hpcjoin::driver::Workload *workload;
+
+	double coefficients[NUMBER_OF_ALGORITHMS][MAX_PHASES];
+	uint32_t calibrationRuns[NUMBER_OF_ALGORITHMS];
+
+};
+
+} /* namespace driver */
+} /* namespace hpcjoin */
+
+#endif /* HPCJOIN_DRIVER_COSTMODEL_H_ */
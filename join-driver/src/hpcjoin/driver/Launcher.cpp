@@ -0,0 +1,78 @@
+/**
+ * @author  Claude Barthels <claudeb@inf.ethz.ch>
+ * (c) 2016, ETH Zurich, Systems Group
+ *
+ */
+
+#include "Launcher.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+
+#define OUTPUT_LINE_LENGTH 4096
+#define EXPERIMENT_PATH_PREFIX "[INFO] Experiment data located at "
+
+namespace hpcjoin {
+namespace driver {
+
+int Launcher::run(const char *command, std::map<std::string, double> *phaseTimes) {
+
+	FILE *output = popen(command, "r");
+	if (output == NULL) {
+		fprintf(stderr, "Could not start %s\n", command);
+		exit(-1);
+	}
+
+	std::string experimentPath;
+	char line[OUTPUT_LINE_LENGTH];
+	while (fgets(line, OUTPUT_LINE_LENGTH, output) != NULL) {
+		fputs(line, stdout);
+		if (strncmp(line, EXPERIMENT_PATH_PREFIX, strlen(EXPERIMENT_PATH_PREFIX)) == 0) {
+			experimentPath = line + strlen(EXPERIMENT_PATH_PREFIX);
+			experimentPath.erase(experimentPath.find_last_not_of("\r\n") + 1);
+		}
+	}
+	fflush(stdout);
+
+	int status = pclose(output);
+	if (status != 0) {
+		return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+	}
+	if (experimentPath.empty() || !readStatistics(experimentPath.c_str(), phaseTimes)) {
+		fprintf(stderr, "No statistics reported by %s\n", command);
+		return -1;
+	}
+	return 0;
+
+}
+
+bool Launcher::readStatistics(const char *experimentPath, std::map<std::string, double> *phaseTimes) {
+
+	std::string statisticsPath = std::string(experimentPath) + "/statistics.csv";
+	FILE *statisticsFile = fopen(statisticsPath.c_str(), "r");
+	if (statisticsFile == NULL) {
+		return false;
+	}
+
+	// phase,iterations,min,median,p99
+	char line[OUTPUT_LINE_LENGTH];
+	while (fgets(line, OUTPUT_LINE_LENGTH, statisticsFile) != NULL) {
+		char phase[64];
+		unsigned long iterations;
+		unsigned long minimum;
+		unsigned long median;
+		unsigned long p99;
+		if (sscanf(line, "%63[^,],%lu,%lu,%lu,%lu", phase, &iterations, &minimum, &median, &p99) == 5) {
+			(*phaseTimes)[phase] = median;
+		}
+	}
+	fclose(statisticsFile);
+
+	return !phaseTimes->empty();
+
+}
+
+} /* namespace driver */
+} /* namespace hpcjoin */
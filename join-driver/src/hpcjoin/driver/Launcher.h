@@ -0,0 +1,37 @@
+/**
+ * @author  Claude Barthels <claudeb@inf.ethz.ch>
+ * (c) 2016, ETH Zurich, Systems Group
+ *
+ */
+
+#ifndef HPCJOIN_DRIVER_LAUNCHER_H_
+#define HPCJOIN_DRIVER_LAUNCHER_H_
+
+#include <map>
+#include <string>
+
+namespace hpcjoin {
+namespace driver {
+
+/**
+ * Runs a join executable and collects the median phase times (in microseconds) from the
+ * statistics file of the experiment folder it reports. The output of the join is passed
+ * through.
+ */
+
+class Launcher {
+
+public:
+
+	static int run(const char *command, std::map<std::string, double> *phaseTimes);
+
+protected:
+
+	static bool readStatistics(const char *experimentPath, std::map<std::string, double> *phaseTimes);
+
+};
+
+} /* namespace driver */
+} /* namespace hpcjoin */
+
+#endif /* HPCJOIN_DRIVER_LAUNCHER_H_ */
@@ -0,0 +1,120 @@
+/**
+ * @author  Claude Barthels <claudeb@inf.ethz.ch>
+ * (c) 2016, ETH Zurich, Systems Group
+ *
+ */
+
+#include "Workload.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <algorithm>
+
+#define ZIPF_EXACT_TERMS (1 << 20)
+
+namespace hpcjoin {
+namespace driver {
+
+Workload::Workload(uint64_t innerRelationSize, uint64_t outerRelationSize, double heavyKeyShare) {
+
+	this->innerRelationSize = innerRelationSize;
+	this->outerRelationSize = outerRelationSize;
+	this->heavyKeyShare = heavyKeyShare;
+
+}
+
+Workload::~Workload() {
+
+}
+
+uint64_t Workload::getInnerRelationSize() {
+
+	return this->innerRelationSize;
+
+}
+
+uint64_t Workload::getOuterRelationSize() {
+
+	return this->outerRelationSize;
+
+}
+
+double Workload::getHeavyKeyShare() {
+
+	return this->heavyKeyShare;
+
+}
+
+uint64_t Workload::readNumberOfTuples(const char *fileName) {
+
+	uint64_t header[4];
+	FILE *file = fopen(fileName, "rb");
+	if (file == NULL) {
+		return RELATION_FILE_INVALID_SIZE;
+	}
+	size_t headerElements = fread(header, sizeof(uint64_t), 4, file);
+	fclose(file);
+
+	if (headerElements != 4 || header[0] != RELATION_FILE_MAGIC) {
+		return RELATION_FILE_INVALID_SIZE;
+	}
+	return header[1];
+
+}
+
+double Workload::sampleHeavyKeyShare(const char *fileName) {
+
+	uint64_t header[4];
+	FILE *file = fopen(fileName, "rb");
+	if (file == NULL || fread(header, sizeof(uint64_t), 4, file) != 4 || header[0] != RELATION_FILE_MAGIC || header[1] == 0) {
+		fprintf(stderr, "Could not read relation file %s\n", fileName);
+		exit(-1);
+	}
+
+	// Keys are sampled at evenly spaced positions, files are often sorted or clustered
+	uint64_t const numberOfTuples = header[1];
+	uint64_t const numberOfSamples = std::min(numberOfTuples, SKEW_SAMPLE_SIZE);
+	uint64_t *samples = (uint64_t *) calloc(numberOfSamples, sizeof(uint64_t));
+	for (uint64_t s = 0; s < numberOfSamples; ++s) {
+		uint64_t position = (numberOfTuples / numberOfSamples) * s;
+		if (fseeko(file, header[2] + position * sizeof(uint64_t), SEEK_SET) != 0 || fread(samples + s, sizeof(uint64_t), 1, file) != 1) {
+			fprintf(stderr, "Could not sample relation file %s\n", fileName);
+			exit(-1);
+		}
+	}
+	fclose(file);
+
+	std::sort(samples, samples + numberOfSamples);
+	uint64_t longestRun = 1;
+	uint64_t currentRun = 1;
+	for (uint64_t s = 1; s < numberOfSamples; ++s) {
+		currentRun = (samples[s] == samples[s - 1]) ? currentRun + 1 : 1;
+		longestRun = std::max(longestRun, currentRun);
+	}
+	free(samples);
+
+	return ((double) longestRun) / numberOfSamples;
+
+}
+
+double Workload::computeZipfHeavyKeyShare(uint64_t numberOfKeys, double exponent) {
+
+	// The first key has probability 1 / H(n, e), the tail of the harmonic number is approximated by its integral
+	double harmonic = 0;
+	uint64_t const exactTerms = std::min(numberOfKeys, (uint64_t) ZIPF_EXACT_TERMS);
+	for (uint64_t k = 1; k <= exactTerms; ++k) {
+		harmonic += pow((double) k, -exponent);
+	}
+	if (numberOfKeys > exactTerms) {
+		double const from = exactTerms + 0.5;
+		double const to = numberOfKeys + 0.5;
+		harmonic += (exponent == 1.0) ? log(to / from) : (pow(to, 1 - exponent) - pow(from, 1 - exponent)) / (1 - exponent);
+	}
+
+	return 1.0 / harmonic;
+
+}
+
+} /* namespace driver */
+} /* namespace hpcjoin */
@@ -0,0 +1,58 @@
+/**
+ * @author  Claude Barthels <claudeb@inf.ethz.ch>
+ * (c) 2016, ETH Zurich, Systems Group
+ *
+ */
+
+#ifndef HPCJOIN_DRIVER_WORKLOAD_H_
+#define HPCJOIN_DRIVER_WORKLOAD_H_
+
+#include <stdint.h>
+
+#define RELATION_FILE_MAGIC (0x314C45524A435048ULL)
+#define RELATION_FILE_INVALID_SIZE (0xFFFFFFFFFFFFFFFFULL)
+
+namespace hpcjoin {
+namespace driver {
+
+/**
+ * Global sizes of both relations and the share of the outer tuples which reference the most
+ * frequent key. The share is sampled from relation files or derived from the parameters of
+ * the generated workload.
+ */
+
+class Workload {
+
+public:
+
+	static const uint64_t SKEW_SAMPLE_SIZE = (1 << 16);
+
+public:
+
+	Workload(uint64_t innerRelationSize, uint64_t outerRelationSize, double heavyKeyShare);
+	~Workload();
+
+public:
+
+	uint64_t getInnerRelationSize();
+	uint64_t getOuterRelationSize();
+	double getHeavyKeyShare();
+
+public:
+
+	static uint64_t readNumberOfTuples(const char *fileName);
+	static double sampleHeavyKeyShare(const char *fileName);
+	static double computeZipfHeavyKeyShare(uint64_t numberOfKeys, double exponent);
+
+protected:
+
+	uint64_t innerRelationSize;
+	uint64_t outerRelationSize;
+	double heavyKeyShare;
+
+};
+
+} /* namespace driver */
+} /* namespace hpcjoin */
+
+#endif /* HPCJOIN_DRIVER_WORKLOAD_H_ */
@@ -0,0 +1,273 @@
+/**
+ * @author  Claude Barthels <claudeb@inf.ethz.ch>
+ * (c) 2016, ETH Zurich, Systems Group
+ *
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <map>
+#include <string>
+
+#include <hpcjoin/driver/Workload.h>
+#include <hpcjoin/driver/CostModel.h>
+#include <hpcjoin/driver/Launcher.h>
+
+static void appendArgument(std::string *command, const char *argument) {
+
+	// Arguments are quoted for the shell which starts the join
+	*command += " '";
+	for (const char *c = argument; *c != '\0'; ++c) {
+		if (*c == '\'') {
+			*command += "'\\''";
+		} else {
+			*command += *c;
+		}
+	}
+	*command += "'";
+
+}
+
+int main(int argc, char *argv[]) {
+
+	uint32_t numberOfNodes = 0;
+	const char *launchCommand = "mpirun -np {np}";
+	const char *radixBinary = "../../radix-hash-join/release/cahj-bin";
+	const char *sortBinary = "../../sort-merge-join/release/casm-bin";
+	const char *historyFileName = "calibration.csv";
+	bool automaticAlgorithm = true;
+	algorithm_t algorithm = ALGORITHM_RADIX;
+	bool sortedOutput = false;
+	bool predictOnly = false;
+
+	char *innerFileName = NULL;
+	char *outerFileName = NULL;
+	uint64_t innerRelationSize = 0;
+	uint64_t outerRelationSize = 0;
+	uint32_t duplicates = 1;
+	double zipfExponent = 0;
+	double matchRate = 1.0;
+
+	// Workload and output options are passed on to the selected join
+	std::string joinArguments;
+
+	int option = -1;
+	while ((option = getopt(argc, argv, "P:L:R:S:H:F:QXmG:i:o:s:z:k:u:c:I:O:e:W:N:T:")) != -1) {
+		switch (option) {
+			case 'P':
+				numberOfNodes = atoi(optarg);
+				break;
+			case 'L':
+				launchCommand = optarg;
+				break;
+			case 'R':
+				radixBinary = optarg;
+				break;
+			case 'S':
+				sortBinary = optarg;
+				break;
+			case 'H':
+				historyFileName = optarg;
+				break;
+			case 'F':
+				automaticAlgorithm = (strcmp(optarg, "auto") == 0);
+				if (!automaticAlgorithm && !hpcjoin::driver::CostModel::parseAlgorithmName(optarg, &algorithm)) {
+					fprintf(stderr, "Unknown algorithm %s\n", optarg);
+					exit(-1);
+				}
+				break;
+			case 'Q':
+				sortedOutput = true;
+				break;
+			case 'X':
+				predictOnly = true;
+				break;
+			case 'm':
+				appendArgument(&joinArguments, "-m");
+				break;
+			case 'G':
+			case 's':
+			case 'c':
+			case 'e':
+			case 'W':
+			case 'N':
+			case 'T': {
+				char flag[3] = { '-', (char) option, '\0' };
+				appendArgument(&joinArguments, flag);
+				appendArgument(&joinArguments, optarg);
+				break;
+			}
+			case 'i':
+				innerFileName = optarg;
+				appendArgument(&joinArguments, "-i");
+				appendArgument(&joinArguments, optarg);
+				break;
+			case 'o':
+				outerFileName = optarg;
+				appendArgument(&joinArguments, "-o");
+				appendArgument(&joinArguments, optarg);
+				break;
+			case 'z':
+				zipfExponent = atof(optarg);
+				appendArgument(&joinArguments, "-z");
+				appendArgument(&joinArguments, optarg);
+				break;
+			case 'k':
+				matchRate = atof(optarg);
+				appendArgument(&joinArguments, "-k");
+				appendArgument(&joinArguments, optarg);
+				break;
+			case 'u':
+				duplicates = atoi(optarg);
+				appendArgument(&joinArguments, "-u");
+				appendArgument(&joinArguments, optarg);
+				break;
+			case 'I':
+				innerRelationSize = strtoull(optarg, NULL, 10);
+				appendArgument(&joinArguments, "-I");
+				appendArgument(&joinArguments, optarg);
+				break;
+			case 'O':
+				outerRelationSize = strtoull(optarg, NULL, 10);
+				appendArgument(&joinArguments, "-O");
+				appendArgument(&joinArguments, optarg);
+				break;
+			default:
+				fprintf(stderr, "Usage: %s -P <processes> [-L <launch command>] [-R <radix hash join binary>] [-S <sort-merge join binary>] [-H <history file>] [-F <auto|radix|broadcast|sort>] [-Q] [-X] [-m] [-G <groups>] [-i <inner relation file>] [-o <outer relation file>] [-s <seed>] [-z <zipf exponent>] [-k <match rate>] [-u <duplicates>] [-c <random|sorted|clustered>] [-I <inner tuples>] [-O <outer tuples>] [-e <experiment tag>] [-W <warm-up iterations>] [-N <measured iterations>] [-T <auto|narrow|compressed|wide>]\n", argv[0]);
+				exit(-1);
+		}
+	}
+
+	if (numberOfNodes == 0) {
+		fprintf(stderr, "The number of processes needs to be set\n");
+		exit(-1);
+	}
+
+	if (duplicates < 1 || matchRate < 0 || matchRate > 1) {
+		fprintf(stderr, "Invalid workload: keys need to appear at least once and the match rate needs to be between 0 and 1\n");
+		exit(-1);
+	}
+
+	/**********************************************************************/
+
+	/**
+	 * Workload
+	 */
+
+	// Same defaults as the join executables
+	uint64_t globalInnerRelationSize = (innerRelationSize != 0) ? innerRelationSize : ((uint64_t) numberOfNodes) * 200000;
+	uint64_t globalOuterRelationSize = (outerRelationSize != 0) ? outerRelationSize : ((uint64_t) numberOfNodes) * 200000;
+	if (innerFileName != NULL) {
+		globalInnerRelationSize = hpcjoin::driver::Workload::readNumberOfTuples(innerFileName);
+	}
+	if (outerFileName != NULL) {
+		globalOuterRelationSize = hpcjoin::driver::Workload::readNumberOfTuples(outerFileName);
+	}
+	if (globalInnerRelationSize == RELATION_FILE_INVALID_SIZE || globalOuterRelationSize == RELATION_FILE_INVALID_SIZE) {
+		fprintf(stderr, "Could not read the size of the relation files\n");
+		exit(-1);
+	}
+
+	// The outer keys reference (inner size / duplicates) distinct keys
+	double heavyKeyShare = 0;
+	uint64_t numberOfDistinctKeys = (globalInnerRelationSize + duplicates - 1) / duplicates;
+	if (outerFileName != NULL) {
+		heavyKeyShare = hpcjoin::driver::Workload::sampleHeavyKeyShare(outerFileName);
+	} else if (zipfExponent > 0) {
+		heavyKeyShare = matchRate * hpcjoin::driver::Workload::computeZipfHeavyKeyShare(numberOfDistinctKeys, zipfExponent);
+	} else {
+		heavyKeyShare = 1.0 / numberOfDistinctKeys;
+	}
+
+	hpcjoin::driver::Workload *workload = new hpcjoin::driver::Workload(globalInnerRelationSize, globalOuterRelationSize, heavyKeyShare);
+	printf("[DRIVER] Workload:\t%u\t%lu\t%lu\t%.6f\n", numberOfNodes, globalInnerRelationSize, globalOuterRelationSize, heavyKeyShare);
+
+	/**********************************************************************/
+
+	/**
+	 * Prediction
+	 */
+
+	hpcjoin::driver::CostModel *model = new hpcjoin::driver::CostModel(numberOfNodes, workload);
+	model->calibrate(historyFileName);
+
+	// Only the sort-merge join produces key-ordered output but it requires a power of two processes, a broadcast requires a network
+	bool candidates[NUMBER_OF_ALGORITHMS];
+	candidates[ALGORITHM_RADIX] = !sortedOutput;
+	candidates[ALGORITHM_BROADCAST] = !sortedOutput && numberOfNodes > 1;
+	candidates[ALGORITHM_SORT] = (numberOfNodes & (numberOfNodes - 1)) == 0;
+
+	bool selected = false;
+	double bestTime = 0;
+	for (uint32_t a = 0; a < NUMBER_OF_ALGORITHMS; ++a) {
+		double time = model->predict((algorithm_t) a);
+		printf("[DRIVER] Predicted:\t%s\t%.3f\t%u%s\n", hpcjoin::driver::CostModel::getAlgorithmName((algorithm_t) a), time / 1000, model->getNumberOfCalibrationRuns((algorithm_t) a),
+				candidates[a] ? "" : "\t(not applicable)");
+		if (automaticAlgorithm && candidates[a] && (!selected || time < bestTime)) {
+			selected = true;
+			bestTime = time;
+			algorithm = (algorithm_t) a;
+		}
+	}
+
+	if (!selected && automaticAlgorithm) {
+		fprintf(stderr, "None of the join algorithms can be used for this workload\n");
+		exit(-1);
+	}
+
+	if (!candidates[algorithm]) {
+		fprintf(stderr, "The %s join cannot be used for this workload\n", hpcjoin::driver::CostModel::getAlgorithmName(algorithm));
+		exit(-1);
+	}
+	printf("[DRIVER] Selected:\t%s\n", hpcjoin::driver::CostModel::getAlgorithmName(algorithm));
+	fflush(stdout);
+
+	if (predictOnly) {
+		delete model;
+		delete workload;
+		return 0;
+	}
+
+	/**********************************************************************/
+
+	/**
+	 * Execution
+	 */
+
+	// Every occurrence of the placeholder is replaced by the number of processes
+	std::string command = launchCommand;
+	char processes[16];
+	snprintf(processes, sizeof(processes), "%u", numberOfNodes);
+	for (size_t position = command.find("{np}"); position != std::string::npos; position = command.find("{np}", position + strlen(processes))) {
+		command.replace(position, strlen("{np}"), processes);
+	}
+	appendArgument(&command, (algorithm == ALGORITHM_SORT) ? sortBinary : radixBinary);
+	command += joinArguments;
+	if (algorithm != ALGORITHM_SORT) {
+		appendArgument(&command, "-B");
+		appendArgument(&command, (algorithm == ALGORITHM_BROADCAST) ? "broadcast" : "shuffle");
+	}
+
+	std::map<std::string, double> phaseTimes;
+	int result = hpcjoin::driver::Launcher::run(command.c_str(), &phaseTimes);
+	if (result != 0) {
+		fprintf(stderr, "The %s join failed (%d)\n", hpcjoin::driver::CostModel::getAlgorithmName(algorithm), result);
+		exit(-1);
+	}
+
+	// Predicted and measured times are logged, the history calibrates the next prediction
+	for (uint32_t p = 0; p < model->getNumberOfPhases(algorithm); ++p) {
+		printf("[DRIVER] Phase:\t%s\t%.3f\t%.3f\n", model->getPhaseName(algorithm, p), model->predictPhase(algorithm, p) / 1000, phaseTimes[model->getPhaseName(algorithm, p)] / 1000);
+	}
+	printf("[DRIVER] Join:\t%s\t%.3f\t%.3f\n", hpcjoin::driver::CostModel::getAlgorithmName(algorithm), model->predict(algorithm) / 1000, phaseTimes["Join"] / 1000);
+	model->record(historyFileName, algorithm, &phaseTimes);
+
+	delete model;
+	delete workload;
+
+	return 0;
+
+}
@@ -0,0 +1,182 @@
+/**
+ * @author  Claude Barthels <claudeb@inf.ethz.ch>
+ * (c) 2016, ETH Zurich, Systems Group
+ *
+ */
+
+#include "Configuration.h"
+
+#include <hpcjoin/data/CompressedTuple.h>
+#include <hpcjoin/data/WideCompressedTuple.h>
+#include <hpcjoin/data/NarrowCompressedTuple.h>
+#include <hpcjoin/data/Tuple.h>
+#include <hpcjoin/utils/Hardware.h>
+#include <hpcjoin/utils/Debug.h>
+
+namespace hpcjoin {
+namespace core {
+
+uint32_t Configuration::THREADS_PER_NODE = 1;
+uint32_t Configuration::NETWORK_THREADS_PER_NODE = 1;
+uint32_t Configuration::FIRST_CORE_ID = 0;
+assignment_policy_t Configuration::ASSIGNMENT_POLICY = ASSIGNMENT_ROUND_ROBIN;
+bool Configuration::ENABLE_HEAVY_PARTITION_REPLICATION = true;
+bool Configuration::MATERIALIZE_RESULTS = false;
+hash_table_layout_t Configuration::HASH_TABLE_LAYOUT = HASH_TABLE_CHAINED;
+bool Configuration::ENABLE_BLOOM_FILTER = false;
+bool Configuration::ENABLE_PACKED_TRANSFERS = false;
+bool Configuration::ENABLE_REQUEST_BASED_PUTS = false;
+bool Configuration::RELEASE_POOL_PAGES = false;
+uint32_t Configuration::MEMORY_BUFFERS_PER_PARTITION = 2;
+huge_page_policy_t Configuration::HUGE_PAGE_POLICY = HUGE_PAGES_NONE;
+tuple_format_t Configuration::TUPLE_FORMAT = TUPLE_FORMAT_COMPRESSED;
+uint32_t Configuration::NARROW_PAYLOAD_BITS = 16;
+uint32_t Configuration::NARROW_PARTITION_BITS = 10;
+uint32_t Configuration::AGGREGATION_GROUPS = 0;
+join_strategy_t Configuration::JOIN_STRATEGY = JOIN_STRATEGY_AUTO;
+double Configuration::NETWORK_BANDWIDTH = 0;
+double Configuration::MEMORY_BANDWIDTH = 0;
+
+uint32_t Configuration::NETWORK_PARTITIONING_FANOUT = 10;
+uint32_t Configuration::LOCAL_PARTITIONING_FANOUT = 10;
+uint64_t Configuration::NETWORK_PARTITIONING_COUNT = (1 << 10);
+uint64_t Configuration::LOCAL_PARTITIONING_COUNT = (1 << 10);
+uint64_t Configuration::CACHE_BUDGET_BYTES = (128 * 1024);
+
+static uint32_t log2Floor(uint64_t value) {
+
+	uint32_t bits = 0;
+	while ((value >> (bits + 1)) > 0) {
+		++bits;
+	}
+	return bits;
+
+}
+
+static uint32_t log2Ceil(uint64_t value) {
+
+	uint32_t bits = log2Floor(value);
+	return (value > (1ULL << bits)) ? bits + 1 : bits;
+
+}
+
+static uint32_t clampFanout(uint32_t fanout, uint32_t upperBound) {
+
+	if (fanout > upperBound) {
+		fanout = upperBound;
+	}
+	if (fanout > Configuration::MAX_PARTITIONING_FANOUT) {
+		fanout = Configuration::MAX_PARTITIONING_FANOUT;
+	}
+	if (fanout < Configuration::MIN_PARTITIONING_FANOUT) {
+		fanout = Configuration::MIN_PARTITIONING_FANOUT;
+	}
+	return fanout;
+
+}
+
+void Configuration::setPartitioningFanouts(uint32_t networkFanout, uint32_t localFanout) {
+
+	NETWORK_PARTITIONING_FANOUT = networkFanout;
+	LOCAL_PARTITIONING_FANOUT = localFanout;
+	NETWORK_PARTITIONING_COUNT = (1ULL << networkFanout);
+	LOCAL_PARTITIONING_COUNT = (1ULL << localFanout);
+
+}
+
+void Configuration::selectPartitioningFanouts(uint64_t globalInnerRelationSize, uint32_t numberOfNodes) {
+
+	uint64_t const l1Size = hpcjoin::utils::Hardware::getL1DataCacheSize();
+	uint64_t const l2Size = hpcjoin::utils::Hardware::getL2CacheSize();
+	uint32_t const tlbEntries = hpcjoin::utils::Hardware::getDataTLBEntries();
+
+	// After both passes, an inner partition should fit into half of the L2 cache
+	CACHE_BUDGET_BYTES = l2Size / 2;
+	uint64_t const innerRelationBytes = globalInnerRelationSize * getCompressedTupleSize();
+	uint32_t const totalFanout = log2Ceil((innerRelationBytes + CACHE_BUDGET_BYTES - 1) / CACHE_BUDGET_BYTES);
+
+	// The network pass creates enough partitions to balance the load between all threads.
+	// Every partition is written to a separate page, which is limited by the TLB size.
+	uint32_t const minNetworkFanout = log2Ceil(((uint64_t) numberOfNodes) * THREADS_PER_NODE * MIN_PARTITIONS_PER_THREAD);
+	uint32_t networkFanout = (totalFanout < log2Floor(tlbEntries)) ? totalFanout : log2Floor(tlbEntries);
+	if (networkFanout < minNetworkFanout) {
+		networkFanout = minNetworkFanout;
+	}
+	networkFanout = clampFanout(networkFanout, MAX_PARTITIONING_FANOUT);
+
+	// The in-cache buffers of the local pass need to fit into the L1 cache
+	uint32_t const localFanout = clampFanout((totalFanout > networkFanout) ? totalFanout - networkFanout : 0, log2Floor(l1Size / CACHELINE_SIZE_BYTES));
+
+	JOIN_DEBUG("Configuration", "L1 %lu, L2 %lu, TLB %u: fan-outs %u (network) and %u (local)", l1Size, l2Size, tlbEntries, networkFanout, localFanout);
+
+	setPartitioningFanouts(networkFanout, localFanout);
+
+}
+
+void Configuration::selectTupleFormat(uint64_t maximumKey, uint64_t maximumRid, bool automatic) {
+
+	// Narrow tuples drop the network partition bits and use as many rid bits as required
+	NARROW_PAYLOAD_BITS = (maximumRid > 0) ? log2Floor(maximumRid) + 1 : 0;
+	NARROW_PARTITION_BITS = NETWORK_PARTITIONING_FANOUT;
+
+	// The smallest representation which holds all keys and rids is used
+	if (automatic) {
+		if (hpcjoin::data::NarrowCompressedTuple::canRepresent(maximumKey, maximumRid)) {
+			TUPLE_FORMAT = TUPLE_FORMAT_NARROW;
+		} else if (hpcjoin::data::CompressedTuple::canRepresent(maximumKey, maximumRid)) {
+			TUPLE_FORMAT = TUPLE_FORMAT_COMPRESSED;
+		} else {
+			TUPLE_FORMAT = TUPLE_FORMAT_WIDE;
+		}
+	} else if (TUPLE_FORMAT == TUPLE_FORMAT_NARROW && !hpcjoin::data::NarrowCompressedTuple::canRepresent(maximumKey, maximumRid)) {
+		// A requested format which would truncate keys or rids is widened
+		TUPLE_FORMAT = hpcjoin::data::CompressedTuple::canRepresent(maximumKey, maximumRid) ? TUPLE_FORMAT_COMPRESSED : TUPLE_FORMAT_WIDE;
+	} else if (TUPLE_FORMAT == TUPLE_FORMAT_COMPRESSED && !hpcjoin::data::CompressedTuple::canRepresent(maximumKey, maximumRid)) {
+		TUPLE_FORMAT = TUPLE_FORMAT_WIDE;
+	}
+
+	JOIN_DEBUG("Configuration", "Maximum key %lu and rid %lu: %s tuples", maximumKey, maximumRid, (TUPLE_FORMAT == TUPLE_FORMAT_WIDE) ? "wide" : ((TUPLE_FORMAT == TUPLE_FORMAT_NARROW) ? "narrow" : "compressed"));
+
+}
+
+uint32_t Configuration::getCompressedTupleSize() {
+
+	switch (TUPLE_FORMAT) {
+		case TUPLE_FORMAT_WIDE:
+			return sizeof(hpcjoin::data::WideCompressedTuple);
+		case TUPLE_FORMAT_NARROW:
+			return sizeof(hpcjoin::data::NarrowCompressedTuple);
+		default:
+			return sizeof(hpcjoin::data::CompressedTuple);
+	}
+
+}
+
+join_strategy_t Configuration::selectJoinStrategy(uint64_t globalInnerRelationSize, uint64_t globalOuterRelationSize, uint32_t numberOfNodes) {
+
+	if (globalInnerRelationSize > MAX_BROADCAST_TUPLES) {
+		return JOIN_STRATEGY_SHUFFLE;
+	}
+	if (JOIN_STRATEGY != JOIN_STRATEGY_AUTO) {
+		return JOIN_STRATEGY;
+	}
+	if (numberOfNodes < 2 || NETWORK_BANDWIDTH <= 0 || MEMORY_BANDWIDTH <= 0) {
+		return JOIN_STRATEGY_SHUFFLE;
+	}
+
+	// The shuffle moves (I+O)/N * (N-1)/N compressed tuples in and out of every process. A
+	// broadcast receives I * (N-1)/N uncompressed tuples, which every process also has to
+	// partition and build. The broadcast is cheaper if O > I * (N * (T/C + Bn/Bm) - 1), where
+	// T and C are the tuple sizes and Bn and Bm the network and memory bandwidth.
+	double const tupleRatio = ((double) sizeof(hpcjoin::data::Tuple)) / getCompressedTupleSize();
+	double const threshold = numberOfNodes * (tupleRatio + NETWORK_BANDWIDTH / MEMORY_BANDWIDTH) - 1;
+	bool const broadcast = (globalOuterRelationSize > threshold * globalInnerRelationSize);
+
+	JOIN_DEBUG("Configuration", "Outer/inner ratio %.2f, broadcast threshold %.2f: %s join", ((double) globalOuterRelationSize) / globalInnerRelationSize, threshold, broadcast ? "broadcast" : "shuffle");
+
+	return broadcast ? JOIN_STRATEGY_BROADCAST : JOIN_STRATEGY_SHUFFLE;
+
+}
+
+} /* namespace core */
+} /* namespace hpcjoin */
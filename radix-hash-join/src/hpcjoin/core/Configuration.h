@@ -9,6 +9,36 @@
 
 #include <stdint.h>
 
+enum assignment_policy_t {
+	ASSIGNMENT_ROUND_ROBIN,
+	ASSIGNMENT_COST_BASED
+};
+
+enum hash_table_layout_t {
+	HASH_TABLE_CHAINED,
+	HASH_TABLE_BUCKETIZED,
+	HASH_TABLE_BUCKETIZED_SCALAR
+};
+
+enum huge_page_policy_t {
+	HUGE_PAGES_NONE,
+	HUGE_PAGES_TRANSPARENT,
+	HUGE_PAGES_2MB,
+	HUGE_PAGES_1GB
+};
+
+enum tuple_format_t {
+	TUPLE_FORMAT_COMPRESSED,
+	TUPLE_FORMAT_WIDE,
+	TUPLE_FORMAT_NARROW
+};
+
+enum join_strategy_t {
+	JOIN_STRATEGY_AUTO,
+	JOIN_STRATEGY_SHUFFLE,
+	JOIN_STRATEGY_BROADCAST
+};
+
 namespace hpcjoin {
 namespace core {
 
@@ -20,23 +50,74 @@ public:
 
 	static const uint32_t CACHELINE_SIZE_BYTES = 64;
 	static const uint32_t CACHELINES_PER_MEMORY_BUFFER = 1024;
-	static const uint32_t MEMORY_BUFFERS_PER_PARTITION = 2;
+	static const uint32_t MAX_MEMORY_BUFFERS_PER_PARTITION = 16;
 
 	static const uint64_t MEMORY_BUFFER_SIZE_BYTES = CACHELINES_PER_MEMORY_BUFFER * CACHELINE_SIZE_BYTES;
-	static const uint64_t MEMORY_PARTITION_SIZE_BYTES = MEMORY_BUFFERS_PER_PARTITION * MEMORY_BUFFER_SIZE_BYTES;
-
-	static const bool ENABLE_TWO_LEVEL_PARTITIONING = true;
-
-	static const uint64_t NETWORK_PARTITIONING_FANOUT = 10;
-	static const uint64_t LOCAL_PARTITIONING_FANOUT = 10;
 
-	static const uint64_t NETWORK_PARTITIONING_COUNT = (1 << NETWORK_PARTITIONING_FANOUT);
-	static const uint64_t LOCAL_PARTITIONING_COUNT = (1 << LOCAL_PARTITIONING_FANOUT);
+	static const uint32_t MIN_PARTITIONING_FANOUT = 1;
+	static const uint32_t MAX_PARTITIONING_FANOUT = 12;
+	static const uint32_t MIN_PARTITIONS_PER_THREAD = 4;
+	static const uint32_t MAX_LOCAL_PARTITIONING_PASSES = 3;
 
 	static constexpr double ALLOCATION_FACTOR = 1.1;
 
 	static const uint32_t PAYLOAD_BITS = 27;
 
+	static constexpr double BUILD_COST_PER_TUPLE = 2.0;
+	static constexpr double PROBE_COST_PER_TUPLE = 1.0;
+	static constexpr double HEAVY_PARTITION_THRESHOLD = 1.0;
+
+	static const uint64_t RESULT_CHUNK_SIZE_BYTES = (1 << 20);
+
+	static const uint32_t BLOOM_FILTER_BITS_PER_KEY = 16;
+
+	static const uint64_t BANDWIDTH_PROBE_SIZE_BYTES = (1 << 22);
+	static const uint32_t BANDWIDTH_PROBE_REPETITIONS = 4;
+
+	// The gathered inner relation is addressed with int counts and displacements
+	static const uint64_t MAX_BROADCAST_TUPLES = 0x7FFFFFFF;
+
+public:
+
+	/**
+	 * Runtime configuration (set before the join is started)
+	 */
+
+	static uint32_t THREADS_PER_NODE;
+	static uint32_t NETWORK_THREADS_PER_NODE;
+	static uint32_t FIRST_CORE_ID;
+	static assignment_policy_t ASSIGNMENT_POLICY;
+	static bool ENABLE_HEAVY_PARTITION_REPLICATION;
+	static bool MATERIALIZE_RESULTS;
+	static hash_table_layout_t HASH_TABLE_LAYOUT;
+	static bool ENABLE_BLOOM_FILTER;
+	static bool ENABLE_PACKED_TRANSFERS;
+	static bool ENABLE_REQUEST_BASED_PUTS;
+	static bool RELEASE_POOL_PAGES;
+	static uint32_t MEMORY_BUFFERS_PER_PARTITION;
+	static huge_page_policy_t HUGE_PAGE_POLICY;
+	static tuple_format_t TUPLE_FORMAT;
+	static uint32_t NARROW_PAYLOAD_BITS;
+	static uint32_t NARROW_PARTITION_BITS;
+	static uint32_t AGGREGATION_GROUPS;
+	static join_strategy_t JOIN_STRATEGY;
+	static double NETWORK_BANDWIDTH;
+	static double MEMORY_BANDWIDTH;
+
+	static uint32_t NETWORK_PARTITIONING_FANOUT;
+	static uint32_t LOCAL_PARTITIONING_FANOUT;
+	static uint64_t NETWORK_PARTITIONING_COUNT;
+	static uint64_t LOCAL_PARTITIONING_COUNT;
+	static uint64_t CACHE_BUDGET_BYTES;
+
+public:
+
+	static void setPartitioningFanouts(uint32_t networkFanout, uint32_t localFanout);
+	static void selectPartitioningFanouts(uint64_t globalInnerRelationSize, uint32_t numberOfNodes);
+	static void selectTupleFormat(uint64_t maximumKey, uint64_t maximumRid, bool automatic);
+	static uint32_t getCompressedTupleSize();
+	static join_strategy_t selectJoinStrategy(uint64_t globalInnerRelationSize, uint64_t globalOuterRelationSize, uint32_t numberOfNodes);
+
 };
 
 } /* namespace core */
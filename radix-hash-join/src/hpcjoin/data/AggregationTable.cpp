@@ -0,0 +1,72 @@
+/**
+ * @author  Claude Barthels <claudeb@inf.ethz.ch>
+ * (c) 2016, ETH Zurich, Systems Group
+ *
+ */
+
+#include "AggregationTable.h"
+
+#include <mpi.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <hpcjoin/core/Configuration.h>
+#include <hpcjoin/utils/Debug.h>
+
+namespace hpcjoin {
+namespace data {
+
+AggregationTable::AggregationTable(uint32_t numberOfGroups) {
+
+	JOIN_ASSERT(numberOfGroups > 0, "Aggregation Table", "At least one group is required");
+
+	this->numberOfGroups = numberOfGroups;
+	int result = posix_memalign((void **) &(this->aggregates), hpcjoin::core::Configuration::CACHELINE_SIZE_BYTES, numberOfGroups * sizeof(aggregate_t));
+	JOIN_ASSERT(result == 0, "Aggregation Table", "Could not allocate aggregates");
+	JOIN_UNUSED(result);
+	memset(this->aggregates, 0, numberOfGroups * sizeof(aggregate_t));
+
+}
+
+AggregationTable::~AggregationTable() {
+
+	free(this->aggregates);
+
+}
+
+void AggregationTable::merge(AggregationTable* other) {
+
+	JOIN_ASSERT(other->numberOfGroups == this->numberOfGroups, "Aggregation Table", "Tables have a different number of groups");
+
+	for (uint32_t g = 0; g < this->numberOfGroups; ++g) {
+		this->aggregates[g].count += other->aggregates[g].count;
+		this->aggregates[g].sum += other->aggregates[g].sum;
+	}
+
+}
+
+void AggregationTable::reduce(uint32_t rootNodeId) {
+
+	// Counts and sums are both added up, the table is reduced as an array of integers
+	int nodeId = -1;
+	MPI_Comm_rank(MPI_COMM_WORLD, &nodeId);
+	void *input = (((uint32_t) nodeId) == rootNodeId) ? MPI_IN_PLACE : this->aggregates;
+	MPI_Reduce(input, this->aggregates, 2 * this->numberOfGroups, MPI_UINT64_T, MPI_SUM, rootNodeId, MPI_COMM_WORLD);
+
+}
+
+uint32_t AggregationTable::getNumberOfGroups() {
+
+	return this->numberOfGroups;
+
+}
+
+aggregate_t* AggregationTable::getAggregate(uint32_t groupId) {
+
+	JOIN_ASSERT(groupId < this->numberOfGroups, "Aggregation Table", "Group id %d out of range", groupId);
+	return this->aggregates + groupId;
+
+}
+
+} /* namespace data */
+} /* namespace hpcjoin */
@@ -0,0 +1,151 @@
+/**
+ * @author  Claude Barthels <claudeb@inf.ethz.ch>
+ * (c) 2016, ETH Zurich, Systems Group
+ *
+ */
+
+#include "ArrivalWindow.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <hpcjoin/utils/Debug.h>
+
+namespace hpcjoin {
+namespace data {
+
+ArrivalWindow::ArrivalWindow(uint32_t numberOfNodes, uint32_t nodeId, hpcjoin::histograms::AssignmentMap *assignment) {
+
+	this->numberOfNodes = numberOfNodes;
+	this->nodeId = nodeId;
+	this->numberOfReplicas = assignment->getNumberOfReplicas();
+	this->assignment = assignment;
+
+	this->expectedArrivals = (uint64_t *) calloc(this->numberOfReplicas, sizeof(uint64_t));
+	this->currentArrivals = (uint64_t *) calloc(this->numberOfReplicas, sizeof(uint64_t));
+	this->reported = (bool *) calloc(this->numberOfReplicas, sizeof(bool));
+
+	// Counters are indexed by replica id, only the ones of local replicas are used
+	MPI_Alloc_mem(this->numberOfReplicas * sizeof(uint64_t), MPI_INFO_NULL, &(this->counters));
+	memset(this->counters, 0, this->numberOfReplicas * sizeof(uint64_t));
+
+	#ifdef USE_FOMPI
+	this->window = (foMPI_Win *) calloc(1, sizeof(foMPI_Win));
+	foMPI_Win_create(this->counters, this->numberOfReplicas * sizeof(uint64_t), sizeof(uint64_t), MPI_INFO_NULL, MPI_COMM_WORLD, this->window);
+	#else
+	this->window = (MPI_Win *) calloc(1, sizeof(MPI_Win));
+	MPI_Win_create(this->counters, this->numberOfReplicas * sizeof(uint64_t), sizeof(uint64_t), MPI_INFO_NULL, MPI_COMM_WORLD, this->window);
+	#endif
+
+}
+
+ArrivalWindow::~ArrivalWindow() {
+
+	#ifdef USE_FOMPI
+	foMPI_Win_free(this->window);
+	#else
+	MPI_Win_free(this->window);
+	#endif
+	MPI_Free_mem(this->counters);
+
+	free(this->window);
+	free(this->expectedArrivals);
+	free(this->currentArrivals);
+	free(this->reported);
+
+}
+
+void ArrivalWindow::start() {
+
+	#ifdef USE_FOMPI
+	foMPI_Win_lock_all(0, *window);
+	#else
+	MPI_Win_lock_all(0, *window);
+	#endif
+
+}
+
+void ArrivalWindow::stop() {
+
+	#ifdef USE_FOMPI
+	foMPI_Win_unlock_all(*window);
+	#else
+	MPI_Win_unlock_all(*window);
+	#endif
+
+}
+
+void ArrivalWindow::computeExpectedArrivals(uint64_t *localSenders) {
+
+	MPI_Allreduce(localSenders, this->expectedArrivals, this->numberOfReplicas, MPI_UINT64_T, MPI_SUM, MPI_COMM_WORLD);
+
+}
+
+void ArrivalWindow::signal(uint32_t replicaId) {
+
+	uint64_t increment = 1;
+	uint32_t targetProcess = this->assignment->getReplicaNode(replicaId);
+
+	#ifdef USE_FOMPI
+	foMPI_Accumulate(&increment, 1, MPI_UINT64_T, targetProcess, replicaId, 1, MPI_UINT64_T, foMPI_SUM, *window);
+	#else
+	MPI_Accumulate(&increment, 1, MPI_UINT64_T, targetProcess, replicaId, 1, MPI_UINT64_T, MPI_SUM, *window);
+	#endif
+
+	// The increment is read from the origin buffer, which goes out of scope
+	#ifdef USE_FOMPI
+	foMPI_Win_flush_local(targetProcess, *window);
+	#else
+	MPI_Win_flush_local(targetProcess, *window);
+	#endif
+
+}
+
+void ArrivalWindow::flush() {
+
+	#ifdef USE_FOMPI
+	foMPI_Win_flush_all(*window);
+	#else
+	MPI_Win_flush_all(*window);
+	#endif
+
+}
+
+uint32_t ArrivalWindow::collectCompletedReplicas(uint32_t *replicaIds) {
+
+	// Counters are updated concurrently by remote accumulates and need to be read atomically
+	#ifdef USE_FOMPI
+	foMPI_Get_accumulate(NULL, 0, MPI_UINT64_T, this->currentArrivals, this->numberOfReplicas, MPI_UINT64_T, this->nodeId, 0, this->numberOfReplicas, MPI_UINT64_T, foMPI_NO_OP, *window);
+	foMPI_Win_flush(this->nodeId, *window);
+	#else
+	MPI_Get_accumulate(NULL, 0, MPI_UINT64_T, this->currentArrivals, this->numberOfReplicas, MPI_UINT64_T, this->nodeId, 0, this->numberOfReplicas, MPI_UINT64_T, MPI_NO_OP, *window);
+	MPI_Win_flush(this->nodeId, *window);
+	#endif
+
+	uint32_t numberOfCompletedReplicas = 0;
+	for (uint32_t r = 0; r < this->numberOfReplicas; ++r) {
+		JOIN_ASSERT(this->currentArrivals[r] <= this->expectedArrivals[r], "Arrival Window", "Replica %d has more arrivals than expected", r);
+		if (this->assignment->getReplicaNode(r) == this->nodeId && !this->reported[r] && this->currentArrivals[r] == this->expectedArrivals[r]) {
+			replicaIds[numberOfCompletedReplicas++] = r;
+			this->reported[r] = true;
+		}
+	}
+
+	return numberOfCompletedReplicas;
+
+}
+
+uint32_t ArrivalWindow::getNumberOfLocalReplicas() {
+
+	uint32_t numberOfLocalReplicas = 0;
+	for (uint32_t r = 0; r < this->numberOfReplicas; ++r) {
+		if (this->assignment->getReplicaNode(r) == this->nodeId) {
+			++numberOfLocalReplicas;
+		}
+	}
+	return numberOfLocalReplicas;
+
+}
+
+} /* namespace data */
+} /* namespace hpcjoin */
@@ -0,0 +1,73 @@
+/**
+ * @author  Claude Barthels <claudeb@inf.ethz.ch>
+ * (c) 2016, ETH Zurich, Systems Group
+ *
+ */
+
+#ifndef HPCJOIN_DATA_ARRIVALWINDOW_H_
+#define HPCJOIN_DATA_ARRIVALWINDOW_H_
+
+#include <mpi.h>
+
+#ifdef USE_FOMPI
+#include <fompi.h>
+#endif
+
+#include <stdint.h>
+
+#include <hpcjoin/histograms/AssignmentMap.h>
+
+namespace hpcjoin {
+namespace data {
+
+/**
+ * Counter window used to signal the arrival of partitions. Once a sender has written all its
+ * tuples of a replica and these are visible at the target, it increments the counter of the
+ * replica on the target process. A replica is complete once the counter reaches the number of
+ * senders (slices of all processes, for both relations) contributing to it.
+ */
+
+class ArrivalWindow {
+
+public:
+
+	ArrivalWindow(uint32_t numberOfNodes, uint32_t nodeId, hpcjoin::histograms::AssignmentMap *assignment);
+	~ArrivalWindow();
+
+public:
+
+	void start();
+	void stop();
+
+	void computeExpectedArrivals(uint64_t *localSenders);
+
+	void signal(uint32_t replicaId);
+	void flush();
+
+	uint32_t collectCompletedReplicas(uint32_t *replicaIds);
+	uint32_t getNumberOfLocalReplicas();
+
+protected:
+
+	uint32_t numberOfNodes;
+	uint32_t nodeId;
+	uint32_t numberOfReplicas;
+	hpcjoin::histograms::AssignmentMap *assignment;
+
+	uint64_t *counters;
+	uint64_t *expectedArrivals;
+	uint64_t *currentArrivals;
+	bool *reported;
+
+	#ifdef USE_FOMPI
+	foMPI_Win *window;
+	#else
+	MPI_Win *window;
+	#endif
+
+};
+
+} /* namespace data */
+} /* namespace hpcjoin */
+
+#endif /* HPCJOIN_DATA_ARRIVALWINDOW_H_ */
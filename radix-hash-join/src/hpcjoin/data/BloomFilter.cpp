@@ -0,0 +1,81 @@
+/**
+ * @author  Claude Barthels <claudeb@inf.ethz.ch>
+ * (c) 2016, ETH Zurich, Systems Group
+ *
+ */
+
+#include "BloomFilter.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <mpi.h>
+
+#include <hpcjoin/core/Configuration.h>
+#include <hpcjoin/utils/Debug.h>
+
+#define BLOOM_FILTER_MAX_WORDS_PER_REDUCTION (1 << 28)
+
+namespace hpcjoin {
+namespace data {
+
+const uint32_t BloomFilter::SALTS[BLOOM_FILTER_WORDS_PER_BLOCK] = { 0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU, 0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U };
+
+BloomFilter::BloomFilter(uint64_t numberOfElements) {
+
+	uint64_t const bitsPerBlock = BLOOM_FILTER_WORDS_PER_BLOCK * 32;
+	uint64_t const requiredBlocks = (numberOfElements * hpcjoin::core::Configuration::BLOOM_FILTER_BITS_PER_KEY + bitsPerBlock - 1) / bitsPerBlock;
+
+	this->numberOfBlocks = 1;
+	while (this->numberOfBlocks < requiredBlocks) {
+		this->numberOfBlocks <<= 1;
+	}
+	this->blockMask = this->numberOfBlocks - 1;
+
+	int result = posix_memalign((void **) &(this->blocks), hpcjoin::core::Configuration::CACHELINE_SIZE_BYTES, getSizeInBytes());
+	JOIN_ASSERT(result == 0, "Bloom Filter", "Could not allocate filter");
+	JOIN_UNUSED(result);
+	memset(this->blocks, 0, getSizeInBytes());
+
+}
+
+BloomFilter::~BloomFilter() {
+
+	free(this->blocks);
+
+}
+
+void BloomFilter::insert(hpcjoin::data::Relation* relation) {
+
+	uint64_t const numberOfElements = relation->getLocalSize();
+	hpcjoin::data::Tuple * const data = relation->getData();
+
+	for (uint64_t i = 0; i < numberOfElements; ++i) {
+		insert(data[i].key);
+	}
+
+}
+
+void BloomFilter::combine() {
+
+	// The element count of a reduction is limited to an int
+	uint32_t *words = (uint32_t *) this->blocks;
+	uint64_t const numberOfWords = this->numberOfBlocks * BLOOM_FILTER_WORDS_PER_BLOCK;
+
+	for (uint64_t offset = 0; offset < numberOfWords; offset += BLOOM_FILTER_MAX_WORDS_PER_REDUCTION) {
+		uint64_t count = numberOfWords - offset;
+		if (count > BLOOM_FILTER_MAX_WORDS_PER_REDUCTION) {
+			count = BLOOM_FILTER_MAX_WORDS_PER_REDUCTION;
+		}
+		MPI_Allreduce(MPI_IN_PLACE, words + offset, (int) count, MPI_UINT32_T, MPI_BOR, MPI_COMM_WORLD);
+	}
+
+}
+
+uint64_t BloomFilter::getSizeInBytes() {
+
+	return this->numberOfBlocks * sizeof(bloom_block_t);
+
+}
+
+} /* namespace data */
+} /* namespace hpcjoin */
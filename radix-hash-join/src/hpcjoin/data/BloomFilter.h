@@ -0,0 +1,103 @@
+/**
+ * @author  Claude Barthels <claudeb@inf.ethz.ch>
+ * (c) 2016, ETH Zurich, Systems Group
+ *
+ */
+
+#ifndef HPCJOIN_DATA_BLOOMFILTER_H_
+#define HPCJOIN_DATA_BLOOMFILTER_H_
+
+#include <stdint.h>
+
+#include <hpcjoin/data/Relation.h>
+
+#define BLOOM_FILTER_WORDS_PER_BLOCK (8)
+
+namespace hpcjoin {
+namespace data {
+
+typedef struct {
+
+	uint32_t words[BLOOM_FILTER_WORDS_PER_BLOCK];
+
+} __attribute__((aligned(32))) bloom_block_t;
+
+/**
+ * Blocked Bloom filter over the keys of the inner relation. A key sets one bit in each word of
+ * a single 32-byte block, such that a lookup touches only one cache line. Every process inserts
+ * its local keys and the filters of all processes are combined with a bitwise OR.
+ */
+
+class BloomFilter {
+
+public:
+
+	BloomFilter(uint64_t numberOfElements);
+	~BloomFilter();
+
+public:
+
+	void insert(hpcjoin::data::Relation *relation);
+	void combine();
+
+	inline void insert(uint64_t key) __attribute__((always_inline));
+	inline bool contains(uint64_t key) __attribute__((always_inline));
+
+	uint64_t getSizeInBytes();
+
+protected:
+
+	static const uint32_t SALTS[BLOOM_FILTER_WORDS_PER_BLOCK];
+
+	inline static uint64_t hash(uint64_t key) __attribute__((always_inline));
+
+protected:
+
+	bloom_block_t *blocks;
+	uint64_t numberOfBlocks;
+	uint64_t blockMask;
+
+};
+
+inline uint64_t BloomFilter::hash(uint64_t key) {
+
+	// Partitions are selected by the low bits of the key, the filter needs all bits mixed
+	key ^= key >> 33;
+	key *= 0xFF51AFD7ED558CCDULL;
+	key ^= key >> 33;
+	key *= 0xC4CEB9FE1A85EC53ULL;
+	key ^= key >> 33;
+	return key;
+
+}
+
+inline void BloomFilter::insert(uint64_t key) {
+
+	uint64_t const h = hash(key);
+	bloom_block_t * const block = this->blocks + ((h >> 32) & this->blockMask);
+	uint32_t const bits = (uint32_t) h;
+
+	for (uint32_t w = 0; w < BLOOM_FILTER_WORDS_PER_BLOCK; ++w) {
+		block->words[w] |= (1U << ((bits * SALTS[w]) >> 27));
+	}
+
+}
+
+inline bool BloomFilter::contains(uint64_t key) {
+
+	uint64_t const h = hash(key);
+	bloom_block_t * const block = this->blocks + ((h >> 32) & this->blockMask);
+	uint32_t const bits = (uint32_t) h;
+
+	uint32_t missing = 0;
+	for (uint32_t w = 0; w < BLOOM_FILTER_WORDS_PER_BLOCK; ++w) {
+		missing |= (~(block->words[w]) & (1U << ((bits * SALTS[w]) >> 27)));
+	}
+	return (missing == 0);
+
+}
+
+} /* namespace data */
+} /* namespace hpcjoin */
+
+#endif /* HPCJOIN_DATA_BLOOMFILTER_H_ */
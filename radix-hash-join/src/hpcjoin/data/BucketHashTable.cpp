@@ -0,0 +1,270 @@
+/**
+ * @author  Claude Barthels <claudeb@inf.ethz.ch>
+ * (c) 2016, ETH Zurich, Systems Group
+ *
+ */
+
+#include "BucketHashTable.h"
+
+#include <immintrin.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <hpcjoin/utils/Debug.h>
+
+namespace hpcjoin {
+namespace data {
+
+template<typename TUPLE>
+BucketHashTable<TUPLE>::BucketHashTable(uint64_t numberOfElements, uint32_t hashShift, uint32_t keyShift, hpcjoin::memory::HashTableArena *arena) {
+
+	JOIN_ASSERT(BUCKET_SLOTS * sizeof(TUPLE) == hpcjoin::core::Configuration::CACHELINE_SIZE_BYTES, "Bucket Hash Table", "Bucket does not match the cacheline size");
+
+	this->arena = arena;
+	this->hashShift = hashShift;
+	this->keyShift = keyShift;
+
+	this->numberOfBuckets = computeNumberOfBuckets(numberOfElements);
+	this->bucketMask = this->numberOfBuckets - 1;
+
+	// Slots beyond the size of a bucket are never read and do not need to be cleared
+	this->buckets = (TUPLE *) arena->getMemory(hpcjoin::memory::ARENA_BUCKETS, this->numberOfBuckets * BUCKET_SLOTS * sizeof(TUPLE));
+	this->bucketSizes = (uint8_t *) arena->getClearedMemory(hpcjoin::memory::ARENA_BUCKET_SIZES, this->numberOfBuckets * sizeof(uint8_t));
+	this->overflowHeads = (uint32_t *) arena->getClearedMemory(hpcjoin::memory::ARENA_OVERFLOW_HEADS, this->numberOfBuckets * sizeof(uint32_t));
+
+	this->overflowNext = NULL;
+	this->overflowValues = NULL;
+	this->overflowSize = 0;
+	this->overflowCapacity = numberOfElements;
+
+}
+
+template<typename TUPLE>
+BucketHashTable<TUPLE>::~BucketHashTable() {
+
+}
+
+template<typename TUPLE>
+void BucketHashTable<TUPLE>::build(TUPLE* tuples, uint64_t numberOfElements) {
+
+	for (uint64_t t = 0; t < numberOfElements; ++t) {
+
+		uint64_t idx = tuples[t].getKey(this->hashShift) & this->bucketMask;
+		uint8_t size = this->bucketSizes[idx];
+
+		if (size < BUCKET_SLOTS) {
+			this->buckets[idx * BUCKET_SLOTS + size] = tuples[t];
+			this->bucketSizes[idx] = size + 1;
+		} else {
+			// Overflow area is only allocated if needed
+			if (this->overflowValues == NULL) {
+				this->overflowValues = (TUPLE *) this->arena->getMemory(hpcjoin::memory::ARENA_OVERFLOW_VALUES, this->overflowCapacity * sizeof(TUPLE));
+				this->overflowNext = (uint32_t *) this->arena->getMemory(hpcjoin::memory::ARENA_OVERFLOW_NEXT, this->overflowCapacity * sizeof(uint32_t));
+			}
+			this->overflowValues[this->overflowSize] = tuples[t];
+			this->overflowNext[this->overflowSize] = this->overflowHeads[idx];
+			this->overflowHeads[idx] = ++(this->overflowSize);
+		}
+
+	}
+
+}
+
+template<typename TUPLE>
+uint64_t BucketHashTable<TUPLE>::probe(TUPLE* tuples, uint64_t numberOfElements, hpcjoin::data::ResultBuffer* resultBuffer, hpcjoin::data::AggregationTable* aggregationTable) {
+
+	return probeScalar(tuples, numberOfElements, resultBuffer, aggregationTable);
+
+}
+
+template<typename TUPLE>
+simd_level_t BucketHashTable<TUPLE>::getSimdLevel() {
+
+	if (__builtin_cpu_supports("avx512f")) {
+		return SIMD_AVX512;
+	}
+	if (__builtin_cpu_supports("avx2")) {
+		return SIMD_AVX2;
+	}
+	return SIMD_SCALAR;
+
+}
+
+template<typename TUPLE>
+uint64_t BucketHashTable<TUPLE>::computeNumberOfBuckets(uint64_t numberOfElements) {
+
+	// Buckets are half-full on average
+	uint64_t N = (numberOfElements + (BUCKET_SLOTS / 2) - 1) / (BUCKET_SLOTS / 2);
+	uint64_t numberOfBuckets = 1;
+	while (numberOfBuckets < N) {
+		numberOfBuckets <<= 1;
+	}
+	return numberOfBuckets;
+
+}
+
+template<typename TUPLE>
+uint64_t BucketHashTable<TUPLE>::probeScalar(TUPLE* tuples, uint64_t numberOfElements, hpcjoin::data::ResultBuffer* resultBuffer, hpcjoin::data::AggregationTable* aggregationTable) {
+
+	uint64_t matches = 0;
+
+	for (uint64_t t = 0; t < numberOfElements; ++t) {
+
+		uint64_t key = tuples[t].getKey(this->keyShift);
+		uint64_t idx = tuples[t].getKey(this->hashShift) & this->bucketMask;
+		TUPLE *bucket = this->buckets + idx * BUCKET_SLOTS;
+
+		for (uint32_t s = 0; s < this->bucketSizes[idx]; ++s) {
+			if (bucket[s].getKey(this->keyShift) == key) {
+				if (resultBuffer != NULL) {
+					resultBuffer->append(bucket[s].getRid(), tuples[t].getRid());
+				}
+				if (aggregationTable != NULL) {
+					aggregationTable->add(bucket[s].getRid(), tuples[t].getRid());
+				}
+				++matches;
+			}
+		}
+
+		if (this->overflowHeads[idx] > 0) {
+			matches += probeOverflow(idx, tuples[t], resultBuffer, aggregationTable);
+		}
+
+	}
+
+	return matches;
+
+}
+
+template<>
+__attribute__((target("avx2"))) uint64_t BucketHashTable<hpcjoin::data::CompressedTuple>::probeAVX2(hpcjoin::data::CompressedTuple* tuples, uint64_t numberOfElements, hpcjoin::data::ResultBuffer* resultBuffer, hpcjoin::data::AggregationTable* aggregationTable) {
+
+	uint64_t matches = 0;
+	// Keys are compared on the packed values of the bucket
+	uint64_t const *bucketValues = (uint64_t *) this->buckets;
+	uint32_t const valueShift = this->keyShift + hpcjoin::core::Configuration::PAYLOAD_BITS;
+	__m128i const shiftCount = _mm_cvtsi32_si128(valueShift);
+
+	for (uint64_t t = 0; t < numberOfElements; ++t) {
+
+		uint64_t idx = tuples[t].getKey(this->hashShift) & this->bucketMask;
+		uint64_t const *bucket = bucketValues + idx * BUCKET_SLOTS;
+
+		__m256i key = _mm256_set1_epi64x(tuples[t].getKey(this->keyShift));
+		__m256i lower = _mm256_srl_epi64(_mm256_load_si256((__m256i *) bucket), shiftCount);
+		__m256i upper = _mm256_srl_epi64(_mm256_load_si256((__m256i *) (bucket + 4)), shiftCount);
+
+		uint32_t hits = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(lower, key)));
+		hits |= _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(upper, key))) << 4;
+		hits &= (1 << this->bucketSizes[idx]) - 1;
+
+		matches += __builtin_popcount(hits);
+		if (resultBuffer != NULL) {
+			for (uint32_t h = hits; h != 0; h &= (h - 1)) {
+				resultBuffer->append(this->buckets[idx * BUCKET_SLOTS + __builtin_ctz(h)].getRid(), tuples[t].getRid());
+			}
+		}
+		if (aggregationTable != NULL) {
+			for (uint32_t h = hits; h != 0; h &= (h - 1)) {
+				aggregationTable->add(this->buckets[idx * BUCKET_SLOTS + __builtin_ctz(h)].getRid(), tuples[t].getRid());
+			}
+		}
+
+		if (this->overflowHeads[idx] > 0) {
+			matches += probeOverflow(idx, tuples[t], resultBuffer, aggregationTable);
+		}
+
+	}
+
+	return matches;
+
+}
+
+template<>
+__attribute__((target("avx512f"))) uint64_t BucketHashTable<hpcjoin::data::CompressedTuple>::probeAVX512(hpcjoin::data::CompressedTuple* tuples, uint64_t numberOfElements, hpcjoin::data::ResultBuffer* resultBuffer, hpcjoin::data::AggregationTable* aggregationTable) {
+
+	uint64_t matches = 0;
+	// Keys are compared on the packed values of the bucket
+	uint64_t const *bucketValues = (uint64_t *) this->buckets;
+	uint32_t const valueShift = this->keyShift + hpcjoin::core::Configuration::PAYLOAD_BITS;
+	__m128i const shiftCount = _mm_cvtsi32_si128(valueShift);
+
+	for (uint64_t t = 0; t < numberOfElements; ++t) {
+
+		uint64_t idx = tuples[t].getKey(this->hashShift) & this->bucketMask;
+		uint64_t const *bucket = bucketValues + idx * BUCKET_SLOTS;
+
+		__m512i key = _mm512_set1_epi64(tuples[t].getKey(this->keyShift));
+		__m512i keys = _mm512_srl_epi64(_mm512_load_si512((__m512i *) bucket), shiftCount);
+
+		uint32_t hits = _mm512_cmpeq_epi64_mask(keys, key);
+		hits &= (1 << this->bucketSizes[idx]) - 1;
+
+		matches += __builtin_popcount(hits);
+		if (resultBuffer != NULL) {
+			for (uint32_t h = hits; h != 0; h &= (h - 1)) {
+				resultBuffer->append(this->buckets[idx * BUCKET_SLOTS + __builtin_ctz(h)].getRid(), tuples[t].getRid());
+			}
+		}
+		if (aggregationTable != NULL) {
+			for (uint32_t h = hits; h != 0; h &= (h - 1)) {
+				aggregationTable->add(this->buckets[idx * BUCKET_SLOTS + __builtin_ctz(h)].getRid(), tuples[t].getRid());
+			}
+		}
+
+		if (this->overflowHeads[idx] > 0) {
+			matches += probeOverflow(idx, tuples[t], resultBuffer, aggregationTable);
+		}
+
+	}
+
+	return matches;
+
+}
+
+template<>
+uint64_t BucketHashTable<hpcjoin::data::CompressedTuple>::probe(hpcjoin::data::CompressedTuple* tuples, uint64_t numberOfElements, hpcjoin::data::ResultBuffer* resultBuffer, hpcjoin::data::AggregationTable* aggregationTable) {
+
+	if (hpcjoin::core::Configuration::HASH_TABLE_LAYOUT == HASH_TABLE_BUCKETIZED) {
+		switch (getSimdLevel()) {
+			case SIMD_AVX512:
+				return probeAVX512(tuples, numberOfElements, resultBuffer, aggregationTable);
+			case SIMD_AVX2:
+				return probeAVX2(tuples, numberOfElements, resultBuffer, aggregationTable);
+			default:
+				break;
+		}
+	}
+
+	return probeScalar(tuples, numberOfElements, resultBuffer, aggregationTable);
+
+}
+
+template<typename TUPLE>
+inline uint64_t BucketHashTable<TUPLE>::probeOverflow(uint64_t bucketId, TUPLE tuple, hpcjoin::data::ResultBuffer* resultBuffer, hpcjoin::data::AggregationTable* aggregationTable) {
+
+	uint64_t matches = 0;
+	uint64_t key = tuple.getKey(this->keyShift);
+
+	for (uint32_t hit = this->overflowHeads[bucketId]; hit > 0; hit = this->overflowNext[hit - 1]) {
+		if (this->overflowValues[hit - 1].getKey(this->keyShift) == key) {
+			if (resultBuffer != NULL) {
+				resultBuffer->append(this->overflowValues[hit - 1].getRid(), tuple.getRid());
+			}
+			if (aggregationTable != NULL) {
+				aggregationTable->add(this->overflowValues[hit - 1].getRid(), tuple.getRid());
+			}
+			++matches;
+		}
+	}
+
+	return matches;
+
+}
+
+template class BucketHashTable<hpcjoin::data::CompressedTuple>;
+template class BucketHashTable<hpcjoin::data::WideCompressedTuple>;
+template class BucketHashTable<hpcjoin::data::NarrowCompressedTuple>;
+
+} /* namespace data */
+} /* namespace hpcjoin */
@@ -0,0 +1,92 @@
+/**
+ * @author  Claude Barthels <claudeb@inf.ethz.ch>
+ * (c) 2016, ETH Zurich, Systems Group
+ *
+ */
+
+#ifndef HPCJOIN_DATA_BUCKETHASHTABLE_H_
+#define HPCJOIN_DATA_BUCKETHASHTABLE_H_
+
+#include <stdint.h>
+
+#include <hpcjoin/core/Configuration.h>
+#include <hpcjoin/data/CompressedTuple.h>
+#include <hpcjoin/data/WideCompressedTuple.h>
+#include <hpcjoin/data/NarrowCompressedTuple.h>
+#include <hpcjoin/data/ResultBuffer.h>
+#include <hpcjoin/data/AggregationTable.h>
+#include <hpcjoin/memory/HashTableArena.h>
+
+namespace hpcjoin {
+namespace data {
+
+enum simd_level_t {
+	SIMD_SCALAR,
+	SIMD_AVX2,
+	SIMD_AVX512
+};
+
+/**
+ * Hash table with cacheline-sized buckets. The compressed tuples of a bucket are stored
+ * contiguously, so that a probe compares all keys of the bucket with a few vector
+ * instructions. Tuples which do not fit into their bucket are chained in an overflow area.
+ * Vectorized probes are only available for 64-bit compressed tuples, wide tuples are probed
+ * with the scalar implementation.
+ */
+
+template<typename TUPLE>
+class BucketHashTable {
+
+public:
+
+	// One cacheline of compressed tuples
+	static const uint32_t BUCKET_SLOTS = hpcjoin::core::Configuration::CACHELINE_SIZE_BYTES / sizeof(TUPLE);
+
+public:
+
+	BucketHashTable(uint64_t numberOfElements, uint32_t hashShift, uint32_t keyShift, hpcjoin::memory::HashTableArena *arena);
+	~BucketHashTable();
+
+public:
+
+	void build(TUPLE *tuples, uint64_t numberOfElements);
+	uint64_t probe(TUPLE *tuples, uint64_t numberOfElements, hpcjoin::data::ResultBuffer *resultBuffer, hpcjoin::data::AggregationTable *aggregationTable);
+
+public:
+
+	static simd_level_t getSimdLevel();
+	static uint64_t computeNumberOfBuckets(uint64_t numberOfElements);
+
+protected:
+
+	uint64_t probeScalar(TUPLE *tuples, uint64_t numberOfElements, hpcjoin::data::ResultBuffer *resultBuffer, hpcjoin::data::AggregationTable *aggregationTable);
+	uint64_t probeAVX2(TUPLE *tuples, uint64_t numberOfElements, hpcjoin::data::ResultBuffer *resultBuffer, hpcjoin::data::AggregationTable *aggregationTable) __attribute__((target("avx2")));
+	uint64_t probeAVX512(TUPLE *tuples, uint64_t numberOfElements, hpcjoin::data::ResultBuffer *resultBuffer, hpcjoin::data::AggregationTable *aggregationTable) __attribute__((target("avx512f")));
+
+	inline uint64_t probeOverflow(uint64_t bucketId, TUPLE tuple, hpcjoin::data::ResultBuffer *resultBuffer, hpcjoin::data::AggregationTable *aggregationTable) __attribute__((always_inline));
+
+protected:
+
+	hpcjoin::memory::HashTableArena *arena;
+
+	uint32_t hashShift;
+	uint32_t keyShift;
+
+	uint64_t numberOfBuckets;
+	uint64_t bucketMask;
+
+	TUPLE *buckets;
+	uint8_t *bucketSizes;
+
+	uint32_t *overflowHeads;
+	uint32_t *overflowNext;
+	TUPLE *overflowValues;
+	uint64_t overflowSize;
+	uint64_t overflowCapacity;
+
+};
+
+} /* namespace data */
+} /* namespace hpcjoin */
+
+#endif /* HPCJOIN_DATA_BUCKETHASHTABLE_H_ */
@@ -8,15 +8,52 @@
 #ifndef HPCJOIN_DATA_COMPRESSEDTUPLE_H_
 #define HPCJOIN_DATA_COMPRESSEDTUPLE_H_
 
+#include <stdint.h>
+
+#include <hpcjoin/core/Configuration.h>
+
 namespace hpcjoin {
 namespace data {
 
+/**
+ * The rid is stored in the lower PAYLOAD_BITS, the key bits above the network partition
+ * bits are stored above. Keys need to be smaller than 2^KEY_BITS and rids smaller than
+ * 2^PAYLOAD_BITS. Key accessors take a shift of at least the network partitioning fan-out
+ * and return the key bits above it.
+ */
+
 class CompressedTuple {
 
+public:
+
+	static const uint32_t KEY_BITS = 64 - hpcjoin::core::Configuration::PAYLOAD_BITS;
+
 public:
 
 	uint64_t value;
 
+public:
+
+	inline void pack(uint64_t key, uint64_t rid, uint32_t partitionBits) {
+		this->value = rid + ((key >> partitionBits) << (partitionBits + hpcjoin::core::Configuration::PAYLOAD_BITS));
+	}
+
+	inline uint64_t getKey(uint32_t shift) const {
+		return this->value >> (shift + hpcjoin::core::Configuration::PAYLOAD_BITS);
+	}
+
+	inline uint64_t getRid() const {
+		return this->value & ((1ULL << hpcjoin::core::Configuration::PAYLOAD_BITS) - 1);
+	}
+
+	static uint32_t getKeyBits() {
+		return KEY_BITS;
+	}
+
+	static bool canRepresent(uint64_t maximumKey, uint64_t maximumRid) {
+		return (maximumKey >> KEY_BITS) == 0 && (maximumRid >> hpcjoin::core::Configuration::PAYLOAD_BITS) == 0;
+	}
+
 };
 
 } /* namespace data */
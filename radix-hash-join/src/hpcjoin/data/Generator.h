@@ -0,0 +1,91 @@
+/**
+ * @author  Claude Barthels <claudeb@inf.ethz.ch>
+ * (c) 2016, ETH Zurich, Systems Group
+ *
+ */
+
+#ifndef HPCJOIN_DATA_GENERATOR_H_
+#define HPCJOIN_DATA_GENERATOR_H_
+
+#include <stdint.h>
+
+#include <hpcjoin/data/Relation.h>
+
+enum key_distribution_t {
+	KEYS_PRIMARY,
+	KEYS_FOREIGN,
+	KEYS_ZIPF
+};
+
+enum tuple_order_t {
+	ORDER_RANDOM,
+	ORDER_SORTED,
+	ORDER_CLUSTERED
+};
+
+namespace hpcjoin {
+namespace data {
+
+/**
+ * Generates relations directly in their final distribution: process i fills the i-th stripe
+ * of the relation (same split as in main). Every value is derived from the seed and the global
+ * position of the tuple, the data is therefore independent of the number of threads and
+ * processes. The rid of a tuple is its global position.
+ *
+ * Primary keys are a random permutation of the keys [0, N / duplicates), each key repeated
+ * duplicates times. Foreign keys reference these keys uniformly or following a Zipf
+ * distribution (rank k is key k - 1). A fraction of (1 - matchRate) of the foreign keys has
+ * no join partner.
+ */
+
+class Generator {
+
+public:
+
+	Generator(uint64_t seed, uint32_t numberOfThreads);
+	~Generator();
+
+public:
+
+	void generatePrimaryKeys(Relation *relation, uint32_t nodeId, uint32_t numberOfNodes, uint32_t duplicates);
+	void generateForeignKeys(Relation *relation, uint32_t nodeId, uint32_t numberOfNodes, uint64_t numberOfDistinctKeys, double matchRate);
+	void generateZipfKeys(Relation *relation, uint32_t nodeId, uint32_t numberOfNodes, uint64_t numberOfDistinctKeys, double exponent, double matchRate);
+
+	void reorder(Relation *relation, tuple_order_t order);
+
+protected:
+
+	void generate(Relation *relation, uint32_t nodeId, uint32_t numberOfNodes);
+	static void * run(void *argument);
+
+	uint64_t computeKey(uint64_t position);
+	uint64_t permute(uint64_t value);
+	uint64_t sampleZipf(uint64_t position);
+
+	double random(uint64_t position, uint64_t stream);
+	uint64_t hash(uint64_t position, uint64_t stream);
+
+protected:
+
+	uint64_t seed;
+	uint32_t numberOfThreads;
+
+	key_distribution_t distribution;
+
+	uint64_t domainSize;
+	uint32_t domainBits;
+	uint32_t duplicates;
+	uint64_t numberOfDistinctKeys;
+	double matchRate;
+
+	double zipfExponent;
+	double zipfIntegralX1;
+	double zipfIntegralN;
+	double zipfS;
+
+};
+
+} /* namespace data */
+} /* namespace hpcjoin */
+
+#endif /* HPCJOIN_DATA_GENERATOR_H_ */
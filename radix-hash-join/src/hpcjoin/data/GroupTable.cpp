@@ -0,0 +1,79 @@
+/**
+ * @author  Claude Barthels <claudeb@inf.ethz.ch>
+ * (c) 2016, ETH Zurich, Systems Group
+ *
+ */
+
+#include "GroupTable.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <hpcjoin/core/Configuration.h>
+#include <hpcjoin/utils/Debug.h>
+
+namespace hpcjoin {
+namespace data {
+
+GroupTable::GroupTable(uint64_t numberOfElements) {
+
+	this->capacity = 1;
+	while (this->capacity < 2 * numberOfElements) {
+		this->capacity <<= 1;
+	}
+	this->mask = this->capacity - 1;
+
+	int result = posix_memalign((void **) &(this->entries), hpcjoin::core::Configuration::CACHELINE_SIZE_BYTES, this->capacity * sizeof(hpcjoin::data::group_t));
+	JOIN_ASSERT(result == 0, "Group Table", "Could not allocate %lu entries", this->capacity);
+	JOIN_UNUSED(result);
+	memset(this->entries, 0, this->capacity * sizeof(hpcjoin::data::group_t));
+	this->used = (uint8_t *) calloc(this->capacity, sizeof(uint8_t));
+
+	this->numberOfGroups = 0;
+
+}
+
+GroupTable::~GroupTable() {
+
+	free(this->entries);
+	free(this->used);
+
+}
+
+uint64_t GroupTable::getNumberOfGroups() {
+
+	return this->numberOfGroups;
+
+}
+
+void GroupTable::copyGroups(hpcjoin::data::Tuple* counts, hpcjoin::data::Tuple* sums) {
+
+	uint64_t g = 0;
+	for (uint64_t e = 0; e < this->capacity; ++e) {
+		if (this->used[e]) {
+			counts[g].key = this->entries[e].key;
+			counts[g].rid = this->entries[e].count;
+			sums[g].key = this->entries[e].key;
+			sums[g].rid = this->entries[e].sum;
+			++g;
+		}
+	}
+
+}
+
+void GroupTable::copyGroups(hpcjoin::data::group_t* groups, uint32_t keyShift, uint64_t keyLowBits) {
+
+	uint64_t g = 0;
+	for (uint64_t e = 0; e < this->capacity; ++e) {
+		if (this->used[e]) {
+			groups[g].key = (this->entries[e].key << keyShift) | keyLowBits;
+			groups[g].count = this->entries[e].count;
+			groups[g].sum = this->entries[e].sum;
+			++g;
+		}
+	}
+
+}
+
+} /* namespace data */
+} /* namespace hpcjoin */
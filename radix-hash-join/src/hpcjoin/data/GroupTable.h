@@ -0,0 +1,103 @@
+/**
+ * @author  Claude Barthels <claudeb@inf.ethz.ch>
+ * (c) 2016, ETH Zurich, Systems Group
+ *
+ */
+
+#ifndef HPCJOIN_DATA_GROUPTABLE_H_
+#define HPCJOIN_DATA_GROUPTABLE_H_
+
+#include <stdint.h>
+
+#include <hpcjoin/data/Tuple.h>
+
+namespace hpcjoin {
+namespace data {
+
+typedef struct {
+
+	uint64_t key;
+	uint64_t count;
+	uint64_t sum;
+
+} group_t;
+
+/**
+ * Open-addressing hash table with linear probing which holds the COUNT and SUM of every
+ * group key. The table is sized for the number of tuples which are inserted, so that it is
+ * at most half full.
+ */
+
+class GroupTable {
+
+public:
+
+	GroupTable(uint64_t numberOfElements);
+	~GroupTable();
+
+public:
+
+	inline void add(uint64_t key, uint64_t count, uint64_t sum) __attribute__((always_inline));
+
+	uint64_t getNumberOfGroups();
+
+	/**
+	 * Writes the groups as (key, count) and (key, sum) tuples
+	 */
+	void copyGroups(hpcjoin::data::Tuple *counts, hpcjoin::data::Tuple *sums);
+
+	/**
+	 * Writes the groups, the stored keys are shifted and the given low bits are added
+	 */
+	void copyGroups(hpcjoin::data::group_t *groups, uint32_t keyShift, uint64_t keyLowBits);
+
+protected:
+
+	inline static uint64_t hash(uint64_t key) __attribute__((always_inline));
+
+protected:
+
+	uint64_t capacity;
+	uint64_t mask;
+
+	hpcjoin::data::group_t *entries;
+	uint8_t *used;
+
+	uint64_t numberOfGroups;
+
+};
+
+inline uint64_t GroupTable::hash(uint64_t key) {
+
+	// Keys of a partition share their low bits, all bits need to be mixed
+	key ^= key >> 33;
+	key *= 0xFF51AFD7ED558CCDULL;
+	key ^= key >> 33;
+	key *= 0xC4CEB9FE1A85EC53ULL;
+	key ^= key >> 33;
+	return key;
+
+}
+
+inline void GroupTable::add(uint64_t key, uint64_t count, uint64_t sum) {
+
+	uint64_t idx = hash(key) & this->mask;
+	while (this->used[idx] && this->entries[idx].key != key) {
+		idx = (idx + 1) & this->mask;
+	}
+
+	if (!this->used[idx]) {
+		this->used[idx] = 1;
+		this->entries[idx].key = key;
+		++(this->numberOfGroups);
+	}
+
+	this->entries[idx].count += count;
+	this->entries[idx].sum += sum;
+
+}
+
+} /* namespace data */
+} /* namespace hpcjoin */
+
+#endif /* HPCJOIN_DATA_GROUPTABLE_H_ */
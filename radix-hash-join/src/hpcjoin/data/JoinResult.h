@@ -0,0 +1,78 @@
+/**
+ * @author  Claude Barthels <claudeb@inf.ethz.ch>
+ * (c) 2016, ETH Zurich, Systems Group
+ *
+ */
+
+#ifndef HPCJOIN_DATA_JOINRESULT_H_
+#define HPCJOIN_DATA_JOINRESULT_H_
+
+#include <stdint.h>
+
+#include <hpcjoin/data/ResultTuple.h>
+#include <hpcjoin/data/ResultBuffer.h>
+
+namespace hpcjoin {
+namespace data {
+
+typedef void (*result_callback_t)(hpcjoin::data::ResultTuple *results, uint64_t numberOfResults, void *argument);
+
+/**
+ * Materialized output of the join on this process. Every worker thread writes into its
+ * own buffer. The results can be consumed chunk-wise through a callback or one by one
+ * through an iterator.
+ */
+
+class JoinResult {
+
+public:
+
+	JoinResult(uint32_t numberOfBuffers);
+	~JoinResult();
+
+public:
+
+	hpcjoin::data::ResultBuffer *getBuffer(uint32_t bufferId);
+	uint32_t getNumberOfBuffers();
+	void flush();
+
+	uint64_t getNumberOfResults();
+	void forEach(result_callback_t callback, void *argument);
+
+public:
+
+	class Iterator {
+
+	public:
+
+		Iterator(JoinResult *result);
+
+	public:
+
+		bool hasNext();
+		hpcjoin::data::ResultTuple *next();
+
+	protected:
+
+		void skipEmptyChunks();
+
+	protected:
+
+		JoinResult *result;
+		uint32_t bufferId;
+		result_chunk_t *chunk;
+		uint64_t position;
+
+	};
+
+protected:
+
+	uint32_t numberOfBuffers;
+	hpcjoin::data::ResultBuffer **buffers;
+
+};
+
+} /* namespace data */
+} /* namespace hpcjoin */
+
+#endif /* HPCJOIN_DATA_JOINRESULT_H_ */
@@ -0,0 +1,61 @@
+/**
+ * @author  Claude Barthels <claudeb@inf.ethz.ch>
+ * (c) 2016, ETH Zurich, Systems Group
+ *
+ */
+
+#ifndef HPCJOIN_DATA_NARROWCOMPRESSEDTUPLE_H_
+#define HPCJOIN_DATA_NARROWCOMPRESSEDTUPLE_H_
+
+#include <stdint.h>
+
+#include <hpcjoin/core/Configuration.h>
+
+namespace hpcjoin {
+namespace data {
+
+/**
+ * 32-bit variant of the compressed tuple for narrow joins. The network partition bits of
+ * the key are dropped, the rid is stored in the lower NARROW_PAYLOAD_BITS and the remaining
+ * key bits above. Both widths are configured at runtime (see Configuration::selectTupleFormat).
+ */
+
+class NarrowCompressedTuple {
+
+public:
+
+	static const uint32_t VALUE_BITS = 32;
+
+public:
+
+	uint32_t value;
+
+public:
+
+	inline void pack(uint64_t key, uint64_t rid, uint32_t partitionBits) {
+		this->value = rid + ((key >> partitionBits) << hpcjoin::core::Configuration::NARROW_PAYLOAD_BITS);
+	}
+
+	inline uint64_t getKey(uint32_t shift) const {
+		return ((uint64_t) this->value) >> (shift - hpcjoin::core::Configuration::NARROW_PARTITION_BITS + hpcjoin::core::Configuration::NARROW_PAYLOAD_BITS);
+	}
+
+	inline uint64_t getRid() const {
+		return this->value & ((1ULL << hpcjoin::core::Configuration::NARROW_PAYLOAD_BITS) - 1);
+	}
+
+	static uint32_t getKeyBits() {
+		return VALUE_BITS - hpcjoin::core::Configuration::NARROW_PAYLOAD_BITS + hpcjoin::core::Configuration::NARROW_PARTITION_BITS;
+	}
+
+	static bool canRepresent(uint64_t maximumKey, uint64_t maximumRid) {
+		return hpcjoin::core::Configuration::NARROW_PAYLOAD_BITS <= VALUE_BITS && (maximumRid >> hpcjoin::core::Configuration::NARROW_PAYLOAD_BITS) == 0
+				&& (maximumKey >> getKeyBits()) == 0;
+	}
+
+};
+
+} /* namespace data */
+} /* namespace hpcjoin */
+
+#endif /* HPCJOIN_DATA_NARROWCOMPRESSEDTUPLE_H_ */
@@ -0,0 +1,180 @@
+/**
+ * @author  Claude Barthels <claudeb@inf.ethz.ch>
+ * (c) 2016, ETH Zurich, Systems Group
+ *
+ */
+
+#include "PackedFormat.h"
+
+#include <mpi.h>
+
+#include <hpcjoin/core/Configuration.h>
+#include <hpcjoin/utils/Debug.h>
+
+namespace hpcjoin {
+namespace data {
+
+PackedFormat::PackedFormat(hpcjoin::data::Relation *relation) {
+
+	this->relation = relation;
+
+	this->keyShift = 0;
+	this->minKeyHigh = 0;
+	this->ridBits = 0;
+	this->bitsPerTuple = 64;
+	this->emptySlot = 0;
+
+}
+
+PackedFormat::~PackedFormat() {
+
+}
+
+void PackedFormat::computeFormat() {
+
+	// Only 64-bit tuples are packed, wide and narrow tuples are transferred as they are
+	if (hpcjoin::core::Configuration::TUPLE_FORMAT != TUPLE_FORMAT_COMPRESSED) {
+		this->bitsPerTuple = 64;
+		return;
+	}
+
+	uint32_t const networkFanout = hpcjoin::core::Configuration::NETWORK_PARTITIONING_FANOUT;
+	this->keyShift = networkFanout + hpcjoin::core::Configuration::PAYLOAD_BITS;
+
+	uint64_t const numberOfElements = relation->getLocalSize();
+	hpcjoin::data::Tuple * const data = relation->getData();
+
+	// Minimum is reduced as a maximum of the complement, such that a single reduction suffices
+	uint64_t ranges[3] = { 0, 0, 0 };
+	for (uint64_t i = 0; i < numberOfElements; ++i) {
+		uint64_t keyHigh = data[i].key >> networkFanout;
+		ranges[0] = (~keyHigh > ranges[0]) ? ~keyHigh : ranges[0];
+		ranges[1] = (keyHigh > ranges[1]) ? keyHigh : ranges[1];
+		ranges[2] = (data[i].rid > ranges[2]) ? data[i].rid : ranges[2];
+	}
+	MPI_Allreduce(MPI_IN_PLACE, ranges, 3, MPI_UINT64_T, MPI_MAX, MPI_COMM_WORLD);
+
+	uint64_t const minKeyHigh = ~ranges[0];
+	uint64_t const maxKeyHigh = ranges[1];
+	uint64_t const maxRid = ranges[2];
+
+	// Keys which do not fit into a compressed tuple are truncated and have no consecutive range
+	if (maxKeyHigh >= (1ULL << (64 - this->keyShift)) || minKeyHigh > maxKeyHigh) {
+		this->bitsPerTuple = 64;
+		return;
+	}
+
+	// The key range is extended by one value, which is used for empty slots
+	this->minKeyHigh = minKeyHigh;
+	this->ridBits = computeNumberOfBits(maxRid);
+	this->bitsPerTuple = this->ridBits + computeNumberOfBits(maxKeyHigh - minKeyHigh + 1);
+	this->emptySlot = (this->bitsPerTuple < 64) ? ((1ULL << this->bitsPerTuple) - 1) : 0;
+
+	JOIN_DEBUG("Packed Format", "Tuples are packed into %d bits (%d rid bits)", this->bitsPerTuple, this->ridBits);
+
+}
+
+bool PackedFormat::isEnabled() {
+
+	return (this->bitsPerTuple < 64);
+
+}
+
+uint32_t PackedFormat::getBitsPerTuple() {
+
+	return this->bitsPerTuple;
+
+}
+
+uint64_t PackedFormat::computePackedSize(uint64_t numberOfTuples) {
+
+	if (!isEnabled()) {
+		return numberOfTuples;
+	}
+
+	return ((numberOfTuples + PACKED_TUPLES_PER_GROUP - 1) / PACKED_TUPLES_PER_GROUP) * this->bitsPerTuple;
+
+}
+
+void PackedFormat::pack(hpcjoin::data::CompressedTuple* tuples, uint64_t numberOfTuples) {
+
+	JOIN_ASSERT(isEnabled(), "Packed Format", "Packing is not enabled");
+
+	uint32_t const bitsPerTuple = this->bitsPerTuple;
+	uint64_t const ridMask = (1ULL << this->keyShift) - 1;
+	uint64_t const numberOfSlots = ((numberOfTuples + PACKED_TUPLES_PER_GROUP - 1) / PACKED_TUPLES_PER_GROUP) * PACKED_TUPLES_PER_GROUP;
+
+	// Packing is done in place. A word is only written once all tuples it overlaps have been read.
+	uint64_t *words = (uint64_t *) tuples;
+	uint64_t nextWord = 0;
+	uint64_t buffer = 0;
+	uint32_t bufferedBits = 0;
+
+	for (uint64_t i = 0; i < numberOfSlots; ++i) {
+
+		uint64_t packedValue = this->emptySlot;
+		if (i < numberOfTuples) {
+			uint64_t value = tuples[i].value;
+			packedValue = (value & ridMask) | (((value >> this->keyShift) - this->minKeyHigh) << this->ridBits);
+		}
+
+		buffer |= (packedValue << bufferedBits);
+		bufferedBits += bitsPerTuple;
+
+		if (bufferedBits >= 64) {
+			words[nextWord++] = buffer;
+			bufferedBits -= 64;
+			buffer = (bufferedBits > 0) ? (packedValue >> (bitsPerTuple - bufferedBits)) : 0;
+		}
+
+	}
+
+	JOIN_ASSERT(bufferedBits == 0, "Packed Format", "Group is not aligned to a word");
+
+}
+
+uint64_t PackedFormat::unpack(uint64_t* packedData, uint64_t packedSize, hpcjoin::data::CompressedTuple* tuples) {
+
+	JOIN_ASSERT(isEnabled(), "Packed Format", "Packing is not enabled");
+	JOIN_ASSERT(packedSize % this->bitsPerTuple == 0, "Packed Format", "Packed data does not consist of complete groups");
+
+	uint32_t const bitsPerTuple = this->bitsPerTuple;
+	uint64_t const valueMask = (1ULL << bitsPerTuple) - 1;
+	uint64_t const ridMask = (1ULL << this->ridBits) - 1;
+	uint64_t const numberOfSlots = (packedSize / bitsPerTuple) * PACKED_TUPLES_PER_GROUP;
+
+	uint64_t numberOfTuples = 0;
+	uint64_t bitOffset = 0;
+
+	for (uint64_t i = 0; i < numberOfSlots; ++i) {
+
+		uint64_t const word = bitOffset >> 6;
+		uint32_t const shift = bitOffset & 63;
+
+		uint64_t packedValue = packedData[word] >> shift;
+		if (shift + bitsPerTuple > 64) {
+			packedValue |= packedData[word + 1] << (64 - shift);
+		}
+		packedValue &= valueMask;
+		bitOffset += bitsPerTuple;
+
+		if (packedValue != this->emptySlot) {
+			uint64_t keyHigh = (packedValue >> this->ridBits) + this->minKeyHigh;
+			tuples[numberOfTuples].value = (packedValue & ridMask) + (keyHigh << this->keyShift);
+			++numberOfTuples;
+		}
+
+	}
+
+	return numberOfTuples;
+
+}
+
+uint32_t PackedFormat::computeNumberOfBits(uint64_t value) {
+
+	return (value == 0) ? 0 : (64 - __builtin_clzll(value));
+
+}
+
+} /* namespace data */
+} /* namespace hpcjoin */
@@ -0,0 +1,66 @@
+/**
+ * @author  Claude Barthels <claudeb@inf.ethz.ch>
+ * (c) 2016, ETH Zurich, Systems Group
+ *
+ */
+
+#ifndef HPCJOIN_DATA_PACKEDFORMAT_H_
+#define HPCJOIN_DATA_PACKEDFORMAT_H_
+
+#include <stdint.h>
+
+#include <hpcjoin/data/Relation.h>
+#include <hpcjoin/data/CompressedTuple.h>
+
+#define PACKED_TUPLES_PER_GROUP (64)
+
+namespace hpcjoin {
+namespace data {
+
+/**
+ * Transfer encoding of compressed tuples. The key bits above the network partition bits are
+ * stored relative to the global minimum, next to the rid, using the smallest width that covers
+ * the global value ranges of the relation. Tuples are packed in groups of 64, such that a group
+ * always occupies exactly as many 64-bit words as a tuple has bits. Unused slots of the last
+ * group are filled with ones, which never encodes a valid tuple.
+ */
+
+class PackedFormat {
+
+public:
+
+	PackedFormat(hpcjoin::data::Relation *relation);
+	~PackedFormat();
+
+public:
+
+	void computeFormat();
+
+	bool isEnabled();
+	uint32_t getBitsPerTuple();
+
+	uint64_t computePackedSize(uint64_t numberOfTuples);
+
+	void pack(hpcjoin::data::CompressedTuple *tuples, uint64_t numberOfTuples);
+	uint64_t unpack(uint64_t *packedData, uint64_t packedSize, hpcjoin::data::CompressedTuple *tuples);
+
+protected:
+
+	static uint32_t computeNumberOfBits(uint64_t value);
+
+protected:
+
+	hpcjoin::data::Relation *relation;
+
+	uint32_t keyShift;
+	uint64_t minKeyHigh;
+	uint32_t ridBits;
+	uint32_t bitsPerTuple;
+	uint64_t emptySlot;
+
+};
+
+} /* namespace data */
+} /* namespace hpcjoin */
+
+#endif /* HPCJOIN_DATA_PACKEDFORMAT_H_ */
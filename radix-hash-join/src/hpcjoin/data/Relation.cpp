@@ -6,10 +6,14 @@
 
 #include "Relation.h"
 
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <mpi.h>
 #include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #include <hpcjoin/core/Configuration.h>
 #include <hpcjoin/utils/Debug.h>
@@ -19,6 +23,8 @@
 
 #define EXCHANGE_DATA_TAG 456378
 
+#define RELATION_FILE_CHUNK_SIZE (1 << 24)
+
 namespace hpcjoin {
 namespace data {
 
@@ -37,7 +43,7 @@ Relation::Relation(uint64_t localSize, uint64_t globalSize) {
 
 Relation::~Relation() {
 
-	free(this->data);
+	hpcjoin::memory::Pool::free(this->data, this->localSize * sizeof(hpcjoin::data::Tuple));
 
 }
 
@@ -59,6 +65,33 @@ hpcjoin::data::Tuple* Relation::getData() {
 
 }
 
+uint64_t Relation::getSliceStart(uint32_t sliceId, uint32_t numberOfSlices) {
+
+	return (this->localSize / numberOfSlices) * sliceId;
+
+}
+
+uint64_t Relation::getSliceSize(uint32_t sliceId, uint32_t numberOfSlices) {
+
+	// The last slice contains the remaining elements
+	return (sliceId < numberOfSlices - 1) ? (this->localSize / numberOfSlices) : (this->localSize - (numberOfSlices - 1) * (this->localSize / numberOfSlices));
+
+}
+
+void Relation::computeMaximumValues(uint64_t *maximumKey, uint64_t *maximumRid) {
+
+	uint64_t key = 0;
+	uint64_t rid = 0;
+	for (uint64_t i = 0; i < this->localSize; ++i) {
+		key = (this->data[i].key > key) ? this->data[i].key : key;
+		rid = (this->data[i].rid > rid) ? this->data[i].rid : rid;
+	}
+
+	*maximumKey = key;
+	*maximumRid = rid;
+
+}
+
 void Relation::fillUniqueValues(uint64_t startKeyValue, uint64_t startRidValue) {
 
 	for (uint64_t i = 0; i < this->localSize; ++i) {
@@ -97,7 +130,9 @@ void Relation::randomOrder() {
 
 void Relation::distribute(uint32_t nodeId, uint32_t numberOfNodes) {
 
-	uint64_t incomingDataSize = (localSize - (numberOfNodes - 1) * (localSize / numberOfNodes));
+	// Every process exchanges the same number of tuples, the remainder of the last process stays in place
+	uint64_t exchangedSize = this->globalSize / numberOfNodes;
+	uint64_t incomingDataSize = (exchangedSize - (numberOfNodes - 1) * (exchangedSize / numberOfNodes));
 	hpcjoin::data::Tuple *incomingData = (hpcjoin::data::Tuple *) calloc(incomingDataSize, sizeof(hpcjoin::data::Tuple));
 
 	for (uint32_t i = 0; i < nodeId; ++i) {
@@ -105,8 +140,8 @@ void Relation::distribute(uint32_t nodeId, uint32_t numberOfNodes) {
 		// Swap with section nodeId+i
 		// Send to node i
 		uint32_t section = (nodeId + i) % numberOfNodes;
-		uint64_t sectionStart = section * (localSize / numberOfNodes);
-		uint64_t sectionSize = (section == numberOfNodes - 1) ? (localSize - (numberOfNodes - 1) * (localSize / numberOfNodes)) : (localSize / numberOfNodes);
+		uint64_t sectionStart = section * (exchangedSize / numberOfNodes);
+		uint64_t sectionSize = (section == numberOfNodes - 1) ? (exchangedSize - (numberOfNodes - 1) * (exchangedSize / numberOfNodes)) : (exchangedSize / numberOfNodes);
 		JOIN_DEBUG("SWAP", "%d (%lu) <--> %d (%lu)\n", nodeId, section, i, section);
 		MPI_Recv(incomingData, sectionSize * sizeof(hpcjoin::data::Tuple), MPI_BYTE, i, EXCHANGE_DATA_TAG, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
 		MPI_Send(this->data + sectionStart, sectionSize * sizeof(hpcjoin::data::Tuple), MPI_BYTE, i, EXCHANGE_DATA_TAG, MPI_COMM_WORLD);
@@ -118,8 +153,8 @@ void Relation::distribute(uint32_t nodeId, uint32_t numberOfNodes) {
 		// Send section nodeId+i
 		// Receive section nodeId+i
 		uint32_t section = (nodeId + i) % numberOfNodes;
-		uint64_t sectionStart = section * (localSize / numberOfNodes);
-		uint64_t sectionSize = (section == numberOfNodes - 1) ? (localSize - (numberOfNodes - 1) * (localSize / numberOfNodes)) : (localSize / numberOfNodes);
+		uint64_t sectionStart = section * (exchangedSize / numberOfNodes);
+		uint64_t sectionSize = (section == numberOfNodes - 1) ? (exchangedSize - (numberOfNodes - 1) * (exchangedSize / numberOfNodes)) : (exchangedSize / numberOfNodes);
 		JOIN_DEBUG("SWAP", "%d (%lu) <--> %d (%lu)\n", nodeId, section, i, section);
 		MPI_Send(this->data + sectionStart, sectionSize * sizeof(hpcjoin::data::Tuple), MPI_BYTE, i, EXCHANGE_DATA_TAG, MPI_COMM_WORLD);
 		MPI_Recv(incomingData, sectionSize * sizeof(hpcjoin::data::Tuple), MPI_BYTE, i, EXCHANGE_DATA_TAG, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
@@ -131,6 +166,151 @@ void Relation::distribute(uint32_t nodeId, uint32_t numberOfNodes) {
 
 }
 
+bool Relation::loadFromFile(const char* fileName, uint32_t nodeId, uint32_t numberOfNodes) {
+
+	uint64_t firstTuple = nodeId * (this->globalSize / numberOfNodes);
+	relation_file_header_t header;
+	int loaded = 0;
+
+	if (numberOfNodes == 1) {
+
+		int fileDescriptor = open(fileName, O_RDONLY);
+		if (fileDescriptor < 0) {
+			return false;
+		}
+		struct stat fileStatus;
+		fstat(fileDescriptor, &fileStatus);
+		if ((uint64_t) fileStatus.st_size < sizeof(relation_file_header_t)) {
+			close(fileDescriptor);
+			return false;
+		}
+
+		char *file = (char *) mmap(NULL, fileStatus.st_size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+		if (file == MAP_FAILED) {
+			close(fileDescriptor);
+			return false;
+		}
+		madvise(file, fileStatus.st_size, MADV_SEQUENTIAL);
+
+		memcpy(&header, file, sizeof(relation_file_header_t));
+		if (isValidHeader(&header, fileStatus.st_size) && header.numberOfTuples == this->globalSize) {
+			uint64_t *keys = ((uint64_t *) (file + header.keyOffset)) + firstTuple;
+			uint64_t *rids = ((uint64_t *) (file + header.ridOffset)) + firstTuple;
+			for (uint64_t i = 0; i < this->localSize; ++i) {
+				this->data[i].key = keys[i];
+				this->data[i].rid = rids[i];
+			}
+			loaded = 1;
+		}
+
+		munmap(file, fileStatus.st_size);
+		close(fileDescriptor);
+
+	} else {
+
+		MPI_File file;
+		int result = MPI_File_open(MPI_COMM_WORLD, (char *) fileName, MPI_MODE_RDONLY, MPI_INFO_NULL, &file);
+		if (result != MPI_SUCCESS) {
+			return false;
+		}
+
+		MPI_Offset fileSize = 0;
+		MPI_File_get_size(file, &fileSize);
+
+		MPI_Status status;
+		int count = 0;
+		MPI_File_read_at_all(file, 0, &header, sizeof(relation_file_header_t), MPI_BYTE, &status);
+		MPI_Get_count(&status, MPI_BYTE, &count);
+		loaded = (count == sizeof(relation_file_header_t) && isValidHeader(&header, fileSize) && header.numberOfTuples == this->globalSize) ? 1 : 0;
+
+		// The column offsets are only used if all processes read a valid header
+		MPI_Allreduce(MPI_IN_PLACE, &loaded, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+
+		if (loaded == 1) {
+
+			// Columns are read in chunks, all processes need to issue the same number of collective reads
+			uint64_t maximumLocalSize = this->globalSize - (numberOfNodes - 1) * (this->globalSize / numberOfNodes);
+			uint64_t numberOfChunks = (maximumLocalSize + RELATION_FILE_CHUNK_SIZE - 1) / RELATION_FILE_CHUNK_SIZE;
+			uint64_t *buffer = (uint64_t *) calloc(RELATION_FILE_CHUNK_SIZE, sizeof(uint64_t));
+
+			for (uint64_t c = 0; c < numberOfChunks; ++c) {
+
+				uint64_t chunkStart = (c * RELATION_FILE_CHUNK_SIZE < this->localSize) ? c * RELATION_FILE_CHUNK_SIZE : this->localSize;
+				uint64_t chunkSize = (this->localSize - chunkStart < RELATION_FILE_CHUNK_SIZE) ? this->localSize - chunkStart : RELATION_FILE_CHUNK_SIZE;
+
+				MPI_File_read_at_all(file, header.keyOffset + (firstTuple + chunkStart) * sizeof(uint64_t), buffer, chunkSize, MPI_UINT64_T, &status);
+				MPI_Get_count(&status, MPI_UINT64_T, &count);
+				if ((uint64_t) count != chunkSize) {
+					loaded = 0;
+				}
+				for (uint64_t i = 0; i < chunkSize; ++i) {
+					this->data[chunkStart + i].key = buffer[i];
+				}
+
+				MPI_File_read_at_all(file, header.ridOffset + (firstTuple + chunkStart) * sizeof(uint64_t), buffer, chunkSize, MPI_UINT64_T, &status);
+				MPI_Get_count(&status, MPI_UINT64_T, &count);
+				if ((uint64_t) count != chunkSize) {
+					loaded = 0;
+				}
+				for (uint64_t i = 0; i < chunkSize; ++i) {
+					this->data[chunkStart + i].rid = buffer[i];
+				}
+
+			}
+
+			free(buffer);
+
+		}
+
+		MPI_File_close(&file);
+		MPI_Allreduce(MPI_IN_PLACE, &loaded, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+
+	}
+
+	return (loaded == 1);
+
+}
+
+uint64_t Relation::readNumberOfTuples(const char* fileName) {
+
+	int32_t nodeId = -1;
+	MPI_Comm_rank(MPI_COMM_WORLD, &nodeId);
+
+	// The header is read by one process and broadcast to all others
+	uint64_t numberOfTuples = RELATION_FILE_INVALID_SIZE;
+	if (nodeId == 0) {
+		relation_file_header_t header;
+		FILE *file = fopen(fileName, "rb");
+		if (file != NULL) {
+			struct stat fileStatus;
+			if (fread(&header, sizeof(relation_file_header_t), 1, file) == 1 && fstat(fileno(file), &fileStatus) == 0 && isValidHeader(&header, fileStatus.st_size)) {
+				numberOfTuples = header.numberOfTuples;
+			}
+			fclose(file);
+		}
+	}
+	MPI_Bcast(&numberOfTuples, 1, MPI_UINT64_T, 0, MPI_COMM_WORLD);
+
+	return numberOfTuples;
+
+}
+
+bool Relation::isValidHeader(relation_file_header_t *header, uint64_t fileSize) {
+
+	// Both columns need to be contained in the file
+	if (header->magic != RELATION_FILE_MAGIC || header->numberOfTuples == RELATION_FILE_INVALID_SIZE) {
+		return false;
+	}
+	if (header->keyOffset > fileSize || (fileSize - header->keyOffset) / sizeof(uint64_t) < header->numberOfTuples) {
+		return false;
+	}
+	if (header->ridOffset > fileSize || (fileSize - header->ridOffset) / sizeof(uint64_t) < header->numberOfTuples) {
+		return false;
+	}
+	return (header->keyOffset % sizeof(uint64_t) == 0) && (header->ridOffset % sizeof(uint64_t) == 0);
+
+}
+
 void Relation::debugKeyPrint() {
 	for (uint64_t i = 0; i < this->localSize; ++i) {
 		fprintf(stdout, "%lu, ", this->data[i].key);
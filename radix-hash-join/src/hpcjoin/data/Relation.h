@@ -11,6 +11,23 @@
 
 #include <hpcjoin/data/Tuple.h>
 
+#define RELATION_FILE_MAGIC (0x314C45524A435048ULL)
+#define RELATION_FILE_INVALID_SIZE (0xFFFFFFFFFFFFFFFFULL)
+
+/**
+ * Binary columnar relation file: a header followed by the key and the rid column, each stored
+ * as an array of numberOfTuples 64-bit values at the given byte offsets.
+ */
+
+typedef struct {
+
+	uint64_t magic;
+	uint64_t numberOfTuples;
+	uint64_t keyOffset;
+	uint64_t ridOffset;
+
+} relation_file_header_t;
+
 namespace hpcjoin {
 namespace data {
 
@@ -30,11 +47,35 @@ public:
 
 	hpcjoin::data::Tuple* getData();
 
+public:
+
+	uint64_t getSliceStart(uint32_t sliceId, uint32_t numberOfSlices);
+	uint64_t getSliceSize(uint32_t sliceId, uint32_t numberOfSlices);
+
+	/**
+	 * Largest key and rid of the local data
+	 */
+	void computeMaximumValues(uint64_t *maximumKey, uint64_t *maximumRid);
+
 public:
 
 	void fillUniqueValues(uint64_t startKeyValue, uint64_t startRidValue);
 	void fillModuloValues(uint64_t startKeyValue, uint64_t startRidValue, uint64_t innerRelationSize);
 
+public:
+
+	/**
+	 * Every process reads its own stripe of the file (same split as the generated data).
+	 * Uses collective MPI-IO reads, a single process maps the file instead. Returns false on all
+	 * processes if the file could not be read completely.
+	 */
+	bool loadFromFile(const char *fileName, uint32_t nodeId, uint32_t numberOfNodes);
+	static uint64_t readNumberOfTuples(const char *fileName);
+
+protected:
+
+	static bool isValidHeader(relation_file_header_t *header, uint64_t fileSize);
+
 protected:
 
 	void randomOrder();
@@ -9,24 +9,50 @@
 #include <hpcjoin/core/Configuration.h>
 #include <hpcjoin/utils/Debug.h>
 #include <hpcjoin/performance/Measurements.h>
+#include <hpcjoin/memory/Region.h>
 
 #include <unistd.h>
 
 namespace hpcjoin {
 namespace data {
 
-Window::Window(uint32_t numberOfNodes, uint32_t nodeId, uint32_t* assignment, uint64_t* localHistogram, uint64_t* globalHistogram, uint64_t* baseOffsets, uint64_t* writeOffsets) {
+Window::Window(uint32_t numberOfNodes, uint32_t nodeId, hpcjoin::histograms::OffsetMap *offsets) {
 
 	this->numberOfNodes = numberOfNodes;
 	this->nodeId = nodeId;
-	this->assignment = assignment;
-	this->localHistogram = localHistogram;
-	this->globalHistogram = globalHistogram;
-	this->baseOffsets = baseOffsets;
-	this->writeOffsets = writeOffsets;
-	this->writeCounters = (uint64_t *) calloc(hpcjoin::core::Configuration::NETWORK_PARTITIONING_COUNT, sizeof(uint64_t));
+	this->numberOfSlices = offsets->getLocalHistogram()->getNumberOfSlices();
+	this->numberOfReplicas = offsets->getAssignment()->getNumberOfReplicas();
+	this->assignment = offsets->getAssignment();
+	this->sliceHistograms = offsets->getLocalHistogram()->getSliceHistograms();
+	this->localReplicaHistogram = offsets->getLocalReplicaHistogram();
+	this->replicaSizes = offsets->getReplicaSizes();
+	this->replicaTupleCounts = offsets->getReplicaTupleCounts();
+	this->baseOffsets = offsets->getBaseOffsets();
+	this->writeOffsets = offsets->getSliceWriteOffsets();
+	this->writeCounters = (uint64_t *) calloc(this->numberOfSlices * this->numberOfReplicas, sizeof(uint64_t));
+	this->tupleSize = hpcjoin::core::Configuration::getCompressedTupleSize();
 	this->localWindowSize = computeLocalWindowSize();
 
+	// Packed partitions are decoded into a separate buffer once all their data has arrived (only compressed tuples are packed)
+	this->format = (offsets->getFormat() != NULL && offsets->getFormat()->isEnabled()) ? offsets->getFormat() : NULL;
+	this->unpackedData = NULL;
+	this->unpackedOffsets = NULL;
+	this->unpackedReplicas = NULL;
+	if (this->format != NULL) {
+		uint64_t numberOfTuples = 0;
+		this->unpackedOffsets = (uint64_t *) calloc(this->numberOfReplicas, sizeof(uint64_t));
+		this->unpackedReplicas = (bool *) calloc(this->numberOfReplicas, sizeof(bool));
+		for (uint32_t i = 0; i < this->numberOfReplicas; ++i) {
+			if (this->assignment->getReplicaNode(i) == this->nodeId) {
+				this->unpackedOffsets[i] = numberOfTuples;
+				numberOfTuples += this->replicaTupleCounts[i];
+			}
+		}
+		int result = posix_memalign((void **) &(this->unpackedData), hpcjoin::core::Configuration::CACHELINE_SIZE_BYTES, numberOfTuples * sizeof(CompressedTuple));
+		JOIN_ASSERT(result == 0, "Window", "Could not allocate unpacked partitions");
+		JOIN_UNUSED(result);
+	}
+
 	#ifdef USE_FOMPI
 	this->window = (foMPI_Win *) calloc(1, sizeof(foMPI_Win));
 	#else
@@ -34,14 +60,20 @@ Window::Window(uint32_t numberOfNodes, uint32_t nodeId, uint32_t* assignment, ui
 	#endif
 
 
-	MPI_Alloc_mem(localWindowSize * sizeof(hpcjoin::data::CompressedTuple), MPI_INFO_NULL, &(this->data));
+	// Huge pages are not exposed through MPI_Alloc_mem, the window is created on top of the mapping instead
+	this->dataBacking = PAGE_BACKING_DEFAULT;
+	if (hpcjoin::core::Configuration::HUGE_PAGE_POLICY == HUGE_PAGES_NONE) {
+		MPI_Alloc_mem(localWindowSize * this->tupleSize, MPI_INFO_NULL, &(this->data));
+	} else {
+		this->data = (char *) hpcjoin::memory::PageAllocator::allocate(localWindowSize * this->tupleSize, PAGE_REGION_WINDOW, &(this->dataBacking));
+	}
 	#ifdef USE_FOMPI
-	foMPI_Win_create(this->data, localWindowSize * sizeof(hpcjoin::data::CompressedTuple), 1, MPI_INFO_NULL, MPI_COMM_WORLD, window);
+	foMPI_Win_create(this->data, localWindowSize * this->tupleSize, 1, MPI_INFO_NULL, MPI_COMM_WORLD, window);
 	#else
-	MPI_Win_create(this->data, localWindowSize * sizeof(hpcjoin::data::CompressedTuple), 1, MPI_INFO_NULL, MPI_COMM_WORLD, window);
+	MPI_Win_create(this->data, localWindowSize * this->tupleSize, 1, MPI_INFO_NULL, MPI_COMM_WORLD, window);
 	#endif
 
-	JOIN_DEBUG("Window", "Window is at address %p to %p", this->data, this->data + localWindowSize);
+	JOIN_DEBUG("Window", "Window is at address %p to %p", this->data, this->data + localWindowSize * this->tupleSize);
 
 }
 
@@ -51,10 +83,17 @@ Window::~Window() {
 	#else
 	MPI_Win_free(window);
 	#endif
-	MPI_Free_mem(data);
+	if (hpcjoin::core::Configuration::HUGE_PAGE_POLICY == HUGE_PAGES_NONE) {
+		MPI_Free_mem(data);
+	} else {
+		hpcjoin::memory::PageAllocator::release(data, localWindowSize * this->tupleSize, this->dataBacking);
+	}
 
 	free(this->writeCounters);
 	free(this->window);
+	free(this->unpackedData);
+	free(this->unpackedOffsets);
+	free(this->unpackedReplicas);
 
 }
 
@@ -79,71 +118,159 @@ void Window::stop() {
 
 }
 
-void Window::write(uint32_t partitionId, CompressedTuple* tuples, uint64_t sizeInTuples, bool flush) {
+void Window::write(uint32_t sliceId, uint32_t partitionId, void *tuples, uint64_t sizeInTuples, bool flush) {
 
-	//JOIN_DEBUG("Window", "Initializing write for partition %d of %lu tuples", partitionId, sizeInTuples);
+	put(sliceId, partitionId, tuples, sizeInTuples, NULL);
 
+	uint32_t replicaStart = this->assignment->getReplicaStart(partitionId);
+	uint32_t replicaCount = this->assignment->getReplicaCount(partitionId);
+
+	if (flush) {
 #ifdef MEASUREMENT_DETAILS_NETWORK
-	hpcjoin::performance::Measurements::startNetworkPartitioningWindowPut();
+	hpcjoin::performance::Measurements::startNetworkPartitioningWindowWait();
 #endif
+		for (uint32_t replicaId = replicaStart; replicaId < replicaStart + replicaCount; ++replicaId) {
+			if (this->localReplicaHistogram[replicaId] > 0) {
+				#ifdef USE_FOMPI
+				foMPI_Win_flush_local(this->assignment->getReplicaNode(replicaId), *window);
+				#else
+				MPI_Win_flush_local(this->assignment->getReplicaNode(replicaId), *window);
+				#endif
+			}
+		}
+#ifdef MEASUREMENT_DETAILS_NETWORK
+	hpcjoin::performance::Measurements::stopNetworkPartitioningWindowWait();
+#endif
+	}
 
-	uint32_t targetProcess = this->assignment[partitionId];
-	uint64_t targetOffset = this->writeOffsets[partitionId] + this->writeCounters[partitionId];
+}
 
-	//JOIN_DEBUG("Window", "Target %d and offset %lu (%lu + %lu)", targetProcess, targetOffset, this->writeOffsets[partitionId], this->writeCounters[partitionId]);
+void Window::put(uint32_t sliceId, uint32_t partitionId, void *tuples, uint64_t sizeInTuples, MPI_Request *requests) {
 
-	#ifdef JOIN_DEBUG_PRINT
-	uint64_t remoteSize = computeWindowSize(targetProcess);
-	#endif
-	JOIN_ASSERT(targetOffset <= remoteSize, "Window", "Target offset is outside window range");
-	JOIN_ASSERT(targetOffset + sizeInTuples <= remoteSize, "Window", "Target offset and size is outside window range");
+	//JOIN_DEBUG("Window", "Initializing write for partition %d of %lu tuples", partitionId, sizeInTuples);
 
-	#ifdef USE_FOMPI
-	foMPI_Put(tuples, sizeInTuples * sizeof(CompressedTuple), MPI_BYTE, targetProcess, targetOffset * sizeof(CompressedTuple), sizeInTuples * sizeof(CompressedTuple), MPI_BYTE, *window);
-	#else
-	MPI_Put(tuples, sizeInTuples * sizeof(CompressedTuple), MPI_BYTE, targetProcess, targetOffset * sizeof(CompressedTuple), sizeInTuples * sizeof(CompressedTuple), MPI_BYTE, *window);
-	#endif
+	uint32_t replicaStart = this->assignment->getReplicaStart(partitionId);
+	uint32_t replicaCount = this->assignment->getReplicaCount(partitionId);
 
-	this->writeCounters[partitionId] += sizeInTuples;
-	//JOIN_DEBUG("Window", "Partition %d has now %lu tuples", partitionId, this->writeCounters[partitionId]);
+	// The same packed data is sent to all replicas
+	uint64_t sizeInWords = sizeInTuples;
+	if (this->format != NULL) {
+		this->format->pack((CompressedTuple *) tuples, sizeInTuples);
+		sizeInWords = this->format->computePackedSize(sizeInTuples);
+	}
 
-	JOIN_ASSERT(this->writeCounters[partitionId] <= this->localHistogram[partitionId], "Window",
-			"Node %d is writing to partition %d. Has %lu tuples declared, but write counter is now %lu.", this->nodeId, partitionId, this->localHistogram[partitionId],
-			this->writeCounters[partitionId]);
+	// Heavy partitions are written to all replicas this process sends data to
+	for (uint32_t replicaId = replicaStart; replicaId < replicaStart + replicaCount; ++replicaId) {
 
-#ifdef MEASUREMENT_DETAILS_NETWORK
-	hpcjoin::performance::Measurements::stopNetworkPartitioningWindowPut();
-#endif
+		if (this->localReplicaHistogram[replicaId] == 0) {
+			continue;
+		}
 
-	if (flush) {
 #ifdef MEASUREMENT_DETAILS_NETWORK
-	hpcjoin::performance::Measurements::startNetworkPartitioningWindowWait();
+		hpcjoin::performance::Measurements::startNetworkPartitioningWindowPut();
 #endif
+
+		uint32_t targetProcess = this->assignment->getReplicaNode(replicaId);
+		uint64_t sliceIndex = sliceId * this->numberOfReplicas + replicaId;
+		JOIN_ASSERT(this->format == NULL || this->writeCounters[sliceIndex] % PACKED_TUPLES_PER_GROUP == 0, "Window", "Previous write contained a partial group");
+		uint64_t targetOffset = this->writeOffsets[sliceIndex] + ((this->format != NULL) ? this->format->computePackedSize(this->writeCounters[sliceIndex]) : this->writeCounters[sliceIndex]);
+
+		//JOIN_DEBUG("Window", "Target %d and offset %lu (%lu + %lu)", targetProcess, targetOffset, this->writeOffsets[sliceIndex], this->writeCounters[sliceIndex]);
+
+		#ifdef JOIN_DEBUG_PRINT
+		uint64_t remoteSize = computeWindowSize(targetProcess);
+		#endif
+		JOIN_ASSERT(targetOffset <= remoteSize, "Window", "Target offset is outside window range");
+		JOIN_ASSERT(targetOffset + sizeInWords <= remoteSize, "Window", "Target offset and size is outside window range");
+
 		#ifdef USE_FOMPI
-		foMPI_Win_flush_local(targetProcess, *window);
+		JOIN_ASSERT(requests == NULL, "Window", "Request-based puts are not supported by foMPI");
+		foMPI_Put(tuples, sizeInWords * this->tupleSize, MPI_BYTE, targetProcess, targetOffset * this->tupleSize, sizeInWords * this->tupleSize, MPI_BYTE, *window);
 		#else
-		MPI_Win_flush_local(targetProcess, *window);
+		if (requests != NULL) {
+			MPI_Rput(tuples, sizeInWords * this->tupleSize, MPI_BYTE, targetProcess, targetOffset * this->tupleSize, sizeInWords * this->tupleSize, MPI_BYTE, *window,
+					&(requests[replicaId - replicaStart]));
+		} else {
+			MPI_Put(tuples, sizeInWords * this->tupleSize, MPI_BYTE, targetProcess, targetOffset * this->tupleSize, sizeInWords * this->tupleSize, MPI_BYTE, *window);
+		}
 		#endif
+
+		this->writeCounters[sliceIndex] += sizeInTuples;
+		//JOIN_DEBUG("Window", "Partition %d has now %lu tuples", partitionId, this->writeCounters[sliceIndex]);
+
+		JOIN_ASSERT(this->writeCounters[sliceIndex] <= this->sliceHistograms[sliceId * hpcjoin::core::Configuration::NETWORK_PARTITIONING_COUNT + partitionId], "Window",
+				"Node %d is writing to partition %d (slice %d). Has %lu tuples declared, but write counter is now %lu.", this->nodeId, partitionId, sliceId,
+				this->sliceHistograms[sliceId * hpcjoin::core::Configuration::NETWORK_PARTITIONING_COUNT + partitionId], this->writeCounters[sliceIndex]);
+
 #ifdef MEASUREMENT_DETAILS_NETWORK
-	hpcjoin::performance::Measurements::stopNetworkPartitioningWindowWait();
+		hpcjoin::performance::Measurements::stopNetworkPartitioningWindowPut();
 #endif
+
 	}
 
 }
 
-CompressedTuple* Window::getPartition(uint32_t partitionId) {
+void Window::write(uint32_t sliceId, uint32_t partitionId, void *tuples, uint64_t sizeInTuples, MPI_Request *requests) {
+
+	put(sliceId, partitionId, tuples, sizeInTuples, requests);
 
-	JOIN_ASSERT(this->nodeId == this->assignment[partitionId], "Window", "Cannot access non-assigned partition");
+}
+
+void Window::completeRequests(MPI_Request* requests, uint32_t numberOfRequests, uint32_t firstRequiredRequest, uint32_t numberOfRequiredRequests, int *completedIndices) {
 
-	return data + this->baseOffsets[partitionId];
+	// Completed requests are released, only block if a required request is still pending
+	int numberOfCompletedRequests = 0;
+	MPI_Testsome(numberOfRequests, requests, &numberOfCompletedRequests, completedIndices, MPI_STATUSES_IGNORE);
+
+	bool pending = false;
+	for (uint32_t r = firstRequiredRequest; r < firstRequiredRequest + numberOfRequiredRequests; ++r) {
+		pending |= (requests[r] != MPI_REQUEST_NULL);
+	}
+
+	if (pending) {
+#ifdef MEASUREMENT_DETAILS_NETWORK
+		hpcjoin::performance::Measurements::startNetworkPartitioningWindowWait();
+#endif
+		MPI_Waitall(numberOfRequiredRequests, requests + firstRequiredRequest, MPI_STATUSES_IGNORE);
+#ifdef MEASUREMENT_DETAILS_NETWORK
+		hpcjoin::performance::Measurements::stopNetworkPartitioningWindowWait();
+#endif
+	}
+
+}
+
+void Window::unpack(uint32_t replicaId) {
+
+	uint64_t unpackedTuples = this->format->unpack((uint64_t *) (this->data + this->baseOffsets[replicaId] * this->tupleSize), this->replicaSizes[replicaId], this->unpackedData + this->unpackedOffsets[replicaId]);
+	JOIN_ASSERT(unpackedTuples == this->replicaTupleCounts[replicaId], "Window", "Unpacked %lu tuples of replica %d, expected %lu", unpackedTuples, replicaId, this->replicaTupleCounts[replicaId]);
+	JOIN_UNUSED(unpackedTuples);
+	this->unpackedReplicas[replicaId] = true;
+
+	// The packed data is not accessed anymore
+	hpcjoin::memory::Region::discard(this->data + this->baseOffsets[replicaId] * this->tupleSize, this->replicaSizes[replicaId] * this->tupleSize);
 
 }
 
-uint64_t Window::getPartitionSize(uint32_t partitionId) {
+void* Window::getPartition(uint32_t replicaId) {
+
+	JOIN_ASSERT(this->nodeId == this->assignment->getReplicaNode(replicaId), "Window", "Cannot access non-assigned partition");
 
-	JOIN_ASSERT(this->nodeId == this->assignment[partitionId], "Window", "Should not access size of non-assigned partition");
+	if (this->format != NULL) {
+		if (!this->unpackedReplicas[replicaId]) {
+			unpack(replicaId);
+		}
+		return this->unpackedData + this->unpackedOffsets[replicaId];
+	}
 
-	return this->globalHistogram[partitionId];
+	return this->data + this->baseOffsets[replicaId] * this->tupleSize;
+
+}
+
+uint64_t Window::getPartitionSize(uint32_t replicaId) {
+
+	JOIN_ASSERT(this->nodeId == this->assignment->getReplicaNode(replicaId), "Window", "Should not access size of non-assigned partition");
+
+	return this->replicaTupleCounts[replicaId];
 
 }
 
@@ -153,12 +280,23 @@ uint64_t Window::computeLocalWindowSize() {
 
 }
 
+uint32_t Window::getMaximumReplicaCount() {
+
+	uint32_t maximum = 0;
+	for (uint32_t p = 0; p < hpcjoin::core::Configuration::NETWORK_PARTITIONING_COUNT; ++p) {
+		uint32_t replicaCount = this->assignment->getReplicaCount(p);
+		maximum = (replicaCount > maximum) ? replicaCount : maximum;
+	}
+	return maximum;
+
+}
+
 uint64_t Window::computeWindowSize(uint32_t nodeId) {
 
 	uint64_t sum = 0;
-	for (uint32_t p = 0; p < hpcjoin::core::Configuration::NETWORK_PARTITIONING_COUNT; ++p) {
-		if (this->assignment[p] == nodeId) {
-			sum += this->globalHistogram[p];
+	for (uint32_t i = 0; i < this->numberOfReplicas; ++i) {
+		if (this->assignment->getReplicaNode(i) == nodeId) {
+			sum += this->replicaSizes[i];
 		}
 	}
 	return sum;
@@ -167,9 +305,17 @@ uint64_t Window::computeWindowSize(uint32_t nodeId) {
 
 void Window::assertAllTuplesWritten() {
 
-	for (uint32_t p = 0; p < hpcjoin::core::Configuration::NETWORK_PARTITIONING_COUNT; ++p) {
-		JOIN_ASSERT(this->localHistogram[p] == this->writeCounters[p], "Window", "Not all tuples submitted to window. Partition %d. Local size %lu tuples. Write size %lu tuples.",
-				p, this->localHistogram[p], this->writeCounters[p]);
+	for (uint32_t s = 0; s < this->numberOfSlices; ++s) {
+		for (uint32_t p = 0; p < hpcjoin::core::Configuration::NETWORK_PARTITIONING_COUNT; ++p) {
+			uint64_t localSize = this->sliceHistograms[s * hpcjoin::core::Configuration::NETWORK_PARTITIONING_COUNT + p];
+			JOIN_UNUSED(localSize);
+			for (uint32_t i = this->assignment->getReplicaStart(p); i < this->assignment->getReplicaStart(p) + this->assignment->getReplicaCount(p); ++i) {
+				uint64_t writeSize = this->writeCounters[s * this->numberOfReplicas + i];
+				JOIN_ASSERT(this->localReplicaHistogram[i] == 0 || localSize == writeSize, "Window",
+						"Not all tuples submitted to window. Partition %d (slice %d, replica %d). Local size %lu tuples. Write size %lu tuples.", p, s, i, localSize, writeSize);
+				JOIN_UNUSED(writeSize);
+			}
+		}
 	}
 
 }
@@ -184,6 +330,56 @@ void Window::flush() {
 
 }
 
+void Window::publishArrivals(uint32_t sliceId, hpcjoin::data::ArrivalWindow *arrivals) {
+
+	// Remote completion of all puts of this slice before the arrival is signalled
+	#ifdef USE_FOMPI
+	foMPI_Win_flush_all(*window);
+	#else
+	MPI_Win_flush_all(*window);
+	#endif
+
+	for (uint32_t replicaId = 0; replicaId < this->numberOfReplicas; ++replicaId) {
+		if (this->writeCounters[sliceId * this->numberOfReplicas + replicaId] > 0) {
+			arrivals->signal(replicaId);
+		}
+	}
+	arrivals->flush();
+
+}
+
+void Window::countSenders(uint64_t *senders) {
+
+	// A slice sends to a replica if it has tuples of the partition and the process is assigned to the replica
+	for (uint32_t s = 0; s < this->numberOfSlices; ++s) {
+		for (uint32_t p = 0; p < hpcjoin::core::Configuration::NETWORK_PARTITIONING_COUNT; ++p) {
+			if (this->sliceHistograms[s * hpcjoin::core::Configuration::NETWORK_PARTITIONING_COUNT + p] == 0) {
+				continue;
+			}
+			for (uint32_t i = this->assignment->getReplicaStart(p); i < this->assignment->getReplicaStart(p) + this->assignment->getReplicaCount(p); ++i) {
+				if (this->localReplicaHistogram[i] > 0) {
+					++senders[i];
+				}
+			}
+		}
+	}
+
+}
+
+void Window::synchronize() {
+
+	// Make remotely written data visible to local loads
+	#ifdef USE_FOMPI
+	foMPI_Win_lock(MPI_LOCK_SHARED, this->nodeId, 0, *window);
+	foMPI_Win_sync(*window);
+	foMPI_Win_unlock(this->nodeId, *window);
+	#else
+	MPI_Win_lock(MPI_LOCK_SHARED, this->nodeId, 0, *window);
+	MPI_Win_sync(*window);
+	MPI_Win_unlock(this->nodeId, *window);
+	#endif
+
+}
 
 } /* namespace data */
 } /* namespace hpcjoin */
@@ -16,6 +16,10 @@
 #include <stdint.h>
 
 #include <hpcjoin/data/CompressedTuple.h>
+#include <hpcjoin/histograms/OffsetMap.h>
+#include <hpcjoin/data/PackedFormat.h>
+#include <hpcjoin/data/ArrivalWindow.h>
+#include <hpcjoin/memory/PageAllocator.h>
 
 namespace hpcjoin {
 namespace data {
@@ -24,7 +28,7 @@ class Window {
 
 public:
 
-	Window(uint32_t numberOfNodes, uint32_t nodeId, uint32_t *assignment, uint64_t *localHistogram, uint64_t *globalHistogram, uint64_t *baseOffsets, uint64_t *writeOffsets);
+	Window(uint32_t numberOfNodes, uint32_t nodeId, hpcjoin::histograms::OffsetMap *offsets);
 	~Window();
 
 public:
@@ -32,28 +36,67 @@ public:
 	void start();
 	void stop();
 
-	void write(uint32_t partitionId, CompressedTuple *tuples, uint64_t sizeInTuples, bool flush = true);
+	/**
+	 * If the tuples are transferred in packed format, they are packed in place. The buffer then
+	 * needs to hold a multiple of PACKED_TUPLES_PER_GROUP tuples and only the last write of a
+	 * slice to a partition may contain a partial group. Tuples are of the compressed tuple type
+	 * selected by the configuration.
+	 */
+	void write(uint32_t sliceId, uint32_t partitionId, void *tuples, uint64_t sizeInTuples, bool flush = true);
+
+	/**
+	 * Request-based variant, one request per replica is stored in the given array. The buffer
+	 * can only be reused once all requests have been completed.
+	 */
+	void write(uint32_t sliceId, uint32_t partitionId, void *tuples, uint64_t sizeInTuples, MPI_Request *requests);
+	void completeRequests(MPI_Request *requests, uint32_t numberOfRequests, uint32_t firstRequiredRequest, uint32_t numberOfRequiredRequests, int *completedIndices);
 
 	void flush();
 
+	/**
+	 * Signals the arrival of all partitions the slice has written to once the tuples are
+	 * visible at the target processes.
+	 */
+	void publishArrivals(uint32_t sliceId, hpcjoin::data::ArrivalWindow *arrivals);
+	void countSenders(uint64_t *senders);
+
+	void synchronize();
+
 public:
 
-	CompressedTuple *getPartition(uint32_t partitionId);
-	uint64_t getPartitionSize(uint32_t partitionId);
+	/**
+	 * Partitions are accessed by replica id (see AssignmentMap)
+	 */
+	void *getPartition(uint32_t replicaId);
+	uint64_t getPartitionSize(uint32_t replicaId);
 
 public:
 
 	uint64_t computeLocalWindowSize();
 	uint64_t computeWindowSize(uint32_t nodeId);
 
+	uint32_t getMaximumReplicaCount();
+
 public:
 
 	void assertAllTuplesWritten();
 
 protected:
 
+	void put(uint32_t sliceId, uint32_t partitionId, void *tuples, uint64_t sizeInTuples, MPI_Request *requests);
+	void unpack(uint32_t replicaId);
+
+protected:
+
+	uint32_t tupleSize;
 	uint64_t localWindowSize;
-	hpcjoin::data::CompressedTuple *data;
+	char *data;
+	page_backing_t dataBacking;
+
+	hpcjoin::data::PackedFormat *format;
+	hpcjoin::data::CompressedTuple *unpackedData;
+	uint64_t *unpackedOffsets;
+	bool *unpackedReplicas;
 
 	#ifdef USE_FOMPI
 	foMPI_Win *window;
@@ -66,10 +109,14 @@ protected:
 
 	uint32_t numberOfNodes;
 	uint32_t nodeId;
-
-	uint32_t *assignment;
-	uint64_t *localHistogram;
-	uint64_t *globalHistogram;
+	uint32_t numberOfSlices;
+	uint32_t numberOfReplicas;
+
+	hpcjoin::histograms::AssignmentMap *assignment;
+	uint64_t *sliceHistograms;
+	uint64_t *localReplicaHistogram;
+	uint64_t *replicaSizes;
+	uint64_t *replicaTupleCounts;
 	uint64_t *baseOffsets;
 	uint64_t *writeOffsets;
 
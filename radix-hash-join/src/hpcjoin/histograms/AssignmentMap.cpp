@@ -7,8 +7,11 @@
 #include "AssignmentMap.h"
 
 #include <stdlib.h>
+#include <math.h>
+#include <algorithm>
 
 #include <hpcjoin/core/Configuration.h>
+#include <hpcjoin/utils/Debug.h>
 #include <hpcjoin/performance/Measurements.h>
 
 namespace hpcjoin {
@@ -20,12 +23,24 @@ AssignmentMap::AssignmentMap(uint32_t numberOfNodes, hpcjoin::histograms::Global
 	this->innerRelationGlobalHistogram = innerRelationGlobalHistogram;
 	this->outerRelationGlobalHistogram = outerRelationGlobalHistogram;
 	this->assignment = (uint32_t *) calloc(hpcjoin::core::Configuration::NETWORK_PARTITIONING_COUNT, sizeof(uint32_t));
+	this->predictedLoads = (double *) calloc(numberOfNodes, sizeof(double));
+
+	this->numberOfReplicas = 0;
+	this->numberOfHeavyPartitions = 0;
+	this->replicaCounts = (uint32_t *) calloc(hpcjoin::core::Configuration::NETWORK_PARTITIONING_COUNT, sizeof(uint32_t));
+	this->replicaStarts = (uint32_t *) calloc(hpcjoin::core::Configuration::NETWORK_PARTITIONING_COUNT + 1, sizeof(uint32_t));
+	this->replicaNodes = NULL;
 
 }
 
 AssignmentMap::~AssignmentMap() {
 
 	free(this->assignment);
+	free(this->predictedLoads);
+
+	free(this->replicaCounts);
+	free(this->replicaStarts);
+	free(this->replicaNodes);
 
 }
 
@@ -35,22 +50,217 @@ void AssignmentMap::computePartitionAssignment() {
 	hpcjoin::performance::Measurements::startHistogramAssignmentComputation();
 #endif
 
-	for(uint32_t p=0; p<hpcjoin::core::Configuration::NETWORK_PARTITIONING_COUNT; ++p) {
-		assignment[p] = p % this->numberOfNodes;
+	computeReplicaCounts();
+
+	switch (hpcjoin::core::Configuration::ASSIGNMENT_POLICY) {
+		case ASSIGNMENT_COST_BASED:
+			computeCostBasedAssignment();
+			break;
+		case ASSIGNMENT_ROUND_ROBIN:
+		default:
+			computeRoundRobinAssignment();
+			break;
+	}
+
+	for (uint32_t p = 0; p < hpcjoin::core::Configuration::NETWORK_PARTITIONING_COUNT; ++p) {
+		assignment[p] = replicaNodes[replicaStarts[p]];
 	}
 
+	computePredictedLoads();
+
 #ifdef MEASUREMENT_DETAILS_HISTOGRAM
 	hpcjoin::performance::Measurements::stopHistogramAssignmentComputation();
 #endif
 
 }
 
+/**
+ * A partition is heavy if its cost exceeds the average load of a node by the configured
+ * factor. It is then spread over as many nodes as necessary to bring the cost of the
+ * replicas below this threshold.
+ */
+void AssignmentMap::computeReplicaCounts() {
+
+	double totalCost = 0;
+	for (uint32_t p = 0; p < hpcjoin::core::Configuration::NETWORK_PARTITIONING_COUNT; ++p) {
+		totalCost += computePartitionCost(p);
+	}
+	double threshold = hpcjoin::core::Configuration::HEAVY_PARTITION_THRESHOLD * (totalCost / this->numberOfNodes);
+
+	this->numberOfReplicas = 0;
+	this->numberOfHeavyPartitions = 0;
+	for (uint32_t p = 0; p < hpcjoin::core::Configuration::NETWORK_PARTITIONING_COUNT; ++p) {
+		uint32_t replicaCount = 1;
+		double cost = computePartitionCost(p);
+		if (hpcjoin::core::Configuration::ENABLE_HEAVY_PARTITION_REPLICATION && this->numberOfNodes > 1 && threshold > 0 && cost > threshold) {
+			replicaCount = std::min(this->numberOfNodes, (uint32_t) ceil(cost / threshold));
+			++(this->numberOfHeavyPartitions);
+			JOIN_DEBUG("Assignment", "Partition %d is heavy (cost %.0f, threshold %.0f) and is assigned to %d nodes", p, cost, threshold, replicaCount);
+		}
+		this->replicaCounts[p] = replicaCount;
+		this->replicaStarts[p] = this->numberOfReplicas;
+		this->numberOfReplicas += replicaCount;
+	}
+	this->replicaStarts[hpcjoin::core::Configuration::NETWORK_PARTITIONING_COUNT] = this->numberOfReplicas;
+
+	free(this->replicaNodes);
+	this->replicaNodes = (uint32_t *) calloc(this->numberOfReplicas, sizeof(uint32_t));
+
+}
+
+void AssignmentMap::computeRoundRobinAssignment() {
+
+	for(uint32_t p=0; p<hpcjoin::core::Configuration::NETWORK_PARTITIONING_COUNT; ++p) {
+		for (uint32_t r = 0; r < replicaCounts[p]; ++r) {
+			replicaNodes[replicaStarts[p] + r] = (p + r) % this->numberOfNodes;
+		}
+	}
+
+}
+
+/**
+ * Greedy longest-processing-time-first: partitions are sorted by their estimated cost and
+ * each partition is given to the node(s) with the lowest load so far. Ties are broken by
+ * partition and node id, such that all processes compute the same assignment.
+ */
+void AssignmentMap::computeCostBasedAssignment() {
+
+	uint32_t const numberOfPartitions = hpcjoin::core::Configuration::NETWORK_PARTITIONING_COUNT;
+
+	double *costs = (double *) calloc(numberOfPartitions, sizeof(double));
+	uint32_t *order = (uint32_t *) calloc(numberOfPartitions, sizeof(uint32_t));
+	double *loads = (double *) calloc(this->numberOfNodes, sizeof(double));
+	bool *taken = (bool *) calloc(this->numberOfNodes, sizeof(bool));
+
+	for (uint32_t p = 0; p < numberOfPartitions; ++p) {
+		costs[p] = computePartitionCost(p);
+		order[p] = p;
+	}
+
+	std::sort(order, order + numberOfPartitions, [costs](uint32_t a, uint32_t b) {
+		return (costs[a] > costs[b]) || (costs[a] == costs[b] && a < b);
+	});
+
+	for (uint32_t i = 0; i < numberOfPartitions; ++i) {
+		uint32_t partitionId = order[i];
+		uint32_t *nodes = replicaNodes + replicaStarts[partitionId];
+		double replicaCost = computeReplicaCost(partitionId);
+
+		// Replicas of the same partition go to distinct nodes
+		for (uint32_t r = 0; r < replicaCounts[partitionId]; ++r) {
+			uint32_t target = this->numberOfNodes;
+			for (uint32_t n = 0; n < this->numberOfNodes; ++n) {
+				if (!taken[n] && (target == this->numberOfNodes || loads[n] < loads[target])) {
+					target = n;
+				}
+			}
+			nodes[r] = target;
+			taken[target] = true;
+			loads[target] += replicaCost;
+		}
+
+		for (uint32_t r = 0; r < replicaCounts[partitionId]; ++r) {
+			taken[nodes[r]] = false;
+		}
+	}
+
+	free(costs);
+	free(order);
+	free(loads);
+	free(taken);
+
+}
+
+void AssignmentMap::computePredictedLoads() {
+
+	for (uint32_t n = 0; n < this->numberOfNodes; ++n) {
+		this->predictedLoads[n] = 0;
+	}
+
+	for (uint32_t p = 0; p < hpcjoin::core::Configuration::NETWORK_PARTITIONING_COUNT; ++p) {
+		for (uint32_t r = 0; r < replicaCounts[p]; ++r) {
+			this->predictedLoads[replicaNodes[replicaStarts[p] + r]] += computeReplicaCost(p);
+		}
+	}
+
+}
+
+double AssignmentMap::computePartitionCost(uint32_t partitionId) {
+
+	uint64_t innerSize = this->innerRelationGlobalHistogram->getGlobalHistogram()[partitionId];
+	uint64_t outerSize = this->outerRelationGlobalHistogram->getGlobalHistogram()[partitionId];
+
+	return hpcjoin::core::Configuration::BUILD_COST_PER_TUPLE * innerSize + hpcjoin::core::Configuration::PROBE_COST_PER_TUPLE * outerSize;
+
+}
+
+double AssignmentMap::computeReplicaCost(uint32_t partitionId) {
+
+	// Every replica builds the full inner partition and probes its share of the outer partition
+	uint64_t innerSize = this->innerRelationGlobalHistogram->getGlobalHistogram()[partitionId];
+	uint64_t outerSize = this->outerRelationGlobalHistogram->getGlobalHistogram()[partitionId];
+
+	return hpcjoin::core::Configuration::BUILD_COST_PER_TUPLE * innerSize
+			+ hpcjoin::core::Configuration::PROBE_COST_PER_TUPLE * ((double) outerSize) / replicaCounts[partitionId];
+
+}
+
 uint32_t* AssignmentMap::getPartitionAssignment() {
 
 	return this->assignment;
 
 }
 
+uint32_t AssignmentMap::getNumberOfReplicas() {
+
+	return this->numberOfReplicas;
+
+}
+
+uint32_t AssignmentMap::getReplicaCount(uint32_t partitionId) {
+
+	return this->replicaCounts[partitionId];
+
+}
+
+uint32_t AssignmentMap::getReplicaStart(uint32_t partitionId) {
+
+	return this->replicaStarts[partitionId];
+
+}
+
+uint32_t AssignmentMap::getReplicaNode(uint32_t replicaId) {
+
+	return this->replicaNodes[replicaId];
+
+}
+
+uint32_t AssignmentMap::getNumberOfHeavyPartitions() {
+
+	return this->numberOfHeavyPartitions;
+
+}
+
+double AssignmentMap::getPredictedLoad(uint32_t nodeId) {
+
+	return this->predictedLoads[nodeId];
+
+}
+
+double AssignmentMap::getImbalanceFactor() {
+
+	// Ratio between the most loaded node and the average load
+	double maximum = 0;
+	double sum = 0;
+	for (uint32_t n = 0; n < this->numberOfNodes; ++n) {
+		maximum = std::max(maximum, this->predictedLoads[n]);
+		sum += this->predictedLoads[n];
+	}
+
+	return (sum > 0) ? (maximum * this->numberOfNodes / sum) : 1.0;
+
+}
+
 } /* namespace histograms */
 } /* namespace hpcjoin */
 
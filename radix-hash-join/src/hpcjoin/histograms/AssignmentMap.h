@@ -14,6 +14,13 @@
 namespace hpcjoin {
 namespace histograms {
 
+/**
+ * Maps partitions to processes. Heavy partitions (see HEAVY_PARTITION_THRESHOLD) are assigned
+ * to several processes: the inner partition is replicated to all of them while the outer
+ * partition is split between them. Every assigned (partition, process) pair is a replica.
+ * Replicas are numbered consecutively, the replicas of partition p start at getReplicaStart(p).
+ */
+
 class AssignmentMap {
 
 public:
@@ -26,6 +33,25 @@ public:
 	void computePartitionAssignment();
 	uint32_t *getPartitionAssignment();
 
+	uint32_t getNumberOfReplicas();
+	uint32_t getReplicaCount(uint32_t partitionId);
+	uint32_t getReplicaStart(uint32_t partitionId);
+	uint32_t getReplicaNode(uint32_t replicaId);
+	uint32_t getNumberOfHeavyPartitions();
+
+	double getPredictedLoad(uint32_t nodeId);
+	double getImbalanceFactor();
+
+protected:
+
+	void computeReplicaCounts();
+	void computeRoundRobinAssignment();
+	void computeCostBasedAssignment();
+	void computePredictedLoads();
+
+	double computePartitionCost(uint32_t partitionId);
+	double computeReplicaCost(uint32_t partitionId);
+
 protected:
 
 	uint32_t numberOfNodes;
@@ -33,6 +59,13 @@ protected:
 	hpcjoin::histograms::GlobalHistogram *outerRelationGlobalHistogram;
 
 	uint32_t *assignment;
+	double *predictedLoads;
+
+	uint32_t numberOfReplicas;
+	uint32_t numberOfHeavyPartitions;
+	uint32_t *replicaCounts;
+	uint32_t *replicaStarts;
+	uint32_t *replicaNodes;
 
 };
 
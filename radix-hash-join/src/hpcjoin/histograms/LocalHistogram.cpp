@@ -13,26 +13,31 @@
 
 #include <hpcjoin/core/Configuration.h>
 #include <hpcjoin/performance/Measurements.h>
+#include <hpcjoin/utils/Dispatch.h>
 
 namespace hpcjoin {
 namespace histograms {
 
 #define HASH_BIT_MODULO(KEY, MASK, NBITS) (((KEY) & (MASK)) >> (NBITS))
 
-LocalHistogram::LocalHistogram(hpcjoin::data::Relation* relation) {
+LocalHistogram::LocalHistogram(hpcjoin::data::Relation* relation, uint32_t numberOfSlices) {
 
 	this->relation = relation;
 	this->values = (uint64_t *) calloc(hpcjoin::core::Configuration::NETWORK_PARTITIONING_COUNT, sizeof(uint64_t));
 
+	this->numberOfSlices = numberOfSlices;
+	this->sliceValues = (uint64_t *) calloc(numberOfSlices * hpcjoin::core::Configuration::NETWORK_PARTITIONING_COUNT, sizeof(uint64_t));
+
 }
 
 LocalHistogram::~LocalHistogram() {
 
 	free(values);
+	free(sliceValues);
 
 }
 
-void LocalHistogram::computeLocalHistogram() {
+void LocalHistogram::computeLocalHistogram(hpcjoin::data::BloomFilter *filter) {
 
 #ifdef MEASUREMENT_DETAILS_HISTOGRAM
 	hpcjoin::performance::Measurements::startHistogramLocalHistogramComputation();
@@ -41,9 +46,24 @@ void LocalHistogram::computeLocalHistogram() {
 	uint64_t const numberOfElements = relation->getLocalSize();
 	hpcjoin::data::Tuple * const data = relation->getData();
 
-	for (uint64_t i = 0; i < numberOfElements; ++i) {
-		uint32_t partitionIdx = HASH_BIT_MODULO(data[i].key, hpcjoin::core::Configuration::NETWORK_PARTITIONING_COUNT - 1, 0);
-		++(values[partitionIdx]);
+	// Every network partitioning thread needs the histogram of its own slice
+	for (uint32_t s = 0; s < this->numberOfSlices; ++s) {
+
+		uint64_t const sliceStart = relation->getSliceStart(s, this->numberOfSlices);
+		uint64_t const sliceEnd = sliceStart + relation->getSliceSize(s, this->numberOfSlices);
+		uint64_t * const sliceHistogram = this->sliceValues + s * hpcjoin::core::Configuration::NETWORK_PARTITIONING_COUNT;
+
+		// Tuples rejected by the filter are not sent, the window sizes only include the remaining ones
+		if (filter == NULL) {
+			FANOUT_DISPATCH(hpcjoin::core::Configuration::NETWORK_PARTITIONING_FANOUT, computeSliceHistogram, data + sliceStart, sliceEnd - sliceStart, sliceHistogram);
+		} else {
+			FANOUT_DISPATCH(hpcjoin::core::Configuration::NETWORK_PARTITIONING_FANOUT, computeFilteredSliceHistogram, data + sliceStart, sliceEnd - sliceStart, sliceHistogram, filter);
+		}
+
+		for (uint32_t p = 0; p < hpcjoin::core::Configuration::NETWORK_PARTITIONING_COUNT; ++p) {
+			values[p] += sliceHistogram[p];
+		}
+
 	}
 
 #ifdef MEASUREMENT_DETAILS_HISTOGRAM
@@ -52,11 +72,45 @@ void LocalHistogram::computeLocalHistogram() {
 
 }
 
+template<uint32_t FANOUT>
+void LocalHistogram::computeSliceHistogram(hpcjoin::data::Tuple* data, uint64_t numberOfElements, uint64_t* histogram) {
+
+	for (uint64_t i = 0; i < numberOfElements; ++i) {
+		uint32_t partitionIdx = HASH_BIT_MODULO(data[i].key, (1 << FANOUT) - 1, 0);
+		++(histogram[partitionIdx]);
+	}
+
+}
+
+template<uint32_t FANOUT>
+void LocalHistogram::computeFilteredSliceHistogram(hpcjoin::data::Tuple* data, uint64_t numberOfElements, uint64_t* histogram, hpcjoin::data::BloomFilter *filter) {
+
+	for (uint64_t i = 0; i < numberOfElements; ++i) {
+		if (filter->contains(data[i].key)) {
+			uint32_t partitionIdx = HASH_BIT_MODULO(data[i].key, (1 << FANOUT) - 1, 0);
+			++(histogram[partitionIdx]);
+		}
+	}
+
+}
+
 uint64_t* LocalHistogram::getLocalHistogram() {
 
 	return this->values;
 
 }
 
+uint64_t* LocalHistogram::getSliceHistograms() {
+
+	return this->sliceValues;
+
+}
+
+uint32_t LocalHistogram::getNumberOfSlices() {
+
+	return this->numberOfSlices;
+
+}
+
 } /* namespace histograms */
 } /* namespace hpcjoin */
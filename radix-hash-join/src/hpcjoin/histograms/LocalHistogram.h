@@ -7,7 +7,10 @@
 #ifndef HPCJOIN_HISTOGRAMS_LOCALHISTOGRAM_H_
 #define HPCJOIN_HISTOGRAMS_LOCALHISTOGRAM_H_
 
+#include <stddef.h>
+
 #include <hpcjoin/data/Relation.h>
+#include <hpcjoin/data/BloomFilter.h>
 
 namespace hpcjoin {
 namespace histograms {
@@ -16,20 +19,32 @@ class LocalHistogram {
 
 public:
 
-	LocalHistogram(hpcjoin::data::Relation *relation);
+	LocalHistogram(hpcjoin::data::Relation *relation, uint32_t numberOfSlices = 1);
 	~LocalHistogram();
 
 public:
 
-	void computeLocalHistogram();
+	void computeLocalHistogram(hpcjoin::data::BloomFilter *filter = NULL);
 
 	uint64_t *getLocalHistogram();
+	uint64_t *getSliceHistograms();
+	uint32_t getNumberOfSlices();
+
+protected:
+
+	template<uint32_t FANOUT>
+	static void computeSliceHistogram(hpcjoin::data::Tuple *data, uint64_t numberOfElements, uint64_t *histogram);
+	template<uint32_t FANOUT>
+	static void computeFilteredSliceHistogram(hpcjoin::data::Tuple *data, uint64_t numberOfElements, uint64_t *histogram, hpcjoin::data::BloomFilter *filter);
 
 protected:
 
 	hpcjoin::data::Relation *relation;
 	uint64_t *values;
 
+	uint32_t numberOfSlices;
+	uint64_t *sliceValues;
+
 };
 
 } /* namespace histograms */
@@ -15,24 +15,38 @@
 namespace hpcjoin {
 namespace histograms {
 
-OffsetMap::OffsetMap(uint32_t numberOfProcesses, LocalHistogram* localHistogram, GlobalHistogram* globalHistogram, AssignmentMap* assignment) {
+OffsetMap::OffsetMap(uint32_t numberOfProcesses, uint32_t processId, LocalHistogram* localHistogram, GlobalHistogram* globalHistogram, AssignmentMap* assignment, bool replicateHeavyPartitions, hpcjoin::data::PackedFormat *format) {
 
 	this->numberOfProcesses = numberOfProcesses;
+	this->processId = processId;
 	this->localHistogram = localHistogram;
 	this->globalHistogram = globalHistogram;
 	this->assignment = assignment;
-
-	this->baseOffsets = (uint64_t *) calloc(hpcjoin::core::Configuration::NETWORK_PARTITIONING_COUNT, sizeof(uint64_t));
-	this->relativeWriteOffsets = (uint64_t *) calloc(hpcjoin::core::Configuration::NETWORK_PARTITIONING_COUNT, sizeof(uint64_t));
-	this->absoluteWriteOffsets = (uint64_t *) calloc(hpcjoin::core::Configuration::NETWORK_PARTITIONING_COUNT, sizeof(uint64_t));
+	this->replicateHeavyPartitions = replicateHeavyPartitions;
+	this->format = format;
+
+	// Allocated once the number of replicas is known
+	this->localReplicaHistogram = NULL;
+	this->replicaTupleCounts = NULL;
+	this->localReplicaSizes = NULL;
+	this->replicaSizes = NULL;
+	this->baseOffsets = NULL;
+	this->relativeWriteOffsets = NULL;
+	this->absoluteWriteOffsets = NULL;
+	this->sliceWriteOffsets = NULL;
 
 }
 
 OffsetMap::~OffsetMap() {
 
+	free(this->localReplicaHistogram);
+	free(this->replicaTupleCounts);
+	free(this->localReplicaSizes);
+	free(this->replicaSizes);
 	free(this->baseOffsets);
 	free(this->relativeWriteOffsets);
 	free(this->absoluteWriteOffsets);
+	free(this->sliceWriteOffsets);
 
 }
 
@@ -42,9 +56,22 @@ void OffsetMap::computeOffsets() {
 	hpcjoin::performance::Measurements::startHistogramOffsetComputation();
 #endif
 
+	uint32_t numberOfReplicas = this->assignment->getNumberOfReplicas();
+	this->localReplicaHistogram = (uint64_t *) calloc(numberOfReplicas, sizeof(uint64_t));
+	this->replicaTupleCounts = (uint64_t *) calloc(numberOfReplicas, sizeof(uint64_t));
+	this->localReplicaSizes = (uint64_t *) calloc(numberOfReplicas, sizeof(uint64_t));
+	this->replicaSizes = (uint64_t *) calloc(numberOfReplicas, sizeof(uint64_t));
+	this->baseOffsets = (uint64_t *) calloc(numberOfReplicas, sizeof(uint64_t));
+	this->relativeWriteOffsets = (uint64_t *) calloc(numberOfReplicas, sizeof(uint64_t));
+	this->absoluteWriteOffsets = (uint64_t *) calloc(numberOfReplicas, sizeof(uint64_t));
+	this->sliceWriteOffsets = (uint64_t *) calloc(this->localHistogram->getNumberOfSlices() * numberOfReplicas, sizeof(uint64_t));
+
+	computeReplicaHistograms();
+	computeReplicaSizes();
 	computeBaseOffsets();
 	computeRelativePrivateOffsets();
 	computeAbsolutePrivateOffsets();
+	computeSliceOffsets();
 
 #ifdef MEASUREMENT_DETAILS_HISTOGRAM
 	hpcjoin::performance::Measurements::stopHistogramOffsetComputation();
@@ -52,16 +79,67 @@ void OffsetMap::computeOffsets() {
 
 }
 
+void OffsetMap::computeReplicaHistograms() {
+
+	uint64_t *histogram = this->localHistogram->getLocalHistogram();
+	uint64_t *globalHistogram = this->globalHistogram->getGlobalHistogram();
+
+	for (uint32_t p = 0; p < hpcjoin::core::Configuration::NETWORK_PARTITIONING_COUNT; ++p) {
+		uint32_t replicaCount = this->assignment->getReplicaCount(p);
+		uint32_t replicaStart = this->assignment->getReplicaStart(p);
+		for (uint32_t r = 0; r < replicaCount; ++r) {
+			bool isTarget = this->replicateHeavyPartitions || (this->processId % replicaCount == r);
+			this->localReplicaHistogram[replicaStart + r] = (isTarget) ? histogram[p] : 0;
+			this->replicaTupleCounts[replicaStart + r] = globalHistogram[p];
+		}
+	}
+
+	// The size of a split partition depends on which processes send data to a replica
+	if (!this->replicateHeavyPartitions && this->assignment->getNumberOfHeavyPartitions() > 0) {
+		MPI_Allreduce(this->localReplicaHistogram, this->replicaTupleCounts, this->assignment->getNumberOfReplicas(), MPI_UINT64_T, MPI_SUM, MPI_COMM_WORLD);
+	}
+
+}
+
+void OffsetMap::computeReplicaSizes() {
+
+	uint32_t numberOfReplicas = this->assignment->getNumberOfReplicas();
+
+	if (this->format == NULL || !this->format->isEnabled()) {
+		for (uint32_t i = 0; i < numberOfReplicas; ++i) {
+			this->localReplicaSizes[i] = this->localReplicaHistogram[i];
+			this->replicaSizes[i] = this->replicaTupleCounts[i];
+		}
+		return;
+	}
+
+	// Every slice packs its tuples separately, the last group of a slice is padded
+	uint32_t numberOfSlices = this->localHistogram->getNumberOfSlices();
+	uint64_t *sliceHistograms = this->localHistogram->getSliceHistograms();
+
+	for (uint32_t p = 0; p < hpcjoin::core::Configuration::NETWORK_PARTITIONING_COUNT; ++p) {
+		uint64_t packedSize = 0;
+		for (uint32_t s = 0; s < numberOfSlices; ++s) {
+			packedSize += this->format->computePackedSize(sliceHistograms[s * hpcjoin::core::Configuration::NETWORK_PARTITIONING_COUNT + p]);
+		}
+		uint32_t replicaStart = this->assignment->getReplicaStart(p);
+		for (uint32_t r = 0; r < this->assignment->getReplicaCount(p); ++r) {
+			this->localReplicaSizes[replicaStart + r] = (this->localReplicaHistogram[replicaStart + r] > 0) ? packedSize : 0;
+		}
+	}
+
+	MPI_Allreduce(this->localReplicaSizes, this->replicaSizes, numberOfReplicas, MPI_UINT64_T, MPI_SUM, MPI_COMM_WORLD);
+
+}
+
 void OffsetMap::computeBaseOffsets() {
 
 	uint64_t *currentOffsets = (uint64_t *) calloc(this->numberOfProcesses, sizeof(uint64_t));
-	uint32_t *partitionAssignment = this->assignment->getPartitionAssignment();
-	uint64_t *histogram = this->globalHistogram->getGlobalHistogram();
 
-	for (uint32_t i = 0; i < hpcjoin::core::Configuration::NETWORK_PARTITIONING_COUNT; ++i) {
-		uint32_t assignedNode = partitionAssignment[i];
+	for (uint32_t i = 0; i < this->assignment->getNumberOfReplicas(); ++i) {
+		uint32_t assignedNode = this->assignment->getReplicaNode(i);
 		this->baseOffsets[i] = currentOffsets[assignedNode];
-		currentOffsets[assignedNode] += histogram[i];
+		currentOffsets[assignedNode] += this->replicaSizes[i];
 	}
 
 	free(currentOffsets);
@@ -70,24 +148,42 @@ void OffsetMap::computeBaseOffsets() {
 
 void OffsetMap::computeRelativePrivateOffsets() {
 
-	MPI_Scan(this->localHistogram->getLocalHistogram(), this->relativeWriteOffsets, hpcjoin::core::Configuration::NETWORK_PARTITIONING_COUNT, MPI_UINT64_T, MPI_SUM,
-			MPI_COMM_WORLD);
+	MPI_Scan(this->localReplicaSizes, this->relativeWriteOffsets, this->assignment->getNumberOfReplicas(), MPI_UINT64_T, MPI_SUM, MPI_COMM_WORLD);
 
-	uint64_t *histogram = this->localHistogram->getLocalHistogram();
-	for (uint32_t i = 0; i < hpcjoin::core::Configuration::NETWORK_PARTITIONING_COUNT; ++i) {
-		this->relativeWriteOffsets[i] -= histogram[i];
+	for (uint32_t i = 0; i < this->assignment->getNumberOfReplicas(); ++i) {
+		this->relativeWriteOffsets[i] -= this->localReplicaSizes[i];
 	}
 
 }
 
 void OffsetMap::computeAbsolutePrivateOffsets() {
 
-	for (uint32_t i = 0; i < hpcjoin::core::Configuration::NETWORK_PARTITIONING_COUNT; ++i) {
+	for (uint32_t i = 0; i < this->assignment->getNumberOfReplicas(); ++i) {
 		this->absoluteWriteOffsets[i] = this->baseOffsets[i] + this->relativeWriteOffsets[i];
 	}
 
 }
 
+void OffsetMap::computeSliceOffsets() {
+
+	// Each slice writes to a disjoint sub-range of the private range of this process
+	uint32_t numberOfSlices = this->localHistogram->getNumberOfSlices();
+	uint32_t numberOfReplicas = this->assignment->getNumberOfReplicas();
+	uint64_t *sliceHistograms = this->localHistogram->getSliceHistograms();
+
+	for (uint32_t p = 0; p < hpcjoin::core::Configuration::NETWORK_PARTITIONING_COUNT; ++p) {
+		uint32_t replicaStart = this->assignment->getReplicaStart(p);
+		for (uint32_t r = 0; r < this->assignment->getReplicaCount(p); ++r) {
+			uint64_t offset = this->absoluteWriteOffsets[replicaStart + r];
+			for (uint32_t s = 0; s < numberOfSlices; ++s) {
+				this->sliceWriteOffsets[s * numberOfReplicas + replicaStart + r] = offset;
+				offset += computeWindowSize(sliceHistograms[s * hpcjoin::core::Configuration::NETWORK_PARTITIONING_COUNT + p]);
+			}
+		}
+	}
+
+}
+
 uint64_t* OffsetMap::getBaseOffsets() {
 
 	return baseOffsets;
@@ -106,5 +202,53 @@ uint64_t* OffsetMap::getAbsoluteWriteOffsets() {
 
 }
 
+uint64_t* OffsetMap::getSliceWriteOffsets() {
+
+	return sliceWriteOffsets;
+
+}
+
+uint64_t* OffsetMap::getLocalReplicaHistogram() {
+
+	return localReplicaHistogram;
+
+}
+
+uint64_t* OffsetMap::getReplicaSizes() {
+
+	return replicaSizes;
+
+}
+
+uint64_t* OffsetMap::getReplicaTupleCounts() {
+
+	return replicaTupleCounts;
+
+}
+
+uint64_t OffsetMap::computeWindowSize(uint64_t numberOfTuples) {
+
+	return (this->format == NULL) ? numberOfTuples : this->format->computePackedSize(numberOfTuples);
+
+}
+
+hpcjoin::data::PackedFormat* OffsetMap::getFormat() {
+
+	return format;
+
+}
+
+hpcjoin::histograms::LocalHistogram* OffsetMap::getLocalHistogram() {
+
+	return localHistogram;
+
+}
+
+hpcjoin::histograms::AssignmentMap* OffsetMap::getAssignment() {
+
+	return assignment;
+
+}
+
 } /* namespace histograms */
 } /* namespace hpcjoin */
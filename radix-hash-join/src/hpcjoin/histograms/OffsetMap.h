@@ -12,15 +12,24 @@
 #include <hpcjoin/histograms/LocalHistogram.h>
 #include <hpcjoin/histograms/GlobalHistogram.h>
 #include <hpcjoin/histograms/AssignmentMap.h>
+#include <hpcjoin/data/PackedFormat.h>
 
 namespace hpcjoin {
 namespace histograms {
 
+/**
+ * Computes the layout of the windows. All offsets are indexed by replica (see AssignmentMap).
+ * If the relation is replicated, a process sends its tuples of a heavy partition to every
+ * replica. Otherwise, the tuples are sent to only one of the replicas (process id modulo the
+ * number of replicas). If a packed format is given, window sizes and offsets are expressed in
+ * packed words instead of tuples.
+ */
+
 class OffsetMap {
 
 public:
 
-	OffsetMap(uint32_t numberOfProcesses, hpcjoin::histograms::LocalHistogram *localHistogram, hpcjoin::histograms::GlobalHistogram *globalHistogram, hpcjoin::histograms::AssignmentMap *assignment);
+	OffsetMap(uint32_t numberOfProcesses, uint32_t processId, hpcjoin::histograms::LocalHistogram *localHistogram, hpcjoin::histograms::GlobalHistogram *globalHistogram, hpcjoin::histograms::AssignmentMap *assignment, bool replicateHeavyPartitions, hpcjoin::data::PackedFormat *format = NULL);
 	~OffsetMap();
 
 public:
@@ -32,23 +41,46 @@ public:
 	uint64_t *getBaseOffsets();
 	uint64_t *getRelativeWriteOffsets();
 	uint64_t *getAbsoluteWriteOffsets();
+	uint64_t *getSliceWriteOffsets();
+
+	uint64_t *getLocalReplicaHistogram();
+	uint64_t *getReplicaSizes();
+	uint64_t *getReplicaTupleCounts();
+	uint64_t computeWindowSize(uint64_t numberOfTuples);
+
+	hpcjoin::data::PackedFormat *getFormat();
+
+	hpcjoin::histograms::LocalHistogram *getLocalHistogram();
+	hpcjoin::histograms::AssignmentMap *getAssignment();
 
 protected:
 
+	void computeReplicaHistograms();
+	void computeReplicaSizes();
 	void computeBaseOffsets();
 	void computeRelativePrivateOffsets();
 	void computeAbsolutePrivateOffsets();
+	void computeSliceOffsets();
 
 protected:
 
 	uint32_t numberOfProcesses;
+	uint32_t processId;
 	hpcjoin::histograms::LocalHistogram *localHistogram;
 	hpcjoin::histograms::GlobalHistogram *globalHistogram;
 	hpcjoin::histograms::AssignmentMap *assignment;
+	bool replicateHeavyPartitions;
+	hpcjoin::data::PackedFormat *format;
+
+	uint64_t *localReplicaHistogram;
+	uint64_t *replicaTupleCounts;
+	uint64_t *localReplicaSizes;
+	uint64_t *replicaSizes;
 
 	uint64_t *baseOffsets;
 	uint64_t *relativeWriteOffsets;
 	uint64_t *absoluteWriteOffsets;
+	uint64_t *sliceWriteOffsets;
 
 };
 
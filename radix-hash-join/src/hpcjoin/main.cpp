@@ -15,24 +15,254 @@
 #include <stdlib.h>
 #include <unistd.h>
 #include <string.h>
+#include <algorithm>
 
 #include <hpcjoin/operators/HashJoin.h>
+#include <hpcjoin/operators/HashAggregation.h>
 #include <hpcjoin/data/Relation.h>
+#include <hpcjoin/data/Generator.h>
 #include <hpcjoin/performance/Measurements.h>
 #include <hpcjoin/core/Configuration.h>
 #include <hpcjoin/utils/Debug.h>
 #include <hpcjoin/utils/Thread.h>
+#include <hpcjoin/utils/Arguments.h>
+#include <hpcjoin/utils/Bandwidth.h>
 #include <hpcjoin/memory/Pool.h>
+#include <hpcjoin/memory/PageAllocator.h>
 #include <hpcjoin/data/Tuple.h>
+#include <hpcjoin/data/BucketHashTable.h>
+#include <hpcjoin/data/AggregationTable.h>
 
 
 int main(int argc, char *argv[]) {
 
 	JOIN_MEM_DEBUG("Main Start");
 
+	JOIN_DEBUG("Main", "Parsing arguments");
+
+	uint32_t networkFanout = 0;
+	uint32_t localFanout = 0;
+	char *innerFileName = NULL;
+	char *outerFileName = NULL;
+
+	bool useGenerator = false;
+	uint64_t seed = 1234;
+	uint32_t duplicates = 1;
+	double zipfExponent = 0;
+	double matchRate = 1.0;
+	tuple_order_t order = ORDER_RANDOM;
+
+	uint64_t innerRelationSize = 0;
+	uint64_t outerRelationSize = 0;
+	char *experimentTag = (char *) "experiment";
+	uint32_t warmupIterations = 0;
+	uint32_t measuredIterations = 1;
+
+	bool automaticTupleFormat = true;
+	bool aggregateOuterRelation = false;
+
+	// Options from configuration files are parsed first
+	int numberOfArguments = 0;
+	char **arguments = NULL;
+	hpcjoin::utils::Arguments::expand(argc, argv, &numberOfArguments, &arguments);
+
+	int option = -1;
+	while ((option = getopt(numberOfArguments, arguments, "t:a:r:mG:AB:n:l:b:fpqdw:g:i:o:s:z:k:u:c:I:O:e:W:N:C:T:")) != -1) {
+		switch (option) {
+			case 't':
+				hpcjoin::core::Configuration::THREADS_PER_NODE = atoi(optarg);
+				break;
+			case 'a':
+				if (strcmp(optarg, "cost") == 0) {
+					hpcjoin::core::Configuration::ASSIGNMENT_POLICY = ASSIGNMENT_COST_BASED;
+				} else if (strcmp(optarg, "rr") == 0) {
+					hpcjoin::core::Configuration::ASSIGNMENT_POLICY = ASSIGNMENT_ROUND_ROBIN;
+				} else {
+					fprintf(stderr, "Unknown assignment policy %s\n", optarg);
+					exit(-1);
+				}
+				break;
+			case 'r':
+				hpcjoin::core::Configuration::ENABLE_HEAVY_PARTITION_REPLICATION = (atoi(optarg) != 0);
+				break;
+			case 'm':
+				hpcjoin::core::Configuration::MATERIALIZE_RESULTS = true;
+				break;
+			case 'G':
+				hpcjoin::core::Configuration::AGGREGATION_GROUPS = atoi(optarg);
+				break;
+			case 'A':
+				aggregateOuterRelation = true;
+				break;
+			case 'B':
+				if (strcmp(optarg, "auto") == 0) {
+					hpcjoin::core::Configuration::JOIN_STRATEGY = JOIN_STRATEGY_AUTO;
+				} else if (strcmp(optarg, "shuffle") == 0) {
+					hpcjoin::core::Configuration::JOIN_STRATEGY = JOIN_STRATEGY_SHUFFLE;
+				} else if (strcmp(optarg, "broadcast") == 0) {
+					hpcjoin::core::Configuration::JOIN_STRATEGY = JOIN_STRATEGY_BROADCAST;
+				} else {
+					fprintf(stderr, "Unknown join strategy %s\n", optarg);
+					exit(-1);
+				}
+				break;
+			case 'b':
+				if (strcmp(optarg, "chain") == 0) {
+					hpcjoin::core::Configuration::HASH_TABLE_LAYOUT = HASH_TABLE_CHAINED;
+				} else if (strcmp(optarg, "bucket") == 0) {
+					hpcjoin::core::Configuration::HASH_TABLE_LAYOUT = HASH_TABLE_BUCKETIZED;
+				} else if (strcmp(optarg, "bucket-scalar") == 0) {
+					hpcjoin::core::Configuration::HASH_TABLE_LAYOUT = HASH_TABLE_BUCKETIZED_SCALAR;
+				} else {
+					fprintf(stderr, "Unknown hash table layout %s\n", optarg);
+					exit(-1);
+				}
+				break;
+			case 'f':
+				hpcjoin::core::Configuration::ENABLE_BLOOM_FILTER = true;
+				break;
+			case 'p':
+				hpcjoin::core::Configuration::ENABLE_PACKED_TRANSFERS = true;
+				break;
+			case 'q':
+				hpcjoin::core::Configuration::ENABLE_REQUEST_BASED_PUTS = true;
+				break;
+			case 'd':
+				hpcjoin::core::Configuration::RELEASE_POOL_PAGES = true;
+				break;
+			case 'w':
+				hpcjoin::core::Configuration::MEMORY_BUFFERS_PER_PARTITION = atoi(optarg);
+				break;
+			case 'g':
+				if (strcmp(optarg, "none") == 0) {
+					hpcjoin::core::Configuration::HUGE_PAGE_POLICY = HUGE_PAGES_NONE;
+				} else if (strcmp(optarg, "thp") == 0) {
+					hpcjoin::core::Configuration::HUGE_PAGE_POLICY = HUGE_PAGES_TRANSPARENT;
+				} else if (strcmp(optarg, "2m") == 0) {
+					hpcjoin::core::Configuration::HUGE_PAGE_POLICY = HUGE_PAGES_2MB;
+				} else if (strcmp(optarg, "1g") == 0) {
+					hpcjoin::core::Configuration::HUGE_PAGE_POLICY = HUGE_PAGES_1GB;
+				} else {
+					fprintf(stderr, "Unknown huge page policy %s\n", optarg);
+					exit(-1);
+				}
+				break;
+			case 'i':
+				innerFileName = optarg;
+				break;
+			case 'o':
+				outerFileName = optarg;
+				break;
+			case 'n':
+				networkFanout = atoi(optarg);
+				break;
+			case 'l':
+				localFanout = atoi(optarg);
+				break;
+			case 's':
+				seed = strtoull(optarg, NULL, 10);
+				useGenerator = true;
+				break;
+			case 'z':
+				zipfExponent = atof(optarg);
+				useGenerator = true;
+				break;
+			case 'k':
+				matchRate = atof(optarg);
+				useGenerator = true;
+				break;
+			case 'u':
+				duplicates = atoi(optarg);
+				useGenerator = true;
+				break;
+			case 'c':
+				if (strcmp(optarg, "random") == 0) {
+					order = ORDER_RANDOM;
+				} else if (strcmp(optarg, "sorted") == 0) {
+					order = ORDER_SORTED;
+				} else if (strcmp(optarg, "clustered") == 0) {
+					order = ORDER_CLUSTERED;
+				} else {
+					fprintf(stderr, "Unknown tuple order %s\n", optarg);
+					exit(-1);
+				}
+				useGenerator = true;
+				break;
+			case 'I':
+				innerRelationSize = strtoull(optarg, NULL, 10);
+				break;
+			case 'O':
+				outerRelationSize = strtoull(optarg, NULL, 10);
+				break;
+			case 'e':
+				experimentTag = optarg;
+				break;
+			case 'W':
+				warmupIterations = atoi(optarg);
+				break;
+			case 'N':
+				measuredIterations = atoi(optarg);
+				break;
+			case 'C':
+				// Configuration files have already been expanded
+				break;
+			case 'T':
+				automaticTupleFormat = (strcmp(optarg, "auto") == 0);
+				if (strcmp(optarg, "compressed") == 0) {
+					hpcjoin::core::Configuration::TUPLE_FORMAT = TUPLE_FORMAT_COMPRESSED;
+				} else if (strcmp(optarg, "wide") == 0) {
+					hpcjoin::core::Configuration::TUPLE_FORMAT = TUPLE_FORMAT_WIDE;
+				} else if (strcmp(optarg, "narrow") == 0) {
+					hpcjoin::core::Configuration::TUPLE_FORMAT = TUPLE_FORMAT_NARROW;
+				} else if (!automaticTupleFormat) {
+					fprintf(stderr, "Unknown tuple format %s\n", optarg);
+					exit(-1);
+				}
+				break;
+			default:
+				fprintf(stderr, "Usage: %s [-t <threads per node>] [-a <rr|cost>] [-r <0|1>] [-m] [-G <groups>] [-A] [-B <auto|shuffle|broadcast>] [-n <network fan-out>] [-l <local fan-out>] [-b <chain|bucket|bucket-scalar>] [-f] [-p] [-q] [-d] [-w <buffers per partition>] [-g <none|thp|2m|1g>] [-i <inner relation file>] [-o <outer relation file>] [-s <seed>] [-z <zipf exponent>] [-k <match rate>] [-u <duplicates>] [-c <random|sorted|clustered>] [-I <inner tuples>] [-O <outer tuples>] [-e <experiment tag>] [-W <warm-up iterations>] [-N <measured iterations>] [-C <configuration file>] [-T <auto|narrow|compressed|wide>]\n", argv[0]);
+				exit(-1);
+		}
+	}
+
+	if (hpcjoin::core::Configuration::THREADS_PER_NODE == 0) {
+		fprintf(stderr, "At least one thread per node is required\n");
+		exit(-1);
+	}
+
+	if ((networkFanout != 0 && (networkFanout < hpcjoin::core::Configuration::MIN_PARTITIONING_FANOUT || networkFanout > hpcjoin::core::Configuration::MAX_PARTITIONING_FANOUT))
+			|| (localFanout != 0 && (localFanout < hpcjoin::core::Configuration::MIN_PARTITIONING_FANOUT || localFanout > hpcjoin::core::Configuration::MAX_PARTITIONING_FANOUT))) {
+		fprintf(stderr, "Fan-outs need to be between %u and %u bits\n", hpcjoin::core::Configuration::MIN_PARTITIONING_FANOUT, hpcjoin::core::Configuration::MAX_PARTITIONING_FANOUT);
+		exit(-1);
+	}
+
+	if (hpcjoin::core::Configuration::MEMORY_BUFFERS_PER_PARTITION < 1 || hpcjoin::core::Configuration::MEMORY_BUFFERS_PER_PARTITION > hpcjoin::core::Configuration::MAX_MEMORY_BUFFERS_PER_PARTITION) {
+		fprintf(stderr, "Number of buffers per partition needs to be between 1 and %u\n", hpcjoin::core::Configuration::MAX_MEMORY_BUFFERS_PER_PARTITION);
+		exit(-1);
+	}
+
+	if (zipfExponent < 0 || matchRate < 0 || matchRate > 1 || duplicates < 1) {
+		fprintf(stderr, "Invalid workload: the Zipf exponent needs to be positive, the match rate between 0 and 1 and keys need to appear at least once\n");
+		exit(-1);
+	}
+
+	if (measuredIterations < 1) {
+		fprintf(stderr, "At least one measured iteration is required\n");
+		exit(-1);
+	}
+
+	// Partial groups of the same key need to end up on the same process
+	if (aggregateOuterRelation) {
+		hpcjoin::core::Configuration::ENABLE_HEAVY_PARTITION_REPLICATION = false;
+		hpcjoin::core::Configuration::ENABLE_BLOOM_FILTER = false;
+	}
+
 	JOIN_DEBUG("Main", "Initializing MPI");
 
-	MPI_Init(NULL, NULL);
+	// Network partitioning threads issue MPI calls concurrently
+	int requiredThreadSupport = (hpcjoin::core::Configuration::THREADS_PER_NODE > 1) ? MPI_THREAD_MULTIPLE : MPI_THREAD_SINGLE;
+	int providedThreadSupport = MPI_THREAD_SINGLE;
+	MPI_Init_thread(NULL, NULL, requiredThreadSupport, &providedThreadSupport);
 
 #ifdef USE_FOMPI
 	foMPI_Init(NULL, NULL);
@@ -46,11 +276,42 @@ int main(int argc, char *argv[]) {
 	MPI_Comm_size(MPI_COMM_WORLD, &numberOfNodes);
 	MPI_Comm_rank(MPI_COMM_WORLD, &nodeId);
 
+	// Fall back to a single network partitioning thread if MPI is not thread-safe (foMPI also lacks request-based puts)
+#ifdef USE_FOMPI
+	hpcjoin::core::Configuration::NETWORK_THREADS_PER_NODE = 1;
+	hpcjoin::core::Configuration::ENABLE_REQUEST_BASED_PUTS = false;
+#else
+	hpcjoin::core::Configuration::NETWORK_THREADS_PER_NODE = (providedThreadSupport == MPI_THREAD_MULTIPLE) ? hpcjoin::core::Configuration::THREADS_PER_NODE : 1;
+#endif
+
+	// Processes sharing a machine are pinned to disjoint sets of cores
+	MPI_Comm localCommunicator;
+	int32_t localNodeId = -1;
+	MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, nodeId, MPI_INFO_NULL, &localCommunicator);
+	MPI_Comm_rank(localCommunicator, &localNodeId);
+	MPI_Comm_free(&localCommunicator);
+	hpcjoin::core::Configuration::FIRST_CORE_ID = localNodeId * hpcjoin::core::Configuration::THREADS_PER_NODE;
+
 	JOIN_DEBUG("Main", "Node %d is preparing performance counters", nodeId);
-	hpcjoin::performance::Measurements::init(nodeId, numberOfNodes, "experiment");
+	hpcjoin::performance::Measurements::init(nodeId, numberOfNodes, experimentTag);
 
 	hpcjoin::performance::Measurements::writeMetaData("NUMNODES", numberOfNodes);
 	hpcjoin::performance::Measurements::writeMetaData("NODEID", nodeId);
+	hpcjoin::performance::Measurements::writeMetaData("WARMUP", warmupIterations);
+	hpcjoin::performance::Measurements::writeMetaData("ITERATIONS", measuredIterations);
+	hpcjoin::performance::Measurements::writeMetaData("THREADS", hpcjoin::core::Configuration::THREADS_PER_NODE);
+	hpcjoin::performance::Measurements::writeMetaData("NETTHREADS", hpcjoin::core::Configuration::NETWORK_THREADS_PER_NODE);
+	hpcjoin::performance::Measurements::writeMetaData("ASSIGNMENT", (char *) ((hpcjoin::core::Configuration::ASSIGNMENT_POLICY == ASSIGNMENT_COST_BASED) ? "cost" : "rr"));
+	hpcjoin::performance::Measurements::writeMetaData("HASHTABLE", (char *) ((hpcjoin::core::Configuration::HASH_TABLE_LAYOUT == HASH_TABLE_CHAINED) ? "chain" : ((hpcjoin::core::Configuration::HASH_TABLE_LAYOUT == HASH_TABLE_BUCKETIZED) ? "bucket" : "bucket-scalar")));
+	hpcjoin::performance::Measurements::writeMetaData("SIMD", (char *) ((hpcjoin::data::BucketHashTable<hpcjoin::data::CompressedTuple>::getSimdLevel() == hpcjoin::data::SIMD_AVX512) ? "avx512" : ((hpcjoin::data::BucketHashTable<hpcjoin::data::CompressedTuple>::getSimdLevel() == hpcjoin::data::SIMD_AVX2) ? "avx2" : "scalar")));
+	hpcjoin::performance::Measurements::writeMetaData("OPERATOR", (char *) (aggregateOuterRelation ? "aggregation" : "join"));
+	hpcjoin::performance::Measurements::writeMetaData("MATERIALIZE", (uint64_t) hpcjoin::core::Configuration::MATERIALIZE_RESULTS);
+	hpcjoin::performance::Measurements::writeMetaData("GROUPS", hpcjoin::core::Configuration::AGGREGATION_GROUPS);
+	hpcjoin::performance::Measurements::writeMetaData("BLOOMFILTER", (uint64_t) hpcjoin::core::Configuration::ENABLE_BLOOM_FILTER);
+	hpcjoin::performance::Measurements::writeMetaData("PACKED", (uint64_t) hpcjoin::core::Configuration::ENABLE_PACKED_TRANSFERS);
+	hpcjoin::performance::Measurements::writeMetaData("RPUT", (uint64_t) hpcjoin::core::Configuration::ENABLE_REQUEST_BASED_PUTS);
+	hpcjoin::performance::Measurements::writeMetaData("RELPOOL", (uint64_t) hpcjoin::core::Configuration::RELEASE_POOL_PAGES);
+	hpcjoin::performance::Measurements::writeMetaData("NETBUFFERS", hpcjoin::core::Configuration::MEMORY_BUFFERS_PER_PARTITION);
 
 	char hostname[1024];
 	memset(hostname, 0, 1024);
@@ -66,8 +327,31 @@ int main(int argc, char *argv[]) {
 
 	JOIN_MEM_DEBUG("Init Completed");
 
-	uint64_t globalInnerRelationSize = ((uint64_t) numberOfNodes) * 200000;
-	uint64_t globalOuterRelationSize = ((uint64_t) numberOfNodes) * 200000;
+	uint64_t globalInnerRelationSize = (innerRelationSize != 0) ? innerRelationSize : ((uint64_t) numberOfNodes) * 200000;
+	uint64_t globalOuterRelationSize = (outerRelationSize != 0) ? outerRelationSize : ((uint64_t) numberOfNodes) * 200000;
+
+	// Relations loaded from files determine the sizes
+	if (innerFileName != NULL) {
+		globalInnerRelationSize = hpcjoin::data::Relation::readNumberOfTuples(innerFileName);
+	}
+	if (outerFileName != NULL) {
+		globalOuterRelationSize = hpcjoin::data::Relation::readNumberOfTuples(outerFileName);
+	}
+	if (globalInnerRelationSize == RELATION_FILE_INVALID_SIZE || globalOuterRelationSize == RELATION_FILE_INVALID_SIZE) {
+		if (nodeId == 0) {
+			fprintf(stderr, "Could not read relation file header\n");
+		}
+		MPI_Finalize();
+		exit(-1);
+	}
+
+	if (hpcjoin::core::Configuration::JOIN_STRATEGY == JOIN_STRATEGY_BROADCAST && globalInnerRelationSize > hpcjoin::core::Configuration::MAX_BROADCAST_TUPLES) {
+		if (nodeId == 0) {
+			fprintf(stderr, "The inner relation is too large to be broadcast\n");
+		}
+		MPI_Finalize();
+		exit(-1);
+	}
 
 	uint64_t localInnerRelationSize =
 			(nodeId < numberOfNodes - 1) ? (globalInnerRelationSize / numberOfNodes) : (globalInnerRelationSize - (numberOfNodes - 1) * (globalInnerRelationSize / numberOfNodes));
@@ -80,56 +364,227 @@ int main(int argc, char *argv[]) {
 	hpcjoin::performance::Measurements::writeMetaData("LISZ", localInnerRelationSize);
 	hpcjoin::performance::Measurements::writeMetaData("LOSZ", localOuterRelationSize);
 
-	hpcjoin::memory::Pool::allocate(hpcjoin::core::Configuration::ALLOCATION_FACTOR * (localInnerRelationSize+localOuterRelationSize) * sizeof(hpcjoin::data::Tuple));
-	hpcjoin::data::Relation *innerRelation = new hpcjoin::data::Relation(localInnerRelationSize, globalInnerRelationSize);
-	hpcjoin::data::Relation *outerRelation = new hpcjoin::data::Relation(localOuterRelationSize, globalOuterRelationSize);
-
-	JOIN_MEM_DEBUG("Relations created");
-
-	srand(1234+nodeId);
-	innerRelation->fillUniqueValues(nodeId * (globalInnerRelationSize / numberOfNodes), nodeId * (globalInnerRelationSize / numberOfNodes));
-	outerRelation->fillUniqueValues((numberOfNodes - nodeId - 1) * (globalOuterRelationSize / numberOfNodes), nodeId * (globalOuterRelationSize / numberOfNodes));
-	//outerRelation->fillModuloValues((numberOfNodes - nodeId - 1) * (globalInnerRelationSize / numberOfNodes), nodeId * (globalOuterRelationSize / numberOfNodes), innerRelation->getLocalSize());
-
-	if (numberOfNodes > 1) {
-		innerRelation->distribute(nodeId, numberOfNodes);
-		outerRelation->distribute(nodeId, numberOfNodes);
+	// Fan-outs not given on the command line are derived from the data size and the caches.
+	// All processes use the values selected by the aggregation node.
+	hpcjoin::core::Configuration::selectPartitioningFanouts(globalInnerRelationSize, numberOfNodes);
+	uint32_t fanouts[2];
+	fanouts[0] = (networkFanout != 0) ? networkFanout : hpcjoin::core::Configuration::NETWORK_PARTITIONING_FANOUT;
+	fanouts[1] = (localFanout != 0) ? localFanout : hpcjoin::core::Configuration::LOCAL_PARTITIONING_FANOUT;
+	MPI_Bcast(fanouts, 2, MPI_UINT32_T, hpcjoin::core::Configuration::RESULT_AGGREGATION_NODE, MPI_COMM_WORLD);
+	hpcjoin::core::Configuration::setPartitioningFanouts(fanouts[0], fanouts[1]);
+
+	hpcjoin::performance::Measurements::writeMetaData("NETFANOUT", hpcjoin::core::Configuration::NETWORK_PARTITIONING_FANOUT);
+	hpcjoin::performance::Measurements::writeMetaData("LOCALFANOUT", hpcjoin::core::Configuration::LOCAL_PARTITIONING_FANOUT);
+
+	// The aggregation additionally holds the partial counts and sums next to its input
+	uint64_t poolTuples = localInnerRelationSize + localOuterRelationSize + (aggregateOuterRelation ? 2 * localOuterRelationSize : 0);
+	hpcjoin::memory::Pool::allocate(hpcjoin::core::Configuration::ALLOCATION_FACTOR * poolTuples * sizeof(hpcjoin::data::Tuple));
+	hpcjoin::performance::Measurements::writeMetaData("NUMANODES", hpcjoin::memory::Pool::getNumberOfArenas());
+
+	// The automatic choice between shuffle and broadcast join depends on the measured bandwidths
+	if (hpcjoin::core::Configuration::JOIN_STRATEGY == JOIN_STRATEGY_AUTO && numberOfNodes > 1 && !aggregateOuterRelation) {
+		hpcjoin::core::Configuration::NETWORK_BANDWIDTH = hpcjoin::utils::Bandwidth::measureNetworkBandwidth(numberOfNodes);
+		hpcjoin::core::Configuration::MEMORY_BANDWIDTH = hpcjoin::utils::Bandwidth::measureMemoryBandwidth();
+		hpcjoin::performance::Measurements::writeMetaData("NETBW", (uint64_t) (hpcjoin::core::Configuration::NETWORK_BANDWIDTH / (1024 * 1024)));
+		hpcjoin::performance::Measurements::writeMetaData("MEMBW", (uint64_t) (hpcjoin::core::Configuration::MEMORY_BANDWIDTH / (1024 * 1024)));
+		JOIN_DEBUG("Main", "Network bandwidth %.0f MB/s, memory bandwidth %.0f MB/s", hpcjoin::core::Configuration::NETWORK_BANDWIDTH / (1024 * 1024), hpcjoin::core::Configuration::MEMORY_BANDWIDTH / (1024 * 1024));
 	}
 
-	//innerRelation->debugKeyPrint();
-	//outerRelation->debugKeyPrint();
-
-	JOIN_MEM_DEBUG("Relations distributed");
-
-	JOIN_DEBUG("Main", "Node %d is preparing join", nodeId);
-
-	hpcjoin::operators::HashJoin *hashJoin = new hpcjoin::operators::HashJoin(numberOfNodes, nodeId, innerRelation, outerRelation);
-	JOIN_MEM_DEBUG("Join created");
-
-	MPI_Barrier(MPI_COMM_WORLD);
-
-	JOIN_DEBUG("Main", "Node %d is starting join", nodeId);
-
-	JOIN_MEM_DEBUG("Join Start");
-	hashJoin->join();
-	JOIN_MEM_DEBUG("Join Stop");
+	// The generator writes every stripe in place, there is no need to redistribute the data
+	hpcjoin::data::Generator *generator = NULL;
+	if (useGenerator) {
+		generator = new hpcjoin::data::Generator(seed, hpcjoin::core::Configuration::THREADS_PER_NODE);
+		char workload[64];
+		snprintf(workload, 64, "%.3f", zipfExponent);
+		hpcjoin::performance::Measurements::writeMetaData("ZIPF", workload);
+		snprintf(workload, 64, "%.3f", matchRate);
+		hpcjoin::performance::Measurements::writeMetaData("MATCHRATE", workload);
+		hpcjoin::performance::Measurements::writeMetaData("SEED", seed);
+		hpcjoin::performance::Measurements::writeMetaData("DUPLICATES", duplicates);
+		hpcjoin::performance::Measurements::writeMetaData("ORDER", (char *) ((order == ORDER_SORTED) ? "sorted" : ((order == ORDER_CLUSTERED) ? "clustered" : "random")));
+	}
+	uint64_t numberOfDistinctKeys = (globalInnerRelationSize + duplicates - 1) / duplicates;
+
+	// Warm-up iterations are not reported, the files contain the details of the last iteration
+	for (uint32_t iteration = 0; iteration < warmupIterations + measuredIterations; ++iteration) {
+
+		JOIN_DEBUG("Main", "Node %d is starting iteration %d", nodeId, iteration);
+
+		// The data of the previous iteration has been released
+		hpcjoin::memory::Pool::reset();
+		hpcjoin::performance::Measurements::reset();
+
+		hpcjoin::data::Relation *innerRelation = new hpcjoin::data::Relation(localInnerRelationSize, globalInnerRelationSize);
+		hpcjoin::data::Relation *outerRelation = new hpcjoin::data::Relation(localOuterRelationSize, globalOuterRelationSize);
+
+		JOIN_MEM_DEBUG("Relations created");
+
+		// Default data is shuffled between the processes, data loaded from a file is read in stripes
+		srand(1234+nodeId);
+		bool relationsLoaded = true;
+		if (innerFileName != NULL) {
+			relationsLoaded = innerRelation->loadFromFile(innerFileName, nodeId, numberOfNodes) && relationsLoaded;
+		} else if (generator != NULL) {
+			generator->generatePrimaryKeys(innerRelation, nodeId, numberOfNodes, duplicates);
+			generator->reorder(innerRelation, order);
+		} else {
+			innerRelation->fillUniqueValues(nodeId * (globalInnerRelationSize / numberOfNodes), nodeId * (globalInnerRelationSize / numberOfNodes));
+			if (numberOfNodes > 1) {
+				innerRelation->distribute(nodeId, numberOfNodes);
+			}
+		}
+		if (outerFileName != NULL) {
+			relationsLoaded = outerRelation->loadFromFile(outerFileName, nodeId, numberOfNodes) && relationsLoaded;
+		} else if (generator != NULL) {
+			if (zipfExponent > 0) {
+				generator->generateZipfKeys(outerRelation, nodeId, numberOfNodes, numberOfDistinctKeys, zipfExponent, matchRate);
+			} else {
+				generator->generateForeignKeys(outerRelation, nodeId, numberOfNodes, numberOfDistinctKeys, matchRate);
+			}
+			generator->reorder(outerRelation, order);
+		} else {
+			outerRelation->fillUniqueValues((numberOfNodes - nodeId - 1) * (globalOuterRelationSize / numberOfNodes), nodeId * (globalOuterRelationSize / numberOfNodes));
+			//outerRelation->fillModuloValues((numberOfNodes - nodeId - 1) * (globalInnerRelationSize / numberOfNodes), nodeId * (globalOuterRelationSize / numberOfNodes), innerRelation->getLocalSize());
+			if (numberOfNodes > 1) {
+				outerRelation->distribute(nodeId, numberOfNodes);
+			}
+		}
+
+		if (!relationsLoaded) {
+			if (nodeId == 0) {
+				fprintf(stderr, "Could not read relation file\n");
+			}
+			MPI_Finalize();
+			exit(-1);
+		}
+
+		//innerRelation->debugKeyPrint();
+		//outerRelation->debugKeyPrint();
+
+		JOIN_MEM_DEBUG("Relations distributed");
+
+		// The tuple format depends on the largest keys and rids of all processes
+		if (automaticTupleFormat || hpcjoin::core::Configuration::TUPLE_FORMAT != TUPLE_FORMAT_WIDE) {
+			tuple_format_t requestedTupleFormat = hpcjoin::core::Configuration::TUPLE_FORMAT;
+			uint64_t maximumValues[4];
+			innerRelation->computeMaximumValues(&(maximumValues[0]), &(maximumValues[1]));
+			outerRelation->computeMaximumValues(&(maximumValues[2]), &(maximumValues[3]));
+			MPI_Allreduce(MPI_IN_PLACE, maximumValues, 4, MPI_UINT64_T, MPI_MAX, MPI_COMM_WORLD);
+			hpcjoin::core::Configuration::selectTupleFormat(std::max(maximumValues[0], maximumValues[2]), std::max(maximumValues[1], maximumValues[3]), automaticTupleFormat);
+			if (!automaticTupleFormat && hpcjoin::core::Configuration::TUPLE_FORMAT != requestedTupleFormat && nodeId == 0) {
+				fprintf(stderr, "Requested tuple format cannot hold key %lu and rid %lu, using %s tuples\n", std::max(maximumValues[0], maximumValues[2]), std::max(maximumValues[1], maximumValues[3]),
+						(hpcjoin::core::Configuration::TUPLE_FORMAT == TUPLE_FORMAT_WIDE) ? "wide" : "compressed");
+			}
+		}
+
+		if (aggregateOuterRelation) {
+
+			JOIN_DEBUG("Main", "Node %d is preparing aggregation", nodeId);
+
+			delete innerRelation;
+			hpcjoin::operators::HashAggregation *hashAggregation = new hpcjoin::operators::HashAggregation(numberOfNodes, nodeId, outerRelation);
+
+			MPI_Barrier(MPI_COMM_WORLD);
+
+			hashAggregation->aggregate();
+
+			JOIN_DEBUG("Main", "Node %d finished aggregation", nodeId);
+
+			// Number of groups, total count and total sum
+			uint64_t totals[3] = { hashAggregation->getNumberOfGroups(), 0, 0 };
+			for (uint64_t g = 0; g < hashAggregation->getNumberOfGroups(); ++g) {
+				totals[1] += hashAggregation->getGroups()[g].count;
+				totals[2] += hashAggregation->getGroups()[g].sum;
+			}
+			if (nodeId == hpcjoin::core::Configuration::RESULT_AGGREGATION_NODE) {
+				MPI_Reduce(MPI_IN_PLACE, totals, 3, MPI_UINT64_T, MPI_SUM, hpcjoin::core::Configuration::RESULT_AGGREGATION_NODE, MPI_COMM_WORLD);
+			} else {
+				MPI_Reduce(totals, NULL, 3, MPI_UINT64_T, MPI_SUM, hpcjoin::core::Configuration::RESULT_AGGREGATION_NODE, MPI_COMM_WORLD);
+			}
+
+			if (iteration >= warmupIterations) {
+				if (nodeId != hpcjoin::core::Configuration::RESULT_AGGREGATION_NODE) {
+					hpcjoin::performance::Measurements::sendMeasurementsToAggregator();
+				} else {
+					hpcjoin::performance::Measurements::printMeasurements(numberOfNodes, nodeId);
+					printf("[RESULTS] Aggregation:\t%lu\t%lu\t%lu\n", totals[0], totals[1], totals[2]);
+				}
+			}
+
+			delete hashAggregation;
+			// OPTIMIZATION outerRelation deleted during aggregation
+			continue;
+
+		}
+
+		JOIN_DEBUG("Main", "Node %d is preparing join", nodeId);
+
+		hpcjoin::operators::HashJoin *hashJoin = new hpcjoin::operators::HashJoin(numberOfNodes, nodeId, innerRelation, outerRelation);
+		JOIN_MEM_DEBUG("Join created");
+
+		MPI_Barrier(MPI_COMM_WORLD);
+
+		JOIN_DEBUG("Main", "Node %d is starting join", nodeId);
+
+		JOIN_MEM_DEBUG("Join Start");
+		hashJoin->join();
+		JOIN_MEM_DEBUG("Join Stop");
+
+		JOIN_DEBUG("Main", "Node %d finished join", nodeId);
+
+		if (hpcjoin::core::Configuration::MATERIALIZE_RESULTS) {
+			uint64_t numberOfResults = 0;
+			for (hpcjoin::data::JoinResult::Iterator it(hashJoin->getResult()); it.hasNext(); it.next()) {
+				++numberOfResults;
+			}
+			JOIN_DEBUG("Main", "Node %d materialized %lu results", nodeId, numberOfResults);
+		}
+
+		MPI_Barrier(MPI_COMM_WORLD);
+
+		if (iteration >= warmupIterations) {
+			if (nodeId != hpcjoin::core::Configuration::RESULT_AGGREGATION_NODE) {
+				hpcjoin::performance::Measurements::sendMeasurementsToAggregator();
+			} else {
+				hpcjoin::performance::Measurements::printMeasurements(numberOfNodes, nodeId);
+				if (hpcjoin::core::Configuration::AGGREGATION_GROUPS > 0) {
+					// Groups which received at least one match, total count and total sum
+					hpcjoin::data::AggregationTable *aggregation = hashJoin->getAggregation();
+					uint32_t numberOfGroups = 0;
+					uint64_t totalCount = 0;
+					uint64_t totalSum = 0;
+					for (uint32_t g = 0; g < aggregation->getNumberOfGroups(); ++g) {
+						numberOfGroups += (aggregation->getAggregate(g)->count > 0) ? 1 : 0;
+						totalCount += aggregation->getAggregate(g)->count;
+						totalSum += aggregation->getAggregate(g)->sum;
+					}
+					printf("[RESULTS] Aggregation:\t%u\t%lu\t%lu\n", numberOfGroups, totalCount, totalSum);
+				}
+			}
+		}
+
+		delete hashJoin;
+		// OPTIMIZATION innerRelation deleted during join
+		// OPTIMIZATION outerRelation deleted during join
 
-	JOIN_DEBUG("Main", "Node %d finished join", nodeId);
+	}
+	delete generator;
 
-	MPI_Barrier(MPI_COMM_WORLD);
+	if (nodeId == hpcjoin::core::Configuration::RESULT_AGGREGATION_NODE) {
+		hpcjoin::performance::Measurements::printStatistics();
+	}
 
 	JOIN_DEBUG("Main", "Node %d finalizing measurements", nodeId);
 
-	if (nodeId != hpcjoin::core::Configuration::RESULT_AGGREGATION_NODE) {
-		hpcjoin::performance::Measurements::sendMeasurementsToAggregator();
-	} else {
-		hpcjoin::performance::Measurements::printMeasurements(numberOfNodes, nodeId);
+	if (!aggregateOuterRelation) {
+		hpcjoin::performance::Measurements::writeMetaData("STRATEGY", (char *) ((hpcjoin::operators::HashJoin::STRATEGY == JOIN_STRATEGY_BROADCAST) ? "broadcast" : "shuffle"));
 	}
-	hpcjoin::performance::Measurements::storeAllMeasurements();
+	hpcjoin::performance::Measurements::writeMetaData("TUPLES", (char *) ((hpcjoin::core::Configuration::TUPLE_FORMAT == TUPLE_FORMAT_WIDE) ? "wide" : ((hpcjoin::core::Configuration::TUPLE_FORMAT == TUPLE_FORMAT_NARROW) ? "narrow" : "compressed")));
+	hpcjoin::performance::Measurements::writeMetaData("HPPOOL", hpcjoin::memory::PageAllocator::getBackingName(hpcjoin::memory::PageAllocator::getRegionBacking(PAGE_REGION_POOL)));
+	hpcjoin::performance::Measurements::writeMetaData("HPWINDOW", hpcjoin::memory::PageAllocator::getBackingName(hpcjoin::memory::PageAllocator::getRegionBacking(PAGE_REGION_WINDOW)));
+	hpcjoin::performance::Measurements::writeMetaData("HPNETBUF", hpcjoin::memory::PageAllocator::getBackingName(hpcjoin::memory::PageAllocator::getRegionBacking(PAGE_REGION_NETWORK_BUFFER)));
 
-	delete hashJoin;
-	// OPTIMIZATION innerRelation deleted during join
-	// OPTIMIZATION outerRelation deleted during join
+	hpcjoin::performance::Measurements::storeAllMeasurements();
 
 #ifdef USE_FOMPI
 	foMPI_Finalize();
@@ -0,0 +1,80 @@
+/**
+ * @author  Claude Barthels <claudeb@inf.ethz.ch>
+ * (c) 2016, ETH Zurich, Systems Group
+ *
+ */
+
+#include "HashTableArena.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <hpcjoin/core/Configuration.h>
+#include <hpcjoin/data/BucketHashTable.h>
+#include <hpcjoin/tasks/BuildProbe.h>
+#include <hpcjoin/utils/Debug.h>
+
+namespace hpcjoin {
+namespace memory {
+
+HashTableArena::HashTableArena() {
+
+	for (uint32_t r = 0; r < ARENA_NUMBER_OF_REGIONS; ++r) {
+		this->regions[r] = NULL;
+		this->regionSizes[r] = 0;
+	}
+
+}
+
+HashTableArena::~HashTableArena() {
+
+	for (uint32_t r = 0; r < ARENA_NUMBER_OF_REGIONS; ++r) {
+		free(this->regions[r]);
+	}
+
+}
+
+template<typename TUPLE>
+void HashTableArena::reserve(uint64_t numberOfElements) {
+
+	if (hpcjoin::core::Configuration::HASH_TABLE_LAYOUT == HASH_TABLE_CHAINED) {
+		getMemory(ARENA_CHAIN_BUCKETS, hpcjoin::tasks::BuildProbe<TUPLE>::computeNumberOfBuckets(numberOfElements) * sizeof(uint64_t));
+		getMemory(ARENA_CHAIN_NEXT, numberOfElements * sizeof(uint64_t));
+	} else {
+		uint64_t numberOfBuckets = hpcjoin::data::BucketHashTable<TUPLE>::computeNumberOfBuckets(numberOfElements);
+		getMemory(ARENA_BUCKETS, numberOfBuckets * hpcjoin::core::Configuration::CACHELINE_SIZE_BYTES);
+		getMemory(ARENA_BUCKET_SIZES, numberOfBuckets * sizeof(uint8_t));
+		getMemory(ARENA_OVERFLOW_HEADS, numberOfBuckets * sizeof(uint32_t));
+	}
+
+}
+
+void* HashTableArena::getMemory(arena_region_t region, uint64_t size) {
+
+	if (size > this->regionSizes[region]) {
+		// The content does not need to be preserved
+		free(this->regions[region]);
+		int result = posix_memalign(&(this->regions[region]), hpcjoin::core::Configuration::CACHELINE_SIZE_BYTES, size);
+		JOIN_ASSERT(result == 0, "Hash Table Arena", "Could not allocate region %d", region);
+		JOIN_UNUSED(result);
+		this->regionSizes[region] = size;
+	}
+
+	return this->regions[region];
+
+}
+
+void* HashTableArena::getClearedMemory(arena_region_t region, uint64_t size) {
+
+	void *memory = getMemory(region, size);
+	memset(memory, 0, size);
+	return memory;
+
+}
+
+template void HashTableArena::reserve<hpcjoin::data::CompressedTuple>(uint64_t numberOfElements);
+template void HashTableArena::reserve<hpcjoin::data::WideCompressedTuple>(uint64_t numberOfElements);
+template void HashTableArena::reserve<hpcjoin::data::NarrowCompressedTuple>(uint64_t numberOfElements);
+
+} /* namespace memory */
+} /* namespace hpcjoin */
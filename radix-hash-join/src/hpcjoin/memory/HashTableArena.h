@@ -0,0 +1,60 @@
+/**
+ * @author  Claude Barthels <claudeb@inf.ethz.ch>
+ * (c) 2016, ETH Zurich, Systems Group
+ *
+ */
+
+#ifndef HPCJOIN_MEMORY_HASHTABLEARENA_H_
+#define HPCJOIN_MEMORY_HASHTABLEARENA_H_
+
+#include <stdint.h>
+
+namespace hpcjoin {
+namespace memory {
+
+enum arena_region_t {
+	ARENA_CHAIN_BUCKETS,
+	ARENA_CHAIN_NEXT,
+	ARENA_BUCKETS,
+	ARENA_BUCKET_SIZES,
+	ARENA_OVERFLOW_HEADS,
+	ARENA_OVERFLOW_NEXT,
+	ARENA_OVERFLOW_VALUES,
+	ARENA_NUMBER_OF_REGIONS
+};
+
+/**
+ * Memory of the hash tables built by one worker thread. Every array of a hash table is
+ * stored in its own region, which is reused by all build-probe tasks of the thread and
+ * only grows if a larger partition is encountered. Only the requested range is cleared.
+ */
+
+class HashTableArena {
+
+public:
+
+	HashTableArena();
+	~HashTableArena();
+
+public:
+
+	/**
+	 * Sized for tables of the given compressed tuple type
+	 */
+	template<typename TUPLE>
+	void reserve(uint64_t numberOfElements);
+
+	void *getMemory(arena_region_t region, uint64_t size);
+	void *getClearedMemory(arena_region_t region, uint64_t size);
+
+protected:
+
+	void *regions[ARENA_NUMBER_OF_REGIONS];
+	uint64_t regionSizes[ARENA_NUMBER_OF_REGIONS];
+
+};
+
+} /* namespace memory */
+} /* namespace hpcjoin */
+
+#endif /* HPCJOIN_MEMORY_HASHTABLEARENA_H_ */
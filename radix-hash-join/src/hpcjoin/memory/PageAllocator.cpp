@@ -0,0 +1,149 @@
+/**
+ * @author  Claude Barthels <claudeb@inf.ethz.ch>
+ * (c) 2016, ETH Zurich, Systems Group
+ *
+ */
+
+#include "PageAllocator.h"
+
+#include <stdlib.h>
+#include <sys/mman.h>
+
+#include <hpcjoin/core/Configuration.h>
+#include <hpcjoin/utils/Debug.h>
+
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT (26)
+#endif
+
+#define PAGE_SIZE_DEFAULT (4096ULL)
+#define PAGE_SIZE_2MB (2ULL << 20)
+#define PAGE_SIZE_1GB (1ULL << 30)
+
+namespace hpcjoin {
+namespace memory {
+
+bool PageAllocator::regionAllocated[PAGE_NUMBER_OF_REGIONS];
+page_backing_t PageAllocator::regionBackings[PAGE_NUMBER_OF_REGIONS];
+
+void* PageAllocator::allocate(uint64_t size, page_region_t region, page_backing_t *backing) {
+
+	void *memory = NULL;
+	*backing = PAGE_BACKING_DEFAULT;
+
+	// Start with the largest requested page size and fall back to smaller ones
+	switch (hpcjoin::core::Configuration::HUGE_PAGE_POLICY) {
+		case HUGE_PAGES_1GB:
+			memory = map(size, PAGE_BACKING_HUGE_1GB);
+			if (memory != NULL) {
+				*backing = PAGE_BACKING_HUGE_1GB;
+				break;
+			}
+			// fall through
+		case HUGE_PAGES_2MB:
+			memory = map(size, PAGE_BACKING_HUGE_2MB);
+			if (memory != NULL) {
+				*backing = PAGE_BACKING_HUGE_2MB;
+				break;
+			}
+			// fall through
+		case HUGE_PAGES_TRANSPARENT:
+			memory = map(size, PAGE_BACKING_TRANSPARENT);
+			if (memory != NULL) {
+				*backing = PAGE_BACKING_TRANSPARENT;
+				break;
+			}
+			// fall through
+		case HUGE_PAGES_NONE:
+			int result = posix_memalign(&memory, PAGE_SIZE_DEFAULT, computeMappingSize(size, PAGE_BACKING_DEFAULT));
+			JOIN_ASSERT(result == 0, "Page Allocator", "Could not allocate %lu bytes", size);
+			JOIN_UNUSED(result);
+			break;
+	}
+
+	JOIN_DEBUG("Page Allocator", "Allocated %lu bytes for region %d using %s pages", size, region, getBackingName(*backing));
+
+	if (!regionAllocated[region] || *backing < regionBackings[region]) {
+		regionBackings[region] = *backing;
+	}
+	regionAllocated[region] = true;
+
+	return memory;
+
+}
+
+void PageAllocator::release(void* memory, uint64_t size, page_backing_t backing) {
+
+	if (memory == NULL) {
+		return;
+	}
+
+	if (backing == PAGE_BACKING_DEFAULT) {
+		free(memory);
+	} else {
+		munmap(memory, computeMappingSize(size, backing));
+	}
+
+}
+
+void* PageAllocator::map(uint64_t size, page_backing_t backing) {
+
+	int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+	if (backing == PAGE_BACKING_HUGE_2MB) {
+		flags |= MAP_HUGETLB | (21 << MAP_HUGE_SHIFT);
+	} else if (backing == PAGE_BACKING_HUGE_1GB) {
+		flags |= MAP_HUGETLB | (30 << MAP_HUGE_SHIFT);
+	}
+
+	void *memory = mmap(NULL, computeMappingSize(size, backing), PROT_READ | PROT_WRITE, flags, -1, 0);
+	if (memory == MAP_FAILED) {
+		return NULL;
+	}
+
+	if (backing == PAGE_BACKING_TRANSPARENT && madvise(memory, computeMappingSize(size, backing), MADV_HUGEPAGE) != 0) {
+		munmap(memory, computeMappingSize(size, backing));
+		return NULL;
+	}
+
+	return memory;
+
+}
+
+uint64_t PageAllocator::computeMappingSize(uint64_t size, page_backing_t backing) {
+
+	uint64_t pageSize = PAGE_SIZE_DEFAULT;
+	if (backing == PAGE_BACKING_HUGE_2MB || backing == PAGE_BACKING_TRANSPARENT) {
+		pageSize = PAGE_SIZE_2MB;
+	} else if (backing == PAGE_BACKING_HUGE_1GB) {
+		pageSize = PAGE_SIZE_1GB;
+	}
+
+	// Empty regions still get one page
+	size = (size == 0) ? 1 : size;
+	return ((size + pageSize - 1) / pageSize) * pageSize;
+
+}
+
+page_backing_t PageAllocator::getRegionBacking(page_region_t region) {
+
+	return regionBackings[region];
+
+}
+
+char* PageAllocator::getBackingName(page_backing_t backing) {
+
+	switch (backing) {
+		case PAGE_BACKING_TRANSPARENT:
+			return (char *) "thp";
+		case PAGE_BACKING_HUGE_2MB:
+			return (char *) "2m";
+		case PAGE_BACKING_HUGE_1GB:
+			return (char *) "1g";
+		default:
+			return (char *) "4k";
+	}
+
+}
+
+} /* namespace memory */
+} /* namespace hpcjoin */
@@ -0,0 +1,62 @@
+/**
+ * @author  Claude Barthels <claudeb@inf.ethz.ch>
+ * (c) 2016, ETH Zurich, Systems Group
+ *
+ */
+
+#ifndef HPCJOIN_MEMORY_PAGEALLOCATOR_H_
+#define HPCJOIN_MEMORY_PAGEALLOCATOR_H_
+
+#include <stdint.h>
+
+enum page_backing_t {
+	PAGE_BACKING_DEFAULT,
+	PAGE_BACKING_TRANSPARENT,
+	PAGE_BACKING_HUGE_2MB,
+	PAGE_BACKING_HUGE_1GB
+};
+
+enum page_region_t {
+	PAGE_REGION_POOL,
+	PAGE_REGION_WINDOW,
+	PAGE_REGION_NETWORK_BUFFER,
+	PAGE_NUMBER_OF_REGIONS
+};
+
+namespace hpcjoin {
+namespace memory {
+
+/**
+ * Allocates large memory regions backed by huge pages (see HUGE_PAGE_POLICY). Explicit huge
+ * pages are requested with mmap(MAP_HUGETLB), falling back to smaller pages, to transparent
+ * huge pages (madvise) and finally to regular pages if none are available. The backing that
+ * was obtained is recorded per region; if allocations of a region got different backings,
+ * the smallest one is reported.
+ */
+
+class PageAllocator {
+
+public:
+
+	static void * allocate(uint64_t size, page_region_t region, page_backing_t *backing);
+	static void release(void *memory, uint64_t size, page_backing_t backing);
+
+	static page_backing_t getRegionBacking(page_region_t region);
+	static char * getBackingName(page_backing_t backing);
+
+protected:
+
+	static void * map(uint64_t size, page_backing_t backing);
+	static uint64_t computeMappingSize(uint64_t size, page_backing_t backing);
+
+protected:
+
+	static bool regionAllocated[PAGE_NUMBER_OF_REGIONS];
+	static page_backing_t regionBackings[PAGE_NUMBER_OF_REGIONS];
+
+};
+
+} /* namespace memory */
+} /* namespace hpcjoin */
+
+#endif /* HPCJOIN_MEMORY_PAGEALLOCATOR_H_ */
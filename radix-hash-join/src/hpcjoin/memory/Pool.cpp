@@ -9,53 +9,149 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <sched.h>
+#include <algorithm>
 
+#ifdef USE_LIBNUMA
+#include <numa.h>
+#endif
+
+#include <hpcjoin/core/Configuration.h>
+#include <hpcjoin/utils/Thread.h>
+#include <hpcjoin/memory/Region.h>
 #include <hpcjoin/utils/Debug.h>
 
+#define POOL_PAGE_SIZE (4096)
+
 namespace hpcjoin {
 namespace memory {
 
-uint64_t Pool::dataSize;
-void * Pool::data;
-uint64_t Pool::remainingSize;
-void * Pool::nextFreeData;
-uint64_t Pool::lowerAddressBound;
-uint64_t Pool::upperAddressBound;
+uint32_t Pool::numberOfArenas = 0;
+pool_arena_t *Pool::arenas = NULL;
+
+typedef struct {
+
+	uint32_t coreId;
+	void *data;
+	uint64_t size;
+
+} pool_touch_argument_t;
 
 void Pool::allocate(uint64_t size) {
 
-	int result = posix_memalign((void **) &(data), 64, size);
-	JOIN_ASSERT(result == 0, "Pool", "Could not allocate memory");
-	memset(data, 0, size);
+	numberOfArenas = 1;
+	#ifdef USE_LIBNUMA
+	if (numa_available() >= 0) {
+		numberOfArenas = numa_max_node() + 1;
+	}
+	#endif
+
+	arenas = (pool_arena_t *) calloc(numberOfArenas, sizeof(pool_arena_t));
+	uint64_t arenaSize = (((size + numberOfArenas - 1) / numberOfArenas) + POOL_PAGE_SIZE - 1) & ~((uint64_t) POOL_PAGE_SIZE - 1);
+
+	for (uint32_t a = 0; a < numberOfArenas; ++a) {
+
+		arenas[a].data = hpcjoin::memory::PageAllocator::allocate(arenaSize, PAGE_REGION_POOL, &(arenas[a].backing));
+
+		// Cores that first touch the pages of the arena
+		uint32_t numberOfCores = 0;
+		uint32_t *cores = NULL;
+		#ifdef USE_LIBNUMA
+		if (numa_available() >= 0) {
+			numa_tonode_memory(arenas[a].data, arenaSize, a);
+			struct bitmask *cpus = numa_allocate_cpumask();
+			numa_node_to_cpus(a, cpus);
+			cores = (uint32_t *) calloc(numa_bitmask_weight(cpus), sizeof(uint32_t));
+			for (uint32_t c = 0; c < cpus->size; ++c) {
+				if (numa_bitmask_isbitset(cpus, c)) {
+					cores[numberOfCores++] = c;
+				}
+			}
+			numa_free_cpumask(cpus);
+		}
+		#endif
+		if (numberOfCores == 0) {
+			::free(cores);
+			numberOfCores = hpcjoin::core::Configuration::THREADS_PER_NODE;
+			cores = (uint32_t *) calloc(numberOfCores, sizeof(uint32_t));
+			for (uint32_t c = 0; c < numberOfCores; ++c) {
+				cores[c] = hpcjoin::core::Configuration::FIRST_CORE_ID + c;
+			}
+		}
+
+		// Every thread initializes a contiguous range of pages
+		uint64_t pagesPerCore = (arenaSize / POOL_PAGE_SIZE + numberOfCores - 1) / numberOfCores;
+		pthread_t *threads = (pthread_t *) calloc(numberOfCores, sizeof(pthread_t));
+		pool_touch_argument_t *arguments = (pool_touch_argument_t *) calloc(numberOfCores, sizeof(pool_touch_argument_t));
+		for (uint32_t c = 0; c < numberOfCores; ++c) {
+			uint64_t start = std::min(c * pagesPerCore * POOL_PAGE_SIZE, arenaSize);
+			uint64_t end = std::min((c + 1) * pagesPerCore * POOL_PAGE_SIZE, arenaSize);
+			arguments[c].coreId = cores[c];
+			arguments[c].data = (void *) (((uint64_t) arenas[a].data) + start);
+			arguments[c].size = end - start;
+			int result = pthread_create(&(threads[c]), NULL, &Pool::touch, &(arguments[c]));
+			JOIN_ASSERT(result == 0, "Pool", "Could not create initialization thread %d", c);
+			JOIN_UNUSED(result);
+		}
+		for (uint32_t c = 0; c < numberOfCores; ++c) {
+			pthread_join(threads[c], NULL);
+		}
+		::free(threads);
+		::free(arguments);
+		::free(cores);
+
+		arenas[a].dataSize = arenaSize;
+		arenas[a].remainingSize = arenaSize;
+		arenas[a].nextFreeData = arenas[a].data;
+		pthread_mutex_init(&(arenas[a].lock), NULL);
+
+		JOIN_DEBUG("Pool", "Arena %d is at address %p to %p", a, arenas[a].data, ((char *) arenas[a].data) + arenaSize);
+
+	}
+
+}
+
+void* Pool::touch(void* argument) {
 
-	dataSize = size;
-	remainingSize = size;
-	nextFreeData = data;
+	pool_touch_argument_t *touchArgument = (pool_touch_argument_t *) argument;
+	hpcjoin::utils::Thread::pin(touchArgument->coreId);
+	memset(touchArgument->data, 0, touchArgument->size);
 
-	lowerAddressBound = (uint64_t) data;
-	upperAddressBound = lowerAddressBound + size;
+	return NULL;
 
 }
 
-void* Pool::getMemory(uint64_t size) {
+void* Pool::getMemory(uint64_t size, int32_t numaNode) {
 
 	void *memory = NULL;
 
-	if (remainingSize >= size) {
-		memory = nextFreeData;
-		uint64_t aligned64Size = 0;
-		if (((size >> 6) << 6) == size) {
-			aligned64Size = size;
-		} else {
-			aligned64Size = (size + 64) & (~0x3F);
-		}
-		JOIN_ASSERT(aligned64Size % 64 == 0, "Pool", "Size not aligned to 64")
-		nextFreeData = (void*) (((uint64_t) nextFreeData) + aligned64Size);
-		remainingSize -= aligned64Size;
+	uint64_t aligned64Size = 0;
+	if (((size >> 6) << 6) == size) {
+		aligned64Size = size;
 	} else {
+		aligned64Size = (size + 64) & (~0x3F);
+	}
+	JOIN_ASSERT(aligned64Size % 64 == 0, "Pool", "Size not aligned to 64")
+
+	uint32_t preferredArena = ((numaNode == POOL_LOCAL_NODE) ? getLocalNode() : numaNode) % numberOfArenas;
+
+	// Memory is requested concurrently by the local processing threads
+	for (uint32_t i = 0; i < numberOfArenas && memory == NULL; ++i) {
+		pool_arena_t *arena = &(arenas[(preferredArena + i) % numberOfArenas]);
+		pthread_mutex_lock(&(arena->lock));
+		if (arena->remainingSize >= aligned64Size) {
+			memory = arena->nextFreeData;
+			arena->nextFreeData = (void*) (((uint64_t) arena->nextFreeData) + aligned64Size);
+			arena->remainingSize -= aligned64Size;
+		}
+		pthread_mutex_unlock(&(arena->lock));
+	}
+
+	if (memory == NULL) {
 		JOIN_DEBUG("Pool", "Out of memory");
 		int result = posix_memalign((void **) &(memory), 64, size);
 		JOIN_ASSERT(result == 0, "Pool", "Could not allocate memory");
+		JOIN_UNUSED(result);
 	}
 
 	JOIN_ASSERT(((uint64_t ) memory) % 64 == 0, "Pool", "Returned memory not aligned to 64")
@@ -63,21 +159,52 @@ void* Pool::getMemory(uint64_t size) {
 
 }
 
-void Pool::free(void* memory) {
-	if ((((uint64_t) memory) < lowerAddressBound) || (((uint64_t) memory) >= upperAddressBound)) {
-		free(memory);
+void Pool::free(void* memory, uint64_t size) {
+	for (uint32_t a = 0; a < numberOfArenas; ++a) {
+		if ((((uint64_t) memory) >= ((uint64_t) arenas[a].data)) && (((uint64_t) memory) < ((uint64_t) arenas[a].data) + arenas[a].dataSize)) {
+			// Arena pages are reused after a reset, discarding them trades refaults for a lower peak memory
+			if (hpcjoin::core::Configuration::RELEASE_POOL_PAGES) {
+				hpcjoin::memory::Region::discard(memory, size);
+			}
+			return;
+		}
 	}
+	::free(memory);
 }
 
 void Pool::freeAll() {
-	free(data);
+	for (uint32_t a = 0; a < numberOfArenas; ++a) {
+		hpcjoin::memory::PageAllocator::release(arenas[a].data, arenas[a].dataSize, arenas[a].backing);
+		pthread_mutex_destroy(&(arenas[a].lock));
+	}
+	::free(arenas);
+	arenas = NULL;
+	numberOfArenas = 0;
 }
 
 void Pool::reset() {
-	remainingSize = dataSize;
-	nextFreeData = data;
+	for (uint32_t a = 0; a < numberOfArenas; ++a) {
+		arenas[a].remainingSize = arenas[a].dataSize;
+		arenas[a].nextFreeData = arenas[a].data;
+	}
+}
+
+uint32_t Pool::getNumberOfArenas() {
+
+	return numberOfArenas;
+
+}
+
+int32_t Pool::getLocalNode() {
+
+	#ifdef USE_LIBNUMA
+	if (numa_available() >= 0) {
+		return numa_node_of_cpu(sched_getcpu());
+	}
+	#endif
+	return 0;
+
 }
 
 } /* namespace memory */
 } /* namespace hpcjoin */
-
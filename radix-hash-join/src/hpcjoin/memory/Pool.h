@@ -8,30 +8,57 @@
 #define HPCJOIN_MEMORY_POOL_H_
 
 #include <stdint.h>
+#include <pthread.h>
+
+#include <hpcjoin/memory/PageAllocator.h>
+
+#define POOL_LOCAL_NODE (-1)
 
 namespace hpcjoin {
 namespace memory {
 
+typedef struct {
+
+	void *data;
+	uint64_t dataSize;
+	page_backing_t backing;
+
+	void *nextFreeData;
+	uint64_t remainingSize;
+
+	pthread_mutex_t lock;
+
+} pool_arena_t;
+
+/**
+ * The pool is split into one arena per NUMA node. If the code is compiled with "-D USE_LIBNUMA",
+ * every arena is bound to its node and its pages are touched by threads running on that node.
+ * Requests are served from the arena of the given node (default is the node of the calling
+ * thread) and from the other arenas if it is exhausted. Freed pool memory is only reused after
+ * a reset, but its pages are returned to the operating system if the size is given.
+ */
+
 class Pool {
 
 public:
 
 	static void allocate(uint64_t size);
-	static void * getMemory(uint64_t size);
-	static void free(void *memory);
+	static void * getMemory(uint64_t size, int32_t numaNode = POOL_LOCAL_NODE);
+	static void free(void *memory, uint64_t size = 0);
 	static void freeAll();
 	static void reset();
 
+	static uint32_t getNumberOfArenas();
+	static int32_t getLocalNode();
+
 protected:
 
-	static uint64_t dataSize;
-	static void * data;
+	static void * touch(void *argument);
 
-	static uint64_t remainingSize;
-	static void * nextFreeData;
+protected:
 
-	static uint64_t lowerAddressBound;
-	static uint64_t upperAddressBound;
+	static uint32_t numberOfArenas;
+	static pool_arena_t *arenas;
 
 };
 
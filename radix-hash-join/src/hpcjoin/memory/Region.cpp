@@ -0,0 +1,72 @@
+/**
+ * @author  Claude Barthels <claudeb@inf.ethz.ch>
+ * (c) 2016, ETH Zurich, Systems Group
+ *
+ */
+
+#include "Region.h"
+
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include <hpcjoin/memory/Pool.h>
+#include <hpcjoin/utils/Debug.h>
+
+namespace hpcjoin {
+namespace memory {
+
+Region::Region(region_type_t type, void *innerMemory, uint64_t innerSize, void *outerMemory, uint64_t outerSize) {
+
+	this->type = type;
+
+	this->memory[0] = innerMemory;
+	this->sizes[0] = innerSize;
+	this->memory[1] = outerMemory;
+	this->sizes[1] = outerSize;
+
+	this->references = 0;
+
+}
+
+Region::~Region() {
+
+	for (uint32_t i = 0; i < 2; ++i) {
+		if (this->type == REGION_POOL) {
+			hpcjoin::memory::Pool::free(this->memory[i], this->sizes[i]);
+		} else {
+			discard(this->memory[i], this->sizes[i]);
+		}
+	}
+
+}
+
+void Region::acquire() {
+
+	__sync_fetch_and_add(&(this->references), 1);
+
+}
+
+void Region::release() {
+
+	JOIN_ASSERT(this->references > 0, "Region", "Region released more often than acquired");
+	if (__sync_sub_and_fetch(&(this->references), 1) == 0) {
+		delete this;
+	}
+
+}
+
+void Region::discard(void* memory, uint64_t size) {
+
+	// Only pages entirely covered by the memory are discarded, the boundaries may be shared
+	uint64_t pageSize = sysconf(_SC_PAGESIZE);
+	uint64_t start = (((uint64_t) memory) + pageSize - 1) & ~(pageSize - 1);
+	uint64_t end = (((uint64_t) memory) + size) & ~(pageSize - 1);
+
+	if (memory != NULL && end > start) {
+		madvise((void *) start, end - start, MADV_DONTNEED);
+	}
+
+}
+
+} /* namespace memory */
+} /* namespace hpcjoin */
@@ -0,0 +1,57 @@
+/**
+ * @author  Claude Barthels <claudeb@inf.ethz.ch>
+ * (c) 2016, ETH Zurich, Systems Group
+ *
+ */
+
+#ifndef HPCJOIN_MEMORY_REGION_H_
+#define HPCJOIN_MEMORY_REGION_H_
+
+#include <stdint.h>
+
+enum region_type_t {
+	REGION_POOL,
+	REGION_MAPPED
+};
+
+namespace hpcjoin {
+namespace memory {
+
+/**
+ * Reference-counted memory holding the inner and the outer data of a partition. Every task
+ * reading the partition holds a reference. Once the last reference is released, pool memory
+ * is returned (see Pool::free) and the pages of mapped memory (windows, unpacked partitions)
+ * are given back to the operating system. The region deletes itself.
+ */
+
+class Region {
+
+public:
+
+	Region(region_type_t type, void *innerMemory, uint64_t innerSize, void *outerMemory, uint64_t outerSize);
+	~Region();
+
+public:
+
+	void acquire();
+	void release();
+
+public:
+
+	static void discard(void *memory, uint64_t size);
+
+protected:
+
+	region_type_t type;
+
+	void *memory[2];
+	uint64_t sizes[2];
+
+	uint32_t references;
+
+};
+
+} /* namespace memory */
+} /* namespace hpcjoin */
+
+#endif /* HPCJOIN_MEMORY_REGION_H_ */
@@ -0,0 +1,297 @@
+/**
+ * @author  Claude Barthels <claudeb@inf.ethz.ch>
+ * (c) 2016, ETH Zurich, Systems Group
+ *
+ */
+
+#include "HashAggregation.h"
+
+#include <stdlib.h>
+#include <sched.h>
+#include <mpi.h>
+#include <algorithm>
+
+#include <hpcjoin/data/ArrivalWindow.h>
+#include <hpcjoin/core/Configuration.h>
+#include <hpcjoin/tasks/HistogramComputation.h>
+#include <hpcjoin/tasks/NetworkPartitioning.h>
+#include <hpcjoin/tasks/PreAggregation.h>
+#include <hpcjoin/tasks/LocalAggregation.h>
+#include <hpcjoin/performance/Measurements.h>
+#include <hpcjoin/utils/Debug.h>
+#include <hpcjoin/memory/Pool.h>
+#include <hpcjoin/memory/Region.h>
+#include <hpcjoin/data/CompressedTuple.h>
+#include <hpcjoin/data/WideCompressedTuple.h>
+#include <hpcjoin/data/NarrowCompressedTuple.h>
+#include <hpcjoin/utils/Dispatch.h>
+
+namespace hpcjoin {
+namespace operators {
+
+uint64_t HashAggregation::RESULT_COUNTER = 0;
+hpcjoin::tasks::TaskQueue *HashAggregation::TASK_QUEUE = NULL;
+hpcjoin::data::group_t *HashAggregation::GROUPS = NULL;
+uint64_t HashAggregation::GROUP_CAPACITY = 0;
+volatile uint64_t HashAggregation::NUMBER_OF_GROUPS = 0;
+
+HashAggregation::HashAggregation(uint32_t numberOfNodes, uint32_t nodeId, hpcjoin::data::Relation *relation) {
+
+	this->nodeId = nodeId;
+	this->numberOfNodes = numberOfNodes;
+	this->relation = relation;
+
+}
+
+HashAggregation::~HashAggregation() {
+
+	free(GROUPS);
+	GROUPS = NULL;
+	GROUP_CAPACITY = 0;
+	NUMBER_OF_GROUPS = 0;
+
+}
+
+void HashAggregation::aggregate() {
+
+	// Partial groups are split by key, replicating a partition would split a group
+	JOIN_ASSERT(!hpcjoin::core::Configuration::ENABLE_HEAVY_PARTITION_REPLICATION, "HashAggregation", "Heavy partition replication is not supported");
+	JOIN_ASSERT(!hpcjoin::core::Configuration::ENABLE_BLOOM_FILTER, "HashAggregation", "Bloom filter is not supported");
+
+	/**********************************************************************/
+
+	MPI_Barrier(MPI_COMM_WORLD);
+	hpcjoin::performance::Measurements::startJoin();
+
+	/**********************************************************************/
+
+	/**
+	 * Pre-aggregation
+	 */
+
+	uint32_t numberOfThreads = hpcjoin::core::Configuration::THREADS_PER_NODE;
+	TASK_QUEUE = new hpcjoin::tasks::TaskQueue(numberOfThreads);
+
+	hpcjoin::data::Relation *counts = NULL;
+	hpcjoin::data::Relation *sums = NULL;
+	preAggregate(&counts, &sums);
+
+	// Partial sums can exceed the input rids, the tuple format needs to fit the exchanged values
+	uint64_t maximumValues[4];
+	counts->computeMaximumValues(&(maximumValues[0]), &(maximumValues[1]));
+	sums->computeMaximumValues(&(maximumValues[2]), &(maximumValues[3]));
+	MPI_Allreduce(MPI_IN_PLACE, maximumValues, 4, MPI_UINT64_T, MPI_MAX, MPI_COMM_WORLD);
+	hpcjoin::core::Configuration::selectTupleFormat(std::max(maximumValues[0], maximumValues[2]), std::max(maximumValues[1], maximumValues[3]), true);
+
+	/**********************************************************************/
+
+	/**
+	 * Histogram computation
+	 */
+
+	hpcjoin::performance::Measurements::startHistogramComputation();
+	hpcjoin::tasks::HistogramComputation *histogramComputation = new hpcjoin::tasks::HistogramComputation(this->numberOfNodes, this->nodeId, counts, sums);
+	histogramComputation->execute();
+	hpcjoin::performance::Measurements::stopHistogramComputation();
+	JOIN_MEM_DEBUG("Histogram phase completed");
+
+	/**********************************************************************/
+
+	/**
+	 * Window allocation
+	 */
+
+	hpcjoin::performance::Measurements::startWindowAllocation();
+	hpcjoin::data::Window *countWindow = new hpcjoin::data::Window(this->numberOfNodes, this->nodeId, histogramComputation->getInnerRelationOffsetMap());
+	hpcjoin::data::Window *sumWindow = new hpcjoin::data::Window(this->numberOfNodes, this->nodeId, histogramComputation->getOuterRelationOffsetMap());
+
+	hpcjoin::data::ArrivalWindow *arrivals = new hpcjoin::data::ArrivalWindow(this->numberOfNodes, this->nodeId, histogramComputation->getAssignmentMap());
+	uint64_t *senders = (uint64_t *) calloc(histogramComputation->getAssignmentMap()->getNumberOfReplicas(), sizeof(uint64_t));
+	countWindow->countSenders(senders);
+	sumWindow->countSenders(senders);
+	arrivals->computeExpectedArrivals(senders);
+	free(senders);
+	hpcjoin::performance::Measurements::stopWindowAllocation();
+	JOIN_MEM_DEBUG("Window allocated");
+
+	/**********************************************************************/
+
+	/**
+	 * Network partitioning
+	 */
+
+	hpcjoin::performance::Measurements::startNetworkPartitioning();
+	uint32_t numberOfSlices = hpcjoin::core::Configuration::NETWORK_THREADS_PER_NODE;
+
+	countWindow->start();
+	sumWindow->start();
+	arrivals->start();
+	for (uint32_t s = 0; s < numberOfSlices; ++s) {
+		TASK_QUEUE->push(new hpcjoin::tasks::NetworkPartitioning(this->nodeId, counts, sums, countWindow, sumWindow, arrivals, s, numberOfSlices, NULL));
+	}
+	TASK_QUEUE->execute();
+	countWindow->stop();
+	sumWindow->stop();
+
+	countWindow->assertAllTuplesWritten();
+	sumWindow->assertAllTuplesWritten();
+	hpcjoin::performance::Measurements::stopNetworkPartitioning();
+	JOIN_MEM_DEBUG("Network phase completed");
+
+	delete counts;
+	delete sums;
+	JOIN_MEM_DEBUG("Partial groups deleted");
+
+	/**********************************************************************/
+
+	/**
+	 * Prepare transition
+	 */
+
+	hpcjoin::performance::Measurements::startLocalProcessingPreparations();
+	hpcjoin::memory::Pool::reset();
+
+	// Every received count tuple is at most one output group
+	hpcjoin::histograms::AssignmentMap *assignment = histogramComputation->getAssignmentMap();
+	GROUP_CAPACITY = 0;
+	for (uint32_t r = 0; r < assignment->getNumberOfReplicas(); ++r) {
+		if (assignment->getReplicaNode(r) == this->nodeId) {
+			GROUP_CAPACITY += countWindow->getPartitionSize(r);
+		}
+	}
+	int result = posix_memalign((void **) &GROUPS, hpcjoin::core::Configuration::CACHELINE_SIZE_BYTES, (GROUP_CAPACITY + 1) * sizeof(hpcjoin::data::group_t));
+	JOIN_ASSERT(result == 0, "HashAggregation", "Could not allocate group output");
+	JOIN_UNUSED(result);
+	NUMBER_OF_GROUPS = 0;
+
+	// The low key bits of a group are given by the partition it was received in
+	uint32_t *replicaPartitions = (uint32_t *) calloc(assignment->getNumberOfReplicas(), sizeof(uint32_t));
+	for (uint32_t p = 0; p < hpcjoin::core::Configuration::NETWORK_PARTITIONING_COUNT; ++p) {
+		for (uint32_t r = 0; r < assignment->getReplicaCount(p); ++r) {
+			replicaPartitions[assignment->getReplicaStart(p) + r] = p;
+		}
+	}
+
+	JOIN_MEM_DEBUG("Local phase prepared");
+
+	hpcjoin::performance::Measurements::stopLocalProcessingPreparations();
+
+	/**********************************************************************/
+
+	/**
+	 * Local processing
+	 */
+
+	hpcjoin::performance::Measurements::startLocalProcessing();
+	uint32_t remainingReplicas = arrivals->getNumberOfLocalReplicas();
+	uint32_t *completedReplicas = (uint32_t *) calloc(assignment->getNumberOfReplicas(), sizeof(uint32_t));
+	while (remainingReplicas > 0) {
+
+		hpcjoin::performance::Measurements::startWaitingForNetworkCompletion();
+		uint32_t numberOfCompletedReplicas = 0;
+		while ((numberOfCompletedReplicas = arrivals->collectCompletedReplicas(completedReplicas)) == 0) {
+			sched_yield();
+		}
+		countWindow->synchronize();
+		sumWindow->synchronize();
+		hpcjoin::performance::Measurements::stopWaitingForNetworkCompletion();
+
+		for (uint32_t i = 0; i < numberOfCompletedReplicas; ++i) {
+			TUPLE_FORMAT_DISPATCH(hpcjoin::core::Configuration::TUPLE_FORMAT, scheduleLocalProcessing, completedReplicas[i], replicaPartitions[completedReplicas[i]], countWindow, sumWindow);
+		}
+
+		TASK_QUEUE->execute();
+		remainingReplicas -= numberOfCompletedReplicas;
+
+	}
+	free(completedReplicas);
+	free(replicaPartitions);
+
+	arrivals->stop();
+	delete arrivals;
+
+	delete histogramComputation;
+
+	RESULT_COUNTER = NUMBER_OF_GROUPS;
+
+	delete TASK_QUEUE;
+	TASK_QUEUE = NULL;
+
+	hpcjoin::performance::Measurements::stopLocalProcessing();
+
+	JOIN_MEM_DEBUG("Local phase completed");
+
+	/**********************************************************************/
+
+	hpcjoin::performance::Measurements::stopJoin();
+
+	delete countWindow;
+	delete sumWindow;
+
+}
+
+void HashAggregation::preAggregate(hpcjoin::data::Relation **counts, hpcjoin::data::Relation **sums) {
+
+	uint32_t numberOfSlices = hpcjoin::core::Configuration::NETWORK_THREADS_PER_NODE;
+
+	// Every thread reduces one slice of the input into its own table
+	hpcjoin::data::GroupTable **tables = new hpcjoin::data::GroupTable*[numberOfSlices];
+	for (uint32_t s = 0; s < numberOfSlices; ++s) {
+		tables[s] = new hpcjoin::data::GroupTable(this->relation->getSliceSize(s, numberOfSlices));
+		TASK_QUEUE->push(new hpcjoin::tasks::PreAggregation(this->relation, tables[s], s, numberOfSlices));
+	}
+	TASK_QUEUE->execute();
+
+	uint64_t sizes[2];
+	sizes[0] = 0;
+	for (uint32_t s = 0; s < numberOfSlices; ++s) {
+		sizes[0] += tables[s]->getNumberOfGroups();
+	}
+	MPI_Allreduce(&(sizes[0]), &(sizes[1]), 1, MPI_UINT64_T, MPI_SUM, MPI_COMM_WORLD);
+
+	// The same group can appear in several slices, these are combined after the exchange
+	*counts = new hpcjoin::data::Relation(sizes[0], sizes[1]);
+	*sums = new hpcjoin::data::Relation(sizes[0], sizes[1]);
+	uint64_t offset = 0;
+	for (uint32_t s = 0; s < numberOfSlices; ++s) {
+		tables[s]->copyGroups((*counts)->getData() + offset, (*sums)->getData() + offset);
+		offset += tables[s]->getNumberOfGroups();
+		delete tables[s];
+	}
+	delete[] tables;
+
+	JOIN_DEBUG("HashAggregation", "Node %d reduced %lu tuples to %lu partial groups", this->nodeId, this->relation->getLocalSize(), sizes[0]);
+
+	delete this->relation;
+	this->relation = NULL;
+
+}
+
+template<typename TUPLE>
+void HashAggregation::scheduleLocalProcessing(uint32_t replicaId, uint32_t partitionId, hpcjoin::data::Window *countWindow, hpcjoin::data::Window *sumWindow) {
+
+	TUPLE *countPartition = (TUPLE *) countWindow->getPartition(replicaId);
+	uint64_t countPartitionSize = countWindow->getPartitionSize(replicaId);
+	TUPLE *sumPartition = (TUPLE *) sumWindow->getPartition(replicaId);
+	uint64_t sumPartitionSize = sumWindow->getPartitionSize(replicaId);
+
+	hpcjoin::memory::Region *region = new hpcjoin::memory::Region(REGION_MAPPED, countPartition, countPartitionSize * sizeof(TUPLE), sumPartition,
+			sumPartitionSize * sizeof(TUPLE));
+	TASK_QUEUE->push(new hpcjoin::tasks::LocalAggregation<TUPLE>(partitionId, countPartitionSize, countPartition, sumPartitionSize, sumPartition, region));
+
+}
+
+hpcjoin::data::group_t* HashAggregation::getGroups() {
+
+	return GROUPS;
+
+}
+
+uint64_t HashAggregation::getNumberOfGroups() {
+
+	return NUMBER_OF_GROUPS;
+
+}
+
+} /* namespace operators */
+} /* namespace hpcjoin */
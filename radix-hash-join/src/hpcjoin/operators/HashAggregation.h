@@ -0,0 +1,68 @@
+/**
+ * @author  Claude Barthels <claudeb@inf.ethz.ch>
+ * (c) 2016, ETH Zurich, Systems Group
+ *
+ */
+
+#ifndef OPERATORS_AGGREGATION_H_
+#define OPERATORS_AGGREGATION_H_
+
+#include <stdint.h>
+
+#include <hpcjoin/data/Relation.h>
+#include <hpcjoin/data/GroupTable.h>
+#include <hpcjoin/data/Window.h>
+#include <hpcjoin/tasks/TaskQueue.h>
+
+namespace hpcjoin {
+namespace operators {
+
+/**
+ * Distributed GROUP BY key with COUNT(*) and SUM(rid). Every process reduces its input to
+ * partial groups, the partial counts and sums are exchanged with the partitioning pipeline
+ * of the join and every process combines the partial groups of the partitions it is
+ * assigned.
+ */
+
+class HashAggregation {
+
+public:
+
+	HashAggregation(uint32_t numberOfNodes, uint32_t nodeId, hpcjoin::data::Relation *relation);
+	~HashAggregation();
+
+public:
+
+	void aggregate();
+
+	hpcjoin::data::group_t *getGroups();
+	uint64_t getNumberOfGroups();
+
+protected:
+
+	uint32_t numberOfNodes;
+	uint32_t nodeId;
+
+	hpcjoin::data::Relation *relation;
+
+protected:
+
+	void preAggregate(hpcjoin::data::Relation **counts, hpcjoin::data::Relation **sums);
+
+	template<typename TUPLE>
+	void scheduleLocalProcessing(uint32_t replicaId, uint32_t partitionId, hpcjoin::data::Window *countWindow, hpcjoin::data::Window *sumWindow);
+
+public:
+
+	static uint64_t RESULT_COUNTER;
+	static hpcjoin::tasks::TaskQueue *TASK_QUEUE;
+	static hpcjoin::data::group_t *GROUPS;
+	static uint64_t GROUP_CAPACITY;
+	static volatile uint64_t NUMBER_OF_GROUPS;
+
+};
+
+} /* namespace operators */
+} /* namespace hpcjoin */
+
+#endif /* OPERATORS_AGGREGATION_H_ */
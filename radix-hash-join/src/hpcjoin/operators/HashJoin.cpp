@@ -7,23 +7,40 @@
 #include "HashJoin.h"
 
 #include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include <mpi.h>
+#include <algorithm>
 
 #include <hpcjoin/data/Window.h>
+#include <hpcjoin/data/ArrivalWindow.h>
 #include <hpcjoin/core/Configuration.h>
 #include <hpcjoin/tasks/HistogramComputation.h>
 #include <hpcjoin/tasks/NetworkPartitioning.h>
+#include <hpcjoin/tasks/BroadcastPartitioning.h>
 #include <hpcjoin/tasks/LocalPartitioning.h>
 #include <hpcjoin/tasks/BuildProbe.h>
 #include <hpcjoin/performance/Measurements.h>
 #include <hpcjoin/utils/Debug.h>
 #include <hpcjoin/memory/Pool.h>
+#include <hpcjoin/memory/PageAllocator.h>
+#include <hpcjoin/memory/Region.h>
 #include <hpcjoin/data/CompressedTuple.h>
+#include <hpcjoin/data/WideCompressedTuple.h>
+#include <hpcjoin/data/NarrowCompressedTuple.h>
+#include <hpcjoin/utils/Dispatch.h>
 
 namespace hpcjoin {
 namespace operators {
 
 uint64_t HashJoin::RESULT_COUNTER = 0;
-std::queue<hpcjoin::tasks::Task *> HashJoin::TASK_QUEUE;
+join_strategy_t HashJoin::STRATEGY = JOIN_STRATEGY_SHUFFLE;
+thread_counter_t *HashJoin::THREAD_RESULT_COUNTERS = NULL;
+hpcjoin::tasks::TaskQueue *HashJoin::TASK_QUEUE = NULL;
+hpcjoin::data::JoinResult *HashJoin::RESULT = NULL;
+hpcjoin::data::AggregationTable **HashJoin::THREAD_AGGREGATION_TABLES = NULL;
+hpcjoin::data::AggregationTable *HashJoin::AGGREGATION = NULL;
+hpcjoin::memory::HashTableArena **HashJoin::THREAD_HASH_TABLE_ARENAS = NULL;
 
 HashJoin::HashJoin(uint32_t numberOfNodes, uint32_t nodeId, hpcjoin::data::Relation *innerRelation, hpcjoin::data::Relation *outerRelation) {
 
@@ -36,6 +53,11 @@ HashJoin::HashJoin(uint32_t numberOfNodes, uint32_t nodeId, hpcjoin::data::Relat
 
 HashJoin::~HashJoin() {
 
+	delete RESULT;
+	RESULT = NULL;
+	delete AGGREGATION;
+	AGGREGATION = NULL;
+
 }
 
 void HashJoin::join() {
@@ -58,6 +80,19 @@ void HashJoin::join() {
 	hpcjoin::performance::Measurements::stopHistogramComputation();
 	JOIN_MEM_DEBUG("Histogram phase completed");
 
+	// A small inner relation is replicated to all processes instead of shuffling both relations
+	uint64_t globalInnerRelationSize = 0;
+	uint64_t globalOuterRelationSize = 0;
+	for (uint32_t p = 0; p < hpcjoin::core::Configuration::NETWORK_PARTITIONING_COUNT; ++p) {
+		globalInnerRelationSize += histogramComputation->getInnerRelationGlobalHistogram()[p];
+		globalOuterRelationSize += histogramComputation->getOuterRelationGlobalHistogram()[p];
+	}
+	STRATEGY = hpcjoin::core::Configuration::selectJoinStrategy(globalInnerRelationSize, globalOuterRelationSize, this->numberOfNodes);
+	if (STRATEGY == JOIN_STRATEGY_BROADCAST) {
+		joinBroadcast(histogramComputation);
+		return;
+	}
+
 	/**********************************************************************/
 
 	/**
@@ -65,13 +100,16 @@ void HashJoin::join() {
 	 */
 
 	hpcjoin::performance::Measurements::startWindowAllocation();
-	hpcjoin::data::Window *innerWindow = new hpcjoin::data::Window(this->numberOfNodes, this->nodeId, histogramComputation->getAssignment(),
-			histogramComputation->getInnerRelationLocalHistogram(), histogramComputation->getInnerRelationGlobalHistogram(), histogramComputation->getInnerRelationBaseOffsets(),
-			histogramComputation->getInnerRelationWriteOffsets());
-
-	hpcjoin::data::Window *outerWindow = new hpcjoin::data::Window(this->numberOfNodes, this->nodeId, histogramComputation->getAssignment(),
-			histogramComputation->getOuterRelationLocalHistogram(), histogramComputation->getOuterRelationGlobalHistogram(), histogramComputation->getOuterRelationBaseOffsets(),
-			histogramComputation->getOuterRelationWriteOffsets());
+	hpcjoin::data::Window *innerWindow = new hpcjoin::data::Window(this->numberOfNodes, this->nodeId, histogramComputation->getInnerRelationOffsetMap());
+	hpcjoin::data::Window *outerWindow = new hpcjoin::data::Window(this->numberOfNodes, this->nodeId, histogramComputation->getOuterRelationOffsetMap());
+
+	// Receivers know from the histograms how many senders will signal the arrival of each partition
+	hpcjoin::data::ArrivalWindow *arrivals = new hpcjoin::data::ArrivalWindow(this->numberOfNodes, this->nodeId, histogramComputation->getAssignmentMap());
+	uint64_t *senders = (uint64_t *) calloc(histogramComputation->getAssignmentMap()->getNumberOfReplicas(), sizeof(uint64_t));
+	innerWindow->countSenders(senders);
+	outerWindow->countSenders(senders);
+	arrivals->computeExpectedArrivals(senders);
+	free(senders);
 	hpcjoin::performance::Measurements::stopWindowAllocation();
 	JOIN_MEM_DEBUG("Window allocated");
 
@@ -82,58 +120,218 @@ void HashJoin::join() {
 	 */
 
 	hpcjoin::performance::Measurements::startNetworkPartitioning();
-	hpcjoin::tasks::NetworkPartitioning *networkPartitioning = new hpcjoin::tasks::NetworkPartitioning(this->nodeId, this->innerRelation, this->outerRelation, innerWindow,
-			outerWindow);
-	networkPartitioning->execute();
+	uint32_t numberOfThreads = hpcjoin::core::Configuration::THREADS_PER_NODE;
+	uint32_t numberOfSlices = hpcjoin::core::Configuration::NETWORK_THREADS_PER_NODE;
+	TASK_QUEUE = new hpcjoin::tasks::TaskQueue(numberOfThreads);
+
+	// Every thread partitions one slice of the input and writes into the same windows
+	innerWindow->start();
+	outerWindow->start();
+	arrivals->start();
+	for (uint32_t s = 0; s < numberOfSlices; ++s) {
+		TASK_QUEUE->push(new hpcjoin::tasks::NetworkPartitioning(this->nodeId, this->innerRelation, this->outerRelation, innerWindow, outerWindow, arrivals, s, numberOfSlices, histogramComputation->getBloomFilter()));
+	}
+	TASK_QUEUE->execute();
+	innerWindow->stop();
+	outerWindow->stop();
+
+	innerWindow->assertAllTuplesWritten();
+	outerWindow->assertAllTuplesWritten();
 	hpcjoin::performance::Measurements::stopNetworkPartitioning();
 	JOIN_MEM_DEBUG("Network phase completed");
 
-	// OPTIMIZATION Save memory as soon as possible
-	//delete this->innerRelation;
-	//delete this->outerRelation;
+	// Save memory as soon as possible, the pool memory of the relations is reused for local partitioning
+	delete this->innerRelation;
+	delete this->outerRelation;
+	this->innerRelation = NULL;
+	this->outerRelation = NULL;
 	JOIN_MEM_DEBUG("Input relations deleted");
 
 	/**********************************************************************/
 
 	/**
-	 * Main synchronization
+	 * Prepare transition
 	 */
 
-	hpcjoin::performance::Measurements::startWaitingForNetworkCompletion();
-	MPI_Barrier(MPI_COMM_WORLD);
-	hpcjoin::performance::Measurements::stopWaitingForNetworkCompletion();
+	hpcjoin::performance::Measurements::startLocalProcessingPreparations();
+	//hpcjoin::memory::Pool::allocate((innerWindow->computeLocalWindowSize() + outerWindow->computeLocalWindowSize())*sizeof(hpcjoin::data::Tuple));
+	hpcjoin::memory::Pool::reset();
+
+	// The hash table arenas are sized for the largest partition assigned to this process
+	uint64_t largestInnerPartitionSize = 0;
+	hpcjoin::histograms::AssignmentMap *assignment = histogramComputation->getAssignmentMap();
+	for (uint32_t r = 0; r < assignment->getNumberOfReplicas(); ++r) {
+		if (assignment->getReplicaNode(r) == this->nodeId && innerWindow->getPartitionSize(r) > largestInnerPartitionSize) {
+			largestInnerPartitionSize = innerWindow->getPartitionSize(r);
+		}
+	}
+	prepareLocalProcessing(largestInnerPartitionSize);
+
+	JOIN_MEM_DEBUG("Local phase prepared");
+
+	hpcjoin::performance::Measurements::stopLocalProcessingPreparations();
 
 	/**********************************************************************/
 
 	/**
-	 * Prepare transition
+	 * Local processing
 	 */
 
-	hpcjoin::performance::Measurements::startLocalProcessingPreparations();
-	if (hpcjoin::core::Configuration::ENABLE_TWO_LEVEL_PARTITIONING) {
-		//hpcjoin::memory::Pool::allocate((innerWindow->computeLocalWindowSize() + outerWindow->computeLocalWindowSize())*sizeof(hpcjoin::data::Tuple));
-		hpcjoin::memory::Pool::reset();
-	}
-	// Create initial set of tasks
-	uint32_t *assignment = histogramComputation->getAssignment();
-	for (uint32_t p = 0; p < hpcjoin::core::Configuration::NETWORK_PARTITIONING_COUNT; ++p) {
-		if (assignment[p] == this->nodeId) {
-			hpcjoin::data::CompressedTuple *innerRelationPartition = innerWindow->getPartition(p);
-			uint64_t innerRelationPartitionSize = innerWindow->getPartitionSize(p);
-			hpcjoin::data::CompressedTuple *outerRelationPartition = outerWindow->getPartition(p);
-			uint64_t outerRelationPartitionSize = outerWindow->getPartitionSize(p);
-
-			if (hpcjoin::core::Configuration::ENABLE_TWO_LEVEL_PARTITIONING) {
-				TASK_QUEUE.push(new hpcjoin::tasks::LocalPartitioning(innerRelationPartitionSize, innerRelationPartition, outerRelationPartitionSize, outerRelationPartition));
-			} else {
-				TASK_QUEUE.push(new hpcjoin::tasks::BuildProbe(innerRelationPartitionSize, innerRelationPartition, outerRelationPartitionSize, outerRelationPartition));
-			}
+	// Partitions are processed as soon as all senders have signalled their arrival
+	hpcjoin::performance::Measurements::startLocalProcessing();
+	uint32_t remainingReplicas = arrivals->getNumberOfLocalReplicas();
+	uint32_t *completedReplicas = (uint32_t *) calloc(assignment->getNumberOfReplicas(), sizeof(uint32_t));
+	while (remainingReplicas > 0) {
+
+		hpcjoin::performance::Measurements::startWaitingForNetworkCompletion();
+		uint32_t numberOfCompletedReplicas = 0;
+		while ((numberOfCompletedReplicas = arrivals->collectCompletedReplicas(completedReplicas)) == 0) {
+			sched_yield();
 		}
+		innerWindow->synchronize();
+		outerWindow->synchronize();
+		hpcjoin::performance::Measurements::stopWaitingForNetworkCompletion();
+
+		for (uint32_t i = 0; i < numberOfCompletedReplicas; ++i) {
+			TUPLE_FORMAT_DISPATCH(hpcjoin::core::Configuration::TUPLE_FORMAT, scheduleLocalProcessing, completedReplicas[i], innerWindow, outerWindow);
+		}
+
+		TASK_QUEUE->execute();
+		remainingReplicas -= numberOfCompletedReplicas;
+
 	}
+	free(completedReplicas);
+
+	arrivals->stop();
+	delete arrivals;
 
 	// Delete the network related computation
 	delete histogramComputation;
-	delete networkPartitioning;
+
+	finishLocalProcessing();
+
+	hpcjoin::performance::Measurements::stopLocalProcessing();
+
+	JOIN_MEM_DEBUG("Local phase completed");
+
+	/**********************************************************************/
+
+	hpcjoin::performance::Measurements::stopJoin();
+
+	delete innerWindow;
+	delete outerWindow;
+
+}
+
+void HashJoin::joinBroadcast(hpcjoin::tasks::HistogramComputation *histogramComputation) {
+
+	/**********************************************************************/
+
+	/**
+	 * Broadcast of the inner relation
+	 */
+
+	hpcjoin::performance::Measurements::startNetworkPartitioning();
+	uint32_t numberOfThreads = hpcjoin::core::Configuration::THREADS_PER_NODE;
+	uint32_t numberOfSlices = hpcjoin::core::Configuration::NETWORK_THREADS_PER_NODE;
+	uint64_t const partitionCount = hpcjoin::core::Configuration::NETWORK_PARTITIONING_COUNT;
+	TASK_QUEUE = new hpcjoin::tasks::TaskQueue(numberOfThreads);
+
+	// Every process receives the inner relation and the local histogram of every other process
+	uint64_t *innerWriteOffsets = (uint64_t *) calloc(this->numberOfNodes * partitionCount, sizeof(uint64_t));
+	MPI_Allgather(histogramComputation->getInnerRelationLocalHistogram(), partitionCount, MPI_UINT64_T, innerWriteOffsets, partitionCount, MPI_UINT64_T, MPI_COMM_WORLD);
+
+	int *chunkSizes = (int *) calloc(this->numberOfNodes, sizeof(int));
+	int *chunkStarts = (int *) calloc(this->numberOfNodes, sizeof(int));
+	uint64_t globalInnerRelationSize = 0;
+	for (uint32_t n = 0; n < this->numberOfNodes; ++n) {
+		uint64_t chunkSize = 0;
+		for (uint32_t p = 0; p < partitionCount; ++p) {
+			chunkSize += innerWriteOffsets[n * partitionCount + p];
+		}
+		JOIN_ASSERT(globalInnerRelationSize + chunkSize <= hpcjoin::core::Configuration::MAX_BROADCAST_TUPLES, "HashJoin", "Inner relation is too large to be broadcast");
+		chunkSizes[n] = chunkSize;
+		chunkStarts[n] = globalInnerRelationSize;
+		globalInnerRelationSize += chunkSize;
+	}
+
+	MPI_Datatype tupleType;
+	MPI_Type_contiguous(sizeof(hpcjoin::data::Tuple), MPI_BYTE, &tupleType);
+	MPI_Type_commit(&tupleType);
+	page_backing_t gatheredBacking;
+	hpcjoin::data::Tuple *gatheredInnerRelation = (hpcjoin::data::Tuple *) hpcjoin::memory::PageAllocator::allocate(globalInnerRelationSize * sizeof(hpcjoin::data::Tuple),
+			PAGE_REGION_NETWORK_BUFFER, &gatheredBacking);
+	MPI_Allgatherv(this->innerRelation->getData(), this->innerRelation->getLocalSize(), tupleType, gatheredInnerRelation, chunkSizes, chunkStarts, tupleType, MPI_COMM_WORLD);
+	MPI_Type_free(&tupleType);
+
+	delete this->innerRelation;
+	this->innerRelation = NULL;
+	JOIN_MEM_DEBUG("Inner relation gathered");
+
+	// The partitions are stored consecutively, the chunks of the processes (slices of the
+	// outer relation) are stored in order within a partition
+	uint64_t *innerPartitionStarts = (uint64_t *) calloc(partitionCount + 1, sizeof(uint64_t));
+	for (uint32_t p = 0; p < partitionCount; ++p) {
+		innerPartitionStarts[p + 1] = innerPartitionStarts[p];
+		for (uint32_t n = 0; n < this->numberOfNodes; ++n) {
+			uint64_t chunkPartitionSize = innerWriteOffsets[n * partitionCount + p];
+			innerWriteOffsets[n * partitionCount + p] = innerPartitionStarts[p + 1];
+			innerPartitionStarts[p + 1] += chunkPartitionSize;
+		}
+	}
+
+	uint64_t *sliceHistograms = histogramComputation->getOuterRelationSliceHistograms();
+	uint64_t *outerWriteOffsets = (uint64_t *) calloc(numberOfSlices * partitionCount, sizeof(uint64_t));
+	uint64_t *outerPartitionStarts = (uint64_t *) calloc(partitionCount + 1, sizeof(uint64_t));
+	for (uint32_t p = 0; p < partitionCount; ++p) {
+		outerPartitionStarts[p + 1] = outerPartitionStarts[p];
+		for (uint32_t s = 0; s < numberOfSlices; ++s) {
+			outerWriteOffsets[s * partitionCount + p] = outerPartitionStarts[p + 1];
+			outerPartitionStarts[p + 1] += sliceHistograms[s * partitionCount + p];
+		}
+	}
+
+	uint32_t const tupleSize = hpcjoin::core::Configuration::getCompressedTupleSize();
+	page_backing_t innerBacking;
+	page_backing_t outerBacking;
+	void *innerPartitions = hpcjoin::memory::PageAllocator::allocate(innerPartitionStarts[partitionCount] * tupleSize, PAGE_REGION_WINDOW, &innerBacking);
+	void *outerPartitions = hpcjoin::memory::PageAllocator::allocate(outerPartitionStarts[partitionCount] * tupleSize, PAGE_REGION_WINDOW, &outerBacking);
+
+	// The outer tuples are partitioned in place with the same filter as in the histogram phase
+	for (uint32_t n = 0; n < this->numberOfNodes; ++n) {
+		TASK_QUEUE->push(new hpcjoin::tasks::BroadcastPartitioning(gatheredInnerRelation + chunkStarts[n], chunkSizes[n], innerWriteOffsets + n * partitionCount, innerPartitions));
+	}
+	for (uint32_t s = 0; s < numberOfSlices; ++s) {
+		TASK_QUEUE->push(new hpcjoin::tasks::BroadcastPartitioning(this->outerRelation->getData() + this->outerRelation->getSliceStart(s, numberOfSlices),
+				this->outerRelation->getSliceSize(s, numberOfSlices), outerWriteOffsets + s * partitionCount, outerPartitions, histogramComputation->getBloomFilter()));
+	}
+	TASK_QUEUE->execute();
+	hpcjoin::performance::Measurements::stopNetworkPartitioning();
+	JOIN_MEM_DEBUG("Broadcast phase completed");
+
+	hpcjoin::memory::PageAllocator::release(gatheredInnerRelation, globalInnerRelationSize * sizeof(hpcjoin::data::Tuple), gatheredBacking);
+	delete this->outerRelation;
+	this->outerRelation = NULL;
+	free(innerWriteOffsets);
+	free(outerWriteOffsets);
+	free(chunkSizes);
+	free(chunkStarts);
+	delete histogramComputation;
+
+	/**********************************************************************/
+
+	/**
+	 * Prepare transition
+	 */
+
+	hpcjoin::performance::Measurements::startLocalProcessingPreparations();
+	hpcjoin::memory::Pool::reset();
+
+	uint64_t largestInnerPartitionSize = 0;
+	for (uint32_t p = 0; p < partitionCount; ++p) {
+		largestInnerPartitionSize = std::max(largestInnerPartitionSize, innerPartitionStarts[p + 1] - innerPartitionStarts[p]);
+	}
+	prepareLocalProcessing(largestInnerPartitionSize);
 
 	JOIN_MEM_DEBUG("Local phase prepared");
 
@@ -145,29 +343,14 @@ void HashJoin::join() {
 	 * Local processing
 	 */
 
-	// OPTIMIZATION Delete window as soon as possible
-	bool windowsDeleted = false;
-
-	// Execute tasks
 	hpcjoin::performance::Measurements::startLocalProcessing();
-	while (TASK_QUEUE.size() > 0) {
-
-		hpcjoin::tasks::Task *task = TASK_QUEUE.front();
-		TASK_QUEUE.pop();
-
-		// OPTIMIZATION When second partitioning pass is completed, windows are no longer required
-		if (hpcjoin::core::Configuration::ENABLE_TWO_LEVEL_PARTITIONING && windowsDeleted) {
-			if (task->getType() == TASK_BUILD_PROBE) {
-				delete innerWindow;
-				delete outerWindow;
-				windowsDeleted = true;
-			}
-		}
+	for (uint32_t p = 0; p < partitionCount; ++p) {
+		TUPLE_FORMAT_DISPATCH(hpcjoin::core::Configuration::TUPLE_FORMAT, scheduleBroadcastProcessing, p, innerPartitions, innerPartitionStarts, outerPartitions, outerPartitionStarts);
+	}
+	TASK_QUEUE->execute();
 
-		task->execute();
-		delete task;
+	finishLocalProcessing();
 
-	}
 	hpcjoin::performance::Measurements::stopLocalProcessing();
 
 	JOIN_MEM_DEBUG("Local phase completed");
@@ -176,12 +359,127 @@ void HashJoin::join() {
 
 	hpcjoin::performance::Measurements::stopJoin();
 
-	// OPTIMIZATION (see above)
-	if (!windowsDeleted) {
-		delete innerWindow;
-		delete outerWindow;
+	hpcjoin::memory::PageAllocator::release(innerPartitions, innerPartitionStarts[partitionCount] * tupleSize, innerBacking);
+	hpcjoin::memory::PageAllocator::release(outerPartitions, outerPartitionStarts[partitionCount] * tupleSize, outerBacking);
+	free(innerPartitionStarts);
+	free(outerPartitionStarts);
+
+}
+
+void HashJoin::prepareLocalProcessing(uint64_t largestInnerPartitionSize) {
+
+	uint32_t numberOfThreads = hpcjoin::core::Configuration::THREADS_PER_NODE;
+
+	// Create per-thread result counters
+	int result = posix_memalign((void **) &THREAD_RESULT_COUNTERS, hpcjoin::core::Configuration::CACHELINE_SIZE_BYTES, numberOfThreads * sizeof(thread_counter_t));
+	JOIN_ASSERT(result == 0, "HashJoin", "Could not allocate result counters");
+	JOIN_UNUSED(result);
+	memset(THREAD_RESULT_COUNTERS, 0, numberOfThreads * sizeof(thread_counter_t));
+
+	// Create per-thread output buffers
+	if (hpcjoin::core::Configuration::MATERIALIZE_RESULTS) {
+		RESULT = new hpcjoin::data::JoinResult(numberOfThreads);
+	}
+
+	// Create per-thread aggregation tables
+	if (hpcjoin::core::Configuration::AGGREGATION_GROUPS > 0) {
+		THREAD_AGGREGATION_TABLES = new hpcjoin::data::AggregationTable*[numberOfThreads];
+		for (uint32_t t = 0; t < numberOfThreads; ++t) {
+			THREAD_AGGREGATION_TABLES[t] = new hpcjoin::data::AggregationTable(hpcjoin::core::Configuration::AGGREGATION_GROUPS);
+		}
+	}
+
+	// Create per-thread hash table arenas, sized for the largest table expected after local partitioning
+	uint64_t const arenaSize = std::min(largestInnerPartitionSize, hpcjoin::core::Configuration::CACHE_BUDGET_BYTES / hpcjoin::core::Configuration::getCompressedTupleSize());
+	THREAD_HASH_TABLE_ARENAS = new hpcjoin::memory::HashTableArena*[numberOfThreads];
+	for (uint32_t t = 0; t < numberOfThreads; ++t) {
+		THREAD_HASH_TABLE_ARENAS[t] = new hpcjoin::memory::HashTableArena();
+		TUPLE_FORMAT_DISPATCH(hpcjoin::core::Configuration::TUPLE_FORMAT, THREAD_HASH_TABLE_ARENAS[t]->reserve, arenaSize);
+	}
+
+}
+
+void HashJoin::finishLocalProcessing() {
+
+	uint32_t numberOfThreads = hpcjoin::core::Configuration::THREADS_PER_NODE;
+
+	RESULT_COUNTER = 0;
+	for (uint32_t t = 0; t < numberOfThreads; ++t) {
+		RESULT_COUNTER += THREAD_RESULT_COUNTERS[t].value;
+	}
+	if (hpcjoin::core::Configuration::MATERIALIZE_RESULTS) {
+		RESULT->flush();
+		JOIN_ASSERT(RESULT->getNumberOfResults() == RESULT_COUNTER, "HashJoin", "Number of materialized results does not match");
 	}
 
+	// Combine the partial aggregates of all threads and all processes
+	if (hpcjoin::core::Configuration::AGGREGATION_GROUPS > 0) {
+		AGGREGATION = THREAD_AGGREGATION_TABLES[0];
+		for (uint32_t t = 1; t < numberOfThreads; ++t) {
+			AGGREGATION->merge(THREAD_AGGREGATION_TABLES[t]);
+			delete THREAD_AGGREGATION_TABLES[t];
+		}
+		delete[] THREAD_AGGREGATION_TABLES;
+		THREAD_AGGREGATION_TABLES = NULL;
+		AGGREGATION->reduce(hpcjoin::core::Configuration::RESULT_AGGREGATION_NODE);
+	}
+
+	delete TASK_QUEUE;
+	TASK_QUEUE = NULL;
+	free(THREAD_RESULT_COUNTERS);
+	THREAD_RESULT_COUNTERS = NULL;
+	for (uint32_t t = 0; t < numberOfThreads; ++t) {
+		delete THREAD_HASH_TABLE_ARENAS[t];
+	}
+	delete[] THREAD_HASH_TABLE_ARENAS;
+	THREAD_HASH_TABLE_ARENAS = NULL;
+
+}
+
+template<typename TUPLE>
+void HashJoin::scheduleLocalProcessing(uint32_t replicaId, hpcjoin::data::Window *innerWindow, hpcjoin::data::Window *outerWindow) {
+
+	TUPLE *innerRelationPartition = (TUPLE *) innerWindow->getPartition(replicaId);
+	uint64_t innerRelationPartitionSize = innerWindow->getPartitionSize(replicaId);
+	TUPLE *outerRelationPartition = (TUPLE *) outerWindow->getPartition(replicaId);
+	uint64_t outerRelationPartitionSize = outerWindow->getPartitionSize(replicaId);
+
+	// Small partitions are joined directly, large ones are partitioned again. The pages of the
+	// received partition are released once it has been processed. The key bits below the network
+	// partitioning fan-out are identical within a partition.
+	hpcjoin::memory::Region *region = new hpcjoin::memory::Region(REGION_MAPPED, innerRelationPartition, innerRelationPartitionSize * sizeof(TUPLE),
+			outerRelationPartition, outerRelationPartitionSize * sizeof(TUPLE));
+	hpcjoin::tasks::LocalPartitioning<TUPLE>::schedule(innerRelationPartitionSize, innerRelationPartition, outerRelationPartitionSize, outerRelationPartition,
+			hpcjoin::core::Configuration::NETWORK_PARTITIONING_FANOUT, 0, region);
+
+}
+
+template<typename TUPLE>
+void HashJoin::scheduleBroadcastProcessing(uint32_t partitionId, void *innerPartitions, uint64_t *innerPartitionStarts, void *outerPartitions, uint64_t *outerPartitionStarts) {
+
+	TUPLE *innerRelationPartition = ((TUPLE *) innerPartitions) + innerPartitionStarts[partitionId];
+	uint64_t innerRelationPartitionSize = innerPartitionStarts[partitionId + 1] - innerPartitionStarts[partitionId];
+	TUPLE *outerRelationPartition = ((TUPLE *) outerPartitions) + outerPartitionStarts[partitionId];
+	uint64_t outerRelationPartitionSize = outerPartitionStarts[partitionId + 1] - outerPartitionStarts[partitionId];
+
+	// Same as for received partitions, the pages are released once the partition has been joined
+	hpcjoin::memory::Region *region = new hpcjoin::memory::Region(REGION_MAPPED, innerRelationPartition, innerRelationPartitionSize * sizeof(TUPLE),
+			outerRelationPartition, outerRelationPartitionSize * sizeof(TUPLE));
+	hpcjoin::tasks::LocalPartitioning<TUPLE>::schedule(innerRelationPartitionSize, innerRelationPartition, outerRelationPartitionSize, outerRelationPartition,
+			hpcjoin::core::Configuration::NETWORK_PARTITIONING_FANOUT, 0, region);
+
+}
+
+hpcjoin::data::JoinResult* HashJoin::getResult() {
+
+	return RESULT;
+
+}
+
+hpcjoin::data::AggregationTable* HashJoin::getAggregation() {
+
+	return AGGREGATION;
+
 }
 
 } /* namespace operators */
@@ -8,15 +8,27 @@
 #define OPERATORS_JOIN_H_
 
 #include <stdint.h>
-#include <queue>
 
 #include <hpcjoin/data/Relation.h>
 #include <hpcjoin/tasks/Task.h>
+#include <hpcjoin/tasks/TaskQueue.h>
+#include <hpcjoin/tasks/HistogramComputation.h>
+#include <hpcjoin/core/Configuration.h>
+#include <hpcjoin/data/JoinResult.h>
+#include <hpcjoin/data/AggregationTable.h>
+#include <hpcjoin/data/Window.h>
+#include <hpcjoin/memory/HashTableArena.h>
 
 
 namespace hpcjoin {
 namespace operators {
 
+typedef struct {
+
+	uint64_t value;
+
+} __attribute__((aligned(64))) thread_counter_t;
+
 class HashJoin {
 
 public:
@@ -28,6 +40,9 @@ public:
 
 	void join();
 
+	hpcjoin::data::JoinResult *getResult();
+	hpcjoin::data::AggregationTable *getAggregation();
+
 protected:
 
 	uint32_t numberOfNodes;
@@ -36,10 +51,28 @@ protected:
 	hpcjoin::data::Relation *innerRelation;
 	hpcjoin::data::Relation *outerRelation;
 
+protected:
+
+	void joinBroadcast(hpcjoin::tasks::HistogramComputation *histogramComputation);
+
+	void prepareLocalProcessing(uint64_t largestInnerPartitionSize);
+	void finishLocalProcessing();
+
+	template<typename TUPLE>
+	void scheduleLocalProcessing(uint32_t replicaId, hpcjoin::data::Window *innerWindow, hpcjoin::data::Window *outerWindow);
+	template<typename TUPLE>
+	void scheduleBroadcastProcessing(uint32_t partitionId, void *innerPartitions, uint64_t *innerPartitionStarts, void *outerPartitions, uint64_t *outerPartitionStarts);
+
 public:
 
 	static uint64_t RESULT_COUNTER;
-	static std::queue<hpcjoin::tasks::Task *> TASK_QUEUE;
+	static join_strategy_t STRATEGY;
+	static thread_counter_t *THREAD_RESULT_COUNTERS;
+	static hpcjoin::tasks::TaskQueue *TASK_QUEUE;
+	static hpcjoin::data::JoinResult *RESULT;
+	static hpcjoin::data::AggregationTable **THREAD_AGGREGATION_TABLES;
+	static hpcjoin::data::AggregationTable *AGGREGATION;
+	static hpcjoin::memory::HashTableArena **THREAD_HASH_TABLE_ARENAS;
 
 
 };
@@ -9,6 +9,7 @@
 #define MSG_TAG_RESULTS 154895
 
 #include <hpcjoin/operators/HashJoin.h>
+#include <hpcjoin/operators/HashAggregation.h>
 #include <hpcjoin/core/Configuration.h>
 #include <hpcjoin/utils/Debug.h>
 
@@ -19,6 +20,8 @@
 #include <unistd.h>
 #include <papi.h>
 #include <sys/stat.h>
+#include <math.h>
+#include <algorithm>
 
 struct timeval hpcjoin::performance::Measurements::joinStart;
 struct timeval hpcjoin::performance::Measurements::joinStop;
@@ -44,37 +47,39 @@ struct timeval hpcjoin::performance::Measurements::histogramAssignmentStart;
 struct timeval hpcjoin::performance::Measurements::histogramAssignmentStop;
 struct timeval hpcjoin::performance::Measurements::histogramOffsetComputationStart;
 struct timeval hpcjoin::performance::Measurements::histogramOffsetComputationStop;
-
-struct timeval hpcjoin::performance::Measurements::networkPartitioningMemoryAllocationStart;
-struct timeval hpcjoin::performance::Measurements::networkPartitioningMemoryAllocationStop;
-struct timeval hpcjoin::performance::Measurements::networkPartitioningMainPartitioningStart;
-struct timeval hpcjoin::performance::Measurements::networkPartitioningMainPartitioningStop;
-struct timeval hpcjoin::performance::Measurements::networkPartitioningFlushPartitioningStart;
-struct timeval hpcjoin::performance::Measurements::networkPartitioningFlushPartitioningStop;
-struct timeval hpcjoin::performance::Measurements::networkPartitioningWindowPutStart;
-struct timeval hpcjoin::performance::Measurements::networkPartitioningWindowPutStop;
-struct timeval hpcjoin::performance::Measurements::networkPartitioningWindowWaitStart;
-struct timeval hpcjoin::performance::Measurements::networkPartitioningWindowWaitStop;
-
-struct timeval hpcjoin::performance::Measurements::localPartitioningTaskStart;
-struct timeval hpcjoin::performance::Measurements::localPartitioningTaskStop;
-struct timeval hpcjoin::performance::Measurements::localPartitioningHistogramComputationStart;
-struct timeval hpcjoin::performance::Measurements::localPartitioningHistogramComputationStop;
-struct timeval hpcjoin::performance::Measurements::localPartitioningOffsetComputationStart;
-struct timeval hpcjoin::performance::Measurements::localPartitioningOffsetComputationStop;
-struct timeval hpcjoin::performance::Measurements::localPartitioningMemoryAllocationStart;
-struct timeval hpcjoin::performance::Measurements::localPartitioningMemoryAllocationStop;
-struct timeval hpcjoin::performance::Measurements::localPartitioningPartitioningStart;
-struct timeval hpcjoin::performance::Measurements::localPartitioningPartitioningStop;
-
-struct timeval hpcjoin::performance::Measurements::buildProbeTaskStart;
-struct timeval hpcjoin::performance::Measurements::buildProbeTaskStop;
-struct timeval hpcjoin::performance::Measurements::buildProbeMemoryAllocationStart;
-struct timeval hpcjoin::performance::Measurements::buildProbeMemoryAllocationStop;
-struct timeval hpcjoin::performance::Measurements::buildProbeBuildStart;
-struct timeval hpcjoin::performance::Measurements::buildProbeBuildStop;
-struct timeval hpcjoin::performance::Measurements::buildProbeProbeStart;
-struct timeval hpcjoin::performance::Measurements::buildProbeProbeStop;
+struct timeval hpcjoin::performance::Measurements::histogramBloomFilterComputationStart;
+struct timeval hpcjoin::performance::Measurements::histogramBloomFilterComputationStop;
+
+__thread struct timeval hpcjoin::performance::Measurements::networkPartitioningMemoryAllocationStart;
+__thread struct timeval hpcjoin::performance::Measurements::networkPartitioningMemoryAllocationStop;
+__thread struct timeval hpcjoin::performance::Measurements::networkPartitioningMainPartitioningStart;
+__thread struct timeval hpcjoin::performance::Measurements::networkPartitioningMainPartitioningStop;
+__thread struct timeval hpcjoin::performance::Measurements::networkPartitioningFlushPartitioningStart;
+__thread struct timeval hpcjoin::performance::Measurements::networkPartitioningFlushPartitioningStop;
+__thread struct timeval hpcjoin::performance::Measurements::networkPartitioningWindowPutStart;
+__thread struct timeval hpcjoin::performance::Measurements::networkPartitioningWindowPutStop;
+__thread struct timeval hpcjoin::performance::Measurements::networkPartitioningWindowWaitStart;
+__thread struct timeval hpcjoin::performance::Measurements::networkPartitioningWindowWaitStop;
+
+__thread struct timeval hpcjoin::performance::Measurements::localPartitioningTaskStart;
+__thread struct timeval hpcjoin::performance::Measurements::localPartitioningTaskStop;
+__thread struct timeval hpcjoin::performance::Measurements::localPartitioningHistogramComputationStart;
+__thread struct timeval hpcjoin::performance::Measurements::localPartitioningHistogramComputationStop;
+__thread struct timeval hpcjoin::performance::Measurements::localPartitioningOffsetComputationStart;
+__thread struct timeval hpcjoin::performance::Measurements::localPartitioningOffsetComputationStop;
+__thread struct timeval hpcjoin::performance::Measurements::localPartitioningMemoryAllocationStart;
+__thread struct timeval hpcjoin::performance::Measurements::localPartitioningMemoryAllocationStop;
+__thread struct timeval hpcjoin::performance::Measurements::localPartitioningPartitioningStart;
+__thread struct timeval hpcjoin::performance::Measurements::localPartitioningPartitioningStop;
+
+__thread struct timeval hpcjoin::performance::Measurements::buildProbeTaskStart;
+__thread struct timeval hpcjoin::performance::Measurements::buildProbeTaskStop;
+__thread struct timeval hpcjoin::performance::Measurements::buildProbeMemoryAllocationStart;
+__thread struct timeval hpcjoin::performance::Measurements::buildProbeMemoryAllocationStop;
+__thread struct timeval hpcjoin::performance::Measurements::buildProbeBuildStart;
+__thread struct timeval hpcjoin::performance::Measurements::buildProbeBuildStop;
+__thread struct timeval hpcjoin::performance::Measurements::buildProbeProbeStart;
+__thread struct timeval hpcjoin::performance::Measurements::buildProbeProbeStop;
 
 uint64_t ** hpcjoin::performance::Measurements::serizlizedResults;
 
@@ -86,8 +91,10 @@ namespace performance {
 uint64_t Measurements::totalCycles;
 uint64_t Measurements::totalTime;
 uint64_t Measurements::phaseTimes[3];
+uint64_t Measurements::phasePeakMemory[3];
 
 void Measurements::startJoin() {
+	readPeakMemory();
 	gettimeofday(&joinStart, NULL);
 	int event = PAPI_TOT_CYC;
 	PAPI_start_counters(&event, 1);
@@ -113,6 +120,7 @@ void Measurements::startHistogramComputation() {
 void Measurements::stopHistogramComputation() {
 	gettimeofday(&histogramComputationStop, NULL);
 	phaseTimes[0] = timeDiff(histogramComputationStop, histogramComputationStart);
+	phasePeakMemory[0] = readPeakMemory();
 }
 
 void Measurements::startNetworkPartitioning() {
@@ -122,6 +130,7 @@ void Measurements::startNetworkPartitioning() {
 void Measurements::stopNetworkPartitioning() {
 	gettimeofday(&networkPartitioningStop, NULL);
 	phaseTimes[1] = timeDiff(networkPartitioningStop, networkPartitioningStart);
+	phasePeakMemory[1] = readPeakMemory();
 }
 
 void Measurements::startLocalProcessing() {
@@ -131,6 +140,7 @@ void Measurements::startLocalProcessing() {
 void Measurements::stopLocalProcessing() {
 	gettimeofday(&localProcessingStop, NULL);
 	phaseTimes[2] = timeDiff(localProcessingStop, localProcessingStart);
+	phasePeakMemory[2] = readPeakMemory();
 }
 
 void Measurements::storePhaseData() {
@@ -139,6 +149,9 @@ void Measurements::storePhaseData() {
 	fprintf(performanceOutputFile, "JHIST\t%lu\tus\n", phaseTimes[0]);
 	fprintf(performanceOutputFile, "JMPI\t%lu\tus\n", phaseTimes[1]);
 	fprintf(performanceOutputFile, "JPROC\t%lu\tus\n", phaseTimes[2]);
+	fprintf(performanceOutputFile, "PEAKHIST\t%lu\tkB\n", phasePeakMemory[0]);
+	fprintf(performanceOutputFile, "PEAKMPI\t%lu\tkB\n", phasePeakMemory[1]);
+	fprintf(performanceOutputFile, "PEAKPROC\t%lu\tkB\n", phasePeakMemory[2]);
 }
 
 /************************************************************/
@@ -160,7 +173,7 @@ void Measurements::startWaitingForNetworkCompletion() {
 
 void Measurements::stopWaitingForNetworkCompletion() {
 	gettimeofday(&waitingForNetworkCompletionStop, NULL);
-	specialTimes[1] = timeDiff(waitingForNetworkCompletionStop, waitingForNetworkCompletionStart);
+	specialTimes[1] += timeDiff(waitingForNetworkCompletionStop, waitingForNetworkCompletionStart);
 }
 
 void Measurements::startLocalProcessingPreparations() {
@@ -188,10 +201,18 @@ uint64_t Measurements::histogramGlobalHistogramComputationIdx = 0;
 uint64_t Measurements::histogramGlobalHistogramComputationTimes[2];
 
 uint64_t Measurements::histogramAssignmentComputationTime;
+double Measurements::histogramAssignmentPredictedLoad = 0;
+double Measurements::histogramAssignmentImbalanceFactor = 0;
+uint32_t Measurements::histogramAssignmentHeavyPartitions = 0;
 
 uint64_t Measurements::histogramOffsetComputationIdx = 0;
 uint64_t Measurements::histogramOffsetComputationTimes[2];
 
+uint64_t Measurements::histogramBloomFilterComputationTime = 0;
+uint64_t Measurements::histogramBloomFilterSize = 0;
+uint64_t Measurements::histogramBloomFilterRemainingTuples = 0;
+uint32_t Measurements::histogramPackedBitsPerTuple[2] = { 64, 64 };
+
 void Measurements::startHistogramLocalHistogramComputation() {
 	gettimeofday(&histogramLocalHistogramComputationStart, NULL);
 }
@@ -225,7 +246,13 @@ void Measurements::startHistogramAssignmentComputation() {
 
 void Measurements::stopHistogramAssignmentComputation() {
 	gettimeofday(&histogramAssignmentStop, NULL);
-	histogramAssignmentComputationTime = timeDiff(histogramAssignmentStop, histogramAssignmentStop);
+	histogramAssignmentComputationTime = timeDiff(histogramAssignmentStop, histogramAssignmentStart);
+}
+
+void Measurements::setHistogramAssignmentLoad(double predictedLoad, double imbalanceFactor, uint32_t numberOfHeavyPartitions) {
+	histogramAssignmentPredictedLoad = predictedLoad;
+	histogramAssignmentImbalanceFactor = imbalanceFactor;
+	histogramAssignmentHeavyPartitions = numberOfHeavyPartitions;
 }
 
 void Measurements::startHistogramOffsetComputation() {
@@ -241,6 +268,25 @@ void Measurements::stopHistogramOffsetComputation() {
 	++histogramOffsetComputationIdx;
 }
 
+void Measurements::startHistogramBloomFilterComputation() {
+	gettimeofday(&histogramBloomFilterComputationStart, NULL);
+}
+
+void Measurements::stopHistogramBloomFilterComputation(uint64_t filterSize) {
+	gettimeofday(&histogramBloomFilterComputationStop, NULL);
+	histogramBloomFilterComputationTime = timeDiff(histogramBloomFilterComputationStop, histogramBloomFilterComputationStart);
+	histogramBloomFilterSize = filterSize;
+}
+
+void Measurements::setHistogramBloomFilterResult(uint64_t remainingTuples) {
+	histogramBloomFilterRemainingTuples = remainingTuples;
+}
+
+void Measurements::setHistogramPackedFormat(uint32_t innerBitsPerTuple, uint32_t outerBitsPerTuple) {
+	histogramPackedBitsPerTuple[0] = innerBitsPerTuple;
+	histogramPackedBitsPerTuple[1] = outerBitsPerTuple;
+}
+
 void Measurements::storeHistogramComputationData() {
 	fprintf(performanceOutputFile, "HILOCAL\t%lu\tus\n", histogramLocalHistogramComputationTimes[0]);
 	fprintf(performanceOutputFile, "HOLOCELEM\t%lu\ttuples\n", histogramLocalHistogramComputationElements[0]);
@@ -253,20 +299,25 @@ void Measurements::storeHistogramComputationData() {
 	fprintf(performanceOutputFile, "HIGLOBAL\t%lu\tus\n", histogramGlobalHistogramComputationTimes[0]);
 	fprintf(performanceOutputFile, "HOGLOBAL\t%lu\tus\n", histogramGlobalHistogramComputationTimes[1]);
 	fprintf(performanceOutputFile, "HASSIGN\t%lu\tus\n", histogramAssignmentComputationTime);
+	fprintf(performanceOutputFile, "HASSIGNLOAD\t%.0f\tcost\n", histogramAssignmentPredictedLoad);
+	fprintf(performanceOutputFile, "HASSIGNIMB\t%.3f\tfactor\n", histogramAssignmentImbalanceFactor);
+	fprintf(performanceOutputFile, "HHEAVY\t%u\tpartitions\n", histogramAssignmentHeavyPartitions);
 	fprintf(performanceOutputFile, "HIOFFCOMP\t%lu\tus\n", histogramOffsetComputationTimes[0]);
 	fprintf(performanceOutputFile, "HOOFFCOMP\t%lu\tus\n", histogramOffsetComputationTimes[1]);
+	fprintf(performanceOutputFile, "HBLOOM\t%lu\tus\n", histogramBloomFilterComputationTime);
+	fprintf(performanceOutputFile, "HBLOOMSIZE\t%lu\tbytes\n", histogramBloomFilterSize);
+	fprintf(performanceOutputFile, "HBLOOMKEPT\t%lu\ttuples\n", histogramBloomFilterRemainingTuples);
+	fprintf(performanceOutputFile, "HIPACKBITS\t%u\tbits\n", histogramPackedBitsPerTuple[0]);
+	fprintf(performanceOutputFile, "HOPACKBITS\t%u\tbits\n", histogramPackedBitsPerTuple[1]);
 }
 
 /************************************************************/
 
-uint64_t Measurements::networkPartitioningMemoryAllocationIdx = 0;
-uint64_t Measurements::networkPartitioningMemoryAllocationTimes[2];
+uint64_t Measurements::networkPartitioningMemoryAllocationTimes[2] = { 0, 0 };
 
-uint64_t Measurements::networkPartitioningMainPartitioningIdx = 0;
-uint64_t Measurements::networkPartitioningMainPartitioningTimes[2];
+uint64_t Measurements::networkPartitioningMainPartitioningTimes[2] = { 0, 0 };
 
-uint64_t Measurements::networkPartitioningFlushPartitioningIdx = 0;
-uint64_t Measurements::networkPartitioningFlushPartitioningTimes[2];
+uint64_t Measurements::networkPartitioningFlushPartitioningTimes[2] = { 0, 0 };
 
 uint64_t Measurements::networkPartitioningWindowPutCount = 0;
 uint64_t Measurements::networkPartitioningWindowPutTimeSum = 0;
@@ -278,39 +329,34 @@ void Measurements::startNetworkPartitioningMemoryAllocation() {
 	gettimeofday(&networkPartitioningMemoryAllocationStart, NULL);
 }
 
-void Measurements::stopNetworkPartitioningMemoryAllocation(uint64_t numberOfElemenets) {
+void Measurements::stopNetworkPartitioningMemoryAllocation(bool isInnerRelation, uint64_t numberOfElemenets) {
 	gettimeofday(&networkPartitioningMemoryAllocationStop, NULL);
 	uint64_t time = timeDiff(networkPartitioningMemoryAllocationStop, networkPartitioningMemoryAllocationStart);
 
-	JOIN_ASSERT(networkPartitioningMemoryAllocationIdx < 2, "Performance", "Index out of bounds");
-	networkPartitioningMemoryAllocationTimes[networkPartitioningMemoryAllocationIdx] = time;
-	++networkPartitioningMemoryAllocationIdx;
+	// Slices are partitioned concurrently, report the sum over all slices
+	__sync_fetch_and_add(&(networkPartitioningMemoryAllocationTimes[isInnerRelation ? 0 : 1]), time);
 }
 
 void Measurements::startNetworkPartitioningMainPartitioning() {
 	gettimeofday(&networkPartitioningMainPartitioningStart, NULL);
 }
 
-void Measurements::stopNetworkPartitioningMainPartitioning(uint64_t numberOfElemenets) {
+void Measurements::stopNetworkPartitioningMainPartitioning(bool isInnerRelation, uint64_t numberOfElemenets) {
 	gettimeofday(&networkPartitioningMainPartitioningStop, NULL);
 	uint64_t time = timeDiff(networkPartitioningMainPartitioningStop, networkPartitioningMainPartitioningStart);
 
-	JOIN_ASSERT(networkPartitioningMainPartitioningIdx < 2, "Performance", "Index out of bounds");
-	networkPartitioningMainPartitioningTimes[networkPartitioningMainPartitioningIdx] = time;
-	++networkPartitioningMainPartitioningIdx;
+	__sync_fetch_and_add(&(networkPartitioningMainPartitioningTimes[isInnerRelation ? 0 : 1]), time);
 }
 
 void Measurements::startNetworkPartitioningFlushPartitioning() {
 	gettimeofday(&networkPartitioningFlushPartitioningStart, NULL);
 }
 
-void Measurements::stopNetworkPartitioningFlushPartitioning() {
+void Measurements::stopNetworkPartitioningFlushPartitioning(bool isInnerRelation) {
 	gettimeofday(&networkPartitioningFlushPartitioningStop, NULL);
 	uint64_t time = timeDiff(networkPartitioningFlushPartitioningStop, networkPartitioningFlushPartitioningStart);
 
-	JOIN_ASSERT(networkPartitioningFlushPartitioningIdx < 2, "Performance", "Index out of bounds");
-	networkPartitioningFlushPartitioningTimes[networkPartitioningFlushPartitioningIdx] = time;
-	++networkPartitioningFlushPartitioningIdx;
+	__sync_fetch_and_add(&(networkPartitioningFlushPartitioningTimes[isInnerRelation ? 0 : 1]), time);
 }
 
 void Measurements::startNetworkPartitioningWindowPut() {
@@ -320,8 +366,8 @@ void Measurements::startNetworkPartitioningWindowPut() {
 void Measurements::stopNetworkPartitioningWindowPut() {
 	gettimeofday(&networkPartitioningWindowPutStop, NULL);
 	uint64_t time = timeDiff(networkPartitioningWindowPutStop, networkPartitioningWindowPutStart);
-	networkPartitioningWindowPutTimeSum += time;
-	++networkPartitioningWindowPutCount;
+	__sync_fetch_and_add(&networkPartitioningWindowPutTimeSum, time);
+	__sync_fetch_and_add(&networkPartitioningWindowPutCount, 1);
 }
 
 void Measurements::startNetworkPartitioningWindowWait() {
@@ -331,8 +377,8 @@ void Measurements::startNetworkPartitioningWindowWait() {
 void Measurements::stopNetworkPartitioningWindowWait() {
 	gettimeofday(&networkPartitioningWindowWaitStop, NULL);
 	uint64_t time = timeDiff(networkPartitioningWindowWaitStop, networkPartitioningWindowWaitStart);
-	networkPartitioningWindowWaitTimeSum += time;
-	++networkPartitioningWindowWaitCount;
+	__sync_fetch_and_add(&networkPartitioningWindowWaitTimeSum, time);
+	__sync_fetch_and_add(&networkPartitioningWindowWaitCount, 1);
 }
 
 void Measurements::storeNetworkPartitioningData() {
@@ -375,8 +421,8 @@ void Measurements::startLocalPartitioningTask() {
 void Measurements::stopLocalPartitioningTask() {
 	gettimeofday(&localPartitioningTaskStop, NULL);
 	uint64_t time = timeDiff(localPartitioningTaskStop, localPartitioningTaskStart);
-	localPartitioningTaskTimeSum += time;
-	++localPartitioningTaskCount;
+	__sync_fetch_and_add(&localPartitioningTaskTimeSum, time);
+	__sync_fetch_and_add(&localPartitioningTaskCount, 1);
 }
 
 void Measurements::startLocalPartitioningHistogramComputation() {
@@ -386,9 +432,9 @@ void Measurements::startLocalPartitioningHistogramComputation() {
 void Measurements::stopLocalPartitioningHistogramComputation(uint64_t numberOfElemenets) {
 	gettimeofday(&localPartitioningHistogramComputationStop, NULL);
 	uint64_t time = timeDiff(localPartitioningHistogramComputationStop, localPartitioningHistogramComputationStart);
-	localPartitioningHistogramComputationTimeSum += time;
-	++localPartitioningHistogramComputationCount;
-	localPartitioningHistogramComputationElementSum += numberOfElemenets;
+	__sync_fetch_and_add(&localPartitioningHistogramComputationTimeSum, time);
+	__sync_fetch_and_add(&localPartitioningHistogramComputationCount, 1);
+	__sync_fetch_and_add(&localPartitioningHistogramComputationElementSum, numberOfElemenets);
 }
 
 void Measurements::startLocalPartitioningOffsetComputation() {
@@ -398,8 +444,8 @@ void Measurements::startLocalPartitioningOffsetComputation() {
 void Measurements::stopLocalPartitioningOffsetComputation() {
 	gettimeofday(&localPartitioningOffsetComputationStop, NULL);
 	uint64_t time = timeDiff(localPartitioningOffsetComputationStop, localPartitioningOffsetComputationStart);
-	localPartitioningOffsetComputationTimeSum += time;
-	++localPartitioningOffsetComputationCount;
+	__sync_fetch_and_add(&localPartitioningOffsetComputationTimeSum, time);
+	__sync_fetch_and_add(&localPartitioningOffsetComputationCount, 1);
 }
 
 void Measurements::startLocalPartitioningMemoryAllocation() {
@@ -409,9 +455,9 @@ void Measurements::startLocalPartitioningMemoryAllocation() {
 void Measurements::stopLocalPartitioningMemoryAllocation(uint64_t bufferSize) {
 	gettimeofday(&localPartitioningMemoryAllocationStop, NULL);
 	uint64_t time = timeDiff(localPartitioningMemoryAllocationStop, localPartitioningMemoryAllocationStart);
-	localPartitioningMemoryAllocationTimeSum += time;
-	++localPartitioningMemoryAllocationCount;
-	localPartitioningMemoryAllocationSizeSum += bufferSize;
+	__sync_fetch_and_add(&localPartitioningMemoryAllocationTimeSum, time);
+	__sync_fetch_and_add(&localPartitioningMemoryAllocationCount, 1);
+	__sync_fetch_and_add(&localPartitioningMemoryAllocationSizeSum, bufferSize);
 }
 
 void Measurements::startLocalPartitioningPartitioning() {
@@ -421,9 +467,9 @@ void Measurements::startLocalPartitioningPartitioning() {
 void Measurements::stopLocalPartitioningPartitioning(uint64_t numberOfElemenets) {
 	gettimeofday(&localPartitioningPartitioningStop, NULL);
 	uint64_t time = timeDiff(localPartitioningPartitioningStop, localPartitioningPartitioningStart);
-	localPartitioningPartitioningTimeSum += time;
-	++localPartitioningPartitioningCount;
-	localPartitioningPartitioningElementSum += numberOfElemenets;
+	__sync_fetch_and_add(&localPartitioningPartitioningTimeSum, time);
+	__sync_fetch_and_add(&localPartitioningPartitioningCount, 1);
+	__sync_fetch_and_add(&localPartitioningPartitioningElementSum, numberOfElemenets);
 }
 
 void Measurements::storeLocalPartitioningData() {
@@ -462,8 +508,8 @@ void Measurements::startBuildProbeTask() {
 void Measurements::stopBuildProbeTask() {
 	gettimeofday(&buildProbeTaskStop, NULL);
 	uint64_t time = timeDiff(buildProbeTaskStop, buildProbeTaskStart);
-	buildProbeTaskTimeSum += time;
-	++buildProbeTaskCount;
+	__sync_fetch_and_add(&buildProbeTaskTimeSum, time);
+	__sync_fetch_and_add(&buildProbeTaskCount, 1);
 }
 
 void Measurements::startBuildProbeMemoryAllocation() {
@@ -473,9 +519,9 @@ void Measurements::startBuildProbeMemoryAllocation() {
 void Measurements::stopBuildProbeMemoryAllocation(uint64_t bufferSize) {
 	gettimeofday(&buildProbeMemoryAllocationStop, NULL);
 	uint64_t time = timeDiff(buildProbeMemoryAllocationStop, buildProbeMemoryAllocationStart);
-	buildProbeMemoryAllocationTimeSum += time;
-	++buildProbeMemoryAllocationCount;
-	buildProbeMemoryAllocationSizeSum += bufferSize;
+	__sync_fetch_and_add(&buildProbeMemoryAllocationTimeSum, time);
+	__sync_fetch_and_add(&buildProbeMemoryAllocationCount, 1);
+	__sync_fetch_and_add(&buildProbeMemoryAllocationSizeSum, bufferSize);
 }
 
 void Measurements::startBuildProbeBuild() {
@@ -485,9 +531,9 @@ void Measurements::startBuildProbeBuild() {
 void Measurements::stopBuildProbeBuild(uint64_t numberOfElemenets) {
 	gettimeofday(&buildProbeBuildStop, NULL);
 	uint64_t time = timeDiff(buildProbeBuildStop, buildProbeBuildStart);
-	buildProbeBuildTimeSum += time;
-	++buildProbeBuildCount;
-	buildProbeBuildElementSum += numberOfElemenets;
+	__sync_fetch_and_add(&buildProbeBuildTimeSum, time);
+	__sync_fetch_and_add(&buildProbeBuildCount, 1);
+	__sync_fetch_and_add(&buildProbeBuildElementSum, numberOfElemenets);
 }
 
 void Measurements::startBuildProbeProbe() {
@@ -497,9 +543,9 @@ void Measurements::startBuildProbeProbe() {
 void Measurements::stopBuildProbeProbe(uint64_t numberOfElemenets) {
 	gettimeofday(&buildProbeProbeStop, NULL);
 	uint64_t time = timeDiff(buildProbeProbeStop, buildProbeProbeStart);
-	buildProbeProbeTimeSum += time;
-	++buildProbeProbeCount;
-	buildProbeProbeElementSum += numberOfElemenets;
+	__sync_fetch_and_add(&buildProbeProbeTimeSum, time);
+	__sync_fetch_and_add(&buildProbeProbeCount, 1);
+	__sync_fetch_and_add(&buildProbeProbeElementSum, numberOfElemenets);
 }
 
 void Measurements::storeBuildProbeData() {
@@ -515,13 +561,21 @@ void Measurements::storeBuildProbeData() {
 
 /************************************************************/
 
-#define NUM_OF_RESULT_ELEMENTS 10
+#define NUM_OF_RESULT_ELEMENTS 11
+#define NUM_OF_STATISTIC_ELEMENTS 9
+
+// Timings of the serialized results (starting at index 1) summarized over the measured iterations
+static const char *STATISTIC_NAMES[NUM_OF_STATISTIC_ELEMENTS] = { "Join", "Histogram", "Network", "Local", "WinAlloc", "PartWait", "LocalPrep", "LocalPart", "LocalBP" };
+
+std::vector<uint64_t *> Measurements::iterationResults;
+std::string Measurements::experimentPath;
 
 uint64_t* Measurements::serializeResults() {
 
 	uint64_t *result = (uint64_t *) calloc(NUM_OF_RESULT_ELEMENTS, sizeof(uint64_t));
 
-	result[0] = hpcjoin::operators::HashJoin::RESULT_COUNTER;
+	// Only one operator runs per experiment, the other counter is zero
+	result[0] = hpcjoin::operators::HashJoin::RESULT_COUNTER + hpcjoin::operators::HashAggregation::RESULT_COUNTER;
 	result[1] = totalTime;
 	result[2] = phaseTimes[0];
 	result[3] = phaseTimes[1];
@@ -531,6 +585,7 @@ uint64_t* Measurements::serializeResults() {
 	result[7] = specialTimes[2];
 	result[8] = localPartitioningTaskTimeSum;
 	result[9] = buildProbeTaskTimeSum;
+	result[10] = (uint64_t) histogramAssignmentPredictedLoad;
 
 	return result;
 
@@ -664,9 +719,146 @@ void Measurements::printMeasurements(uint32_t numberOfNodes, uint32_t nodeId) {
 	printf("\n");
 	averageLocalBuildProbeTime /= numberOfNodes;
 
+	printf("[RESULTS] PredLoad:\t");
+	for (uint32_t n = 0; n < numberOfNodes; ++n) {
+		printf("%lu\t", serizlizedResults[n][10]);
+	}
+	printf("\n");
+
+	printf("[RESULTS] Imbalance:\t%.3f\t%u\n", histogramAssignmentImbalanceFactor, histogramAssignmentHeavyPartitions);
+
 	printf("[RESULTS] Summary:\t%lu\t%.3f\t%.3f\t%.3f\t%.3f\n", totalNumberOfTuples, ((double) averageJoinTime) / 1000, ((double) averageHistogramTime) / 1000,
 			((double) averageNetworkTime) / 1000, ((double) averageLocalTime) / 1000);
 
+	recordIteration(numberOfNodes);
+
+}
+
+void Measurements::recordIteration(uint32_t numberOfNodes) {
+
+	// An iteration takes as long as its slowest process
+	uint64_t *iteration = (uint64_t *) calloc(NUM_OF_RESULT_ELEMENTS, sizeof(uint64_t));
+	for (uint32_t n = 0; n < numberOfNodes; ++n) {
+		iteration[0] += serizlizedResults[n][0];
+		for (uint32_t e = 1; e < NUM_OF_RESULT_ELEMENTS; ++e) {
+			iteration[e] = std::max(iteration[e], serizlizedResults[n][e]);
+		}
+		free(serizlizedResults[n]);
+	}
+	delete[] serizlizedResults;
+	serizlizedResults = NULL;
+
+	iterationResults.push_back(iteration);
+
+}
+
+uint64_t Measurements::computePercentile(uint64_t* sortedValues, uint64_t numberOfValues, double percentile) {
+
+	// Nearest-rank percentile
+	uint64_t rank = (uint64_t) ceil(percentile * numberOfValues);
+	return sortedValues[(rank > 0) ? rank - 1 : 0];
+
+}
+
+void Measurements::printStatistics() {
+
+	uint64_t numberOfIterations = iterationResults.size();
+	if (numberOfIterations == 0) {
+		return;
+	}
+
+	char statisticsFullPath[1024];
+	memset(statisticsFullPath, 0, 1024);
+	sprintf(statisticsFullPath, "%s/statistics.csv", experimentPath.c_str());
+	FILE *statisticsOutputFile = fopen(statisticsFullPath, "w");
+	JOIN_ASSERT(statisticsOutputFile != NULL, "Measurements", "Could not create statistics file");
+	fprintf(statisticsOutputFile, "phase,iterations,min,median,p99\n");
+
+	printf("[STATS] Iterations:\t%lu\n", numberOfIterations);
+	printf("[STATS] Tuples:\t%lu\n", iterationResults[numberOfIterations - 1][0]);
+
+	uint64_t *values = (uint64_t *) calloc(numberOfIterations, sizeof(uint64_t));
+	for (uint32_t s = 0; s < NUM_OF_STATISTIC_ELEMENTS; ++s) {
+		for (uint64_t i = 0; i < numberOfIterations; ++i) {
+			values[i] = iterationResults[i][s + 1];
+		}
+		std::sort(values, values + numberOfIterations);
+		uint64_t median = computePercentile(values, numberOfIterations, 0.5);
+		uint64_t p99 = computePercentile(values, numberOfIterations, 0.99);
+		printf("[STATS] %s:\t%.3f\t%.3f\t%.3f\n", STATISTIC_NAMES[s], ((double) values[0]) / 1000, ((double) median) / 1000, ((double) p99) / 1000);
+		fprintf(statisticsOutputFile, "%s,%lu,%lu,%lu,%lu\n", STATISTIC_NAMES[s], numberOfIterations, values[0], median, p99);
+	}
+	free(values);
+
+	fflush(statisticsOutputFile);
+	fclose(statisticsOutputFile);
+
+	for (uint64_t i = 0; i < numberOfIterations; ++i) {
+		free(iterationResults[i]);
+	}
+	iterationResults.clear();
+
+}
+
+void Measurements::reset() {
+
+	totalCycles = 0;
+	totalTime = 0;
+	memset(phaseTimes, 0, sizeof(phaseTimes));
+	memset(phasePeakMemory, 0, sizeof(phasePeakMemory));
+	memset(specialTimes, 0, sizeof(specialTimes));
+
+	histogramLocalHistogramComputationIdx = 0;
+	memset(histogramLocalHistogramComputationTimes, 0, sizeof(histogramLocalHistogramComputationTimes));
+	memset(histogramLocalHistogramComputationElements, 0, sizeof(histogramLocalHistogramComputationElements));
+	histogramGlobalHistogramComputationIdx = 0;
+	memset(histogramGlobalHistogramComputationTimes, 0, sizeof(histogramGlobalHistogramComputationTimes));
+	histogramAssignmentComputationTime = 0;
+	histogramAssignmentPredictedLoad = 0;
+	histogramAssignmentImbalanceFactor = 0;
+	histogramAssignmentHeavyPartitions = 0;
+	histogramOffsetComputationIdx = 0;
+	memset(histogramOffsetComputationTimes, 0, sizeof(histogramOffsetComputationTimes));
+	histogramBloomFilterComputationTime = 0;
+	histogramBloomFilterSize = 0;
+	histogramBloomFilterRemainingTuples = 0;
+	histogramPackedBitsPerTuple[0] = 64;
+	histogramPackedBitsPerTuple[1] = 64;
+
+	memset(networkPartitioningMemoryAllocationTimes, 0, sizeof(networkPartitioningMemoryAllocationTimes));
+	memset(networkPartitioningMainPartitioningTimes, 0, sizeof(networkPartitioningMainPartitioningTimes));
+	memset(networkPartitioningFlushPartitioningTimes, 0, sizeof(networkPartitioningFlushPartitioningTimes));
+	networkPartitioningWindowPutCount = 0;
+	networkPartitioningWindowPutTimeSum = 0;
+	networkPartitioningWindowWaitCount = 0;
+	networkPartitioningWindowWaitTimeSum = 0;
+
+	localPartitioningTaskCount = 0;
+	localPartitioningTaskTimeSum = 0;
+	localPartitioningHistogramComputationCount = 0;
+	localPartitioningHistogramComputationTimeSum = 0;
+	localPartitioningHistogramComputationElementSum = 0;
+	localPartitioningOffsetComputationCount = 0;
+	localPartitioningOffsetComputationTimeSum = 0;
+	localPartitioningMemoryAllocationCount = 0;
+	localPartitioningMemoryAllocationTimeSum = 0;
+	localPartitioningMemoryAllocationSizeSum = 0;
+	localPartitioningPartitioningCount = 0;
+	localPartitioningPartitioningTimeSum = 0;
+	localPartitioningPartitioningElementSum = 0;
+
+	buildProbeTaskCount = 0;
+	buildProbeTaskTimeSum = 0;
+	buildProbeMemoryAllocationCount = 0;
+	buildProbeMemoryAllocationTimeSum = 0;
+	buildProbeMemoryAllocationSizeSum = 0;
+	buildProbeBuildCount = 0;
+	buildProbeBuildTimeSum = 0;
+	buildProbeBuildElementSum = 0;
+	buildProbeProbeCount = 0;
+	buildProbeProbeTimeSum = 0;
+	buildProbeProbeElementSum = 0;
+
 }
 
 FILE * Measurements::performanceOutputFile = NULL;
@@ -708,6 +900,7 @@ void Measurements::init(uint32_t nodeId, uint32_t numberOfNodes, std::string tag
 
 	if (nodeId == hpcjoin::core::Configuration::RESULT_AGGREGATION_NODE) {
 		printf("[INFO] Experiment data located at %s\n", experimentFullPath);
+		experimentPath = experimentFullPath;
 	}
 
 }
@@ -813,6 +1006,33 @@ void Measurements::printMemoryUtilization(const char* name) {
 
 }
 
+uint64_t Measurements::readPeakMemory() {
+
+	uint64_t peakMemory = 0;
+	char line[128];
+
+	FILE* file = fopen("/proc/self/status", "r");
+	if (file != NULL) {
+		while (fgets(line, 128, file) != NULL) {
+			if (strncmp(line, "VmHWM:", 6) == 0) {
+				peakMemory = parseInfoLine(line);
+				break;
+			}
+		}
+		fclose(file);
+	}
+
+	// Reset the peak so that the next call reports the peak of the next phase
+	file = fopen("/proc/self/clear_refs", "w");
+	if (file != NULL) {
+		fprintf(file, "5");
+		fclose(file);
+	}
+
+	return peakMemory;
+
+}
+
 } /* namespace performance */
 } /* namespace hpcjoin */
 
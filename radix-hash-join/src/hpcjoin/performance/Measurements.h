@@ -12,6 +12,7 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <string>
+#include <vector>
 
 namespace hpcjoin {
 namespace performance {
@@ -48,6 +49,9 @@ protected:
 	static uint64_t totalCycles;
 	static uint64_t totalTime;
 	static uint64_t phaseTimes[3];
+	static uint64_t phasePeakMemory[3];
+
+	static uint64_t readPeakMemory();
 
 	/**
 	 * Timing for synchronization and preparations
@@ -86,8 +90,13 @@ public:
 	static void stopHistogramGlobalHistogramComputation();
 	static void startHistogramAssignmentComputation();
 	static void stopHistogramAssignmentComputation();
+	static void setHistogramAssignmentLoad(double predictedLoad, double imbalanceFactor, uint32_t numberOfHeavyPartitions);
 	static void startHistogramOffsetComputation();
 	static void stopHistogramOffsetComputation();
+	static void startHistogramBloomFilterComputation();
+	static void stopHistogramBloomFilterComputation(uint64_t filterSize);
+	static void setHistogramBloomFilterResult(uint64_t remainingTuples);
+	static void setHistogramPackedFormat(uint32_t innerBitsPerTuple, uint32_t outerBitsPerTuple);
 	static void storeHistogramComputationData();
 
 protected:
@@ -104,6 +113,8 @@ protected:
 	static struct timeval histogramAssignmentStop;
 	static struct timeval histogramOffsetComputationStart;
 	static struct timeval histogramOffsetComputationStop;
+	static struct timeval histogramBloomFilterComputationStart;
+	static struct timeval histogramBloomFilterComputationStop;
 
 	static uint64_t histogramLocalHistogramComputationIdx;
 	static uint64_t histogramLocalHistogramComputationTimes[2];
@@ -111,19 +122,26 @@ protected:
 	static uint64_t histogramGlobalHistogramComputationIdx;
 	static uint64_t histogramGlobalHistogramComputationTimes[2];
 	static uint64_t histogramAssignmentComputationTime;
+	static double histogramAssignmentPredictedLoad;
+	static double histogramAssignmentImbalanceFactor;
+	static uint32_t histogramAssignmentHeavyPartitions;
 	static uint64_t histogramOffsetComputationIdx;
 	static uint64_t histogramOffsetComputationTimes[2];
+	static uint64_t histogramBloomFilterComputationTime;
+	static uint64_t histogramBloomFilterSize;
+	static uint64_t histogramBloomFilterRemainingTuples;
+	static uint32_t histogramPackedBitsPerTuple[2];
 
 
 
 public:
 
 	static void startNetworkPartitioningMemoryAllocation();
-	static void stopNetworkPartitioningMemoryAllocation(uint64_t bufferSize);
+	static void stopNetworkPartitioningMemoryAllocation(bool isInnerRelation, uint64_t bufferSize);
 	static void startNetworkPartitioningMainPartitioning();
-	static void stopNetworkPartitioningMainPartitioning(uint64_t numberOfElemenets);
+	static void stopNetworkPartitioningMainPartitioning(bool isInnerRelation, uint64_t numberOfElemenets);
 	static void startNetworkPartitioningFlushPartitioning();
-	static void stopNetworkPartitioningFlushPartitioning();
+	static void stopNetworkPartitioningFlushPartitioning(bool isInnerRelation);
 	static void startNetworkPartitioningWindowPut();
 	static void stopNetworkPartitioningWindowPut();
 	static void startNetworkPartitioningWindowWait();
@@ -132,22 +150,19 @@ public:
 
 protected:
 
-	static struct timeval networkPartitioningMemoryAllocationStart;
-	static struct timeval networkPartitioningMemoryAllocationStop;
-	static struct timeval networkPartitioningMainPartitioningStart;
-	static struct timeval networkPartitioningMainPartitioningStop;
-	static struct timeval networkPartitioningFlushPartitioningStart;
-	static struct timeval networkPartitioningFlushPartitioningStop;
-	static struct timeval networkPartitioningWindowPutStart;
-	static struct timeval networkPartitioningWindowPutStop;
-	static struct timeval networkPartitioningWindowWaitStart;
-	static struct timeval networkPartitioningWindowWaitStop;
-
-	static uint64_t networkPartitioningMemoryAllocationIdx;
+	static __thread struct timeval networkPartitioningMemoryAllocationStart;
+	static __thread struct timeval networkPartitioningMemoryAllocationStop;
+	static __thread struct timeval networkPartitioningMainPartitioningStart;
+	static __thread struct timeval networkPartitioningMainPartitioningStop;
+	static __thread struct timeval networkPartitioningFlushPartitioningStart;
+	static __thread struct timeval networkPartitioningFlushPartitioningStop;
+	static __thread struct timeval networkPartitioningWindowPutStart;
+	static __thread struct timeval networkPartitioningWindowPutStop;
+	static __thread struct timeval networkPartitioningWindowWaitStart;
+	static __thread struct timeval networkPartitioningWindowWaitStop;
+
 	static uint64_t networkPartitioningMemoryAllocationTimes[2];
-	static uint64_t networkPartitioningMainPartitioningIdx;
 	static uint64_t networkPartitioningMainPartitioningTimes[2];
-	static uint64_t networkPartitioningFlushPartitioningIdx;
 	static uint64_t networkPartitioningFlushPartitioningTimes[2];
 	static uint64_t networkPartitioningWindowPutCount;
 	static uint64_t networkPartitioningWindowPutTimeSum;
@@ -174,16 +189,16 @@ public:
 
 protected:
 
-	static struct timeval localPartitioningTaskStart;
-	static struct timeval localPartitioningTaskStop;
-	static struct timeval localPartitioningHistogramComputationStart;
-	static struct timeval localPartitioningHistogramComputationStop;
-	static struct timeval localPartitioningOffsetComputationStart;
-	static struct timeval localPartitioningOffsetComputationStop;
-	static struct timeval localPartitioningMemoryAllocationStart;
-	static struct timeval localPartitioningMemoryAllocationStop;
-	static struct timeval localPartitioningPartitioningStart;
-	static struct timeval localPartitioningPartitioningStop;
+	static __thread struct timeval localPartitioningTaskStart;
+	static __thread struct timeval localPartitioningTaskStop;
+	static __thread struct timeval localPartitioningHistogramComputationStart;
+	static __thread struct timeval localPartitioningHistogramComputationStop;
+	static __thread struct timeval localPartitioningOffsetComputationStart;
+	static __thread struct timeval localPartitioningOffsetComputationStop;
+	static __thread struct timeval localPartitioningMemoryAllocationStart;
+	static __thread struct timeval localPartitioningMemoryAllocationStop;
+	static __thread struct timeval localPartitioningPartitioningStart;
+	static __thread struct timeval localPartitioningPartitioningStop;
 
 	static uint64_t localPartitioningTaskCount;
 	static uint64_t localPartitioningTaskTimeSum;
@@ -217,14 +232,14 @@ public:
 
 protected:
 
-	static struct timeval buildProbeTaskStart;
-	static struct timeval buildProbeTaskStop;
-	static struct timeval buildProbeMemoryAllocationStart;
-	static struct timeval buildProbeMemoryAllocationStop;
-	static struct timeval buildProbeBuildStart;
-	static struct timeval buildProbeBuildStop;
-	static struct timeval buildProbeProbeStart;
-	static struct timeval buildProbeProbeStop;
+	static __thread struct timeval buildProbeTaskStart;
+	static __thread struct timeval buildProbeTaskStop;
+	static __thread struct timeval buildProbeMemoryAllocationStart;
+	static __thread struct timeval buildProbeMemoryAllocationStop;
+	static __thread struct timeval buildProbeBuildStart;
+	static __thread struct timeval buildProbeBuildStop;
+	static __thread struct timeval buildProbeProbeStart;
+	static __thread struct timeval buildProbeProbeStop;
 
 	static uint64_t buildProbeTaskCount;
 	static uint64_t buildProbeTaskTimeSum;
@@ -251,11 +266,19 @@ public:
 	static void printMeasurements(uint32_t numberOfNodes, uint32_t nodeId);
 	static void storeAllMeasurements();
 
+	static void reset();
+	static void printStatistics();
+
 protected:
 
 	static uint64_t timeDiff(struct timeval stop, struct timeval start);
 	static uint64_t **serizlizedResults;
 
+	static void recordIteration(uint32_t numberOfNodes);
+	static uint64_t computePercentile(uint64_t *sortedValues, uint64_t numberOfValues, double percentile);
+	static std::vector<uint64_t *> iterationResults;
+	static std::string experimentPath;
+
 protected:
 
 	static FILE * performanceOutputFile;
@@ -0,0 +1,77 @@
+/**
+ * @author  Claude Barthels <claudeb@inf.ethz.ch>
+ * (c) 2016, ETH Zurich, Systems Group
+ *
+ */
+
+#include "BroadcastPartitioning.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <hpcjoin/core/Configuration.h>
+#include <hpcjoin/utils/Debug.h>
+#include <hpcjoin/utils/Dispatch.h>
+
+#define HASH_BIT_MODULO(KEY, MASK, NBITS) (((KEY) & (MASK)) >> (NBITS))
+
+namespace hpcjoin {
+namespace tasks {
+
+BroadcastPartitioning::BroadcastPartitioning(hpcjoin::data::Tuple *data, uint64_t numberOfElements, uint64_t *partitionOffsets, void *output, hpcjoin::data::BloomFilter *filter) {
+
+	this->data = data;
+	this->numberOfElements = numberOfElements;
+
+	this->partitionOffsets = partitionOffsets;
+	this->output = output;
+
+	this->filter = filter;
+
+}
+
+BroadcastPartitioning::~BroadcastPartitioning() {
+
+}
+
+void BroadcastPartitioning::execute() {
+
+	TUPLE_FORMAT_DISPATCH(hpcjoin::core::Configuration::TUPLE_FORMAT, partitionData);
+
+}
+
+template<typename TUPLE>
+void BroadcastPartitioning::partitionData() {
+
+	TYPED_FANOUT_DISPATCH(TUPLE, hpcjoin::core::Configuration::NETWORK_PARTITIONING_FANOUT, partition);
+
+}
+
+template<typename TUPLE, uint32_t FANOUT>
+void BroadcastPartitioning::partition() {
+
+	uint64_t offsets[1 << FANOUT];
+	memcpy(offsets, this->partitionOffsets, (1 << FANOUT) * sizeof(uint64_t));
+
+	TUPLE * const out = (TUPLE *) this->output;
+	hpcjoin::data::Tuple * const in = this->data;
+
+	// Tuples rejected by the filter have not been counted in the histogram
+	for (uint64_t i = 0; i < this->numberOfElements; ++i) {
+		if (this->filter != NULL && !this->filter->contains(in[i].key)) {
+			continue;
+		}
+		uint32_t partitionIdx = HASH_BIT_MODULO(in[i].key, (1 << FANOUT) - 1, 0);
+		out[offsets[partitionIdx]++].pack(in[i].key, in[i].rid, FANOUT);
+	}
+
+	JOIN_DEBUG("Broadcast Partitioning", "Partitioned %lu tuples", this->numberOfElements);
+
+}
+
+task_type_t BroadcastPartitioning::getType() {
+	return TASK_BROADCAST_PARTITION;
+}
+
+} /* namespace tasks */
+} /* namespace hpcjoin */
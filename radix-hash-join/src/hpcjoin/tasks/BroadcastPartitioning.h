@@ -0,0 +1,61 @@
+/**
+ * @author  Claude Barthels <claudeb@inf.ethz.ch>
+ * (c) 2016, ETH Zurich, Systems Group
+ *
+ */
+
+#ifndef HPCJOIN_TASKS_BROADCASTPARTITIONING_H_
+#define HPCJOIN_TASKS_BROADCASTPARTITIONING_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <hpcjoin/tasks/Task.h>
+#include <hpcjoin/data/Tuple.h>
+#include <hpcjoin/data/BloomFilter.h>
+
+namespace hpcjoin {
+namespace tasks {
+
+/**
+ * Partitions a chunk of tuples into local memory with the network partitioning fan-out and
+ * compresses them in the same way as the network pass. The partitions of all chunks share
+ * one output array, every chunk writes partition p starting at partitionOffsets[p].
+ */
+
+class BroadcastPartitioning : public Task {
+
+public:
+
+	BroadcastPartitioning(hpcjoin::data::Tuple *data, uint64_t numberOfElements, uint64_t *partitionOffsets, void *output, hpcjoin::data::BloomFilter *filter = NULL);
+	~BroadcastPartitioning();
+
+public:
+
+	void execute();
+	task_type_t getType();
+
+protected:
+
+	template<typename TUPLE>
+	void partitionData();
+
+	template<typename TUPLE, uint32_t FANOUT>
+	void partition();
+
+protected:
+
+	hpcjoin::data::Tuple *data;
+	uint64_t numberOfElements;
+
+	uint64_t *partitionOffsets;
+	void *output;
+
+	hpcjoin::data::BloomFilter *filter;
+
+};
+
+} /* namespace tasks */
+} /* namespace hpcjoin */
+
+#endif /* HPCJOIN_TASKS_BROADCASTPARTITIONING_H_ */
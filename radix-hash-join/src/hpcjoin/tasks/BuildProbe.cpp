@@ -9,6 +9,9 @@
 #include <stdlib.h>
 
 #include <hpcjoin/operators/HashJoin.h>
+#include <hpcjoin/tasks/TaskQueue.h>
+#include <hpcjoin/data/ResultBuffer.h>
+#include <hpcjoin/data/BucketHashTable.h>
 #include <hpcjoin/core/Configuration.h>
 #include <hpcjoin/utils/Debug.h>
 #include <hpcjoin/performance/Measurements.h>
@@ -24,12 +27,12 @@
         V++;                                    \
     } while(0)
 
-#define HASH_BIT_MODULO(KEY, MASK, NBITS) (((KEY) & (MASK)) >> (NBITS))
 
 namespace hpcjoin {
 namespace tasks {
 
-BuildProbe::BuildProbe(uint64_t innerPartitionSize, hpcjoin::data::CompressedTuple *innerPartition, uint64_t outerPartitionSize, hpcjoin::data::CompressedTuple *outerPartition) {
+template<typename TUPLE>
+BuildProbe<TUPLE>::BuildProbe(uint64_t innerPartitionSize, TUPLE *innerPartition, uint64_t outerPartitionSize, TUPLE *outerPartition, uint32_t hashShift, hpcjoin::memory::Region *region) {
 
 	this->innerPartitionSize = innerPartitionSize;
 	this->innerPartition = innerPartition;
@@ -37,13 +40,19 @@ BuildProbe::BuildProbe(uint64_t innerPartitionSize, hpcjoin::data::CompressedTup
 	this->outerPartitionSize = outerPartitionSize;
 	this->outerPartition = outerPartition;
 
+	this->hashShift = hashShift;
+
+	this->region = region;
+
 }
 
-BuildProbe::~BuildProbe() {
+template<typename TUPLE>
+BuildProbe<TUPLE>::~BuildProbe() {
 
 }
 
-void BuildProbe::execute() {
+template<typename TUPLE>
+void BuildProbe<TUPLE>::execute() {
 
 #ifdef MEASUREMENT_DETAILS_LOCALBP
 	hpcjoin::performance::Measurements::startBuildProbeTask();
@@ -51,20 +60,56 @@ void BuildProbe::execute() {
 
 	JOIN_DEBUG("Build-Probe", "Executing build-probe phase of size %lu x %lu", innerPartitionSize, outerPartitionSize);
 
-	uint32_t const keyShift = hpcjoin::core::Configuration::NETWORK_PARTITIONING_FANOUT + hpcjoin::core::Configuration::PAYLOAD_BITS;
-	uint32_t const shiftBits =  keyShift + hpcjoin::core::Configuration::LOCAL_PARTITIONING_FANOUT;
+	uint32_t const keyShift = hpcjoin::core::Configuration::NETWORK_PARTITIONING_FANOUT;
 
+	hpcjoin::data::ResultBuffer *resultBuffer = NULL;
+	if (hpcjoin::core::Configuration::MATERIALIZE_RESULTS) {
+		resultBuffer = hpcjoin::operators::HashJoin::RESULT->getBuffer(hpcjoin::tasks::TaskQueue::getThreadId());
+	}
 
-	uint64_t N = this->innerPartitionSize;
-	NEXT_POW_2(N);
-	uint64_t const MASK = (N-1) << (shiftBits);
+	hpcjoin::data::AggregationTable *aggregationTable = NULL;
+	if (hpcjoin::core::Configuration::AGGREGATION_GROUPS > 0) {
+		aggregationTable = hpcjoin::operators::HashJoin::THREAD_AGGREGATION_TABLES[hpcjoin::tasks::TaskQueue::getThreadId()];
+	}
+
+	hpcjoin::memory::HashTableArena *arena = hpcjoin::operators::HashJoin::THREAD_HASH_TABLE_ARENAS[hpcjoin::tasks::TaskQueue::getThreadId()];
+
+	uint64_t matches = 0;
+	if (this->innerPartitionSize > 0 && this->outerPartitionSize > 0) {
+		if (hpcjoin::core::Configuration::HASH_TABLE_LAYOUT == HASH_TABLE_CHAINED) {
+			matches = buildProbeChained(keyShift, resultBuffer, aggregationTable, arena);
+		} else {
+			matches = buildProbeBucketized(keyShift, resultBuffer, aggregationTable, arena);
+		}
+	}
+
+	hpcjoin::operators::HashJoin::THREAD_RESULT_COUNTERS[hpcjoin::tasks::TaskQueue::getThreadId()].value += matches;
+
+	if (this->region != NULL) {
+		this->region->release();
+	}
+
+#ifdef MEASUREMENT_DETAILS_LOCALBP
+	hpcjoin::performance::Measurements::stopBuildProbeTask();
+#endif
+
+}
+
+template<typename TUPLE>
+uint64_t BuildProbe<TUPLE>::buildProbeChained(uint32_t keyShift, hpcjoin::data::ResultBuffer *resultBuffer, hpcjoin::data::AggregationTable *aggregationTable, hpcjoin::memory::HashTableArena *arena) {
+
+	uint32_t const shiftBits = this->hashShift;
+
+	uint64_t const N = computeNumberOfBuckets(this->innerPartitionSize);
+	uint64_t const MASK = (N-1);
 
 #ifdef MEASUREMENT_DETAILS_LOCALBP
 	hpcjoin::performance::Measurements::startBuildProbeMemoryAllocation();
 #endif
 
-	uint64_t *hashTableNext = (uint64_t*) calloc(this->innerPartitionSize, sizeof(uint64_t));
-	uint64_t *hashTableBucket = (uint64_t*) calloc(N, sizeof(uint64_t));
+	// Next pointers are written before they are read, only the buckets need to be cleared
+	uint64_t *hashTableNext = (uint64_t*) arena->getMemory(hpcjoin::memory::ARENA_CHAIN_NEXT, this->innerPartitionSize * sizeof(uint64_t));
+	uint64_t *hashTableBucket = (uint64_t*) arena->getClearedMemory(hpcjoin::memory::ARENA_CHAIN_BUCKETS, N * sizeof(uint64_t));
 
 #ifdef MEASUREMENT_DETAILS_LOCALBP
 	hpcjoin::performance::Measurements::stopBuildProbeMemoryAllocation(this->innerPartitionSize);
@@ -78,7 +123,7 @@ void BuildProbe::execute() {
 #endif
 
 	for (uint64_t t=0; t<this->innerPartitionSize;) {
-		uint64_t idx = HASH_BIT_MODULO(innerPartition[t].value, MASK, shiftBits);
+		uint64_t idx = innerPartition[t].getKey(shiftBits) & MASK;
 		hashTableNext[t] = hashTableBucket[idx];
 		hashTableBucket[idx]  = ++t;
 	}
@@ -94,11 +139,36 @@ void BuildProbe::execute() {
 #endif
 
 	uint64_t matches = 0;
-	for (uint64_t t=0; t<this->outerPartitionSize; ++t) {
-		uint64_t idx = HASH_BIT_MODULO(outerPartition[t].value, MASK, shiftBits);
-		for(uint64_t hit = hashTableBucket[idx]; hit > 0; hit = hashTableNext[hit-1]){
-			if((outerPartition[t].value >> keyShift) == (innerPartition[hit-1].value >> keyShift)){
-				++matches;
+	if (aggregationTable != NULL) {
+		for (uint64_t t=0; t<this->outerPartitionSize; ++t) {
+			uint64_t idx = outerPartition[t].getKey(shiftBits) & MASK;
+			for(uint64_t hit = hashTableBucket[idx]; hit > 0; hit = hashTableNext[hit-1]){
+				if(outerPartition[t].getKey(keyShift) == innerPartition[hit-1].getKey(keyShift)){
+					if (resultBuffer != NULL) {
+						resultBuffer->append(innerPartition[hit-1].getRid(), outerPartition[t].getRid());
+					}
+					aggregationTable->add(innerPartition[hit-1].getRid(), outerPartition[t].getRid());
+					++matches;
+				}
+			}
+		}
+	} else if (resultBuffer != NULL) {
+		for (uint64_t t=0; t<this->outerPartitionSize; ++t) {
+			uint64_t idx = outerPartition[t].getKey(shiftBits) & MASK;
+			for(uint64_t hit = hashTableBucket[idx]; hit > 0; hit = hashTableNext[hit-1]){
+				if(outerPartition[t].getKey(keyShift) == innerPartition[hit-1].getKey(keyShift)){
+					resultBuffer->append(innerPartition[hit-1].getRid(), outerPartition[t].getRid());
+					++matches;
+				}
+			}
+		}
+	} else {
+		for (uint64_t t=0; t<this->outerPartitionSize; ++t) {
+			uint64_t idx = outerPartition[t].getKey(shiftBits) & MASK;
+			for(uint64_t hit = hashTableBucket[idx]; hit > 0; hit = hashTableNext[hit-1]){
+				if(outerPartition[t].getKey(keyShift) == innerPartition[hit-1].getKey(keyShift)){
+					++matches;
+				}
 			}
 		}
 	}
@@ -107,21 +177,71 @@ void BuildProbe::execute() {
 	hpcjoin::performance::Measurements::stopBuildProbeProbe(this->outerPartitionSize);
 #endif
 
-	free(hashTableNext);
-	free(hashTableBucket);
+	return matches;
+
+}
 
-	hpcjoin::operators::HashJoin::RESULT_COUNTER += matches;
+template<typename TUPLE>
+uint64_t BuildProbe<TUPLE>::buildProbeBucketized(uint32_t keyShift, hpcjoin::data::ResultBuffer *resultBuffer, hpcjoin::data::AggregationTable *aggregationTable, hpcjoin::memory::HashTableArena *arena) {
 
 #ifdef MEASUREMENT_DETAILS_LOCALBP
-	hpcjoin::performance::Measurements::stopBuildProbeTask();
+	hpcjoin::performance::Measurements::startBuildProbeMemoryAllocation();
 #endif
 
+	hpcjoin::data::BucketHashTable<TUPLE> *hashTable = new hpcjoin::data::BucketHashTable<TUPLE>(this->innerPartitionSize, this->hashShift, keyShift, arena);
+
+#ifdef MEASUREMENT_DETAILS_LOCALBP
+	hpcjoin::performance::Measurements::stopBuildProbeMemoryAllocation(this->innerPartitionSize);
+#endif
+
+	// Build hash table
+
+#ifdef MEASUREMENT_DETAILS_LOCALBP
+	hpcjoin::performance::Measurements::startBuildProbeBuild();
+#endif
+
+	hashTable->build(this->innerPartition, this->innerPartitionSize);
+
+#ifdef MEASUREMENT_DETAILS_LOCALBP
+	hpcjoin::performance::Measurements::stopBuildProbeBuild(this->innerPartitionSize);
+#endif
+
+	// Probe hash table
+
+#ifdef MEASUREMENT_DETAILS_LOCALBP
+	hpcjoin::performance::Measurements::startBuildProbeProbe();
+#endif
+
+	uint64_t matches = hashTable->probe(this->outerPartition, this->outerPartitionSize, resultBuffer, aggregationTable);
+
+#ifdef MEASUREMENT_DETAILS_LOCALBP
+	hpcjoin::performance::Measurements::stopBuildProbeProbe(this->outerPartitionSize);
+#endif
+
+	delete hashTable;
+
+	return matches;
+
+}
+
+template<typename TUPLE>
+uint64_t BuildProbe<TUPLE>::computeNumberOfBuckets(uint64_t numberOfElements) {
+
+	uint64_t N = numberOfElements;
+	NEXT_POW_2(N);
+	return N;
+
 }
 
-task_type_t BuildProbe::getType() {
+template<typename TUPLE>
+task_type_t BuildProbe<TUPLE>::getType() {
 	return TASK_BUILD_PROBE;
 }
 
+template class BuildProbe<hpcjoin::data::CompressedTuple>;
+template class BuildProbe<hpcjoin::data::WideCompressedTuple>;
+template class BuildProbe<hpcjoin::data::NarrowCompressedTuple>;
+
 } /* namespace tasks */
 } /* namespace hpcjoin */
 
@@ -11,15 +11,21 @@
 
 #include <hpcjoin/tasks/Task.h>
 #include <hpcjoin/data/CompressedTuple.h>
+#include <hpcjoin/data/WideCompressedTuple.h>
+#include <hpcjoin/data/ResultBuffer.h>
+#include <hpcjoin/data/AggregationTable.h>
+#include <hpcjoin/memory/HashTableArena.h>
+#include <hpcjoin/memory/Region.h>
 
 namespace hpcjoin {
 namespace tasks {
 
+template<typename TUPLE>
 class BuildProbe : public Task {
 
 public:
 
-	BuildProbe(uint64_t innerPartitionSize, hpcjoin::data::CompressedTuple *innerPartition, uint64_t outerPartitionSize, hpcjoin::data::CompressedTuple *outerPartition);
+	BuildProbe(uint64_t innerPartitionSize, TUPLE *innerPartition, uint64_t outerPartitionSize, TUPLE *outerPartition, uint32_t hashShift, hpcjoin::memory::Region *region = NULL);
 	~BuildProbe();
 
 public:
@@ -27,12 +33,25 @@ public:
 	void execute();
 	task_type_t getType();
 
+public:
+
+	static uint64_t computeNumberOfBuckets(uint64_t numberOfElements);
+
+protected:
+
+	uint64_t buildProbeChained(uint32_t keyShift, hpcjoin::data::ResultBuffer *resultBuffer, hpcjoin::data::AggregationTable *aggregationTable, hpcjoin::memory::HashTableArena *arena);
+	uint64_t buildProbeBucketized(uint32_t keyShift, hpcjoin::data::ResultBuffer *resultBuffer, hpcjoin::data::AggregationTable *aggregationTable, hpcjoin::memory::HashTableArena *arena);
+
 protected:
 
 	uint64_t innerPartitionSize;
-	hpcjoin::data::CompressedTuple *innerPartition;
+	TUPLE *innerPartition;
 	uint64_t outerPartitionSize;
-	hpcjoin::data::CompressedTuple *outerPartition;
+	TUPLE *outerPartition;
+
+	uint32_t hashShift;
+
+	hpcjoin::memory::Region *region;
 
 };
 
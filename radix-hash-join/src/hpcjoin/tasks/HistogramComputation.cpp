@@ -10,6 +10,7 @@
 
 #include <hpcjoin/core/Configuration.h>
 #include <hpcjoin/utils/Debug.h>
+#include <hpcjoin/performance/Measurements.h>
 
 namespace hpcjoin {
 namespace tasks {
@@ -22,16 +23,27 @@ HistogramComputation::HistogramComputation(uint32_t numberOfNodes, uint32_t node
 	this->innerRelation = innerRelation;
 	this->outerRelation = outerRelation;
 
-	this->innerRelationLocalHistogram = new hpcjoin::histograms::LocalHistogram(innerRelation);
-	this->outerRelationLocalHistogram = new hpcjoin::histograms::LocalHistogram(outerRelation);
+	this->innerRelationLocalHistogram = new hpcjoin::histograms::LocalHistogram(innerRelation, hpcjoin::core::Configuration::NETWORK_THREADS_PER_NODE);
+	this->outerRelationLocalHistogram = new hpcjoin::histograms::LocalHistogram(outerRelation, hpcjoin::core::Configuration::NETWORK_THREADS_PER_NODE);
 
 	this->innerRelationGlobalHistogram = new hpcjoin::histograms::GlobalHistogram(this->innerRelationLocalHistogram);
 	this->outerRelationGlobalHistogram = new hpcjoin::histograms::GlobalHistogram(this->outerRelationLocalHistogram);
 
+	// Packed formats are only known once the value ranges have been computed
+	this->innerFormat = NULL;
+	this->outerFormat = NULL;
+	if (hpcjoin::core::Configuration::ENABLE_PACKED_TRANSFERS) {
+		this->innerFormat = new hpcjoin::data::PackedFormat(innerRelation);
+		this->outerFormat = new hpcjoin::data::PackedFormat(outerRelation);
+	}
+
 	this->assignment = new hpcjoin::histograms::AssignmentMap(this->numberOfNodes, this->innerRelationGlobalHistogram, this->outerRelationGlobalHistogram);
 
-	this->innerOffsets = new hpcjoin::histograms::OffsetMap(this->numberOfNodes, this->innerRelationLocalHistogram, this->innerRelationGlobalHistogram, this->assignment);
-	this->outerOffsets = new hpcjoin::histograms::OffsetMap(this->numberOfNodes, this->outerRelationLocalHistogram, this->outerRelationGlobalHistogram, this->assignment);
+	// Inner partitions are replicated to all nodes of a heavy partition, outer partitions are split
+	this->innerOffsets = new hpcjoin::histograms::OffsetMap(this->numberOfNodes, this->nodeId, this->innerRelationLocalHistogram, this->innerRelationGlobalHistogram, this->assignment, true, this->innerFormat);
+	this->outerOffsets = new hpcjoin::histograms::OffsetMap(this->numberOfNodes, this->nodeId, this->outerRelationLocalHistogram, this->outerRelationGlobalHistogram, this->assignment, false, this->outerFormat);
+
+	this->bloomFilter = NULL;
 
 }
 
@@ -48,17 +60,48 @@ HistogramComputation::~HistogramComputation() {
 	delete this->innerOffsets;
 	delete this->outerOffsets;
 
+	delete this->bloomFilter;
+
+	delete this->innerFormat;
+	delete this->outerFormat;
+
 }
 
 void HistogramComputation::execute() {
 
 	this->innerRelationLocalHistogram->computeLocalHistogram();
-	this->outerRelationLocalHistogram->computeLocalHistogram();
-
 	this->innerRelationGlobalHistogram->computeGlobalHistogram();
+
+	// Outer tuples without a join partner are removed before they are counted and sent
+	if (hpcjoin::core::Configuration::ENABLE_BLOOM_FILTER) {
+		computeBloomFilter();
+	}
+
+	this->outerRelationLocalHistogram->computeLocalHistogram(this->bloomFilter);
 	this->outerRelationGlobalHistogram->computeGlobalHistogram();
 
+#ifdef MEASUREMENT_DETAILS_HISTOGRAM
+	if (this->bloomFilter != NULL) {
+		uint64_t remainingTuples = 0;
+		uint64_t *histogram = this->outerRelationLocalHistogram->getLocalHistogram();
+		for (uint32_t p = 0; p < hpcjoin::core::Configuration::NETWORK_PARTITIONING_COUNT; ++p) {
+			remainingTuples += histogram[p];
+		}
+		hpcjoin::performance::Measurements::setHistogramBloomFilterResult(remainingTuples);
+	}
+#endif
+
 	this->assignment->computePartitionAssignment();
+	hpcjoin::performance::Measurements::setHistogramAssignmentLoad(this->assignment->getPredictedLoad(this->nodeId), this->assignment->getImbalanceFactor(),
+			this->assignment->getNumberOfHeavyPartitions());
+
+	if (hpcjoin::core::Configuration::ENABLE_PACKED_TRANSFERS) {
+		this->innerFormat->computeFormat();
+		this->outerFormat->computeFormat();
+#ifdef MEASUREMENT_DETAILS_HISTOGRAM
+		hpcjoin::performance::Measurements::setHistogramPackedFormat(this->innerFormat->getBitsPerTuple(), this->outerFormat->getBitsPerTuple());
+#endif
+	}
 
 	this->innerOffsets->computeOffsets();
 	this->outerOffsets->computeOffsets();
@@ -84,6 +127,12 @@ uint64_t* HistogramComputation::getOuterRelationLocalHistogram() {
 
 }
 
+uint64_t* HistogramComputation::getOuterRelationSliceHistograms() {
+
+	return this->outerRelationLocalHistogram->getSliceHistograms();
+
+}
+
 uint64_t* HistogramComputation::getInnerRelationGlobalHistogram() {
 
 	return this->innerRelationGlobalHistogram->getGlobalHistogram();
@@ -122,6 +171,46 @@ uint64_t* HistogramComputation::getOuterRelationWriteOffsets() {
 
 }
 
+void HistogramComputation::computeBloomFilter() {
+
+#ifdef MEASUREMENT_DETAILS_HISTOGRAM
+	hpcjoin::performance::Measurements::startHistogramBloomFilterComputation();
+#endif
+
+	this->bloomFilter = new hpcjoin::data::BloomFilter(this->innerRelation->getGlobalSize());
+	this->bloomFilter->insert(this->innerRelation);
+	this->bloomFilter->combine();
+
+#ifdef MEASUREMENT_DETAILS_HISTOGRAM
+	hpcjoin::performance::Measurements::stopHistogramBloomFilterComputation(this->bloomFilter->getSizeInBytes());
+#endif
+
+}
+
+hpcjoin::histograms::AssignmentMap* HistogramComputation::getAssignmentMap() {
+
+	return this->assignment;
+
+}
+
+hpcjoin::histograms::OffsetMap* HistogramComputation::getInnerRelationOffsetMap() {
+
+	return this->innerOffsets;
+
+}
+
+hpcjoin::histograms::OffsetMap* HistogramComputation::getOuterRelationOffsetMap() {
+
+	return this->outerOffsets;
+
+}
+
+hpcjoin::data::BloomFilter* HistogramComputation::getBloomFilter() {
+
+	return this->bloomFilter;
+
+}
+
 task_type_t HistogramComputation::getType() {
 	return TASK_HISTOGRAM;
 }
@@ -13,6 +13,8 @@
 #include <hpcjoin/histograms/LocalHistogram.h>
 #include <hpcjoin/histograms/AssignmentMap.h>
 #include <hpcjoin/histograms/OffsetMap.h>
+#include <hpcjoin/data/BloomFilter.h>
+#include <hpcjoin/data/PackedFormat.h>
 
 namespace hpcjoin {
 namespace tasks {
@@ -33,12 +35,14 @@ protected:
 
 	void computeLocalHistograms();
 	void computeGlobalInformation();
+	void computeBloomFilter();
 
 public:
 
 	uint32_t *getAssignment();
 	uint64_t *getInnerRelationLocalHistogram();
 	uint64_t *getOuterRelationLocalHistogram();
+	uint64_t *getOuterRelationSliceHistograms();
 	uint64_t *getInnerRelationGlobalHistogram();
 	uint64_t *getOuterRelationGlobalHistogram();
 	uint64_t *getInnerRelationBaseOffsets();
@@ -46,6 +50,11 @@ public:
 	uint64_t *getInnerRelationWriteOffsets();
 	uint64_t *getOuterRelationWriteOffsets();
 
+	hpcjoin::histograms::AssignmentMap *getAssignmentMap();
+	hpcjoin::histograms::OffsetMap *getInnerRelationOffsetMap();
+	hpcjoin::histograms::OffsetMap *getOuterRelationOffsetMap();
+	hpcjoin::data::BloomFilter *getBloomFilter();
+
 protected:
 
 	uint32_t nodeId;
@@ -65,6 +74,11 @@ protected:
 	hpcjoin::histograms::OffsetMap *innerOffsets;
 	hpcjoin::histograms::OffsetMap *outerOffsets;
 
+	hpcjoin::data::BloomFilter *bloomFilter;
+
+	hpcjoin::data::PackedFormat *innerFormat;
+	hpcjoin::data::PackedFormat *outerFormat;
+
 };
 
 } /* namespace tasks */
@@ -0,0 +1,127 @@
+/**
+ * @author  Claude Barthels <claudeb@inf.ethz.ch>
+ * (c) 2016, ETH Zurich, Systems Group
+ *
+ */
+
+#include "LocalAggregation.h"
+
+#include <stdlib.h>
+
+#include <hpcjoin/core/Configuration.h>
+#include <hpcjoin/operators/HashAggregation.h>
+#include <hpcjoin/tasks/LocalPartitioning.h>
+#include <hpcjoin/data/GroupTable.h>
+#include <hpcjoin/memory/Pool.h>
+#include <hpcjoin/utils/Debug.h>
+
+namespace hpcjoin {
+namespace tasks {
+
+template<typename TUPLE>
+LocalAggregation<TUPLE>::LocalAggregation(uint32_t partitionId, uint64_t countPartitionSize, TUPLE *countPartition, uint64_t sumPartitionSize, TUPLE *sumPartition, hpcjoin::memory::Region *region) {
+
+	this->partitionId = partitionId;
+
+	this->countPartitionSize = countPartitionSize;
+	this->countPartition = countPartition;
+
+	this->sumPartitionSize = sumPartitionSize;
+	this->sumPartition = sumPartition;
+
+	this->region = region;
+	if (region != NULL) {
+		region->acquire();
+	}
+
+}
+
+template<typename TUPLE>
+LocalAggregation<TUPLE>::~LocalAggregation() {
+
+}
+
+template<typename TUPLE>
+void LocalAggregation<TUPLE>::execute() {
+
+	// The key bits below the network partitioning fan-out are the partition id
+	uint32_t const keyShift = hpcjoin::core::Configuration::NETWORK_PARTITIONING_FANOUT;
+
+	bool exceedsCache = (this->countPartitionSize * sizeof(TUPLE) > hpcjoin::core::Configuration::CACHE_BUDGET_BYTES);
+	bool bitsRemaining = (keyShift + hpcjoin::core::Configuration::LOCAL_PARTITIONING_FANOUT <= TUPLE::getKeyBits());
+
+	if (!exceedsCache || !bitsRemaining) {
+		aggregate(this->countPartitionSize, this->countPartition, this->sumPartitionSize, this->sumPartition, keyShift);
+		if (this->region != NULL) {
+			this->region->release();
+		}
+		return;
+	}
+
+	JOIN_DEBUG("Local Aggregation", "Partition of size %lu requires a local pass", this->countPartitionSize);
+
+	uint64_t *countHistogram = NULL;
+	uint64_t *countOffsets = NULL;
+	uint64_t countOutputSize = 0;
+	TUPLE *countPartitions = hpcjoin::tasks::LocalPartitioning<TUPLE>::partition(this->countPartition, this->countPartitionSize, keyShift, &countHistogram, &countOffsets, &countOutputSize);
+
+	uint64_t *sumHistogram = NULL;
+	uint64_t *sumOffsets = NULL;
+	uint64_t sumOutputSize = 0;
+	TUPLE *sumPartitions = hpcjoin::tasks::LocalPartitioning<TUPLE>::partition(this->sumPartition, this->sumPartitionSize, keyShift, &sumHistogram, &sumOffsets, &sumOutputSize);
+
+	// The input is no longer needed
+	if (this->region != NULL) {
+		this->region->release();
+	}
+
+	for (uint32_t p = 0; p < hpcjoin::core::Configuration::LOCAL_PARTITIONING_COUNT; ++p) {
+		if (countHistogram[p] > 0) {
+			aggregate(countHistogram[p], countPartitions + countOffsets[p], sumHistogram[p], sumPartitions + sumOffsets[p], keyShift);
+		}
+	}
+
+	hpcjoin::memory::Pool::free(countPartitions, countOutputSize);
+	hpcjoin::memory::Pool::free(sumPartitions, sumOutputSize);
+
+	free(countHistogram);
+	free(sumHistogram);
+
+	free(countOffsets);
+	free(sumOffsets);
+
+}
+
+template<typename TUPLE>
+void LocalAggregation<TUPLE>::aggregate(uint64_t countSize, TUPLE* counts, uint64_t sumSize, TUPLE* sums, uint32_t keyShift) {
+
+	// Every group has a count on the same process as its sum, the count tuples bound the table size
+	hpcjoin::data::GroupTable *groups = new hpcjoin::data::GroupTable(countSize);
+
+	for (uint64_t t = 0; t < countSize; ++t) {
+		groups->add(counts[t].getKey(keyShift), counts[t].getRid(), 0);
+	}
+	for (uint64_t t = 0; t < sumSize; ++t) {
+		groups->add(sums[t].getKey(keyShift), 0, sums[t].getRid());
+	}
+
+	uint64_t numberOfGroups = groups->getNumberOfGroups();
+	uint64_t offset = __sync_fetch_and_add(&(hpcjoin::operators::HashAggregation::NUMBER_OF_GROUPS), numberOfGroups);
+	JOIN_ASSERT(offset + numberOfGroups <= hpcjoin::operators::HashAggregation::GROUP_CAPACITY, "Local Aggregation", "Group output is too small");
+	groups->copyGroups(hpcjoin::operators::HashAggregation::GROUPS + offset, keyShift, this->partitionId);
+
+	delete groups;
+
+}
+
+template<typename TUPLE>
+task_type_t LocalAggregation<TUPLE>::getType() {
+	return TASK_AGGREGATION;
+}
+
+template class LocalAggregation<hpcjoin::data::CompressedTuple>;
+template class LocalAggregation<hpcjoin::data::WideCompressedTuple>;
+template class LocalAggregation<hpcjoin::data::NarrowCompressedTuple>;
+
+} /* namespace tasks */
+} /* namespace hpcjoin */
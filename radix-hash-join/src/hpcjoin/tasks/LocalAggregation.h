@@ -0,0 +1,62 @@
+/**
+ * @author  Claude Barthels <claudeb@inf.ethz.ch>
+ * (c) 2016, ETH Zurich, Systems Group
+ *
+ */
+
+#ifndef HPCJOIN_TASKS_LOCALAGGREGATION_H_
+#define HPCJOIN_TASKS_LOCALAGGREGATION_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <hpcjoin/tasks/Task.h>
+#include <hpcjoin/data/CompressedTuple.h>
+#include <hpcjoin/data/WideCompressedTuple.h>
+#include <hpcjoin/data/NarrowCompressedTuple.h>
+#include <hpcjoin/memory/Region.h>
+
+namespace hpcjoin {
+namespace tasks {
+
+/**
+ * Combines the partial aggregates of one received partition. The counts and the sums of the
+ * groups arrive as two relations of compressed tuples, the rid holds the partial value.
+ * Partitions which exceed the cache budget are split with one local partitioning pass and
+ * every sub-partition is aggregated in a cache-sized group table.
+ */
+
+template<typename TUPLE>
+class LocalAggregation : public Task {
+
+public:
+
+	LocalAggregation(uint32_t partitionId, uint64_t countPartitionSize, TUPLE *countPartition, uint64_t sumPartitionSize, TUPLE *sumPartition, hpcjoin::memory::Region *region = NULL);
+	~LocalAggregation();
+
+public:
+
+	void execute();
+	task_type_t getType();
+
+protected:
+
+	void aggregate(uint64_t countSize, TUPLE *counts, uint64_t sumSize, TUPLE *sums, uint32_t keyShift);
+
+protected:
+
+	uint32_t partitionId;
+
+	uint64_t countPartitionSize;
+	TUPLE *countPartition;
+	uint64_t sumPartitionSize;
+	TUPLE *sumPartition;
+
+	hpcjoin::memory::Region *region;
+
+};
+
+} /* namespace tasks */
+} /* namespace hpcjoin */
+
+#endif /* HPCJOIN_TASKS_LOCALAGGREGATION_H_ */
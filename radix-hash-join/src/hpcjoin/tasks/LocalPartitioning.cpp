@@ -8,6 +8,7 @@
 
 #include <immintrin.h>
 #include <stdlib.h>
+#include <type_traits>
 
 #include <hpcjoin/core/Configuration.h>
 #include <hpcjoin/operators/HashJoin.h>
@@ -15,26 +16,30 @@
 #include <hpcjoin/utils/Debug.h>
 #include <hpcjoin/performance/Measurements.h>
 #include <hpcjoin/memory/Pool.h>
+#include <hpcjoin/utils/Dispatch.h>
 
 #define LOCAL_PARTITIONING_CACHELINE_SIZE (64)
-#define TUPLES_PER_CACHELINE (LOCAL_PARTITIONING_CACHELINE_SIZE / sizeof(hpcjoin::data::CompressedTuple))
+#define TUPLES_PER_CACHELINE (LOCAL_PARTITIONING_CACHELINE_SIZE / sizeof(TUPLE))
 
-#define HASH_BIT_MODULO(KEY, MASK, NBITS) (((KEY) & (MASK)) >> (NBITS))
+#define HASH_SHIFT_MODULO(KEY, MASK, NBITS) (((KEY) >> (NBITS)) & (MASK))
 
-typedef union {
+template<typename TUPLE>
+union cacheline_t {
     struct {
-    	hpcjoin::data::CompressedTuple tuples[TUPLES_PER_CACHELINE];
+    	TUPLE tuples[TUPLES_PER_CACHELINE];
     } tuples;
     struct {
-    	hpcjoin::data::CompressedTuple tuples[TUPLES_PER_CACHELINE - 1];
-        uint64_t slot;
+    	TUPLE tuples[TUPLES_PER_CACHELINE - 1];
+        // The slot needs to fit into the last tuple
+        typename std::conditional<(sizeof(TUPLE) < sizeof(uint64_t)), uint32_t, uint64_t>::type slot;
     } data;
-} cacheline_t;
+};
 
 namespace hpcjoin {
 namespace tasks {
 
-LocalPartitioning::LocalPartitioning(uint64_t innerPartitionSize, hpcjoin::data::CompressedTuple *innerPartition, uint64_t outerPartitionSize, hpcjoin::data::CompressedTuple *outerPartition) {
+template<typename TUPLE>
+LocalPartitioning<TUPLE>::LocalPartitioning(uint64_t innerPartitionSize, TUPLE *innerPartition, uint64_t outerPartitionSize, TUPLE *outerPartition, uint32_t shift, uint32_t numberOfPasses, hpcjoin::memory::Region *region) {
 
 	this->innerPartitionSize = innerPartitionSize;
 	this->innerPartition = innerPartition;
@@ -42,67 +47,65 @@ LocalPartitioning::LocalPartitioning(uint64_t innerPartitionSize, hpcjoin::data:
 	this->outerPartitionSize = outerPartitionSize;
 	this->outerPartition = outerPartition;
 
+	this->shift = shift;
+	this->numberOfPasses = numberOfPasses;
+
+	this->region = region;
+
 	JOIN_ASSERT(hpcjoin::core::Configuration::CACHELINE_SIZE_BYTES == LOCAL_PARTITIONING_CACHELINE_SIZE, "Local Partitioning",
 			"Cache line sizes do not match. This is a hack and the value needs to be edited in two places.");
 
 }
 
-LocalPartitioning::~LocalPartitioning() {
+template<typename TUPLE>
+LocalPartitioning<TUPLE>::~LocalPartitioning() {
 
 }
 
-void LocalPartitioning::execute() {
+template<typename TUPLE>
+void LocalPartitioning<TUPLE>::execute() {
 
 #ifdef MEASUREMENT_DETAILS_LOCALPART
 	hpcjoin::performance::Measurements::startLocalPartitioningTask();
 #endif
 
-	uint64_t *innerHistogram = computeHistogram(this->innerPartition, this->innerPartitionSize);
-	uint64_t *outerHistogram = computeHistogram(this->outerPartition, this->outerPartitionSize);
-
-	uint64_t *innerOffsets = computePrefixSum(innerHistogram);
-	uint64_t *outerOffsets = computePrefixSum(outerHistogram);
-
-#ifdef MEASUREMENT_DETAILS_LOCALPART
-	hpcjoin::performance::Measurements::startLocalPartitioningMemoryAllocation();
-#endif
-
-	hpcjoin::data::CompressedTuple *innerPartitions = NULL;
-	uint64_t innerOutputSize = (innerPartitionSize + hpcjoin::core::Configuration::LOCAL_PARTITIONING_COUNT * TUPLES_PER_CACHELINE) * sizeof(hpcjoin::data::CompressedTuple);
-	//int result = posix_memalign((void **) &(innerPartitions), LOCAL_PARTITIONING_CACHELINE_SIZE, innerOutputSize);
-	//JOIN_ASSERT(result == 0, "Local Partitioning", "Could not allocate output buffer for inner partition");
-	innerPartitions = (hpcjoin::data::CompressedTuple *) hpcjoin::memory::Pool::getMemory(innerOutputSize);
-
-#ifdef MEASUREMENT_DETAILS_LOCALPART
-	hpcjoin::performance::Measurements::stopLocalPartitioningMemoryAllocation(innerOutputSize);
-#endif
-
-#ifdef MEASUREMENT_DETAILS_LOCALPART
-	hpcjoin::performance::Measurements::startLocalPartitioningMemoryAllocation();
-#endif
-
-	hpcjoin::data::CompressedTuple *outerPartitions = NULL;
-	uint64_t outerOutputSize = (outerPartitionSize + hpcjoin::core::Configuration::LOCAL_PARTITIONING_COUNT * TUPLES_PER_CACHELINE) * sizeof(hpcjoin::data::CompressedTuple);
-	//result = posix_memalign((void **) &(outerPartitions), LOCAL_PARTITIONING_CACHELINE_SIZE, outerOutputSize);
-	//JOIN_ASSERT(result == 0, "Local Partitioning", "Could not allocate output buffer for outer partition");
-	outerPartitions = (hpcjoin::data::CompressedTuple *) hpcjoin::memory::Pool::getMemory(outerOutputSize);
-
-#ifdef MEASUREMENT_DETAILS_LOCALPART
-	hpcjoin::performance::Measurements::stopLocalPartitioningMemoryAllocation(outerOutputSize);
-#endif
+	uint32_t const fanout = hpcjoin::core::Configuration::LOCAL_PARTITIONING_FANOUT;
 
+	uint64_t *innerHistogram = NULL;
+	uint64_t *innerOffsets = NULL;
+	uint64_t innerOutputSize = 0;
 	JOIN_DEBUG("Local Partitioning", "Partitioning inner partition of size %lu", innerPartitionSize);
-	partitionData(innerPartition, innerPartitionSize, innerPartitions, innerOffsets, innerHistogram);
+	TUPLE *innerPartitions = partition(this->innerPartition, this->innerPartitionSize, this->shift, &innerHistogram, &innerOffsets, &innerOutputSize);
 
+	uint64_t *outerHistogram = NULL;
+	uint64_t *outerOffsets = NULL;
+	uint64_t outerOutputSize = 0;
 	JOIN_DEBUG("Local Partitioning", "Partitioning outer partition of size %lu", outerPartitionSize);
-	partitionData(outerPartition, outerPartitionSize, outerPartitions, outerOffsets, outerHistogram);
+	TUPLE *outerPartitions = partition(this->outerPartition, this->outerPartitionSize, this->shift, &outerHistogram, &outerOffsets, &outerOutputSize);
+
+	// Reference held until all sub-partitions have been scheduled
+	hpcjoin::memory::Region *outputRegion = new hpcjoin::memory::Region(REGION_POOL, innerPartitions, innerOutputSize, outerPartitions, outerOutputSize);
+	outputRegion->acquire();
+
+	// The input is no longer needed
+	if (this->region != NULL) {
+		this->region->release();
+	}
 
-	// Add build-probe tasks to queue
+	// Add build-probe or further partitioning tasks to queue
+	uint32_t const nextShift = this->shift + fanout;
 	for(uint32_t p=0; p<hpcjoin::core::Configuration::LOCAL_PARTITIONING_COUNT; ++p) {
 		if(innerHistogram[p] > 0 && outerHistogram[p] > 0) {
-			hpcjoin::operators::HashJoin::TASK_QUEUE.push(new hpcjoin::tasks::BuildProbe(innerHistogram[p], innerPartitions+innerOffsets[p], outerHistogram[p], outerPartitions+outerOffsets[p]));
+			if (innerHistogram[p] == innerPartitionSize) {
+				// Another pass would not split the partition (e.g. a single heavy key)
+				outputRegion->acquire();
+				hpcjoin::operators::HashJoin::TASK_QUEUE->push(new hpcjoin::tasks::BuildProbe<TUPLE>(innerHistogram[p], innerPartitions+innerOffsets[p], outerHistogram[p], outerPartitions+outerOffsets[p], nextShift, outputRegion));
+			} else {
+				schedule(innerHistogram[p], innerPartitions+innerOffsets[p], outerHistogram[p], outerPartitions+outerOffsets[p], nextShift, this->numberOfPasses + 1, outputRegion);
+			}
 		}
 	}
+	outputRegion->release();
 
 	free(innerHistogram);
 	free(outerHistogram);
@@ -116,17 +119,63 @@ void LocalPartitioning::execute() {
 
 }
 
-uint64_t* LocalPartitioning::computeHistogram(hpcjoin::data::CompressedTuple* tuples, uint64_t size) {
+template<typename TUPLE>
+void LocalPartitioning<TUPLE>::schedule(uint64_t innerPartitionSize, TUPLE* innerPartition, uint64_t outerPartitionSize, TUPLE* outerPartition,
+		uint32_t shift, uint32_t numberOfPasses, hpcjoin::memory::Region *region) {
+
+	if (region != NULL) {
+		region->acquire();
+	}
 
-	uint64_t *histogram = (uint64_t*) calloc(hpcjoin::core::Configuration::LOCAL_PARTITIONING_COUNT, sizeof(uint64_t));
+	bool exceedsCache = (innerPartitionSize * sizeof(TUPLE) > hpcjoin::core::Configuration::CACHE_BUDGET_BYTES);
+	bool bitsRemaining = (shift + hpcjoin::core::Configuration::LOCAL_PARTITIONING_FANOUT <= TUPLE::getKeyBits());
+
+	if (exceedsCache && bitsRemaining && numberOfPasses < hpcjoin::core::Configuration::MAX_LOCAL_PARTITIONING_PASSES) {
+		JOIN_DEBUG("Local Partitioning", "Partition of size %lu requires local pass %d", innerPartitionSize, numberOfPasses + 1);
+		hpcjoin::operators::HashJoin::TASK_QUEUE->push(new hpcjoin::tasks::LocalPartitioning<TUPLE>(innerPartitionSize, innerPartition, outerPartitionSize, outerPartition, shift, numberOfPasses, region));
+	} else {
+		hpcjoin::operators::HashJoin::TASK_QUEUE->push(new hpcjoin::tasks::BuildProbe<TUPLE>(innerPartitionSize, innerPartition, outerPartitionSize, outerPartition, shift, region));
+	}
+
+}
+
+template<typename TUPLE>
+TUPLE* LocalPartitioning<TUPLE>::partition(TUPLE* tuples, uint64_t size, uint32_t shift, uint64_t** histogram, uint64_t** offsets, uint64_t* outputSize) {
+
+	uint32_t const fanout = hpcjoin::core::Configuration::LOCAL_PARTITIONING_FANOUT;
+
+	FANOUT_DISPATCH(fanout, *histogram = computeHistogram, tuples, size, shift);
+	*offsets = computePrefixSum(*histogram);
+
+#ifdef MEASUREMENT_DETAILS_LOCALPART
+	hpcjoin::performance::Measurements::startLocalPartitioningMemoryAllocation();
+#endif
+
+	*outputSize = (size + hpcjoin::core::Configuration::LOCAL_PARTITIONING_COUNT * TUPLES_PER_CACHELINE) * sizeof(TUPLE);
+	TUPLE *partitions = (TUPLE *) hpcjoin::memory::Pool::getMemory(*outputSize);
+
+#ifdef MEASUREMENT_DETAILS_LOCALPART
+	hpcjoin::performance::Measurements::stopLocalPartitioningMemoryAllocation(*outputSize);
+#endif
+
+	FANOUT_DISPATCH(fanout, partitionData, tuples, size, partitions, *offsets, *histogram, shift);
+
+	return partitions;
+
+}
+
+template<typename TUPLE>
+template<uint32_t FANOUT>
+uint64_t* LocalPartitioning<TUPLE>::computeHistogram(TUPLE* tuples, uint64_t size, uint32_t shift) {
+
+	uint64_t *histogram = (uint64_t*) calloc(1 << FANOUT, sizeof(uint64_t));
 
 #ifdef MEASUREMENT_DETAILS_LOCALPART
 	hpcjoin::performance::Measurements::startLocalPartitioningHistogramComputation();
 #endif
 
-	uint64_t MASK = (hpcjoin::core::Configuration::LOCAL_PARTITIONING_COUNT - 1) << (hpcjoin::core::Configuration::NETWORK_PARTITIONING_FANOUT + hpcjoin::core::Configuration::PAYLOAD_BITS);
 	for (uint64_t t = 0; t < size; ++t) {
-		uint64_t idx = HASH_BIT_MODULO(tuples[t].value, MASK, hpcjoin::core::Configuration::NETWORK_PARTITIONING_FANOUT+ hpcjoin::core::Configuration::PAYLOAD_BITS);
+		uint64_t idx = HASH_SHIFT_MODULO(tuples[t].getKey(shift), (1 << FANOUT) - 1, 0);
 		++(histogram[idx]);
 	}
 
@@ -138,7 +187,8 @@ uint64_t* LocalPartitioning::computeHistogram(hpcjoin::data::CompressedTuple* tu
 
 }
 
-uint64_t* LocalPartitioning::computePrefixSum(uint64_t* histogram) {
+template<typename TUPLE>
+uint64_t* LocalPartitioning<TUPLE>::computePrefixSum(uint64_t* histogram) {
 
 	uint64_t *prefix = (uint64_t*) calloc(hpcjoin::core::Configuration::LOCAL_PARTITIONING_COUNT, sizeof(uint64_t));
 
@@ -165,26 +215,26 @@ uint64_t* LocalPartitioning::computePrefixSum(uint64_t* histogram) {
 
 }
 
-void LocalPartitioning::partitionData(hpcjoin::data::CompressedTuple* input, uint64_t inputSize, hpcjoin::data::CompressedTuple* output, uint64_t* partitionOffsets, uint64_t* histogram) {
+template<typename TUPLE>
+template<uint32_t FANOUT>
+void LocalPartitioning<TUPLE>::partitionData(TUPLE* input, uint64_t inputSize, TUPLE* output, uint64_t* partitionOffsets, uint64_t* histogram, uint32_t shift) {
 
-	cacheline_t inCacheBuffer[hpcjoin::core::Configuration::LOCAL_PARTITIONING_COUNT] __attribute__((aligned(LOCAL_PARTITIONING_CACHELINE_SIZE)));
+	cacheline_t<TUPLE> inCacheBuffer[1 << FANOUT] __attribute__((aligned(LOCAL_PARTITIONING_CACHELINE_SIZE)));
 
-	for(uint64_t p=0; p<hpcjoin::core::Configuration::LOCAL_PARTITIONING_COUNT; ++p) {
+	for(uint64_t p=0; p<(1 << FANOUT); ++p) {
 		inCacheBuffer[p].data.slot = partitionOffsets[p];
 	}
 
 	// Partition data
-	uint64_t MASK = (hpcjoin::core::Configuration::LOCAL_PARTITIONING_COUNT - 1) << (hpcjoin::core::Configuration::NETWORK_PARTITIONING_FANOUT + hpcjoin::core::Configuration::PAYLOAD_BITS);
-
 #ifdef MEASUREMENT_DETAILS_LOCALPART
 	hpcjoin::performance::Measurements::startLocalPartitioningPartitioning();
 #endif
 
 	for (uint64_t t = 0; t < inputSize; ++t) {
 
-		uint64_t partitionId = HASH_BIT_MODULO(input[t].value, MASK, hpcjoin::core::Configuration::NETWORK_PARTITIONING_FANOUT + hpcjoin::core::Configuration::PAYLOAD_BITS);
+		uint64_t partitionId = HASH_SHIFT_MODULO(input[t].getKey(shift), (1 << FANOUT) - 1, 0);
 		uint64_t slot = inCacheBuffer[partitionId].data.slot;
-		hpcjoin::data::CompressedTuple *cacheLine = (hpcjoin::data::CompressedTuple *) (inCacheBuffer + partitionId);
+		TUPLE *cacheLine = (TUPLE *) (inCacheBuffer + partitionId);
 		uint32_t slotMod = (slot) & (TUPLES_PER_CACHELINE - 1);
 
 		cacheLine[slotMod] = input[t];
@@ -197,7 +247,7 @@ void LocalPartitioning::partitionData(hpcjoin::data::CompressedTuple* input, uin
 	}
 
 	// Flush the remaining in-cache data
-	for(uint64_t p=0; p<hpcjoin::core::Configuration::LOCAL_PARTITIONING_COUNT; ++p) {
+	for(uint64_t p=0; p<(1 << FANOUT); ++p) {
 
 		uint64_t slot = inCacheBuffer[p].data.slot;
 		uint32_t remainingElements = (slot) & (TUPLES_PER_CACHELINE - 1);
@@ -215,7 +265,8 @@ void LocalPartitioning::partitionData(hpcjoin::data::CompressedTuple* input, uin
 
 }
 
-void LocalPartitioning::streamWrite(void* to, void* from) {
+template<typename TUPLE>
+void LocalPartitioning<TUPLE>::streamWrite(void* to, void* from) {
 
 	JOIN_ASSERT(to != NULL, "Local Partitioning", "Stream destination should not be NULL");
 	JOIN_ASSERT(from != NULL, "Local Partitioning", "Stream source should not be NULL");
@@ -233,10 +284,15 @@ void LocalPartitioning::streamWrite(void* to, void* from) {
 
 }
 
-task_type_t LocalPartitioning::getType() {
+template<typename TUPLE>
+task_type_t LocalPartitioning<TUPLE>::getType() {
 	return TASK_PARTITION;
 }
 
+template class LocalPartitioning<hpcjoin::data::CompressedTuple>;
+template class LocalPartitioning<hpcjoin::data::WideCompressedTuple>;
+template class LocalPartitioning<hpcjoin::data::NarrowCompressedTuple>;
+
 
 } /* namespace tasks */
 } /* namespace hpcjoin */
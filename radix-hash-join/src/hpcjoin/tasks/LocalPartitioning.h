@@ -8,18 +8,27 @@
 #define HPCJOIN_TASKS_LOCALPARTITIONING_H_
 
 #include <stdint.h>
+#include <stddef.h>
 
 #include <hpcjoin/tasks/Task.h>
 #include <hpcjoin/data/CompressedTuple.h>
+#include <hpcjoin/data/WideCompressedTuple.h>
+#include <hpcjoin/memory/Region.h>
 
 namespace hpcjoin {
 namespace tasks {
 
+/**
+ * Partitions received partitions further, the template argument is the compressed tuple type
+ * selected by the configuration. Shifts are given in key bits.
+ */
+
+template<typename TUPLE>
 class LocalPartitioning : public Task {
 
 public:
 
-	LocalPartitioning(uint64_t innerPartitionSize, hpcjoin::data::CompressedTuple *innerPartition, uint64_t outerPartitionSize, hpcjoin::data::CompressedTuple *outerPartition);
+	LocalPartitioning(uint64_t innerPartitionSize, TUPLE *innerPartition, uint64_t outerPartitionSize, TUPLE *outerPartition, uint32_t shift, uint32_t numberOfPasses, hpcjoin::memory::Region *region);
 	~LocalPartitioning();
 
 public:
@@ -27,19 +36,39 @@ public:
 	void execute();
 	task_type_t getType();
 
+public:
+
+	/**
+	 * The scheduled task holds a reference to the region containing the partition (if any)
+	 */
+	static void schedule(uint64_t innerPartitionSize, TUPLE *innerPartition, uint64_t outerPartitionSize, TUPLE *outerPartition, uint32_t shift, uint32_t numberOfPasses, hpcjoin::memory::Region *region = NULL);
+
+	/**
+	 * Partitions the tuples into pool memory of the returned size (one pass, local fan-out).
+	 * The histogram and the offsets of the sub-partitions need to be freed by the caller.
+	 */
+	static TUPLE *partition(TUPLE *tuples, uint64_t size, uint32_t shift, uint64_t **histogram, uint64_t **offsets, uint64_t *outputSize);
+
 protected:
 
 	uint64_t innerPartitionSize;
-	hpcjoin::data::CompressedTuple *innerPartition;
+	TUPLE *innerPartition;
 	uint64_t outerPartitionSize;
-	hpcjoin::data::CompressedTuple *outerPartition;
+	TUPLE *outerPartition;
+
+	uint32_t shift;
+	uint32_t numberOfPasses;
+
+	hpcjoin::memory::Region *region;
 
 protected:
 
-	static uint64_t *computeHistogram(hpcjoin::data::CompressedTuple *tuples, uint64_t size);
+	template<uint32_t FANOUT>
+	static uint64_t *computeHistogram(TUPLE *tuples, uint64_t size, uint32_t shift);
 	static uint64_t *computePrefixSum(uint64_t *histogram);
 
-	static void partitionData(hpcjoin::data::CompressedTuple *input, uint64_t inputSize, hpcjoin::data::CompressedTuple *output, uint64_t *partitionOffsets, uint64_t *histogram);
+	template<uint32_t FANOUT>
+	static void partitionData(TUPLE *input, uint64_t inputSize, TUPLE *output, uint64_t *partitionOffsets, uint64_t *histogram, uint32_t shift);
 
 	static void streamWrite(void *to, void *from);
 
@@ -11,44 +11,55 @@
 #include <string.h>
 
 #include <hpcjoin/core/Configuration.h>
-#include <hpcjoin/data/CompressedTuple.h>
 #include <hpcjoin/utils/Debug.h>
 #include <hpcjoin/performance/Measurements.h>
+#include <hpcjoin/utils/Dispatch.h>
+#include <hpcjoin/memory/PageAllocator.h>
 
 #define NETWORK_PARTITIONING_CACHELINE_SIZE (64)
-#define TUPLES_PER_CACHELINE (NETWORK_PARTITIONING_CACHELINE_SIZE / sizeof(hpcjoin::data::CompressedTuple))
+#define TUPLES_PER_CACHELINE (NETWORK_PARTITIONING_CACHELINE_SIZE / sizeof(TUPLE))
 
 #define HASH_BIT_MODULO(KEY, MASK, NBITS) (((KEY) & (MASK)) >> (NBITS))
 
-#define PARTITION_ACCESS(p) (((char *) inMemoryBuffer) + (p * hpcjoin::core::Configuration::MEMORY_PARTITION_SIZE_BYTES))
+#define PARTITION_ACCESS(p) (((char *) inMemoryBuffer) + (p * bufferedPartitionSize))
+#define REQUEST_ACCESS(p, b) (requests + ((p) * buffersPerPartition + (b)) * requestsPerBuffer)
 
 namespace hpcjoin {
 namespace tasks {
 
-typedef union {
+template<typename TUPLE>
+union cacheline_t {
 
 	struct {
-		hpcjoin::data::CompressedTuple tuples[TUPLES_PER_CACHELINE];
+		TUPLE tuples[TUPLES_PER_CACHELINE];
 	} tuples;
 
 	struct {
-		hpcjoin::data::CompressedTuple tuples[TUPLES_PER_CACHELINE - 1];
-		uint32_t inCacheCounter;
-		uint32_t memoryCounter;
+		TUPLE tuples[TUPLES_PER_CACHELINE - 1];
+		// Both counters fit into the last tuple, even of a 32-bit tuple. The memory counter is
+		// below MAX_MEMORY_BUFFERS_PER_PARTITION * CACHELINES_PER_MEMORY_BUFFER.
+		uint16_t inCacheCounter;
+		uint16_t memoryCounter;
 	} data;
 
-} cacheline_t;
+};
 
 NetworkPartitioning::NetworkPartitioning(uint32_t nodeId, hpcjoin::data::Relation* innerRelation, hpcjoin::data::Relation* outerRelation, hpcjoin::data::Window* innerWindow,
-		hpcjoin::data::Window* outerWindow) {
+		hpcjoin::data::Window* outerWindow, hpcjoin::data::ArrivalWindow *arrivals, uint32_t sliceId, uint32_t numberOfSlices, hpcjoin::data::BloomFilter *outerFilter) {
 
 	this->nodeId = nodeId;
 
+	this->sliceId = sliceId;
+	this->numberOfSlices = numberOfSlices;
+
 	this->innerRelation = innerRelation;
 	this->outerRelation = outerRelation;
 
 	this->innerWindow = innerWindow;
 	this->outerWindow = outerWindow;
+	this->arrivals = arrivals;
+
+	this->outerFilter = outerFilter;
 
 	JOIN_ASSERT(hpcjoin::core::Configuration::CACHELINE_SIZE_BYTES == NETWORK_PARTITIONING_CACHELINE_SIZE, "Network Partitioning", "Cache line sizes do not match. This is a hack and the value needs to be edited in two places.");
 
@@ -59,47 +70,68 @@ NetworkPartitioning::~NetworkPartitioning() {
 
 void NetworkPartitioning::execute() {
 
-	JOIN_DEBUG("Network Partitioning", "Node %d is partitioning inner relation", this->nodeId);
-	partition(innerRelation, innerWindow);
-
-	JOIN_DEBUG("Network Partitioning", "Node %d is partitioning outer relation", this->nodeId);
-	partition(outerRelation, outerWindow);
+	TUPLE_FORMAT_DISPATCH(hpcjoin::core::Configuration::TUPLE_FORMAT, partitionRelations);
 
 }
 
-void NetworkPartitioning::partition(hpcjoin::data::Relation *relation, hpcjoin::data::Window *window) {
+template<typename TUPLE>
+void NetworkPartitioning::partitionRelations() {
+
+	JOIN_DEBUG("Network Partitioning", "Node %d is partitioning slice %d of inner relation", this->nodeId, this->sliceId);
+	TYPED_FANOUT_DISPATCH(TUPLE, hpcjoin::core::Configuration::NETWORK_PARTITIONING_FANOUT, partition, innerRelation, innerWindow, true, (hpcjoin::data::BloomFilter *) NULL);
+
+	JOIN_DEBUG("Network Partitioning", "Node %d is partitioning slice %d of outer relation", this->nodeId, this->sliceId);
+	TYPED_FANOUT_DISPATCH(TUPLE, hpcjoin::core::Configuration::NETWORK_PARTITIONING_FANOUT, partition, outerRelation, outerWindow, false, outerFilter);
+
+}
 
-	window->start();
+template<typename TUPLE, uint32_t FANOUT>
+void NetworkPartitioning::partition(hpcjoin::data::Relation *relation, hpcjoin::data::Window *window, bool isInnerRelation, hpcjoin::data::BloomFilter *filter) {
 
-	uint64_t const numberOfElements = relation->getLocalSize();
-	hpcjoin::data::Tuple * const data = relation->getData();
+	uint64_t const numberOfElements = relation->getSliceSize(this->sliceId, this->numberOfSlices);
+	hpcjoin::data::Tuple * const data = relation->getData() + relation->getSliceStart(this->sliceId, this->numberOfSlices);
 
 	// Create in-memory buffer
-	uint64_t const bufferedPartitionCount = hpcjoin::core::Configuration::NETWORK_PARTITIONING_COUNT;
-	uint64_t const bufferedPartitionSize = hpcjoin::core::Configuration::MEMORY_PARTITION_SIZE_BYTES;
+	uint32_t const buffersPerPartition = hpcjoin::core::Configuration::MEMORY_BUFFERS_PER_PARTITION;
+	uint64_t const bufferedPartitionCount = (1 << FANOUT);
+	uint64_t const bufferedPartitionSize = buffersPerPartition * hpcjoin::core::Configuration::MEMORY_BUFFER_SIZE_BYTES;
 	uint64_t const inMemoryBufferSize = bufferedPartitionCount * bufferedPartitionSize;
 
-	const uint32_t partitionBits = hpcjoin::core::Configuration::NETWORK_PARTITIONING_FANOUT;
+	const uint32_t partitionBits = FANOUT;
 
 #ifdef MEASUREMENT_DETAILS_NETWORK
 	hpcjoin::performance::Measurements::startNetworkPartitioningMemoryAllocation();
 #endif
 
-	hpcjoin::data::CompressedTuple * inMemoryBuffer = NULL;
-	int result = posix_memalign((void **) &(inMemoryBuffer), NETWORK_PARTITIONING_CACHELINE_SIZE, inMemoryBufferSize);
+	page_backing_t inMemoryBufferBacking = PAGE_BACKING_DEFAULT;
+	TUPLE * inMemoryBuffer = (TUPLE *) hpcjoin::memory::PageAllocator::allocate(inMemoryBufferSize, PAGE_REGION_NETWORK_BUFFER, &inMemoryBufferBacking);
 
-	JOIN_ASSERT(result == 0, "Network Partitioning", "Could not allocate in-memory buffer");
+	JOIN_ASSERT(inMemoryBuffer != NULL, "Network Partitioning", "Could not allocate in-memory buffer");
 	memset(inMemoryBuffer, 0, inMemoryBufferSize);
 
+	// With request-based puts, every buffer has one request per replica of the partition
+	bool const requestBased = hpcjoin::core::Configuration::ENABLE_REQUEST_BASED_PUTS;
+	uint32_t const requestsPerBuffer = window->getMaximumReplicaCount();
+	uint32_t const requestsPerPartition = buffersPerPartition * requestsPerBuffer;
+	MPI_Request *requests = NULL;
+	int *completedIndices = NULL;
+	if (requestBased) {
+		requests = (MPI_Request *) calloc(bufferedPartitionCount * requestsPerPartition, sizeof(MPI_Request));
+		completedIndices = (int *) calloc(requestsPerPartition, sizeof(int));
+		for (uint64_t r = 0; r < bufferedPartitionCount * requestsPerPartition; ++r) {
+			requests[r] = MPI_REQUEST_NULL;
+		}
+	}
+
 #ifdef MEASUREMENT_DETAILS_NETWORK
-	hpcjoin::performance::Measurements::stopNetworkPartitioningMemoryAllocation(inMemoryBufferSize);
+	hpcjoin::performance::Measurements::stopNetworkPartitioningMemoryAllocation(isInnerRelation, inMemoryBufferSize);
 #endif
 
 	// Create in-cache buffer
-	cacheline_t inCacheBuffer[hpcjoin::core::Configuration::NETWORK_PARTITIONING_COUNT] __attribute__((aligned(NETWORK_PARTITIONING_CACHELINE_SIZE)));;
+	cacheline_t<TUPLE> inCacheBuffer[1 << FANOUT] __attribute__((aligned(NETWORK_PARTITIONING_CACHELINE_SIZE)));
 
 	JOIN_DEBUG("Network Partitioning", "Node %d is setting counter to zero", this->nodeId);
-	for (uint32_t p = 0; p < hpcjoin::core::Configuration::NETWORK_PARTITIONING_COUNT; ++p) {
+	for (uint32_t p = 0; p < bufferedPartitionCount; ++p) {
 		inCacheBuffer[p].data.inCacheCounter = 0;
 		inCacheBuffer[p].data.memoryCounter = 0;
 	}
@@ -110,17 +142,22 @@ void NetworkPartitioning::partition(hpcjoin::data::Relation *relation, hpcjoin::
 
 	for (uint64_t i = 0; i < numberOfElements; ++i) {
 
+		// Skip tuples without a join partner, they have not been counted in the histogram
+		if (filter != NULL && !filter->contains(data[i].key)) {
+			continue;
+		}
+
 		// Compute partition
-		uint32_t partitionId = HASH_BIT_MODULO(data[i].key, hpcjoin::core::Configuration::NETWORK_PARTITIONING_COUNT - 1, 0);
+		uint32_t partitionId = HASH_BIT_MODULO(data[i].key, bufferedPartitionCount - 1, 0);
 
 		// Save counter to register
 		uint32_t inCacheCounter = inCacheBuffer[partitionId].data.inCacheCounter;
 		uint32_t memoryCounter = inCacheBuffer[partitionId].data.memoryCounter;
 
 		// Move data to cache line
-		hpcjoin::data::CompressedTuple *cacheLine = (hpcjoin::data::CompressedTuple *) (inCacheBuffer + partitionId);
+		TUPLE *cacheLine = (TUPLE *) (inCacheBuffer + partitionId);
 		//cacheLine[inCacheCounter] = data[i];
-		cacheLine[inCacheCounter].value = data[i].rid + ((data[i].key >> partitionBits) << (partitionBits + hpcjoin::core::Configuration::PAYLOAD_BITS));
+		cacheLine[inCacheCounter].pack(data[i].key, data[i].rid, partitionBits);
 		++inCacheCounter;
 
 		// Check if cache line is full
@@ -138,14 +175,32 @@ void NetworkPartitioning::partition(hpcjoin::data::Relation *relation, hpcjoin::
 			// Check if memory buffer is full
 			if (memoryCounter % hpcjoin::core::Configuration::CACHELINES_PER_MEMORY_BUFFER == 0) {
 
-				bool rewindBuffer = (memoryCounter == hpcjoin::core::Configuration::MEMORY_BUFFERS_PER_PARTITION * hpcjoin::core::Configuration::CACHELINES_PER_MEMORY_BUFFER);
+				bool rewindBuffer = (memoryCounter == buffersPerPartition * hpcjoin::core::Configuration::CACHELINES_PER_MEMORY_BUFFER);
 
 				//JOIN_DEBUG("Network Partitioning", "Node %d has a full memory buffer %d", this->nodeId, partitionId);
-				hpcjoin::data::CompressedTuple *inMemoryBufferLocation = reinterpret_cast<hpcjoin::data::CompressedTuple *>(PARTITION_ACCESS(partitionId) + (memoryCounter * NETWORK_PARTITIONING_CACHELINE_SIZE) - (hpcjoin::core::Configuration::MEMORY_BUFFER_SIZE_BYTES));
-				window->write(partitionId, inMemoryBufferLocation, hpcjoin::core::Configuration::CACHELINES_PER_MEMORY_BUFFER * TUPLES_PER_CACHELINE, rewindBuffer);
+				TUPLE *inMemoryBufferLocation = reinterpret_cast<TUPLE *>(PARTITION_ACCESS(partitionId) + (memoryCounter * NETWORK_PARTITIONING_CACHELINE_SIZE) - (hpcjoin::core::Configuration::MEMORY_BUFFER_SIZE_BYTES));
+
+				if (requestBased) {
+
+					uint32_t bufferId = memoryCounter / hpcjoin::core::Configuration::CACHELINES_PER_MEMORY_BUFFER - 1;
+					window->write(this->sliceId, partitionId, inMemoryBufferLocation, hpcjoin::core::Configuration::CACHELINES_PER_MEMORY_BUFFER * TUPLES_PER_CACHELINE, REQUEST_ACCESS(partitionId, bufferId));
+
+					if (rewindBuffer) {
+						memoryCounter = 0;
+					}
+
+					// Only block if the puts issued from the next buffer have not completed yet
+					uint32_t nextBufferId = memoryCounter / hpcjoin::core::Configuration::CACHELINES_PER_MEMORY_BUFFER;
+					window->completeRequests(REQUEST_ACCESS(partitionId, 0), requestsPerPartition, nextBufferId * requestsPerBuffer, requestsPerBuffer, completedIndices);
+
+				} else {
+
+					window->write(this->sliceId, partitionId, inMemoryBufferLocation, hpcjoin::core::Configuration::CACHELINES_PER_MEMORY_BUFFER * TUPLES_PER_CACHELINE, rewindBuffer);
+
+					if (rewindBuffer) {
+						memoryCounter = 0;
+					}
 
-				if(rewindBuffer) {
-					memoryCounter = 0;
 				}
 
 				//JOIN_DEBUG("Network Partitioning", "Node %d has completed the put operation of memory buffer %d", this->nodeId, partitionId);
@@ -160,7 +215,7 @@ void NetworkPartitioning::partition(hpcjoin::data::Relation *relation, hpcjoin::
 	}
 
 #ifdef MEASUREMENT_DETAILS_NETWORK
-	hpcjoin::performance::Measurements::stopNetworkPartitioningMainPartitioning(numberOfElements);
+	hpcjoin::performance::Measurements::stopNetworkPartitioningMainPartitioning(isInnerRelation, numberOfElements);
 #endif
 
 	JOIN_DEBUG("Network Partitioning", "Node %d is flushing remaining tuples", this->nodeId);
@@ -170,13 +225,13 @@ void NetworkPartitioning::partition(hpcjoin::data::Relation *relation, hpcjoin::
 #endif
 
 	// Flush remaining elements to memory buffers
-	for(uint32_t p=0; p<hpcjoin::core::Configuration::NETWORK_PARTITIONING_COUNT; ++p) {
+	for(uint32_t p=0; p<bufferedPartitionCount; ++p) {
 
 		uint32_t inCacheCounter = inCacheBuffer[p].data.inCacheCounter;
 		uint32_t memoryCounter = inCacheBuffer[p].data.memoryCounter;
 
-		hpcjoin::data::CompressedTuple *cacheLine = (hpcjoin::data::CompressedTuple *) (inCacheBuffer + p);
-		hpcjoin::data::CompressedTuple *inMemoryFreeSpace = reinterpret_cast<hpcjoin::data::CompressedTuple *>(PARTITION_ACCESS(p) + (memoryCounter * NETWORK_PARTITIONING_CACHELINE_SIZE));
+		TUPLE *cacheLine = (TUPLE *) (inCacheBuffer + p);
+		TUPLE *inMemoryFreeSpace = reinterpret_cast<TUPLE *>(PARTITION_ACCESS(p) + (memoryCounter * NETWORK_PARTITIONING_CACHELINE_SIZE));
 		for(uint32_t t=0; t<inCacheCounter; ++t) {
 				inMemoryFreeSpace[t] = cacheLine[t];
 		}
@@ -184,23 +239,35 @@ void NetworkPartitioning::partition(hpcjoin::data::Relation *relation, hpcjoin::
 		uint32_t remainingTupleInMemory = ((memoryCounter % hpcjoin::core::Configuration::CACHELINES_PER_MEMORY_BUFFER) * TUPLES_PER_CACHELINE) + inCacheCounter;
 
 		if(remainingTupleInMemory > 0) {
-			hpcjoin::data::CompressedTuple *inMemoryBufferOfPartition = reinterpret_cast<hpcjoin::data::CompressedTuple *>(PARTITION_ACCESS(p) + (memoryCounter/hpcjoin::core::Configuration::CACHELINES_PER_MEMORY_BUFFER) * hpcjoin::core::Configuration::MEMORY_BUFFER_SIZE_BYTES);
-			window->write(p, inMemoryBufferOfPartition, remainingTupleInMemory, false);
+			TUPLE *inMemoryBufferOfPartition = reinterpret_cast<TUPLE *>(PARTITION_ACCESS(p) + (memoryCounter/hpcjoin::core::Configuration::CACHELINES_PER_MEMORY_BUFFER) * hpcjoin::core::Configuration::MEMORY_BUFFER_SIZE_BYTES);
+			if (requestBased) {
+				uint32_t bufferId = memoryCounter / hpcjoin::core::Configuration::CACHELINES_PER_MEMORY_BUFFER;
+				window->write(this->sliceId, p, inMemoryBufferOfPartition, remainingTupleInMemory, REQUEST_ACCESS(p, bufferId));
+			} else {
+				window->write(this->sliceId, p, inMemoryBufferOfPartition, remainingTupleInMemory, false);
+			}
 		}
 
 	}
 
-	window->flush();
-	window->stop();
+	// Buffer can only be released once all puts from it have completed
+	if (requestBased) {
+		for (uint32_t p = 0; p < bufferedPartitionCount; ++p) {
+			window->completeRequests(REQUEST_ACCESS(p, 0), requestsPerPartition, 0, requestsPerPartition, completedIndices);
+		}
+		free(requests);
+		free(completedIndices);
+	}
+
+	// Completes all outstanding puts of this slice
+	window->publishArrivals(this->sliceId, this->arrivals);
 
-	free(inMemoryBuffer);
+	hpcjoin::memory::PageAllocator::release(inMemoryBuffer, inMemoryBufferSize, inMemoryBufferBacking);
 
 #ifdef MEASUREMENT_DETAILS_NETWORK
-	hpcjoin::performance::Measurements::stopNetworkPartitioningFlushPartitioning();
+	hpcjoin::performance::Measurements::stopNetworkPartitioningFlushPartitioning(isInnerRelation);
 #endif
 
-	window->assertAllTuplesWritten();
-
 }
 
 inline void NetworkPartitioning::streamWrite(void* to, void* from) {
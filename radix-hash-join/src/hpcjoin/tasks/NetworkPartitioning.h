@@ -10,15 +10,22 @@
 #include <hpcjoin/tasks/Task.h>
 #include <hpcjoin/data/Window.h>
 #include <hpcjoin/data/Relation.h>
+#include <hpcjoin/data/BloomFilter.h>
 
 namespace hpcjoin {
 namespace tasks {
 
+/**
+ * Partitions one slice of the local input relations and writes the partitions into the
+ * windows. Windows need to be started before and stopped after all slices have been processed.
+ * Once a relation has been sent, the arrival of its partitions is signalled to the receivers.
+ */
+
 class NetworkPartitioning : public Task {
 
 public:
 
-	NetworkPartitioning(uint32_t nodeId, hpcjoin::data::Relation *innerRelation, hpcjoin::data::Relation *outerRelation, hpcjoin::data::Window *innerWindow, hpcjoin::data::Window *outerWindow);
+	NetworkPartitioning(uint32_t nodeId, hpcjoin::data::Relation *innerRelation, hpcjoin::data::Relation *outerRelation, hpcjoin::data::Window *innerWindow, hpcjoin::data::Window *outerWindow, hpcjoin::data::ArrivalWindow *arrivals, uint32_t sliceId = 0, uint32_t numberOfSlices = 1, hpcjoin::data::BloomFilter *outerFilter = NULL);
 	~NetworkPartitioning();
 
 public:
@@ -28,17 +35,27 @@ public:
 
 protected:
 
-	void partition(hpcjoin::data::Relation *relation, hpcjoin::data::Window *window);
+	template<typename TUPLE>
+	void partitionRelations();
+
+	template<typename TUPLE, uint32_t FANOUT>
+	void partition(hpcjoin::data::Relation *relation, hpcjoin::data::Window *window, bool isInnerRelation, hpcjoin::data::BloomFilter *filter);
 
 protected:
 
 	uint32_t nodeId;
 
+	uint32_t sliceId;
+	uint32_t numberOfSlices;
+
 	hpcjoin::data::Relation *innerRelation;
 	hpcjoin::data::Relation *outerRelation;
 
 	hpcjoin::data::Window *innerWindow;
 	hpcjoin::data::Window *outerWindow;
+	hpcjoin::data::ArrivalWindow *arrivals;
+
+	hpcjoin::data::BloomFilter *outerFilter;
 
 protected:
 
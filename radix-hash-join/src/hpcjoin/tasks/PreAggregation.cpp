@@ -0,0 +1,47 @@
+/**
+ * @author  Claude Barthels <claudeb@inf.ethz.ch>
+ * (c) 2016, ETH Zurich, Systems Group
+ *
+ */
+
+#include "PreAggregation.h"
+
+#include <hpcjoin/utils/Debug.h>
+
+namespace hpcjoin {
+namespace tasks {
+
+PreAggregation::PreAggregation(hpcjoin::data::Relation* relation, hpcjoin::data::GroupTable* groups, uint32_t sliceId, uint32_t numberOfSlices) {
+
+	this->relation = relation;
+	this->groups = groups;
+
+	this->sliceId = sliceId;
+	this->numberOfSlices = numberOfSlices;
+
+}
+
+PreAggregation::~PreAggregation() {
+
+}
+
+void PreAggregation::execute() {
+
+	uint64_t const sliceStart = this->relation->getSliceStart(this->sliceId, this->numberOfSlices);
+	uint64_t const sliceSize = this->relation->getSliceSize(this->sliceId, this->numberOfSlices);
+	hpcjoin::data::Tuple * const data = this->relation->getData() + sliceStart;
+
+	for (uint64_t t = 0; t < sliceSize; ++t) {
+		this->groups->add(data[t].key, 1, data[t].rid);
+	}
+
+	JOIN_DEBUG("Pre-Aggregation", "Slice %d reduced %lu tuples to %lu groups", this->sliceId, sliceSize, this->groups->getNumberOfGroups());
+
+}
+
+task_type_t PreAggregation::getType() {
+	return TASK_PRE_AGGREGATION;
+}
+
+} /* namespace tasks */
+} /* namespace hpcjoin */
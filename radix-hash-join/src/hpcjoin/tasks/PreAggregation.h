@@ -0,0 +1,49 @@
+/**
+ * @author  Claude Barthels <claudeb@inf.ethz.ch>
+ * (c) 2016, ETH Zurich, Systems Group
+ *
+ */
+
+#ifndef HPCJOIN_TASKS_PREAGGREGATION_H_
+#define HPCJOIN_TASKS_PREAGGREGATION_H_
+
+#include <stdint.h>
+
+#include <hpcjoin/tasks/Task.h>
+#include <hpcjoin/data/Relation.h>
+#include <hpcjoin/data/GroupTable.h>
+
+namespace hpcjoin {
+namespace tasks {
+
+/**
+ * Aggregates one slice of the local input before it is sent over the network. Every tuple
+ * counts once towards its key and its rid is added to the sum of the key.
+ */
+
+class PreAggregation : public Task {
+
+public:
+
+	PreAggregation(hpcjoin::data::Relation *relation, hpcjoin::data::GroupTable *groups, uint32_t sliceId = 0, uint32_t numberOfSlices = 1);
+	~PreAggregation();
+
+public:
+
+	void execute();
+	task_type_t getType();
+
+protected:
+
+	hpcjoin::data::Relation *relation;
+	hpcjoin::data::GroupTable *groups;
+
+	uint32_t sliceId;
+	uint32_t numberOfSlices;
+
+};
+
+} /* namespace tasks */
+} /* namespace hpcjoin */
+
+#endif /* HPCJOIN_TASKS_PREAGGREGATION_H_ */
@@ -10,8 +10,11 @@
 enum task_type_t {
 	TASK_HISTOGRAM,
 	TASK_NET_PARTITION,
+	TASK_BROADCAST_PARTITION,
 	TASK_PARTITION,
-	TASK_BUILD_PROBE
+	TASK_BUILD_PROBE,
+	TASK_PRE_AGGREGATION,
+	TASK_AGGREGATION
 } ;
 
 namespace hpcjoin {
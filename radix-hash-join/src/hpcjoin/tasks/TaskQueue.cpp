@@ -0,0 +1,196 @@
+/**
+ * @author  Claude Barthels <claudeb@inf.ethz.ch>
+ * (c) 2016, ETH Zurich, Systems Group
+ *
+ */
+
+#include "TaskQueue.h"
+
+#include <stdlib.h>
+#include <sched.h>
+
+#include <hpcjoin/core/Configuration.h>
+#include <hpcjoin/utils/Thread.h>
+#include <hpcjoin/utils/Debug.h>
+
+namespace hpcjoin {
+namespace tasks {
+
+typedef struct {
+
+	TaskQueue *queue;
+	uint32_t threadId;
+
+} worker_argument_t;
+
+static __thread uint32_t currentThreadId = 0;
+
+TaskQueue::TaskQueue(uint32_t numberOfThreads) {
+
+	JOIN_ASSERT(numberOfThreads > 0, "Task Queue", "At least one thread is required");
+
+	this->numberOfThreads = numberOfThreads;
+	this->pendingTasks = 0;
+	this->running = false;
+	this->nextDeque = 0;
+
+	int result = posix_memalign((void **) &(this->deques), hpcjoin::core::Configuration::CACHELINE_SIZE_BYTES, numberOfThreads * sizeof(task_deque_t));
+	JOIN_ASSERT(result == 0, "Task Queue", "Could not allocate deques");
+	JOIN_UNUSED(result);
+
+	for (uint32_t t = 0; t < numberOfThreads; ++t) {
+		pthread_spin_init(&(this->deques[t].lock), PTHREAD_PROCESS_PRIVATE);
+		this->deques[t].tasks = new std::deque<hpcjoin::tasks::Task *>();
+	}
+
+}
+
+TaskQueue::~TaskQueue() {
+
+	for (uint32_t t = 0; t < numberOfThreads; ++t) {
+		JOIN_ASSERT(this->deques[t].tasks->empty(), "Task Queue", "Deque %d still contains tasks", t);
+		delete this->deques[t].tasks;
+		pthread_spin_destroy(&(this->deques[t].lock));
+	}
+	free(this->deques);
+
+}
+
+void TaskQueue::push(hpcjoin::tasks::Task* task) {
+
+	// Tasks created outside of the workers are distributed round-robin
+	uint32_t target = 0;
+	if (this->running) {
+		target = currentThreadId;
+	} else {
+		target = this->nextDeque;
+		this->nextDeque = (this->nextDeque + 1) % this->numberOfThreads;
+	}
+
+	__sync_fetch_and_add(&(this->pendingTasks), 1);
+
+	pthread_spin_lock(&(this->deques[target].lock));
+	this->deques[target].tasks->push_back(task);
+	pthread_spin_unlock(&(this->deques[target].lock));
+
+}
+
+void TaskQueue::execute() {
+
+	JOIN_DEBUG("Task Queue", "Executing %lu tasks on %d threads", this->pendingTasks, this->numberOfThreads);
+
+	this->running = true;
+	__sync_synchronize();
+
+	pthread_t *threads = (pthread_t *) calloc(this->numberOfThreads, sizeof(pthread_t));
+	worker_argument_t *arguments = (worker_argument_t *) calloc(this->numberOfThreads, sizeof(worker_argument_t));
+
+	for (uint32_t t = 1; t < this->numberOfThreads; ++t) {
+		arguments[t].queue = this;
+		arguments[t].threadId = t;
+		int result = pthread_create(&(threads[t]), NULL, &TaskQueue::run, &(arguments[t]));
+		JOIN_ASSERT(result == 0, "Task Queue", "Could not create worker thread %d", t);
+		JOIN_UNUSED(result);
+	}
+
+	// The calling thread is the first worker
+	hpcjoin::utils::Thread::pin(hpcjoin::core::Configuration::FIRST_CORE_ID);
+	work(0);
+
+	for (uint32_t t = 1; t < this->numberOfThreads; ++t) {
+		pthread_join(threads[t], NULL);
+	}
+
+	free(threads);
+	free(arguments);
+
+	this->running = false;
+
+}
+
+uint32_t TaskQueue::getNumberOfThreads() {
+
+	return this->numberOfThreads;
+
+}
+
+uint32_t TaskQueue::getThreadId() {
+
+	return currentThreadId;
+
+}
+
+void* TaskQueue::run(void* argument) {
+
+	worker_argument_t *workerArgument = (worker_argument_t *) argument;
+	hpcjoin::utils::Thread::pin(hpcjoin::core::Configuration::FIRST_CORE_ID + workerArgument->threadId);
+	workerArgument->queue->work(workerArgument->threadId);
+
+	return NULL;
+
+}
+
+void TaskQueue::work(uint32_t threadId) {
+
+	currentThreadId = threadId;
+
+	while (this->pendingTasks > 0) {
+
+		hpcjoin::tasks::Task *task = pop(threadId);
+		if (task == NULL) {
+			task = steal(threadId);
+		}
+
+		if (task == NULL) {
+			sched_yield();
+			continue;
+		}
+
+		task->execute();
+		delete task;
+
+		// Tasks created by the task have been pushed before it completed
+		__sync_fetch_and_sub(&(this->pendingTasks), 1);
+
+	}
+
+	currentThreadId = 0;
+
+}
+
+hpcjoin::tasks::Task* TaskQueue::pop(uint32_t threadId) {
+
+	hpcjoin::tasks::Task *task = NULL;
+
+	pthread_spin_lock(&(this->deques[threadId].lock));
+	if (!this->deques[threadId].tasks->empty()) {
+		task = this->deques[threadId].tasks->back();
+		this->deques[threadId].tasks->pop_back();
+	}
+	pthread_spin_unlock(&(this->deques[threadId].lock));
+
+	return task;
+
+}
+
+hpcjoin::tasks::Task* TaskQueue::steal(uint32_t threadId) {
+
+	hpcjoin::tasks::Task *task = NULL;
+
+	for (uint32_t i = 1; i < this->numberOfThreads && task == NULL; ++i) {
+		uint32_t victim = (threadId + i) % this->numberOfThreads;
+		pthread_spin_lock(&(this->deques[victim].lock));
+		if (!this->deques[victim].tasks->empty()) {
+			task = this->deques[victim].tasks->front();
+			this->deques[victim].tasks->pop_front();
+		}
+		pthread_spin_unlock(&(this->deques[victim].lock));
+	}
+
+	return task;
+
+}
+
+} /* namespace tasks */
+} /* namespace hpcjoin */
+
@@ -0,0 +1,72 @@
+/**
+ * @author  Claude Barthels <claudeb@inf.ethz.ch>
+ * (c) 2016, ETH Zurich, Systems Group
+ *
+ */
+
+#ifndef HPCJOIN_TASKS_TASKQUEUE_H_
+#define HPCJOIN_TASKS_TASKQUEUE_H_
+
+#include <stdint.h>
+#include <pthread.h>
+#include <deque>
+
+#include <hpcjoin/tasks/Task.h>
+
+namespace hpcjoin {
+namespace tasks {
+
+typedef struct {
+
+	pthread_spinlock_t lock;
+	std::deque<hpcjoin::tasks::Task *> *tasks;
+
+} __attribute__((aligned(64))) task_deque_t;
+
+/**
+ * Work-stealing task queue. Every worker thread owns a deque. Tasks created by a worker are
+ * pushed to the back of its own deque and processed in LIFO order (the data of a newly created
+ * task is likely still in the cache). Idle workers steal from the front of other deques.
+ */
+
+class TaskQueue {
+
+public:
+
+	TaskQueue(uint32_t numberOfThreads);
+	~TaskQueue();
+
+public:
+
+	void push(hpcjoin::tasks::Task *task);
+	void execute();
+
+	uint32_t getNumberOfThreads();
+
+public:
+
+	static uint32_t getThreadId();
+
+protected:
+
+	static void *run(void *argument);
+	void work(uint32_t threadId);
+
+	hpcjoin::tasks::Task *pop(uint32_t threadId);
+	hpcjoin::tasks::Task *steal(uint32_t threadId);
+
+protected:
+
+	uint32_t numberOfThreads;
+	task_deque_t *deques;
+
+	volatile uint64_t pendingTasks;
+	volatile bool running;
+	uint32_t nextDeque;
+
+};
+
+} /* namespace tasks */
+} /* namespace hpcjoin */
+
+#endif /* HPCJOIN_TASKS_TASKQUEUE_H_ */
@@ -0,0 +1,39 @@
+/**
+ * @author  Claude Barthels <claudeb@inf.ethz.ch>
+ * (c) 2016, ETH Zurich, Systems Group
+ *
+ */
+
+#ifndef UTILS_ARGUMENTS_H_
+#define UTILS_ARGUMENTS_H_
+
+#include <stdint.h>
+
+#define ARGUMENTS_CONFIG_OPTION "-C"
+
+namespace hpcjoin {
+namespace utils {
+
+/**
+ * Configuration files contain command line options separated by whitespace, text after a '#'
+ * is ignored. The options of all files given with "-C <file>" are placed in front of the
+ * command line options, options on the command line therefore override the files.
+ */
+
+class Arguments {
+
+public:
+
+	static void expand(int argc, char *argv[], int *expandedArgc, char ***expandedArgv);
+
+protected:
+
+	static void readFile(const char *fileName, char **tokens, int *numberOfTokens);
+	static int countTokens(const char *fileName);
+
+};
+
+} /* namespace utils */
+} /* namespace hpcjoin */
+
+#endif /* UTILS_ARGUMENTS_H_ */
@@ -0,0 +1,75 @@
+/**
+ * @author  Claude Barthels <claudeb@inf.ethz.ch>
+ * (c) 2016, ETH Zurich, Systems Group
+ *
+ */
+
+#include "Bandwidth.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <mpi.h>
+
+#include <hpcjoin/core/Configuration.h>
+#include <hpcjoin/utils/Debug.h>
+
+namespace hpcjoin {
+namespace utils {
+
+double Bandwidth::measureNetworkBandwidth(uint32_t numberOfNodes) {
+
+	uint64_t const probeSize = hpcjoin::core::Configuration::BANDWIDTH_PROBE_SIZE_BYTES;
+	uint32_t const repetitions = hpcjoin::core::Configuration::BANDWIDTH_PROBE_REPETITIONS;
+
+	char *sendBuffer = (char *) calloc(probeSize, sizeof(char));
+	char *receiveBuffer = (char *) calloc(numberOfNodes * probeSize, sizeof(char));
+	JOIN_ASSERT(sendBuffer != NULL && receiveBuffer != NULL, "Bandwidth", "Could not allocate probe buffers");
+
+	// The first exchange sets up the connections and is not measured
+	MPI_Allgather(sendBuffer, probeSize, MPI_BYTE, receiveBuffer, probeSize, MPI_BYTE, MPI_COMM_WORLD);
+
+	MPI_Barrier(MPI_COMM_WORLD);
+	double time = MPI_Wtime();
+	for (uint32_t r = 0; r < repetitions; ++r) {
+		MPI_Allgather(sendBuffer, probeSize, MPI_BYTE, receiveBuffer, probeSize, MPI_BYTE, MPI_COMM_WORLD);
+	}
+	time = MPI_Wtime() - time;
+	MPI_Allreduce(MPI_IN_PLACE, &time, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+
+	free(sendBuffer);
+	free(receiveBuffer);
+
+	// Every process receives the probes of all other processes
+	return ((double) (numberOfNodes - 1) * probeSize * repetitions) / time;
+
+}
+
+double Bandwidth::measureMemoryBandwidth() {
+
+	uint64_t const probeSize = hpcjoin::core::Configuration::BANDWIDTH_PROBE_SIZE_BYTES;
+	uint32_t const repetitions = hpcjoin::core::Configuration::BANDWIDTH_PROBE_REPETITIONS;
+
+	char *source = (char *) calloc(probeSize, sizeof(char));
+	char *destination = (char *) calloc(probeSize, sizeof(char));
+	JOIN_ASSERT(source != NULL && destination != NULL, "Bandwidth", "Could not allocate probe buffers");
+
+	// The first copy touches the pages and is not measured
+	memcpy(destination, source, probeSize);
+
+	double time = MPI_Wtime();
+	for (uint32_t r = 0; r < repetitions; ++r) {
+		source[r] = (char) r;
+		memcpy(destination, source, probeSize);
+	}
+	time = MPI_Wtime() - time;
+	MPI_Allreduce(MPI_IN_PLACE, &time, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+
+	free(source);
+	free(destination);
+
+	return ((double) probeSize * repetitions) / time;
+
+}
+
+} /* namespace utils */
+} /* namespace hpcjoin */
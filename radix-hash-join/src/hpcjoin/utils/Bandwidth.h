@@ -0,0 +1,32 @@
+/**
+ * @author  Claude Barthels <claudeb@inf.ethz.ch>
+ * (c) 2016, ETH Zurich, Systems Group
+ *
+ */
+
+#ifndef UTILS_BANDWIDTH_H_
+#define UTILS_BANDWIDTH_H_
+
+#include <stdint.h>
+
+namespace hpcjoin {
+namespace utils {
+
+/**
+ * Short collective benchmarks which measure the bandwidth in bytes per second. All processes
+ * need to call them and obtain the same (slowest) value.
+ */
+
+class Bandwidth {
+
+public:
+
+	static double measureNetworkBandwidth(uint32_t numberOfNodes);
+	static double measureMemoryBandwidth();
+
+};
+
+} /* namespace utils */
+} /* namespace hpcjoin */
+
+#endif /* UTILS_BANDWIDTH_H_ */
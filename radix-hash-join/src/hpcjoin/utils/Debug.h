@@ -47,6 +47,11 @@
 
 /*********************************/
 
+// Values which are only checked by JOIN_ASSERT are unused in release builds
+#define JOIN_UNUSED(V) { (void) (V); }
+
+/*********************************/
+
 #ifdef JOIN_MEMORY_PRINT
 
 #define JOIN_MEM_DEBUG(A) { \
@@ -0,0 +1,85 @@
+/**
+ * @author  Claude Barthels <claudeb@inf.ethz.ch>
+ * (c) 2016, ETH Zurich, Systems Group
+ *
+ */
+
+#ifndef UTILS_DISPATCH_H_
+#define UTILS_DISPATCH_H_
+
+#include <hpcjoin/core/Configuration.h>
+#include <hpcjoin/data/CompressedTuple.h>
+#include <hpcjoin/data/WideCompressedTuple.h>
+#include <hpcjoin/data/NarrowCompressedTuple.h>
+#include <hpcjoin/utils/Debug.h>
+
+/**
+ * Calls the instance of a kernel template which has been specialized for the given
+ * fan-out. CALL is the call expression without the template argument list, e.g.
+ * FANOUT_DISPATCH(fanout, histogram = computeHistogram, data, size). The supported
+ * range is MIN_PARTITIONING_FANOUT to MAX_PARTITIONING_FANOUT (see Configuration.h).
+ */
+
+#define FANOUT_DISPATCH(FANOUT, CALL, ...) { \
+	switch (FANOUT) { \
+		case 1: CALL<1>(__VA_ARGS__); break; \
+		case 2: CALL<2>(__VA_ARGS__); break; \
+		case 3: CALL<3>(__VA_ARGS__); break; \
+		case 4: CALL<4>(__VA_ARGS__); break; \
+		case 5: CALL<5>(__VA_ARGS__); break; \
+		case 6: CALL<6>(__VA_ARGS__); break; \
+		case 7: CALL<7>(__VA_ARGS__); break; \
+		case 8: CALL<8>(__VA_ARGS__); break; \
+		case 9: CALL<9>(__VA_ARGS__); break; \
+		case 10: CALL<10>(__VA_ARGS__); break; \
+		case 11: CALL<11>(__VA_ARGS__); break; \
+		case 12: CALL<12>(__VA_ARGS__); break; \
+		default: \
+			fprintf(stderr, "Unsupported partitioning fan-out %u\n", (uint32_t) (FANOUT)); \
+			exit(-1); \
+	} \
+}
+
+/**
+ * Same as FANOUT_DISPATCH for kernels which are additionally specialized for a tuple
+ * type, e.g. TYPED_FANOUT_DISPATCH(TUPLE, fanout, partition, relation). The tuple type is
+ * the first template argument of the kernel.
+ */
+
+#define TYPED_FANOUT_DISPATCH(TYPE, FANOUT, CALL, ...) { \
+	switch (FANOUT) { \
+		case 1: CALL<TYPE, 1>(__VA_ARGS__); break; \
+		case 2: CALL<TYPE, 2>(__VA_ARGS__); break; \
+		case 3: CALL<TYPE, 3>(__VA_ARGS__); break; \
+		case 4: CALL<TYPE, 4>(__VA_ARGS__); break; \
+		case 5: CALL<TYPE, 5>(__VA_ARGS__); break; \
+		case 6: CALL<TYPE, 6>(__VA_ARGS__); break; \
+		case 7: CALL<TYPE, 7>(__VA_ARGS__); break; \
+		case 8: CALL<TYPE, 8>(__VA_ARGS__); break; \
+		case 9: CALL<TYPE, 9>(__VA_ARGS__); break; \
+		case 10: CALL<TYPE, 10>(__VA_ARGS__); break; \
+		case 11: CALL<TYPE, 11>(__VA_ARGS__); break; \
+		case 12: CALL<TYPE, 12>(__VA_ARGS__); break; \
+		default: \
+			fprintf(stderr, "Unsupported partitioning fan-out %u\n", (uint32_t) (FANOUT)); \
+			exit(-1); \
+	} \
+}
+
+/**
+ * Calls the instance of a template which has been specialized for the compressed tuple
+ * type of the given format (see Configuration::TUPLE_FORMAT).
+ */
+
+#define TUPLE_FORMAT_DISPATCH(FORMAT, CALL, ...) { \
+	switch (FORMAT) { \
+		case TUPLE_FORMAT_COMPRESSED: CALL<hpcjoin::data::CompressedTuple>(__VA_ARGS__); break; \
+		case TUPLE_FORMAT_WIDE: CALL<hpcjoin::data::WideCompressedTuple>(__VA_ARGS__); break; \
+		case TUPLE_FORMAT_NARROW: CALL<hpcjoin::data::NarrowCompressedTuple>(__VA_ARGS__); break; \
+		default: \
+			fprintf(stderr, "Unsupported tuple format %u\n", (uint32_t) (FORMAT)); \
+			exit(-1); \
+	} \
+}
+
+#endif /* UTILS_DISPATCH_H_ */
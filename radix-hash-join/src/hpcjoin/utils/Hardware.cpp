@@ -0,0 +1,73 @@
+/**
+ * @author  Claude Barthels <claudeb@inf.ethz.ch>
+ * (c) 2016, ETH Zurich, Systems Group
+ *
+ */
+
+#include "Hardware.h"
+
+#include <unistd.h>
+#include <cpuid.h>
+
+// Used if the values cannot be detected
+#define DEFAULT_L1_DATA_CACHE_SIZE (32 * 1024)
+#define DEFAULT_L2_CACHE_SIZE (256 * 1024)
+#define DEFAULT_DATA_TLB_ENTRIES (1024)
+
+namespace hpcjoin {
+namespace utils {
+
+uint64_t Hardware::getL1DataCacheSize() {
+
+	long size = sysconf(_SC_LEVEL1_DCACHE_SIZE);
+	return (size > 0) ? size : DEFAULT_L1_DATA_CACHE_SIZE;
+
+}
+
+uint64_t Hardware::getL2CacheSize() {
+
+	long size = sysconf(_SC_LEVEL2_CACHE_SIZE);
+	return (size > 0) ? size : DEFAULT_L2_CACHE_SIZE;
+
+}
+
+uint32_t Hardware::getDataTLBEntries() {
+
+	uint32_t entries = 0;
+	uint32_t eax, ebx, ecx, edx;
+
+	// Intel: deterministic address translation parameters
+	if (__get_cpuid_max(0, NULL) >= 0x18) {
+		__cpuid_count(0x18, 0, eax, ebx, ecx, edx);
+		uint32_t maxSubleaf = eax;
+		for (uint32_t s = 0; s <= maxSubleaf; ++s) {
+			__cpuid_count(0x18, s, eax, ebx, ecx, edx);
+			uint32_t type = edx & 0x1F;
+			bool supports4KPages = (ebx & 0x1);
+			// Data TLB (1) or unified TLB (3)
+			if ((type == 1 || type == 3) && supports4KPages) {
+				uint32_t ways = (ebx >> 16) & 0xFFFF;
+				uint32_t sets = ecx;
+				if (ways * sets > entries) {
+					entries = ways * sets;
+				}
+			}
+		}
+	}
+
+	// AMD: L1 and L2 data TLB for 4K pages
+	if (entries == 0 && __get_cpuid_max(0x80000000, NULL) >= 0x80000006) {
+		__cpuid(0x80000005, eax, ebx, ecx, edx);
+		entries = (ebx >> 16) & 0xFF;
+		__cpuid(0x80000006, eax, ebx, ecx, edx);
+		if (((ebx >> 16) & 0xFFF) > entries) {
+			entries = (ebx >> 16) & 0xFFF;
+		}
+	}
+
+	return (entries > 0) ? entries : DEFAULT_DATA_TLB_ENTRIES;
+
+}
+
+} /* namespace utils */
+} /* namespace hpcjoin */
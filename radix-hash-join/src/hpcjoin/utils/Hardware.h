@@ -0,0 +1,28 @@
+/**
+ * @author  Claude Barthels <claudeb@inf.ethz.ch>
+ * (c) 2016, ETH Zurich, Systems Group
+ *
+ */
+
+#ifndef UTILS_HARDWARE_H_
+#define UTILS_HARDWARE_H_
+
+#include <stdint.h>
+
+namespace hpcjoin {
+namespace utils {
+
+class Hardware {
+
+public:
+
+	static uint64_t getL1DataCacheSize();
+	static uint64_t getL2CacheSize();
+	static uint32_t getDataTLBEntries();
+
+};
+
+} /* namespace utils */
+} /* namespace hpcjoin */
+
+#endif /* UTILS_HARDWARE_H_ */
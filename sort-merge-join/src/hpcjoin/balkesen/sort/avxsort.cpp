@@ -4,6 +4,8 @@
  *
  */
 
+#include <string.h>
+
 #include "avxsort.h"
 #include "avxsort_core.h"
 
@@ -245,5 +247,35 @@ avxsort_int64(int64_t ** inputptr, int64_t ** outputptr, uint64_t nitems)
 void
 avxsort_int32(int32_t ** inputptr, int32_t ** outputptr, uint64_t nitems)
 {
-    /* \todo: implement */
+    /* no 32-bit sorting network available, use a LSD radix sort */
+    uint32_t * input  = (uint32_t*)(*inputptr);
+    uint32_t * output = (uint32_t*)(*outputptr);
+    uint64_t histogram[256];
+
+    for(uint32_t shift = 0; shift < 32; shift += 8) {
+        /* flip the sign bit in the last pass to get signed order */
+        uint32_t flip = (shift == 24) ? 0x80 : 0;
+
+        memset(histogram, 0, sizeof(histogram));
+        for(uint64_t i = 0; i < nitems; i++)
+            histogram[((input[i] >> shift) & 0xFF) ^ flip]++;
+
+        uint64_t sum = 0;
+        for(uint32_t b = 0; b < 256; b++) {
+            uint64_t count = histogram[b];
+            histogram[b] = sum;
+            sum += count;
+        }
+
+        for(uint64_t i = 0; i < nitems; i++)
+            output[histogram[((input[i] >> shift) & 0xFF) ^ flip]++] = input[i];
+
+        uint32_t * tmp = input;
+        input = output;
+        output = tmp;
+    }
+
+    /* sorted data is in the last written buffer */
+    *inputptr = (int32_t *)(output);
+    *outputptr = (int32_t *)(input);
 }
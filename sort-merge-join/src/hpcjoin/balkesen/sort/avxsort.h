@@ -35,7 +35,7 @@ avxsort_int64(int64_t ** inputptr, int64_t ** outputptr, uint64_t nitems);
 
 /**
  * \copydoc avxsort_int64
- * @note currently not implemented.
+ * @note uses a scalar LSD radix sort, no 32-bit sorting network is available.
  */
 void
 avxsort_int32(int32_t ** inputptr, int32_t ** outputptr, uint64_t nitems);
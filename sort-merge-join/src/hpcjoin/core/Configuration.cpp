@@ -0,0 +1,52 @@
+/**
+ * @author  Claude Barthels <claudeb@inf.ethz.ch>
+ * (c) 2016, ETH Zurich, Systems Group
+ *
+ */
+
+#include "Configuration.h"
+
+#include <hpcjoin/data/CompressedTuple.h>
+#include <hpcjoin/data/NarrowCompressedTuple.h>
+#include <hpcjoin/utils/Debug.h>
+
+namespace hpcjoin {
+namespace core {
+
+bool Configuration::MATERIALIZE_RESULTS = false;
+tuple_format_t Configuration::TUPLE_FORMAT = TUPLE_FORMAT_COMPRESSED;
+uint32_t Configuration::NARROW_PAYLOAD_BITS = 16;
+uint32_t Configuration::NARROW_PARTITION_BITS = 0;
+uint32_t Configuration::AGGREGATION_GROUPS = 0;
+
+void Configuration::selectTupleFormat(uint64_t maximumKey, uint64_t maximumRid, uint32_t partitionBits, bool automatic) {
+
+	// Narrow tuples drop the node partition bits and use as many rid bits as required
+	NARROW_PAYLOAD_BITS = 0;
+	while (NARROW_PAYLOAD_BITS < 64 && (maximumRid >> NARROW_PAYLOAD_BITS) > 0) {
+		++NARROW_PAYLOAD_BITS;
+	}
+	NARROW_PARTITION_BITS = partitionBits;
+
+	// The smallest representation which holds all keys and rids is used
+	if (automatic) {
+		if (hpcjoin::data::NarrowCompressedTuple::canRepresent(maximumKey, maximumRid)) {
+			TUPLE_FORMAT = TUPLE_FORMAT_NARROW;
+		} else if (hpcjoin::data::CompressedTuple::canRepresent(maximumKey, maximumRid)) {
+			TUPLE_FORMAT = TUPLE_FORMAT_COMPRESSED;
+		} else {
+			TUPLE_FORMAT = TUPLE_FORMAT_WIDE;
+		}
+	} else if (TUPLE_FORMAT == TUPLE_FORMAT_NARROW && !hpcjoin::data::NarrowCompressedTuple::canRepresent(maximumKey, maximumRid)) {
+		// A requested format which would truncate keys or rids is widened
+		TUPLE_FORMAT = hpcjoin::data::CompressedTuple::canRepresent(maximumKey, maximumRid) ? TUPLE_FORMAT_COMPRESSED : TUPLE_FORMAT_WIDE;
+	} else if (TUPLE_FORMAT == TUPLE_FORMAT_COMPRESSED && !hpcjoin::data::CompressedTuple::canRepresent(maximumKey, maximumRid)) {
+		TUPLE_FORMAT = TUPLE_FORMAT_WIDE;
+	}
+
+	JOIN_DEBUG("Configuration", "Maximum key %lu and rid %lu: %s tuples", maximumKey, maximumRid, (TUPLE_FORMAT == TUPLE_FORMAT_WIDE) ? "wide" : ((TUPLE_FORMAT == TUPLE_FORMAT_NARROW) ? "narrow" : "compressed"));
+
+}
+
+} /* namespace core */
+} /* namespace hpcjoin */
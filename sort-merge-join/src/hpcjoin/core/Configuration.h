@@ -9,6 +9,12 @@
 
 #include <stdint.h>
 
+enum tuple_format_t {
+	TUPLE_FORMAT_COMPRESSED,
+	TUPLE_FORMAT_WIDE,
+	TUPLE_FORMAT_NARROW
+};
+
 namespace hpcjoin {
 namespace core {
 
@@ -28,6 +34,24 @@ public:
 
 	static const uint32_t MAX_MERGE_FAN_IN = 16;
 
+	static const uint64_t RESULT_CHUNK_SIZE_BYTES = (1 << 20);
+
+public:
+
+	/**
+	 * Runtime configuration (set before the join is started)
+	 */
+
+	static bool MATERIALIZE_RESULTS;
+	static tuple_format_t TUPLE_FORMAT;
+	static uint32_t NARROW_PAYLOAD_BITS;
+	static uint32_t NARROW_PARTITION_BITS;
+	static uint32_t AGGREGATION_GROUPS;
+
+public:
+
+	static void selectTupleFormat(uint64_t maximumKey, uint64_t maximumRid, uint32_t partitionBits, bool automatic);
+
 };
 
 } /* namespace core */
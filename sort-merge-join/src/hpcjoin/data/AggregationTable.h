@@ -0,0 +1,64 @@
+/**
+ * @author  Claude Barthels <claudeb@inf.ethz.ch>
+ * (c) 2016, ETH Zurich, Systems Group
+ *
+ */
+
+#ifndef HPCJOIN_DATA_AGGREGATIONTABLE_H_
+#define HPCJOIN_DATA_AGGREGATIONTABLE_H_
+
+#include <stdint.h>
+
+namespace hpcjoin {
+namespace data {
+
+typedef struct {
+
+	uint64_t count;
+	uint64_t sum;
+
+} aggregate_t;
+
+/**
+ * Partial result of a join-aggregation (GROUP BY with COUNT and SUM). Matches are folded
+ * into the table instead of being materialized. The group column is the inner record-
+ * identifier modulo the number of groups and the aggregated column is the outer record-
+ * identifier. Every process fills its own table, the tables are combined after the join.
+ */
+
+class AggregationTable {
+
+public:
+
+	AggregationTable(uint32_t numberOfGroups);
+	~AggregationTable();
+
+public:
+
+	inline void add(uint64_t innerRid, uint64_t outerRid) __attribute__((always_inline));
+
+	void merge(AggregationTable *other);
+	void reduce(uint32_t rootNodeId);
+
+	uint32_t getNumberOfGroups();
+	aggregate_t *getAggregate(uint32_t groupId);
+
+protected:
+
+	uint32_t numberOfGroups;
+	aggregate_t *aggregates;
+
+};
+
+inline void AggregationTable::add(uint64_t innerRid, uint64_t outerRid) {
+
+	aggregate_t *aggregate = this->aggregates + (innerRid % this->numberOfGroups);
+	++(aggregate->count);
+	aggregate->sum += outerRid;
+
+}
+
+} /* namespace data */
+} /* namespace hpcjoin */
+
+#endif /* HPCJOIN_DATA_AGGREGATIONTABLE_H_ */
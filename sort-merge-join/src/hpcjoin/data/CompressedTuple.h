@@ -7,18 +7,47 @@
 #ifndef HPCJOIN_DATA_COMPRESSEDTUPLE_H_
 #define HPCJOIN_DATA_COMPRESSEDTUPLE_H_
 
-#include <stdlib.h>
-#include <stdio.h>
+#include <stdint.h>
+
+#include <hpcjoin/core/Configuration.h>
 
 namespace hpcjoin {
 namespace data {
 
+/**
+ * The rid is stored in the lower PAYLOAD_BITS, the key bits above the node partition bits
+ * are stored above. The sort kernels compare the values as signed integers, hence keys
+ * need to be smaller than 2^KEY_BITS and rids smaller than 2^PAYLOAD_BITS.
+ */
+
 class CompressedTuple {
 
+public:
+
+	static const uint32_t KEY_BITS = 63 - hpcjoin::core::Configuration::PAYLOAD_BITS;
+
 public:
 
 	uint64_t value;
 
+public:
+
+	inline void pack(uint64_t key, uint64_t rid, uint32_t partitionBits) {
+		this->value = rid + ((key >> partitionBits) << (partitionBits + hpcjoin::core::Configuration::PAYLOAD_BITS));
+	}
+
+	inline uint64_t getKey(uint32_t shift) const {
+		return this->value >> (shift + hpcjoin::core::Configuration::PAYLOAD_BITS);
+	}
+
+	inline uint64_t getRid() const {
+		return this->value & ((1ULL << hpcjoin::core::Configuration::PAYLOAD_BITS) - 1);
+	}
+
+	static bool canRepresent(uint64_t maximumKey, uint64_t maximumRid) {
+		return (maximumKey >> KEY_BITS) == 0 && (maximumRid >> hpcjoin::core::Configuration::PAYLOAD_BITS) == 0;
+	}
+
 };
 
 } /* namespace data */
@@ -0,0 +1,283 @@
+/**
+ * @author  Claude Barthels <claudeb@inf.ethz.ch>
+ * (c) 2016, ETH Zurich, Systems Group
+ *
+ */
+
+#include "Generator.h"
+
+#include <stdlib.h>
+#include <math.h>
+#include <pthread.h>
+#include <algorithm>
+
+#include <hpcjoin/utils/Debug.h>
+
+#define GENERATOR_CLUSTER_SIZE (4096)
+#define GENERATOR_FEISTEL_ROUNDS (4)
+
+#define GENERATOR_STREAM_KEY (0)
+#define GENERATOR_STREAM_MATCH (1)
+#define GENERATOR_STREAM_CLUSTER (2)
+#define GENERATOR_STREAM_FEISTEL (16)
+#define GENERATOR_STREAM_ZIPF (32)
+
+namespace hpcjoin {
+namespace data {
+
+typedef struct {
+
+	Generator *generator;
+	hpcjoin::data::Tuple *tuples;
+	uint64_t firstPosition;
+	uint64_t numberOfTuples;
+
+} generator_argument_t;
+
+static inline uint64_t mix(uint64_t value) {
+
+	value ^= value >> 33;
+	value *= 0xff51afd7ed558ccdULL;
+	value ^= value >> 33;
+	value *= 0xc4ceb9fe1a85ec53ULL;
+	value ^= value >> 33;
+	return value;
+
+}
+
+static inline double zipfHelper1(double x) {
+	return (fabs(x) > 1e-8) ? log1p(x) / x : 1.0 - x * (0.5 - x * (1.0 / 3.0 - 0.25 * x));
+}
+
+static inline double zipfHelper2(double x) {
+	return (fabs(x) > 1e-8) ? expm1(x) / x : 1.0 + x * 0.5 * (1.0 + x * (1.0 / 3.0) * (1.0 + 0.25 * x));
+}
+
+static inline double zipfH(double x, double exponent) {
+	return exp(-exponent * log(x));
+}
+
+static inline double zipfIntegral(double x, double exponent) {
+	double logX = log(x);
+	return zipfHelper2((1.0 - exponent) * logX) * logX;
+}
+
+static inline double zipfIntegralInverse(double x, double exponent) {
+	double t = x * (1.0 - exponent);
+	if (t < -1.0) {
+		t = -1.0;
+	}
+	return exp(zipfHelper1(t) * x);
+}
+
+static bool compareKeys(const hpcjoin::data::Tuple &a, const hpcjoin::data::Tuple &b) {
+	return a.key < b.key;
+}
+
+Generator::Generator(uint64_t seed, uint32_t numberOfThreads) {
+
+	JOIN_ASSERT(numberOfThreads > 0, "Generator", "At least one thread is required");
+
+	this->seed = mix(seed + 1);
+	this->numberOfThreads = numberOfThreads;
+
+	this->distribution = KEYS_PRIMARY;
+	this->domainSize = 0;
+	this->domainBits = 0;
+	this->duplicates = 1;
+	this->numberOfDistinctKeys = 0;
+	this->matchRate = 1.0;
+
+	this->zipfExponent = 0;
+	this->zipfIntegralX1 = 0;
+	this->zipfIntegralN = 0;
+	this->zipfS = 0;
+
+}
+
+Generator::~Generator() {
+
+}
+
+void Generator::generatePrimaryKeys(Relation* relation, uint32_t nodeId, uint32_t numberOfNodes, uint32_t duplicates) {
+
+	JOIN_ASSERT(duplicates > 0, "Generator", "Every key needs to appear at least once");
+
+	this->distribution = KEYS_PRIMARY;
+	this->duplicates = duplicates;
+	this->domainSize = relation->getGlobalSize();
+	this->numberOfDistinctKeys = (this->domainSize + duplicates - 1) / duplicates;
+
+	// Feistel networks permute domains of an even number of bits, larger values are cycled back
+	this->domainBits = 2;
+	while (this->domainBits < 64 && (1ULL << this->domainBits) < this->domainSize) {
+		this->domainBits += 2;
+	}
+
+	generate(relation, nodeId, numberOfNodes);
+
+}
+
+void Generator::generateForeignKeys(Relation* relation, uint32_t nodeId, uint32_t numberOfNodes, uint64_t numberOfDistinctKeys, double matchRate) {
+
+	this->distribution = KEYS_FOREIGN;
+	this->numberOfDistinctKeys = numberOfDistinctKeys;
+	this->matchRate = matchRate;
+
+	generate(relation, nodeId, numberOfNodes);
+
+}
+
+void Generator::generateZipfKeys(Relation* relation, uint32_t nodeId, uint32_t numberOfNodes, uint64_t numberOfDistinctKeys, double exponent, double matchRate) {
+
+	JOIN_ASSERT(exponent > 0, "Generator", "Zipf exponent needs to be positive");
+
+	this->distribution = KEYS_ZIPF;
+	this->numberOfDistinctKeys = numberOfDistinctKeys;
+	this->matchRate = matchRate;
+
+	// Rejection-inversion sampling (Hoermann and Derflinger), constant time per sample
+	this->zipfExponent = exponent;
+	this->zipfIntegralX1 = zipfIntegral(1.5, exponent) - 1.0;
+	this->zipfIntegralN = zipfIntegral(numberOfDistinctKeys + 0.5, exponent);
+	this->zipfS = 2.0 - zipfIntegralInverse(zipfIntegral(2.5, exponent) - zipfH(2.0, exponent), exponent);
+
+	generate(relation, nodeId, numberOfNodes);
+
+}
+
+void Generator::generate(Relation* relation, uint32_t nodeId, uint32_t numberOfNodes) {
+
+	uint64_t firstPosition = nodeId * (relation->getGlobalSize() / numberOfNodes);
+	uint64_t localSize = relation->getLocalSize();
+
+	pthread_t *threads = (pthread_t *) calloc(this->numberOfThreads, sizeof(pthread_t));
+	generator_argument_t *arguments = (generator_argument_t *) calloc(this->numberOfThreads, sizeof(generator_argument_t));
+
+	for (uint32_t t = 0; t < this->numberOfThreads; ++t) {
+		uint64_t start = (localSize / this->numberOfThreads) * t;
+		uint64_t end = (t < this->numberOfThreads - 1) ? (localSize / this->numberOfThreads) * (t + 1) : localSize;
+		arguments[t].generator = this;
+		arguments[t].tuples = relation->getData() + start;
+		arguments[t].firstPosition = firstPosition + start;
+		arguments[t].numberOfTuples = end - start;
+		int result = pthread_create(&(threads[t]), NULL, &Generator::run, &(arguments[t]));
+		JOIN_ASSERT(result == 0, "Generator", "Could not create generator thread %d", t);
+		JOIN_UNUSED(result);
+	}
+
+	for (uint32_t t = 0; t < this->numberOfThreads; ++t) {
+		pthread_join(threads[t], NULL);
+	}
+
+	free(threads);
+	free(arguments);
+
+}
+
+void* Generator::run(void* argument) {
+
+	generator_argument_t *generatorArgument = (generator_argument_t *) argument;
+
+	for (uint64_t i = 0; i < generatorArgument->numberOfTuples; ++i) {
+		uint64_t position = generatorArgument->firstPosition + i;
+		generatorArgument->tuples[i].key = generatorArgument->generator->computeKey(position);
+		generatorArgument->tuples[i].rid = position;
+	}
+
+	return NULL;
+
+}
+
+uint64_t Generator::computeKey(uint64_t position) {
+
+	if (this->distribution == KEYS_PRIMARY) {
+		return permute(position) / this->duplicates;
+	}
+
+	// Keys without a join partner are drawn from a disjoint range of the same size
+	if (this->matchRate < 1.0 && random(position, GENERATOR_STREAM_MATCH) >= this->matchRate) {
+		return this->numberOfDistinctKeys + hash(position, GENERATOR_STREAM_KEY) % this->numberOfDistinctKeys;
+	}
+
+	if (this->distribution == KEYS_FOREIGN) {
+		return hash(position, GENERATOR_STREAM_KEY) % this->numberOfDistinctKeys;
+	}
+
+	return sampleZipf(position) - 1;
+
+}
+
+uint64_t Generator::permute(uint64_t value) {
+
+	uint32_t const halfBits = this->domainBits / 2;
+	uint64_t const halfMask = (halfBits == 32) ? 0xFFFFFFFFULL : ((1ULL << halfBits) - 1);
+
+	do {
+		uint64_t left = value >> halfBits;
+		uint64_t right = value & halfMask;
+		for (uint32_t r = 0; r < GENERATOR_FEISTEL_ROUNDS; ++r) {
+			uint64_t next = left ^ (hash(right, GENERATOR_STREAM_FEISTEL + r) & halfMask);
+			left = right;
+			right = next;
+		}
+		value = (left << halfBits) | right;
+	} while (value >= this->domainSize);
+
+	return value;
+
+}
+
+uint64_t Generator::sampleZipf(uint64_t position) {
+
+	for (uint64_t attempt = 0;; ++attempt) {
+		double u = this->zipfIntegralN + random(position, GENERATOR_STREAM_ZIPF + attempt) * (this->zipfIntegralX1 - this->zipfIntegralN);
+		double x = zipfIntegralInverse(u, this->zipfExponent);
+		uint64_t k = (uint64_t) (x + 0.5);
+		if (k < 1) {
+			k = 1;
+		} else if (k > this->numberOfDistinctKeys) {
+			k = this->numberOfDistinctKeys;
+		}
+		if (k - x <= this->zipfS || u >= zipfIntegral(k + 0.5, this->zipfExponent) - zipfH(k, this->zipfExponent)) {
+			return k;
+		}
+	}
+
+}
+
+void Generator::reorder(Relation* relation, tuple_order_t order) {
+
+	if (order == ORDER_RANDOM) {
+		return;
+	}
+
+	hpcjoin::data::Tuple *tuples = relation->getData();
+	uint64_t numberOfTuples = relation->getLocalSize();
+	std::sort(tuples, tuples + numberOfTuples, compareKeys);
+
+	if (order == ORDER_CLUSTERED) {
+		// Blocks of neighbouring keys are shuffled, the order within a block is kept
+		uint64_t numberOfClusters = numberOfTuples / GENERATOR_CLUSTER_SIZE;
+		for (uint64_t c = numberOfClusters; c > 1; --c) {
+			uint64_t other = hash(c, GENERATOR_STREAM_CLUSTER) % c;
+			std::swap_ranges(tuples + (c - 1) * GENERATOR_CLUSTER_SIZE, tuples + c * GENERATOR_CLUSTER_SIZE, tuples + other * GENERATOR_CLUSTER_SIZE);
+		}
+	}
+
+}
+
+double Generator::random(uint64_t position, uint64_t stream) {
+
+	return (hash(position, stream) >> 11) * (1.0 / 9007199254740992.0);
+
+}
+
+uint64_t Generator::hash(uint64_t position, uint64_t stream) {
+
+	return mix(this->seed ^ mix(position * 0x9E3779B97F4A7C15ULL + stream));
+
+}
+
+} /* namespace data */
+} /* namespace hpcjoin */
@@ -0,0 +1,129 @@
+/**
+ * @author  Claude Barthels <claudeb@inf.ethz.ch>
+ * (c) 2016, ETH Zurich, Systems Group
+ *
+ */
+
+#include "JoinResult.h"
+
+#include <stdlib.h>
+
+#include <hpcjoin/utils/Debug.h>
+
+namespace hpcjoin {
+namespace data {
+
+JoinResult::JoinResult(uint32_t numberOfBuffers) {
+
+	this->numberOfBuffers = numberOfBuffers;
+	this->buffers = (hpcjoin::data::ResultBuffer **) calloc(numberOfBuffers, sizeof(hpcjoin::data::ResultBuffer *));
+	for (uint32_t b = 0; b < numberOfBuffers; ++b) {
+		this->buffers[b] = new hpcjoin::data::ResultBuffer();
+	}
+
+}
+
+JoinResult::~JoinResult() {
+
+	for (uint32_t b = 0; b < this->numberOfBuffers; ++b) {
+		delete this->buffers[b];
+	}
+	free(this->buffers);
+
+}
+
+hpcjoin::data::ResultBuffer* JoinResult::getBuffer(uint32_t bufferId) {
+
+	JOIN_ASSERT(bufferId < this->numberOfBuffers, "Join Result", "Buffer id %d out of range", bufferId);
+	return this->buffers[bufferId];
+
+}
+
+uint32_t JoinResult::getNumberOfBuffers() {
+
+	return this->numberOfBuffers;
+
+}
+
+void JoinResult::flush() {
+
+	for (uint32_t b = 0; b < this->numberOfBuffers; ++b) {
+		this->buffers[b]->flush();
+	}
+
+}
+
+uint64_t JoinResult::getNumberOfResults() {
+
+	uint64_t numberOfResults = 0;
+	for (uint32_t b = 0; b < this->numberOfBuffers; ++b) {
+		numberOfResults += this->buffers[b]->getNumberOfResults();
+	}
+	return numberOfResults;
+
+}
+
+void JoinResult::forEach(result_callback_t callback, void* argument) {
+
+	for (uint32_t b = 0; b < this->numberOfBuffers; ++b) {
+		for (result_chunk_t *chunk = this->buffers[b]->getFirstChunk(); chunk != NULL; chunk = chunk->next) {
+			if (chunk->size > 0) {
+				callback(chunk->results, chunk->size, argument);
+			}
+		}
+	}
+
+}
+
+JoinResult::Iterator::Iterator(JoinResult* result) {
+
+	this->result = result;
+	this->bufferId = 0;
+	this->chunk = (result->numberOfBuffers > 0) ? result->buffers[0]->getFirstChunk() : NULL;
+	this->position = 0;
+
+	skipEmptyChunks();
+
+}
+
+bool JoinResult::Iterator::hasNext() {
+
+	return (this->chunk != NULL);
+
+}
+
+hpcjoin::data::ResultTuple* JoinResult::Iterator::next() {
+
+	JOIN_ASSERT(this->chunk != NULL, "Join Result", "Iterator has no more results");
+
+	hpcjoin::data::ResultTuple *tuple = this->chunk->results + this->position;
+	++(this->position);
+	skipEmptyChunks();
+
+	return tuple;
+
+}
+
+void JoinResult::Iterator::skipEmptyChunks() {
+
+	while (true) {
+		if (this->chunk != NULL) {
+			if (this->position < this->chunk->size) {
+				return;
+			}
+			this->chunk = this->chunk->next;
+			this->position = 0;
+		} else {
+			++(this->bufferId);
+			if (this->bufferId >= this->result->numberOfBuffers) {
+				return;
+			}
+			this->chunk = this->result->buffers[this->bufferId]->getFirstChunk();
+			this->position = 0;
+		}
+	}
+
+}
+
+} /* namespace data */
+} /* namespace hpcjoin */
@@ -10,7 +10,23 @@
 #include <stdint.h>
 
 #include <hpcjoin/data/Tuple.h>
-#include <hpcjoin/data/CompressedTuple.h>
+
+#define RELATION_FILE_MAGIC (0x314C45524A435048ULL)
+#define RELATION_FILE_INVALID_SIZE (0xFFFFFFFFFFFFFFFFULL)
+
+/**
+ * Binary columnar relation file: a header followed by the key and the rid column, each stored
+ * as an array of numberOfTuples 64-bit values at the given byte offsets.
+ */
+
+typedef struct {
+
+	uint64_t magic;
+	uint64_t numberOfTuples;
+	uint64_t keyOffset;
+	uint64_t ridOffset;
+
+} relation_file_header_t;
 
 namespace hpcjoin {
 namespace data {
@@ -35,22 +51,41 @@ public: // Special functions to reuse data with compressed data
 
 	uint64_t secondHalfStartInBytes;
 	uint64_t secondHalfSizeInBytes;
-	hpcjoin::data::CompressedTuple* getFirstHalfData();
-	hpcjoin::data::CompressedTuple* getSecondHalfData();
+	void* getFirstHalfData();
+	void* getSecondHalfData();
+
+	/**
+	 * Grows the buffer if a half cannot hold the given number of bytes, the tuple data is not preserved
+	 */
+	void reserveHalves(uint64_t halfSizeInBytes);
 
 public:
 
+	/**
+	 * Largest key and rid of the local data
+	 */
+	void computeMaximumValues(uint64_t *maximumKey, uint64_t *maximumRid);
+
 	void fillUniqueValues(uint64_t startKeyValue, uint64_t startRidValue);
 	void fillModuloValues(uint64_t startKeyValue, uint64_t startRidValue, uint64_t innerRelationSize);
 
 public:
 
-	// Removed: Implementation was specific to Cray machines
-	//void loadFromFile(char * fileName);
-	//void storeToFile(char * fileName);
+	/**
+	 * Every process reads its own stripe of the file (same split as the generated data).
+	 * Uses collective MPI-IO reads, a single process maps the file instead. Returns false on all
+	 * processes if the file could not be read completely.
+	 */
+	bool loadFromFile(const char *fileName, uint32_t nodeId, uint32_t numberOfNodes);
+	static uint64_t readNumberOfTuples(const char *fileName);
+
+protected:
+
+	static bool isValidHeader(relation_file_header_t *header, uint64_t fileSize);
 
 protected:
 
+	void allocateBuffer(uint64_t sizeInBytes);
 	void randomOrder();
 
 public:
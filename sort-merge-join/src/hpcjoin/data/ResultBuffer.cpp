@@ -0,0 +1,89 @@
+/**
+ * @author  Claude Barthels <claudeb@inf.ethz.ch>
+ * (c) 2016, ETH Zurich, Systems Group
+ *
+ */
+
+#include "ResultBuffer.h"
+
+#include <stdlib.h>
+
+#include <hpcjoin/utils/Debug.h>
+
+namespace hpcjoin {
+namespace data {
+
+ResultBuffer::ResultBuffer() {
+
+	int result = posix_memalign((void **) &(this->cacheLine), hpcjoin::core::Configuration::CACHELINE_SIZE_BYTES, hpcjoin::core::Configuration::CACHELINE_SIZE_BYTES);
+	JOIN_ASSERT(result == 0, "Result Buffer", "Could not allocate cacheline");
+	JOIN_UNUSED(result);
+	this->cacheLineSlot = 0;
+
+	this->firstChunk = NULL;
+	this->currentChunk = NULL;
+
+	this->numberOfResults = 0;
+
+}
+
+ResultBuffer::~ResultBuffer() {
+
+	result_chunk_t *chunk = this->firstChunk;
+	while (chunk != NULL) {
+		result_chunk_t *next = chunk->next;
+		free(chunk->results);
+		free(chunk);
+		chunk = next;
+	}
+	free(this->cacheLine);
+
+}
+
+void ResultBuffer::flush() {
+
+	for (uint32_t t = 0; t < this->cacheLineSlot; ++t) {
+		if (this->currentChunk == NULL || this->currentChunk->size == RESULT_TUPLES_PER_CHUNK) {
+			addChunk();
+		}
+		this->currentChunk->results[this->currentChunk->size] = this->cacheLine[t];
+		++(this->currentChunk->size);
+	}
+	this->numberOfResults += this->cacheLineSlot;
+	this->cacheLineSlot = 0;
+
+	// Make the streamed data visible to other threads
+	_mm_sfence();
+
+}
+
+uint64_t ResultBuffer::getNumberOfResults() {
+
+	return this->numberOfResults;
+
+}
+
+result_chunk_t* ResultBuffer::getFirstChunk() {
+
+	return this->firstChunk;
+
+}
+
+void ResultBuffer::addChunk() {
+
+	result_chunk_t *chunk = (result_chunk_t *) calloc(1, sizeof(result_chunk_t));
+	int result = posix_memalign((void **) &(chunk->results), hpcjoin::core::Configuration::CACHELINE_SIZE_BYTES, hpcjoin::core::Configuration::RESULT_CHUNK_SIZE_BYTES);
+	JOIN_ASSERT(result == 0, "Result Buffer", "Could not allocate result chunk");
+	JOIN_UNUSED(result);
+
+	if (this->currentChunk == NULL) {
+		this->firstChunk = chunk;
+	} else {
+		this->currentChunk->next = chunk;
+	}
+	this->currentChunk = chunk;
+
+}
+
+} /* namespace data */
+} /* namespace hpcjoin */
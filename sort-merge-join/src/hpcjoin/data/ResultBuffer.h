@@ -0,0 +1,107 @@
+/**
+ * @author  Claude Barthels <claudeb@inf.ethz.ch>
+ * (c) 2016, ETH Zurich, Systems Group
+ *
+ */
+
+#ifndef HPCJOIN_DATA_RESULTBUFFER_H_
+#define HPCJOIN_DATA_RESULTBUFFER_H_
+
+#include <stdint.h>
+#include <immintrin.h>
+
+#include <hpcjoin/core/Configuration.h>
+#include <hpcjoin/data/ResultTuple.h>
+
+#define RESULT_TUPLES_PER_CACHELINE (hpcjoin::core::Configuration::CACHELINE_SIZE_BYTES / sizeof(hpcjoin::data::ResultTuple))
+#define RESULT_TUPLES_PER_CHUNK (hpcjoin::core::Configuration::RESULT_CHUNK_SIZE_BYTES / sizeof(hpcjoin::data::ResultTuple))
+
+namespace hpcjoin {
+namespace data {
+
+typedef struct result_chunk {
+
+	struct result_chunk *next;
+	uint64_t size;
+	hpcjoin::data::ResultTuple *results;
+
+} result_chunk_t;
+
+/**
+ * Output buffer of a single thread. Results are collected in a cacheline and streamed
+ * into fixed-size chunks. Full chunks are never copied, a new chunk is appended instead.
+ */
+
+class ResultBuffer {
+
+public:
+
+	ResultBuffer();
+	~ResultBuffer();
+
+public:
+
+	inline void append(uint64_t innerRid, uint64_t outerRid) __attribute__((always_inline));
+	void flush();
+
+	uint64_t getNumberOfResults();
+	result_chunk_t *getFirstChunk();
+
+protected:
+
+	void addChunk();
+
+	inline static void streamWrite(void *to, void *from) __attribute__((always_inline));
+
+protected:
+
+	hpcjoin::data::ResultTuple *cacheLine;
+	uint32_t cacheLineSlot;
+
+	result_chunk_t *firstChunk;
+	result_chunk_t *currentChunk;
+
+	uint64_t numberOfResults;
+
+};
+
+inline void ResultBuffer::append(uint64_t innerRid, uint64_t outerRid) {
+
+	cacheLine[cacheLineSlot].innerRid = innerRid;
+	cacheLine[cacheLineSlot].outerRid = outerRid;
+	++cacheLineSlot;
+
+	if (cacheLineSlot == RESULT_TUPLES_PER_CACHELINE) {
+		if (currentChunk == NULL || currentChunk->size == RESULT_TUPLES_PER_CHUNK) {
+			addChunk();
+		}
+		streamWrite(currentChunk->results + currentChunk->size, cacheLine);
+		currentChunk->size += RESULT_TUPLES_PER_CACHELINE;
+		numberOfResults += RESULT_TUPLES_PER_CACHELINE;
+		cacheLineSlot = 0;
+	}
+
+}
+
+inline void ResultBuffer::streamWrite(void* to, void* from) {
+
+	register __m128i * d1 = (__m128i *) to;
+	register __m128i s1 = *((__m128i *) from);
+	register __m128i * d2 = d1 + 1;
+	register __m128i s2 = *(((__m128i *) from) + 1);
+	register __m128i * d3 = d1 + 2;
+	register __m128i s3 = *(((__m128i *) from) + 2);
+	register __m128i * d4 = d1 + 3;
+	register __m128i s4 = *(((__m128i *) from) + 3);
+
+	_mm_stream_si128(d1, s1);
+	_mm_stream_si128(d2, s2);
+	_mm_stream_si128(d3, s3);
+	_mm_stream_si128(d4, s4);
+
+}
+
+} /* namespace data */
+} /* namespace hpcjoin */
+
+#endif /* HPCJOIN_DATA_RESULTBUFFER_H_ */
@@ -0,0 +1,27 @@
+/**
+ * @author  Claude Barthels <claudeb@inf.ethz.ch>
+ * (c) 2016, ETH Zurich, Systems Group
+ *
+ */
+
+#ifndef HPCJOIN_DATA_RESULTTUPLE_H_
+#define HPCJOIN_DATA_RESULTTUPLE_H_
+
+#include <stdint.h>
+
+namespace hpcjoin {
+namespace data {
+
+class ResultTuple {
+
+public:
+
+	uint64_t innerRid;
+	uint64_t outerRid;
+
+};
+
+} /* namespace data */
+} /* namespace hpcjoin */
+
+#endif /* HPCJOIN_DATA_RESULTTUPLE_H_ */
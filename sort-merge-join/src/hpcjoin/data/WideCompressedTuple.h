@@ -0,0 +1,59 @@
+/**
+ * @author  Claude Barthels <claudeb@inf.ethz.ch>
+ * (c) 2016, ETH Zurich, Systems Group
+ *
+ */
+
+#ifndef HPCJOIN_DATA_WIDECOMPRESSEDTUPLE_H_
+#define HPCJOIN_DATA_WIDECOMPRESSEDTUPLE_H_
+
+#include <stdint.h>
+
+namespace hpcjoin {
+namespace data {
+
+/**
+ * 128-bit variant of the compressed tuple for keys and rids which exceed the packed
+ * limits. Runs of wide tuples are ordered by key only.
+ */
+
+class WideCompressedTuple {
+
+public:
+
+	static const uint32_t KEY_BITS = 64;
+
+public:
+
+	uint64_t key;
+	uint64_t rid;
+
+public:
+
+	inline void pack(uint64_t key, uint64_t rid, uint32_t partitionBits) {
+		this->key = key;
+		this->rid = rid;
+	}
+
+	inline uint64_t getKey(uint32_t shift) const {
+		return this->key >> shift;
+	}
+
+	inline uint64_t getRid() const {
+		return this->rid;
+	}
+
+	inline bool operator<(const WideCompressedTuple &other) const {
+		return this->key < other.key;
+	}
+
+	static bool canRepresent(uint64_t maximumKey, uint64_t maximumRid) {
+		return true;
+	}
+
+};
+
+} /* namespace data */
+} /* namespace hpcjoin */
+
+#endif /* HPCJOIN_DATA_WIDECOMPRESSEDTUPLE_H_ */
@@ -7,6 +7,8 @@
 #include "Window.h"
 
 #include <hpcjoin/core/Configuration.h>
+#include <hpcjoin/data/WideCompressedTuple.h>
+#include <hpcjoin/data/NarrowCompressedTuple.h>
 #include <hpcjoin/utils/Debug.h>
 
 #include <string.h>
@@ -16,7 +18,8 @@
 namespace hpcjoin {
 namespace data {
 
-Window::Window(uint32_t numberOfNodes, uint64_t sizeInElements, uint64_t* numberOfElementsFromNode, uint64_t* writeOffsets, hpcjoin::data::Relation *relation) {
+template<typename TUPLE>
+Window<TUPLE>::Window(uint32_t numberOfNodes, uint64_t sizeInElements, uint64_t* numberOfElementsFromNode, uint64_t* writeOffsets, hpcjoin::data::Relation *relation) {
 
 	this->numberOfNodes = numberOfNodes;
 	this->sizeInElements = sizeInElements;
@@ -34,19 +37,19 @@ Window::Window(uint32_t numberOfNodes, uint64_t sizeInElements, uint64_t* number
 	memset(&window, 0, sizeof(MPI_Win));
 #endif
 
-	//MPI_Alloc_mem(sizeInElements * sizeof(hpcjoin::data::CompressedTuple), MPI_INFO_NULL, &(this->data));
+	//MPI_Alloc_mem(sizeInElements * sizeof(TUPLE), MPI_INFO_NULL, &(this->data));
 	// HACK: reuse memory
-	this->data = relation->getFirstHalfData();
-	JOIN_ALWAYS_ASSERT(sizeInElements*sizeof(hpcjoin::data::CompressedTuple) <= relation->secondHalfStartInBytes, "Window", "Window will overlap with second half of relation buffer.");
-	JOIN_ALWAYS_ASSERT(sizeInElements*sizeof(hpcjoin::data::CompressedTuple) <= relation->secondHalfSizeInBytes, "Window", "Second half of relation buffer is not big enough to hold data.");
+	this->data = (TUPLE *) relation->getFirstHalfData();
+	JOIN_ALWAYS_ASSERT(sizeInElements*sizeof(TUPLE) <= relation->secondHalfStartInBytes, "Window", "Window will overlap with second half of relation buffer.");
+	JOIN_ALWAYS_ASSERT(sizeInElements*sizeof(TUPLE) <= relation->secondHalfSizeInBytes, "Window", "Second half of relation buffer is not big enough to hold data.");
 
 #ifdef USE_FOMPI
-	foMPI_Win_create(this->data, sizeInElements * sizeof(hpcjoin::data::CompressedTuple), 1, MPI_INFO_NULL, MPI_COMM_WORLD, &window);
+	foMPI_Win_create(this->data, sizeInElements * sizeof(TUPLE), 1, MPI_INFO_NULL, MPI_COMM_WORLD, &window);
 #else
-	MPI_Win_create(this->data, sizeInElements * sizeof(hpcjoin::data::CompressedTuple), 1, MPI_INFO_NULL, MPI_COMM_WORLD, &window);
+	MPI_Win_create(this->data, sizeInElements * sizeof(TUPLE), 1, MPI_INFO_NULL, MPI_COMM_WORLD, &window);
 #endif
 
-	JOIN_DEBUG("Window", "Allocated %lu bytes", sizeInElements * sizeof(hpcjoin::data::CompressedTuple));
+	JOIN_DEBUG("Window", "Allocated %lu bytes", sizeInElements * sizeof(TUPLE));
 
 	/**
 	 * Run segmentation
@@ -58,12 +61,13 @@ Window::Window(uint32_t numberOfNodes, uint64_t sizeInElements, uint64_t* number
 
 }
 
-void Window::write(uint32_t targetNode, CompressedTuple* tuples, uint32_t sizeInTuples) {
+template<typename TUPLE>
+void Window<TUPLE>::write(uint32_t targetNode, TUPLE* tuples, uint32_t sizeInTuples) {
 
 	JOIN_DEBUG("Window", "Writing to window");
 
-	uint32_t sizeInBytes = sizeInTuples*sizeof(hpcjoin::data::CompressedTuple);
-	uint64_t targetOffset = (writeOffsets[targetNode]+writeCounters[targetNode]) * sizeof(hpcjoin::data::CompressedTuple);
+	uint32_t sizeInBytes = sizeInTuples*sizeof(TUPLE);
+	uint64_t targetOffset = (writeOffsets[targetNode]+writeCounters[targetNode]) * sizeof(TUPLE);
 
 	//JOIN_DEBUG("Window", "Writing %d bytes (%d tuples) to process %d to offset %lu (%lu + %lu)", sizeInBytes, sizeInTuples, targetNode, targetOffset, writeOffsets[targetNode], writeCounters[targetNode]);
 
@@ -77,12 +81,13 @@ void Window::write(uint32_t targetNode, CompressedTuple* tuples, uint32_t sizeIn
 	JOIN_DEBUG("Window", "Write completed");
 }
 
-bool Window::getNextRun(CompressedTuple** tuples, uint64_t* sizeInTuples) {
+template<typename TUPLE>
+bool Window<TUPLE>::getNextRun(TUPLE** tuples, uint64_t* sizeInTuples) {
 
 	bool validElement = (this->currentRunNode < this->numberOfNodes);
 	if(validElement) {
 		uint32_t elementsInRun  = MIN(this->currentRunRemainingElements, hpcjoin::core::Configuration::SORT_RUN_ELEMENT_COUNT);
-		hpcjoin::data::CompressedTuple *runStart = this->currentRunData;
+		TUPLE *runStart = this->currentRunData;
 
 		this->currentRunData += elementsInRun;
 		this->currentRunRemainingElements -= elementsInRun;
@@ -106,7 +111,8 @@ bool Window::getNextRun(CompressedTuple** tuples, uint64_t* sizeInTuples) {
 	}
 }
 
-void Window::start() {
+template<typename TUPLE>
+void Window<TUPLE>::start() {
 
 	JOIN_DEBUG("Window", "Starting window");
 #ifdef USE_FOMPI
@@ -117,7 +123,8 @@ void Window::start() {
 
 }
 
-void Window::stop() {
+template<typename TUPLE>
+void Window<TUPLE>::stop() {
 
 	JOIN_DEBUG("Window", "Stopping window");
 #ifdef USE_FOMPI
@@ -131,10 +138,14 @@ void Window::stop() {
 	}
 }
 
-hpcjoin::data::CompressedTuple* Window::getData() {
+template<typename TUPLE>
+TUPLE* Window<TUPLE>::getData() {
 	return this->data;
 }
 
+template class Window<hpcjoin::data::CompressedTuple>;
+template class Window<hpcjoin::data::WideCompressedTuple>;
+template class Window<hpcjoin::data::NarrowCompressedTuple>;
 
 } /* namespace data */
 } /* namespace hpcjoin */
@@ -22,6 +22,7 @@
 namespace hpcjoin {
 namespace data {
 
+template<typename TUPLE>
 class Window {
 
 public:
@@ -34,10 +35,10 @@ public:
 	void start();
 	void stop();
 
-	void write(uint32_t targetNode, CompressedTuple *tuples, uint32_t sizeInTuples);
-	bool getNextRun(CompressedTuple **tuples, uint64_t *sizeInTuples);
+	void write(uint32_t targetNode, TUPLE *tuples, uint32_t sizeInTuples);
+	bool getNextRun(TUPLE **tuples, uint64_t *sizeInTuples);
 
-	hpcjoin::data::CompressedTuple * getData();
+	TUPLE * getData();
 
 protected:
 
@@ -47,11 +48,11 @@ protected:
 	uint64_t *writeOffsets;
 	uint64_t *writeCounters;
 
-	hpcjoin::data::CompressedTuple *data;
+	TUPLE *data;
 
 protected:
 
-	hpcjoin::data::CompressedTuple *currentRunData;
+	TUPLE *currentRunData;
 	uint32_t currentRunNode;
 	uint64_t currentRunRemainingElements;
 
@@ -15,18 +15,139 @@
 #include <stdlib.h>
 #include <unistd.h>
 #include <string.h>
+#include <math.h>
+#include <algorithm>
 
 #include <hpcjoin/data/Relation.h>
+#include <hpcjoin/data/Generator.h>
 #include <hpcjoin/core/Configuration.h>
 #include <hpcjoin/operators/SortMergeJoin.h>
+#include <hpcjoin/data/AggregationTable.h>
 #include <hpcjoin/performance/Measurements.h>
 #include <hpcjoin/utils/Debug.h>
 #include <hpcjoin/utils/Thread.h>
+#include <hpcjoin/utils/Arguments.h>
 
 int main(int argc, char *argv[]) {
 
 	JOIN_MEM_DEBUG("Main Start");
 
+	JOIN_DEBUG("Main", "Parsing arguments");
+
+	char *innerFileName = NULL;
+	char *outerFileName = NULL;
+
+	bool useGenerator = false;
+	uint64_t seed = 1234;
+	uint32_t duplicates = 1;
+	double zipfExponent = 0;
+	double matchRate = 1.0;
+	tuple_order_t order = ORDER_RANDOM;
+
+	uint64_t innerRelationSize = 0;
+	uint64_t outerRelationSize = 0;
+	char *experimentTag = (char *) "experiment";
+	uint32_t warmupIterations = 0;
+	uint32_t measuredIterations = 1;
+
+	bool automaticTupleFormat = true;
+
+	// Options from configuration files are parsed first
+	int numberOfArguments = 0;
+	char **arguments = NULL;
+	hpcjoin::utils::Arguments::expand(argc, argv, &numberOfArguments, &arguments);
+
+	int option = -1;
+	while ((option = getopt(numberOfArguments, arguments, "mG:i:o:s:z:k:u:c:I:O:e:W:N:C:T:")) != -1) {
+		switch (option) {
+			case 'm':
+				hpcjoin::core::Configuration::MATERIALIZE_RESULTS = true;
+				break;
+			case 'G':
+				hpcjoin::core::Configuration::AGGREGATION_GROUPS = atoi(optarg);
+				break;
+			case 'i':
+				innerFileName = optarg;
+				break;
+			case 'o':
+				outerFileName = optarg;
+				break;
+			case 's':
+				seed = strtoull(optarg, NULL, 10);
+				useGenerator = true;
+				break;
+			case 'z':
+				zipfExponent = atof(optarg);
+				useGenerator = true;
+				break;
+			case 'k':
+				matchRate = atof(optarg);
+				useGenerator = true;
+				break;
+			case 'u':
+				duplicates = atoi(optarg);
+				useGenerator = true;
+				break;
+			case 'c':
+				if (strcmp(optarg, "random") == 0) {
+					order = ORDER_RANDOM;
+				} else if (strcmp(optarg, "sorted") == 0) {
+					order = ORDER_SORTED;
+				} else if (strcmp(optarg, "clustered") == 0) {
+					order = ORDER_CLUSTERED;
+				} else {
+					fprintf(stderr, "Unknown tuple order %s\n", optarg);
+					exit(-1);
+				}
+				useGenerator = true;
+				break;
+			case 'I':
+				innerRelationSize = strtoull(optarg, NULL, 10);
+				break;
+			case 'O':
+				outerRelationSize = strtoull(optarg, NULL, 10);
+				break;
+			case 'e':
+				experimentTag = optarg;
+				break;
+			case 'W':
+				warmupIterations = atoi(optarg);
+				break;
+			case 'N':
+				measuredIterations = atoi(optarg);
+				break;
+			case 'C':
+				// Configuration files have already been expanded
+				break;
+			case 'T':
+				automaticTupleFormat = (strcmp(optarg, "auto") == 0);
+				if (strcmp(optarg, "compressed") == 0) {
+					hpcjoin::core::Configuration::TUPLE_FORMAT = TUPLE_FORMAT_COMPRESSED;
+				} else if (strcmp(optarg, "wide") == 0) {
+					hpcjoin::core::Configuration::TUPLE_FORMAT = TUPLE_FORMAT_WIDE;
+				} else if (strcmp(optarg, "narrow") == 0) {
+					hpcjoin::core::Configuration::TUPLE_FORMAT = TUPLE_FORMAT_NARROW;
+				} else if (!automaticTupleFormat) {
+					fprintf(stderr, "Unknown tuple format %s\n", optarg);
+					exit(-1);
+				}
+				break;
+			default:
+				fprintf(stderr, "Usage: %s [-m] [-G <groups>] [-i <inner relation file>] [-o <outer relation file>] [-s <seed>] [-z <zipf exponent>] [-k <match rate>] [-u <duplicates>] [-c <random|sorted|clustered>] [-I <inner tuples>] [-O <outer tuples>] [-e <experiment tag>] [-W <warm-up iterations>] [-N <measured iterations>] [-C <configuration file>] [-T <auto|narrow|compressed|wide>]\n", argv[0]);
+				exit(-1);
+		}
+	}
+
+	if (zipfExponent < 0 || matchRate < 0 || matchRate > 1 || duplicates < 1) {
+		fprintf(stderr, "Invalid workload: the Zipf exponent needs to be positive, the match rate between 0 and 1 and keys need to appear at least once\n");
+		exit(-1);
+	}
+
+	if (measuredIterations < 1) {
+		fprintf(stderr, "At least one measured iteration is required\n");
+		exit(-1);
+	}
+
 	JOIN_DEBUG("Main", "Initializing MPI");
 
 	MPI_Init(NULL, NULL);
@@ -45,11 +166,15 @@ int main(int argc, char *argv[]) {
 
 	JOIN_DEBUG("Main", "There are %d nodes in total", numberOfNodes);
 	JOIN_DEBUG("Main", "Node %d is preparing performance counters", nodeId);
-	hpcjoin::performance::Measurements::init(nodeId, numberOfNodes, "experiment");
+	hpcjoin::performance::Measurements::init(nodeId, numberOfNodes, experimentTag);
 
 	hpcjoin::performance::Measurements::writeMetaData("NUMNODES", numberOfNodes);
 	hpcjoin::performance::Measurements::writeMetaData("NODEID", nodeId);
+	hpcjoin::performance::Measurements::writeMetaData("WARMUP", warmupIterations);
+	hpcjoin::performance::Measurements::writeMetaData("ITERATIONS", measuredIterations);
 	hpcjoin::performance::Measurements::writeMetaData("RUNSZ", hpcjoin::core::Configuration::SORT_RUN_ELEMENT_COUNT);
+	hpcjoin::performance::Measurements::writeMetaData("MATERIALIZE", (uint64_t) hpcjoin::core::Configuration::MATERIALIZE_RESULTS);
+	hpcjoin::performance::Measurements::writeMetaData("GROUPS", hpcjoin::core::Configuration::AGGREGATION_GROUPS);
 
 	char hostname[1024];
 	memset(hostname, 0, 1024);
@@ -61,12 +186,36 @@ int main(int argc, char *argv[]) {
 	JOIN_ASSERT(nodeId >= 0, "Main", "Node id not set");
 	JOIN_ASSERT(nodeId < numberOfNodes, "Main", "Node id is not in range");
 
+	// The partitioning masks the key bits, each process owns one value of the lowest log2(nodes) bits
+	if ((numberOfNodes & (numberOfNodes - 1)) != 0) {
+		if (nodeId == 0) {
+			fprintf(stderr, "The number of processes needs to be a power of two\n");
+		}
+		MPI_Finalize();
+		exit(-1);
+	}
+
 	JOIN_DEBUG("Main", "Node %d is loading relations", nodeId);
 
 	JOIN_MEM_DEBUG("Init Completed");
 
-	uint64_t globalInnerRelationSize = ((uint64_t) numberOfNodes) * 200000;
-	uint64_t globalOuterRelationSize = ((uint64_t) numberOfNodes) * 200000;
+	uint64_t globalInnerRelationSize = (innerRelationSize != 0) ? innerRelationSize : ((uint64_t) numberOfNodes) * 200000;
+	uint64_t globalOuterRelationSize = (outerRelationSize != 0) ? outerRelationSize : ((uint64_t) numberOfNodes) * 200000;
+
+	// Relations loaded from files determine the sizes
+	if (innerFileName != NULL) {
+		globalInnerRelationSize = hpcjoin::data::Relation::readNumberOfTuples(innerFileName);
+	}
+	if (outerFileName != NULL) {
+		globalOuterRelationSize = hpcjoin::data::Relation::readNumberOfTuples(outerFileName);
+	}
+	if (globalInnerRelationSize == RELATION_FILE_INVALID_SIZE || globalOuterRelationSize == RELATION_FILE_INVALID_SIZE) {
+		if (nodeId == 0) {
+			fprintf(stderr, "Could not read relation file header\n");
+		}
+		MPI_Finalize();
+		exit(-1);
+	}
 
 	uint64_t localInnerRelationSize =
 			(nodeId < numberOfNodes - 1) ? (globalInnerRelationSize / numberOfNodes) : (globalInnerRelationSize - (numberOfNodes - 1) * (globalInnerRelationSize / numberOfNodes));
@@ -74,48 +223,149 @@ int main(int argc, char *argv[]) {
 	uint64_t localOuterRelationSize =
 			(nodeId < numberOfNodes - 1) ? (globalOuterRelationSize / numberOfNodes) : (globalOuterRelationSize - (numberOfNodes - 1) * (globalOuterRelationSize / numberOfNodes));
 
-	hpcjoin::data::Relation *innerRelation = new hpcjoin::data::Relation(localInnerRelationSize, globalInnerRelationSize);
-	hpcjoin::data::Relation *outerRelation = new hpcjoin::data::Relation(localOuterRelationSize, globalOuterRelationSize);
-
 	hpcjoin::performance::Measurements::writeMetaData("GISZ", globalInnerRelationSize);
 	hpcjoin::performance::Measurements::writeMetaData("GOSZ", globalOuterRelationSize);
 	hpcjoin::performance::Measurements::writeMetaData("LISZ", localInnerRelationSize);
 	hpcjoin::performance::Measurements::writeMetaData("LOSZ", localOuterRelationSize);
 
-	JOIN_MEM_DEBUG("Relations created");
-
-	srand(time(NULL)+nodeId);
-	innerRelation->fillUniqueValues(nodeId * (globalInnerRelationSize / numberOfNodes), nodeId * (globalInnerRelationSize / numberOfNodes));
-	outerRelation->fillUniqueValues((numberOfNodes - nodeId - 1) * (globalOuterRelationSize / numberOfNodes), nodeId * (globalOuterRelationSize / numberOfNodes));
-
-	if (numberOfNodes > 1) {
-		innerRelation->distribute(nodeId, numberOfNodes);
-		outerRelation->distribute(nodeId, numberOfNodes);
+	// The generator writes every stripe in place, there is no need to redistribute the data
+	hpcjoin::data::Generator *generator = NULL;
+	if (useGenerator) {
+		generator = new hpcjoin::data::Generator(seed, 1);
+		char workload[64];
+		snprintf(workload, 64, "%.3f", zipfExponent);
+		hpcjoin::performance::Measurements::writeMetaData("ZIPF", workload);
+		snprintf(workload, 64, "%.3f", matchRate);
+		hpcjoin::performance::Measurements::writeMetaData("MATCHRATE", workload);
+		hpcjoin::performance::Measurements::writeMetaData("SEED", seed);
+		hpcjoin::performance::Measurements::writeMetaData("DUPLICATES", duplicates);
+		hpcjoin::performance::Measurements::writeMetaData("ORDER", (char *) ((order == ORDER_SORTED) ? "sorted" : ((order == ORDER_CLUSTERED) ? "clustered" : "random")));
 	}
+	uint64_t numberOfDistinctKeys = (globalInnerRelationSize + duplicates - 1) / duplicates;
+
+	// Warm-up iterations are not reported, the files contain the details of the last iteration
+	for (uint32_t iteration = 0; iteration < warmupIterations + measuredIterations; ++iteration) {
+
+		JOIN_DEBUG("Main", "Node %d is starting iteration %d", nodeId, iteration);
+
+		hpcjoin::performance::Measurements::reset();
+
+		hpcjoin::data::Relation *innerRelation = new hpcjoin::data::Relation(localInnerRelationSize, globalInnerRelationSize);
+		hpcjoin::data::Relation *outerRelation = new hpcjoin::data::Relation(localOuterRelationSize, globalOuterRelationSize);
+
+		JOIN_MEM_DEBUG("Relations created");
+
+		// Default data is shuffled between the processes, data loaded from a file is read in stripes
+		srand(time(NULL)+nodeId);
+		bool relationsLoaded = true;
+		if (innerFileName != NULL) {
+			relationsLoaded = innerRelation->loadFromFile(innerFileName, nodeId, numberOfNodes) && relationsLoaded;
+		} else if (generator != NULL) {
+			generator->generatePrimaryKeys(innerRelation, nodeId, numberOfNodes, duplicates);
+			generator->reorder(innerRelation, order);
+		} else {
+			innerRelation->fillUniqueValues(nodeId * (globalInnerRelationSize / numberOfNodes), nodeId * (globalInnerRelationSize / numberOfNodes));
+			if (numberOfNodes > 1) {
+				innerRelation->distribute(nodeId, numberOfNodes);
+			}
+		}
+		if (outerFileName != NULL) {
+			relationsLoaded = outerRelation->loadFromFile(outerFileName, nodeId, numberOfNodes) && relationsLoaded;
+		} else if (generator != NULL) {
+			if (zipfExponent > 0) {
+				generator->generateZipfKeys(outerRelation, nodeId, numberOfNodes, numberOfDistinctKeys, zipfExponent, matchRate);
+			} else {
+				generator->generateForeignKeys(outerRelation, nodeId, numberOfNodes, numberOfDistinctKeys, matchRate);
+			}
+			generator->reorder(outerRelation, order);
+		} else {
+			outerRelation->fillUniqueValues((numberOfNodes - nodeId - 1) * (globalOuterRelationSize / numberOfNodes), nodeId * (globalOuterRelationSize / numberOfNodes));
+			if (numberOfNodes > 1) {
+				outerRelation->distribute(nodeId, numberOfNodes);
+			}
+		}
+
+		if (!relationsLoaded) {
+			if (nodeId == 0) {
+				fprintf(stderr, "Could not read relation file\n");
+			}
+			MPI_Finalize();
+			exit(-1);
+		}
+
+		JOIN_MEM_DEBUG("Relations distributed");
+
+		// The tuple format depends on the largest keys and rids of all processes
+		if (automaticTupleFormat || hpcjoin::core::Configuration::TUPLE_FORMAT != TUPLE_FORMAT_WIDE) {
+			tuple_format_t requestedTupleFormat = hpcjoin::core::Configuration::TUPLE_FORMAT;
+			uint64_t maximumValues[4];
+			innerRelation->computeMaximumValues(&(maximumValues[0]), &(maximumValues[1]));
+			outerRelation->computeMaximumValues(&(maximumValues[2]), &(maximumValues[3]));
+			MPI_Allreduce(MPI_IN_PLACE, maximumValues, 4, MPI_UINT64_T, MPI_MAX, MPI_COMM_WORLD);
+			hpcjoin::core::Configuration::selectTupleFormat(std::max(maximumValues[0], maximumValues[2]), std::max(maximumValues[1], maximumValues[3]), (uint32_t) log2(numberOfNodes), automaticTupleFormat);
+			if (!automaticTupleFormat && hpcjoin::core::Configuration::TUPLE_FORMAT != requestedTupleFormat && nodeId == 0) {
+				fprintf(stderr, "Requested tuple format cannot hold key %lu and rid %lu, using %s tuples\n", std::max(maximumValues[0], maximumValues[2]), std::max(maximumValues[1], maximumValues[3]),
+						(hpcjoin::core::Configuration::TUPLE_FORMAT == TUPLE_FORMAT_WIDE) ? "wide" : "compressed");
+			}
+		}
+
+		JOIN_DEBUG("Main", "Node %d is preparing join", nodeId);
+
+		hpcjoin::operators::SortMergeJoin *sortMergeJoin = new hpcjoin::operators::SortMergeJoin(numberOfNodes, nodeId, innerRelation, outerRelation);
+
+		MPI_Barrier(MPI_COMM_WORLD);
+
+		JOIN_DEBUG("Main", "Node %d is starting join", nodeId);
+
+		sortMergeJoin->join();
+
+		JOIN_DEBUG("Main", "Node %d finished join", nodeId);
+
+		if (hpcjoin::core::Configuration::MATERIALIZE_RESULTS) {
+			uint64_t numberOfResults = 0;
+			for (hpcjoin::data::JoinResult::Iterator it(sortMergeJoin->getResult()); it.hasNext(); it.next()) {
+				++numberOfResults;
+			}
+			JOIN_DEBUG("Main", "Node %d materialized %lu results", nodeId, numberOfResults);
+		}
+
+		MPI_Barrier(MPI_COMM_WORLD);
+
+		if (iteration >= warmupIterations) {
+			if (nodeId != hpcjoin::core::Configuration::RESULT_AGGREGATION_NODE) {
+				hpcjoin::performance::Measurements::sendMeasurementsToAggregator();
+			} else {
+				hpcjoin::performance::Measurements::printMeasurements(numberOfNodes, nodeId);
+				if (hpcjoin::core::Configuration::AGGREGATION_GROUPS > 0) {
+					// Groups which received at least one match, total count and total sum
+					hpcjoin::data::AggregationTable *aggregation = sortMergeJoin->getAggregation();
+					uint32_t numberOfGroups = 0;
+					uint64_t totalCount = 0;
+					uint64_t totalSum = 0;
+					for (uint32_t g = 0; g < aggregation->getNumberOfGroups(); ++g) {
+						numberOfGroups += (aggregation->getAggregate(g)->count > 0) ? 1 : 0;
+						totalCount += aggregation->getAggregate(g)->count;
+						totalSum += aggregation->getAggregate(g)->sum;
+					}
+					printf("[RESULTS] Aggregation:\t%u\t%lu\t%lu\n", numberOfGroups, totalCount, totalSum);
+				}
+			}
+		}
+
+		delete sortMergeJoin;
+		delete innerRelation;
+		delete outerRelation;
 
-	JOIN_MEM_DEBUG("Relations distributed");
-
-	JOIN_DEBUG("Main", "Node %d is preparing join", nodeId);
-
-	hpcjoin::operators::SortMergeJoin *sortMergeJoin = new hpcjoin::operators::SortMergeJoin(numberOfNodes, nodeId, innerRelation, outerRelation);
-
-	MPI_Barrier(MPI_COMM_WORLD);
-
-	JOIN_DEBUG("Main", "Node %d is starting join", nodeId);
-
-	sortMergeJoin->join();
-
-	JOIN_DEBUG("Main", "Node %d finished join", nodeId);
+	}
+	delete generator;
 
-	MPI_Barrier(MPI_COMM_WORLD);
+	if (nodeId == hpcjoin::core::Configuration::RESULT_AGGREGATION_NODE) {
+		hpcjoin::performance::Measurements::printStatistics();
+	}
 
 	JOIN_DEBUG("Main", "Node %d finalizing measurements", nodeId);
 
-	if (nodeId != hpcjoin::core::Configuration::RESULT_AGGREGATION_NODE) {
-		hpcjoin::performance::Measurements::sendMeasurementsToAggregator();
-	} else {
-		hpcjoin::performance::Measurements::printMeasurements(numberOfNodes, nodeId);
-	}
+	hpcjoin::performance::Measurements::writeMetaData("TUPLES", (char *) ((hpcjoin::core::Configuration::TUPLE_FORMAT == TUPLE_FORMAT_WIDE) ? "wide" : ((hpcjoin::core::Configuration::TUPLE_FORMAT == TUPLE_FORMAT_NARROW) ? "narrow" : "compressed")));
 	hpcjoin::performance::Measurements::storeAllMeasurements();
 
 #ifdef USE_FOMPI
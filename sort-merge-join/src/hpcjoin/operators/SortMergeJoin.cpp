@@ -10,7 +10,12 @@
 #include <mpi.h>
 #include <stdlib.h>
 #include <string.h>
+#include <queue>
+#include <vector>
 
+#include <hpcjoin/data/CompressedTuple.h>
+#include <hpcjoin/data/WideCompressedTuple.h>
+#include <hpcjoin/data/NarrowCompressedTuple.h>
 #include <hpcjoin/tasks/PartitionTask.h>
 #include <hpcjoin/tasks/SortTask.h>
 #include <hpcjoin/tasks/MergeLevelTask.h>
@@ -27,11 +32,6 @@ namespace hpcjoin {
 namespace operators {
 
 uint64_t SortMergeJoin::RESULT_COUNTER;
-std::queue<hpcjoin::tasks::SortTask *> SortMergeJoin::SORT_TASK_QUEUE;
-std::vector<hpcjoin::data::CompressedTuple*> SortMergeJoin::INNER_SORTED_RUN_QUEUE;
-std::vector<hpcjoin::data::CompressedTuple*> SortMergeJoin::OUTER_SORTED_RUN_QUEUE;
-std::vector<uint64_t> SortMergeJoin::INNER_SORTED_RUN_SIZE_QUEUE;
-std::vector<uint64_t> SortMergeJoin::OUTER_SORTED_RUN_SIZE_QUEUE;
 
 SortMergeJoin::SortMergeJoin(uint32_t numberOfNodes, uint32_t nodeId, hpcjoin::data::Relation* innerRelation, hpcjoin::data::Relation* outerRelation) {
 
@@ -39,14 +39,33 @@ SortMergeJoin::SortMergeJoin(uint32_t numberOfNodes, uint32_t nodeId, hpcjoin::d
 	this->numberOfNodes = numberOfNodes;
 	this->innerRelation = innerRelation;
 	this->outerRelation = outerRelation;
+	this->result = NULL;
+	this->aggregation = NULL;
 
 }
 
 SortMergeJoin::~SortMergeJoin() {
+
+	delete this->result;
+	delete this->aggregation;
+
 }
 
 void SortMergeJoin::join() {
 
+	if (hpcjoin::core::Configuration::TUPLE_FORMAT == TUPLE_FORMAT_WIDE) {
+		joinRelations<hpcjoin::data::WideCompressedTuple>();
+	} else if (hpcjoin::core::Configuration::TUPLE_FORMAT == TUPLE_FORMAT_NARROW) {
+		joinRelations<hpcjoin::data::NarrowCompressedTuple>();
+	} else {
+		joinRelations<hpcjoin::data::CompressedTuple>();
+	}
+
+}
+
+template<typename TUPLE>
+void SortMergeJoin::joinRelations() {
+
 	/**********************************************************************/
 
 	MPI_Barrier(MPI_COMM_WORLD);
@@ -59,7 +78,7 @@ void SortMergeJoin::join() {
 	 */
 
 	hpcjoin::performance::Measurements::startPartitioning();
-	hpcjoin::tasks::PartitionTask *partitionTask = new hpcjoin::tasks::PartitionTask(this->innerRelation, this->outerRelation, this->numberOfNodes);
+	hpcjoin::tasks::PartitionTask<TUPLE> *partitionTask = new hpcjoin::tasks::PartitionTask<TUPLE>(this->innerRelation, this->outerRelation, this->numberOfNodes);
 	partitionTask->execute();
 	hpcjoin::performance::Measurements::stopPartitioning();
 
@@ -70,9 +89,12 @@ void SortMergeJoin::join() {
 	 */
 
 	hpcjoin::performance::Measurements::startWindowAllocation();
-	hpcjoin::data::Window *innerWindow = new hpcjoin::data::Window(this->numberOfNodes, partitionTask->innerWindowSize, partitionTask->innerIncomingData,
+	// The relation buffers hold the received data and the merge levels, skewed inputs and wide tuples need more space
+	innerRelation->reserveHalves(partitionTask->innerWindowSize * sizeof(TUPLE));
+	outerRelation->reserveHalves(partitionTask->outerWindowSize * sizeof(TUPLE));
+	hpcjoin::data::Window<TUPLE> *innerWindow = new hpcjoin::data::Window<TUPLE>(this->numberOfNodes, partitionTask->innerWindowSize, partitionTask->innerIncomingData,
 			partitionTask->innerWriteOffsets, innerRelation);
-	hpcjoin::data::Window *outerWindow = new hpcjoin::data::Window(this->numberOfNodes, partitionTask->outerWindowSize, partitionTask->outerIncomingData,
+	hpcjoin::data::Window<TUPLE> *outerWindow = new hpcjoin::data::Window<TUPLE>(this->numberOfNodes, partitionTask->outerWindowSize, partitionTask->outerIncomingData,
 			partitionTask->outerWriteOffsets, outerRelation);
 	hpcjoin::performance::Measurements::stopWindowAllocation();
 
@@ -83,31 +105,32 @@ void SortMergeJoin::join() {
 	 */
 
 	// Create sort tasks
+	std::queue<hpcjoin::tasks::SortTask<TUPLE> *> sortTaskQueue;
 	hpcjoin::performance::Measurements::startRunPreparations();
 	for (uint32_t p = 0; p < numberOfNodes; ++p) {
 		uint32_t partitionId = (nodeId + p) % numberOfNodes;
 
 		uint64_t innerPartitionSize = partitionTask->innerHistogram[partitionId];
-		hpcjoin::data::CompressedTuple *innerPartitionStart = partitionTask->innerPartitionOutput + partitionTask->innerLocalWriteOffsets[partitionId];
+		TUPLE *innerPartitionStart = partitionTask->innerPartitionOutput + partitionTask->innerLocalWriteOffsets[partitionId];
 
 		uint64_t outerPartitionSize = partitionTask->outerHistogram[partitionId];
-		hpcjoin::data::CompressedTuple *outerPartitionStart = partitionTask->outerPartitionOutput + partitionTask->outerLocalWriteOffsets[partitionId];
+		TUPLE *outerPartitionStart = partitionTask->outerPartitionOutput + partitionTask->outerLocalWriteOffsets[partitionId];
 
 		uint64_t innerProcessCounter = 0;
 		while (innerProcessCounter < innerPartitionSize) {
 			uint64_t runSize = MIN(innerPartitionSize - innerProcessCounter, hpcjoin::core::Configuration::SORT_RUN_ELEMENT_COUNT);
-			hpcjoin::data::CompressedTuple *runStart = innerPartitionStart + innerProcessCounter;
-			hpcjoin::tasks::SortTask *sortTask = new hpcjoin::tasks::SortTask(runStart, runSize, innerWindow, partitionId);
-			SORT_TASK_QUEUE.push(sortTask);
+			TUPLE *runStart = innerPartitionStart + innerProcessCounter;
+			hpcjoin::tasks::SortTask<TUPLE> *sortTask = new hpcjoin::tasks::SortTask<TUPLE>(runStart, runSize, innerWindow, partitionId);
+			sortTaskQueue.push(sortTask);
 			innerProcessCounter += runSize;
 		}
 
 		uint64_t outerProcessCounter = 0;
 		while (outerProcessCounter < outerPartitionSize) {
 			uint64_t runSize = MIN(outerPartitionSize - outerProcessCounter, hpcjoin::core::Configuration::SORT_RUN_ELEMENT_COUNT);
-			hpcjoin::data::CompressedTuple *runStart = outerPartitionStart + outerProcessCounter;
-			hpcjoin::tasks::SortTask *sortTask = new hpcjoin::tasks::SortTask(runStart, runSize, outerWindow, partitionId);
-			SORT_TASK_QUEUE.push(sortTask);
+			TUPLE *runStart = outerPartitionStart + outerProcessCounter;
+			hpcjoin::tasks::SortTask<TUPLE> *sortTask = new hpcjoin::tasks::SortTask<TUPLE>(runStart, runSize, outerWindow, partitionId);
+			sortTaskQueue.push(sortTask);
 			outerProcessCounter += runSize;
 		}
 
@@ -118,9 +141,9 @@ void SortMergeJoin::join() {
 	innerWindow->start();
 	outerWindow->start();
 	// Execute sort tasks
-	while (!SORT_TASK_QUEUE.empty()) {
-		hpcjoin::tasks::SortTask *sortTask = SORT_TASK_QUEUE.front();
-		SORT_TASK_QUEUE.pop();
+	while (!sortTaskQueue.empty()) {
+		hpcjoin::tasks::SortTask<TUPLE> *sortTask = sortTaskQueue.front();
+		sortTaskQueue.pop();
 		sortTask->execute();
 		delete sortTask;
 	}
@@ -144,38 +167,42 @@ void SortMergeJoin::join() {
 	 * Merge data
 	 */
 
-	hpcjoin::data::CompressedTuple *innerRun = NULL;
+	std::vector<TUPLE *> innerSortedRuns;
+	std::vector<uint64_t> innerSortedRunSizes;
+	TUPLE *innerRun = NULL;
 	uint64_t innerElementsInRun = 0;
 	uint64_t totalInnerReceiveElements = 0;
 
 	hpcjoin::performance::Measurements::startMerging();
 
 	while (innerWindow->getNextRun(&innerRun, &innerElementsInRun)) {
-		INNER_SORTED_RUN_QUEUE.push_back(innerRun);
-		INNER_SORTED_RUN_SIZE_QUEUE.push_back(innerElementsInRun);
+		innerSortedRuns.push_back(innerRun);
+		innerSortedRunSizes.push_back(innerElementsInRun);
 		totalInnerReceiveElements += innerElementsInRun;
 	}
 
 
 
-	hpcjoin::data::CompressedTuple *outerRun = NULL;
+	std::vector<TUPLE *> outerSortedRuns;
+	std::vector<uint64_t> outerSortedRunSizes;
+	TUPLE *outerRun = NULL;
 	uint64_t outerElementsInRun = 0;
 	uint64_t totalOuterReceiveElements = 0;
 
 	while (outerWindow->getNextRun(&outerRun, &outerElementsInRun)) {
-		OUTER_SORTED_RUN_QUEUE.push_back(outerRun);
-		OUTER_SORTED_RUN_SIZE_QUEUE.push_back(outerElementsInRun);
+		outerSortedRuns.push_back(outerRun);
+		outerSortedRunSizes.push_back(outerElementsInRun);
 		totalOuterReceiveElements += outerElementsInRun;
 	}
 
-	uint32_t numberOfInnerRuns = INNER_SORTED_RUN_QUEUE.size();
-	uint32_t numberOfOuterRuns = OUTER_SORTED_RUN_QUEUE.size();
+	uint32_t numberOfInnerRuns = innerSortedRuns.size();
+	uint32_t numberOfOuterRuns = outerSortedRuns.size();
 
-	hpcjoin::data::CompressedTuple **inputRuns = &(INNER_SORTED_RUN_QUEUE[0]);
-	uint64_t *inputRunSizes = &(INNER_SORTED_RUN_SIZE_QUEUE[0]);
+	TUPLE **inputRuns = &(innerSortedRuns[0]);
+	uint64_t *inputRunSizes = &(innerSortedRunSizes[0]);
 
-	hpcjoin::data::CompressedTuple *input = innerRelation->getFirstHalfData();
-	hpcjoin::data::CompressedTuple *output = innerRelation->getSecondHalfData();
+	TUPLE *input = (TUPLE *) innerRelation->getFirstHalfData();
+	TUPLE *output = (TUPLE *) innerRelation->getSecondHalfData();
 
 	JOIN_ASSERT(((uint64_t) input ) % 64 == 0, "SortMerge", "Inner input not aligned");
 	JOIN_ASSERT(((uint64_t) output ) % 64 == 0, "SortMerge", "Inner output not aligned");
@@ -183,7 +210,7 @@ void SortMergeJoin::join() {
 	while (numberOfInnerRuns > 1) {
 
 		// Create task and execute merge
-		hpcjoin::tasks::MergeLevelTask *mergingTask = new hpcjoin::tasks::MergeLevelTask(numberOfInnerRuns, inputRuns, inputRunSizes, output);
+		hpcjoin::tasks::MergeLevelTask<TUPLE> *mergingTask = new hpcjoin::tasks::MergeLevelTask<TUPLE>(numberOfInnerRuns, inputRuns, inputRunSizes, output);
 		mergingTask->execute();
 
 		// Set up next iteration
@@ -193,18 +220,18 @@ void SortMergeJoin::join() {
 		delete mergingTask;
 
 		// Swap input and output buffer
-		hpcjoin::data::CompressedTuple *tmp = output;
+		TUPLE *tmp = output;
 		output = input;
 		input = tmp;
 
 	}
-	hpcjoin::data::CompressedTuple *innerSortedRelation = input;
+	TUPLE *innerSortedRelation = input;
 
-	inputRuns = &(OUTER_SORTED_RUN_QUEUE[0]);
-	inputRunSizes = &(OUTER_SORTED_RUN_SIZE_QUEUE[0]);
+	inputRuns = &(outerSortedRuns[0]);
+	inputRunSizes = &(outerSortedRunSizes[0]);
 
-	input = outerRelation->getFirstHalfData();
-	output = outerRelation->getSecondHalfData();
+	input = (TUPLE *) outerRelation->getFirstHalfData();
+	output = (TUPLE *) outerRelation->getSecondHalfData();
 
 	JOIN_ASSERT(((uint64_t) input ) % 64 == 0, "SortMerge", "Outer input not aligned");
 	JOIN_ASSERT(((uint64_t) output ) % 64 == 0, "SortMerge", "Outer output not aligned");
@@ -212,7 +239,7 @@ void SortMergeJoin::join() {
 	while (numberOfOuterRuns > 1) {
 
 		// Create task and execute merge
-		hpcjoin::tasks::MergeLevelTask *mergingTask = new hpcjoin::tasks::MergeLevelTask(numberOfOuterRuns, inputRuns, inputRunSizes, output);
+		hpcjoin::tasks::MergeLevelTask<TUPLE> *mergingTask = new hpcjoin::tasks::MergeLevelTask<TUPLE>(numberOfOuterRuns, inputRuns, inputRunSizes, output);
 		mergingTask->execute();
 
 		// Set up next iteration
@@ -222,12 +249,12 @@ void SortMergeJoin::join() {
 		delete mergingTask;
 
 		// Swap input and output buffer
-		hpcjoin::data::CompressedTuple *tmp = output;
+		TUPLE *tmp = output;
 		output = input;
 		input = tmp;
 
 	}
-	hpcjoin::data::CompressedTuple *outerSortedRelation = input;
+	TUPLE *outerSortedRelation = input;
 
 	hpcjoin::performance::Measurements::stopMerging();
 
@@ -239,12 +266,27 @@ void SortMergeJoin::join() {
 
 	hpcjoin::performance::Measurements::startMatching();
 
-	hpcjoin::tasks::MergeJoinTask *mergeJoin = new hpcjoin::tasks::MergeJoinTask(innerSortedRelation, totalInnerReceiveElements, outerSortedRelation,
-			totalOuterReceiveElements, numberOfNodes);
+	hpcjoin::data::ResultBuffer *resultBuffer = NULL;
+	if (hpcjoin::core::Configuration::MATERIALIZE_RESULTS) {
+		this->result = new hpcjoin::data::JoinResult(1);
+		resultBuffer = this->result->getBuffer(0);
+	}
+
+	if (hpcjoin::core::Configuration::AGGREGATION_GROUPS > 0) {
+		this->aggregation = new hpcjoin::data::AggregationTable(hpcjoin::core::Configuration::AGGREGATION_GROUPS);
+	}
+
+	hpcjoin::tasks::MergeJoinTask<TUPLE> *mergeJoin = new hpcjoin::tasks::MergeJoinTask<TUPLE>(innerSortedRelation, totalInnerReceiveElements, outerSortedRelation,
+			totalOuterReceiveElements, numberOfNodes, resultBuffer, this->aggregation);
 	mergeJoin->execute();
 
 	RESULT_COUNTER = mergeJoin->getNumberOfMatchingTuples();
 
+	// Combine the partial aggregates of all processes
+	if (this->aggregation != NULL) {
+		this->aggregation->reduce(hpcjoin::core::Configuration::RESULT_AGGREGATION_NODE);
+	}
+
 	hpcjoin::performance::Measurements::stopMatching();
 	hpcjoin::performance::Measurements::stopJoin();
 
@@ -254,6 +296,18 @@ void SortMergeJoin::join() {
 
 }
 
+hpcjoin::data::JoinResult* SortMergeJoin::getResult() {
+
+	return this->result;
+
+}
+
+hpcjoin::data::AggregationTable* SortMergeJoin::getAggregation() {
+
+	return this->aggregation;
+
+}
+
 } /* namespace operators */
 } /* namespace hpcjoin */
 
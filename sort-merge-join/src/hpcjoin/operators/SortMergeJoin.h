@@ -9,10 +9,10 @@
 #define HPCJOIN_OPERATORS_SORTMERGEJOIN_H_
 
 #include <stdint.h>
-#include <queue>
 
 #include <hpcjoin/data/Relation.h>
-#include <hpcjoin/tasks/SortTask.h>
+#include <hpcjoin/data/JoinResult.h>
+#include <hpcjoin/data/AggregationTable.h>
 
 namespace hpcjoin {
 namespace operators {
@@ -28,6 +28,9 @@ public:
 
 	void join();
 
+	hpcjoin::data::JoinResult *getResult();
+	hpcjoin::data::AggregationTable *getAggregation();
+
 protected:
 
 	uint32_t numberOfNodes;
@@ -36,15 +39,17 @@ protected:
 	hpcjoin::data::Relation *innerRelation;
 	hpcjoin::data::Relation *outerRelation;
 
+	hpcjoin::data::JoinResult *result;
+	hpcjoin::data::AggregationTable *aggregation;
+
+protected:
+
+	template<typename TUPLE>
+	void joinRelations();
+
 public:
 
 	static uint64_t RESULT_COUNTER;
-	static std::queue<hpcjoin::tasks::SortTask *> SORT_TASK_QUEUE;
-
-	static std::vector<hpcjoin::data::CompressedTuple*> INNER_SORTED_RUN_QUEUE;
-	static std::vector<hpcjoin::data::CompressedTuple*> OUTER_SORTED_RUN_QUEUE;
-	static std::vector<uint64_t> INNER_SORTED_RUN_SIZE_QUEUE;
-	static std::vector<uint64_t> OUTER_SORTED_RUN_SIZE_QUEUE;
 
 };
 
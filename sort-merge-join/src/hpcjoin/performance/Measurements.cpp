@@ -15,6 +15,8 @@
 #include <unistd.h>
 #include <papi.h>
 #include <sys/stat.h>
+#include <math.h>
+#include <algorithm>
 
 #include <hpcjoin/core/Configuration.h>
 #include <hpcjoin/utils/Debug.h>
@@ -390,6 +392,7 @@ void Measurements::init(uint32_t nodeId, uint32_t numberOfNodes, std::string tag
 
 	if (nodeId == hpcjoin::core::Configuration::RESULT_AGGREGATION_NODE) {
 		printf("[INFO] Experiment data located at %s\n", experimentFullPath);
+		experimentPath = experimentFullPath;
 	}
 
 }
@@ -421,6 +424,13 @@ uint64_t Measurements::timeDiff(struct timeval stop, struct timeval start) {
 /************************************************************/
 
 #define NUM_OF_RESULT_ELEMENTS 7
+#define NUM_OF_STATISTIC_ELEMENTS 6
+
+// Timings of the serialized results (starting at index 1) summarized over the measured iterations
+static const char *STATISTIC_NAMES[NUM_OF_STATISTIC_ELEMENTS] = { "Join", "Partition", "Sorting", "Waiting", "Merging", "Matching" };
+
+std::vector<uint64_t *> Measurements::iterationResults;
+std::string Measurements::experimentPath;
 
 uint64_t* Measurements::serializeResults() {
 
@@ -538,6 +548,111 @@ void Measurements::printMeasurements(uint32_t numberOfNodes, uint32_t nodeId) {
 
 	printf("[RESULTS] Summary:\t%lu\t%.3f\t%.3f\t%.3f\t%.3f\t%.3f\t%.3f\n", totalNumberOfTuples, ((double) averageJoinTime) / 1000, ((double) averagePartitionTime) / 1000, ((double) averageSortingTime) / 1000, ((double) averageWaitingTime) / 1000, ((double) averageMergingTime) / 1000, ((double) averageMatchingTime) / 1000);
 
+	recordIteration(numberOfNodes);
+
+}
+
+void Measurements::recordIteration(uint32_t numberOfNodes) {
+
+	// An iteration takes as long as its slowest process
+	uint64_t *iteration = (uint64_t *) calloc(NUM_OF_RESULT_ELEMENTS, sizeof(uint64_t));
+	for (uint32_t n = 0; n < numberOfNodes; ++n) {
+		iteration[0] += serizlizedResults[n][0];
+		for (uint32_t e = 1; e < NUM_OF_RESULT_ELEMENTS; ++e) {
+			iteration[e] = std::max(iteration[e], serizlizedResults[n][e]);
+		}
+		free(serizlizedResults[n]);
+	}
+	delete[] serizlizedResults;
+	serizlizedResults = NULL;
+
+	iterationResults.push_back(iteration);
+
+}
+
+uint64_t Measurements::computePercentile(uint64_t* sortedValues, uint64_t numberOfValues, double percentile) {
+
+	// Nearest-rank percentile
+	uint64_t rank = (uint64_t) ceil(percentile * numberOfValues);
+	return sortedValues[(rank > 0) ? rank - 1 : 0];
+
+}
+
+void Measurements::printStatistics() {
+
+	uint64_t numberOfIterations = iterationResults.size();
+	if (numberOfIterations == 0) {
+		return;
+	}
+
+	char statisticsFullPath[1024];
+	memset(statisticsFullPath, 0, 1024);
+	sprintf(statisticsFullPath, "%s/statistics.csv", experimentPath.c_str());
+	FILE *statisticsOutputFile = fopen(statisticsFullPath, "w");
+	JOIN_ASSERT(statisticsOutputFile != NULL, "Measurements", "Could not create statistics file");
+	fprintf(statisticsOutputFile, "phase,iterations,min,median,p99\n");
+
+	printf("[STATS] Iterations:\t%lu\n", numberOfIterations);
+	printf("[STATS] Tuples:\t%lu\n", iterationResults[numberOfIterations - 1][0]);
+
+	uint64_t *values = (uint64_t *) calloc(numberOfIterations, sizeof(uint64_t));
+	for (uint32_t s = 0; s < NUM_OF_STATISTIC_ELEMENTS; ++s) {
+		for (uint64_t i = 0; i < numberOfIterations; ++i) {
+			values[i] = iterationResults[i][s + 1];
+		}
+		std::sort(values, values + numberOfIterations);
+		uint64_t median = computePercentile(values, numberOfIterations, 0.5);
+		uint64_t p99 = computePercentile(values, numberOfIterations, 0.99);
+		printf("[STATS] %s:\t%.3f\t%.3f\t%.3f\n", STATISTIC_NAMES[s], ((double) values[0]) / 1000, ((double) median) / 1000, ((double) p99) / 1000);
+		fprintf(statisticsOutputFile, "%s,%lu,%lu,%lu,%lu\n", STATISTIC_NAMES[s], numberOfIterations, values[0], median, p99);
+	}
+	free(values);
+
+	fflush(statisticsOutputFile);
+	fclose(statisticsOutputFile);
+
+	for (uint64_t i = 0; i < numberOfIterations; ++i) {
+		free(iterationResults[i]);
+	}
+	iterationResults.clear();
+
+}
+
+void Measurements::reset() {
+
+	totalCycles = 0;
+	totalTime = 0;
+	partitioningTime = 0;
+	sortingTime = 0;
+	mergingTime = 0;
+	matchingTime = 0;
+
+	localHistogramIdx = 0;
+	memset(localHistogramTimes, 0, sizeof(localHistogramTimes));
+	memset(localHistogramElements, 0, sizeof(localHistogramElements));
+	windowPreparationTime = 0;
+	partitioningElementsIdx = 0;
+	memset(partitioningElementsTimes, 0, sizeof(partitioningElementsTimes));
+	memset(partitioningElementsElements, 0, sizeof(partitioningElementsElements));
+	windowAllocationTime = 0;
+
+	runPreparationsTime = 0;
+	sortTaskTimeSum = 0;
+	sortTaskCount = 0;
+	sortElementsTimeSum = 0;
+	sortElementCount = 0;
+	putTimeSum = 0;
+	putCount = 0;
+	flushTime = 0;
+	waitIncomingTime = 0;
+
+	mergingLevelTimeSum = 0;
+	mergingLevelCount = 0;
+	mergingTaskTimeSum = 0;
+	mergingTaskCount = 0;
+
+	matchingTaskTime = 0;
+
 }
 
 } /* namespace performance */
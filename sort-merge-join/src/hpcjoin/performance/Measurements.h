@@ -12,6 +12,7 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <string>
+#include <vector>
 
 namespace hpcjoin {
 namespace performance {
@@ -191,11 +192,19 @@ public:
 	static void printMeasurements(uint32_t numberOfNodes, uint32_t nodeId);
 	static void storeAllMeasurements();
 
+	static void reset();
+	static void printStatistics();
+
 protected:
 
 	static uint64_t timeDiff(struct timeval stop, struct timeval start);
 	static uint64_t **serizlizedResults;
 
+	static void recordIteration(uint32_t numberOfNodes);
+	static uint64_t computePercentile(uint64_t *sortedValues, uint64_t numberOfValues, double percentile);
+	static std::vector<uint64_t *> iterationResults;
+	static std::string experimentPath;
+
 protected:
 
 	static FILE * performanceOutputFile;
@@ -9,12 +9,15 @@
 
 #include <hpcjoin/performance/Measurements.h>
 #include <hpcjoin/core/Configuration.h>
+#include <hpcjoin/data/WideCompressedTuple.h>
+#include <hpcjoin/data/NarrowCompressedTuple.h>
 #include <math.h>
 
 namespace hpcjoin {
 namespace tasks {
 
-MergeJoinTask::MergeJoinTask(hpcjoin::data::CompressedTuple* leftRun, uint64_t leftNumberOfElements, hpcjoin::data::CompressedTuple* rightRun, uint64_t rightNumberOfElements, uint32_t numberOfNodes) {
+template<typename TUPLE>
+MergeJoinTask<TUPLE>::MergeJoinTask(TUPLE* leftRun, uint64_t leftNumberOfElements, TUPLE* rightRun, uint64_t rightNumberOfElements, uint32_t numberOfNodes, hpcjoin::data::ResultBuffer *resultBuffer, hpcjoin::data::AggregationTable *aggregationTable) {
 
 	this->numberOfNodes = numberOfNodes;
 	this->leftRun = leftRun;
@@ -22,13 +25,17 @@ MergeJoinTask::MergeJoinTask(hpcjoin::data::CompressedTuple* leftRun, uint64_t l
 	this->rightRun = rightRun;
 	this->rightNumberOfElements = rightNumberOfElements;
 	this->matchingTuplesCount = 0;
+	this->resultBuffer = resultBuffer;
+	this->aggregationTable = aggregationTable;
 
 }
 
-MergeJoinTask::~MergeJoinTask() {
+template<typename TUPLE>
+MergeJoinTask<TUPLE>::~MergeJoinTask() {
 }
 
-void MergeJoinTask::execute() {
+template<typename TUPLE>
+void MergeJoinTask<TUPLE>::execute() {
 
 	hpcjoin::performance::Measurements::startMatchingTask();
 
@@ -38,34 +45,79 @@ void MergeJoinTask::execute() {
 
 	uint64_t const numR = this->leftNumberOfElements;
 	uint64_t const numS = this->rightNumberOfElements;
-	uint32_t const shift =  hpcjoin::core::Configuration::PAYLOAD_BITS + log2(numberOfNodes); // TODO add node bits
+	uint32_t const shift = log2(numberOfNodes);
 
-	hpcjoin::data::CompressedTuple * const rtuples = this->leftRun;
-	hpcjoin::data::CompressedTuple * const stuples = this->rightRun;
+	TUPLE * const rtuples = this->leftRun;
+	TUPLE * const stuples = this->rightRun;
 
-	while (i < numR && j < numS) {
-		if ((rtuples[i].value >> shift) < (stuples[j].value >> shift))
-			i++;
-		else if ((rtuples[i].value >> shift) > (stuples[j].value >> shift))
-			j++;
-		else {
+	if (this->resultBuffer != NULL || this->aggregationTable != NULL) {
 
-			uint64_t jj;
-			do {
-				jj = j;
+		// Matches are materialized and/or folded into the aggregation table
+		hpcjoin::data::ResultBuffer * const output = this->resultBuffer;
+		hpcjoin::data::AggregationTable * const aggregation = this->aggregationTable;
 
+		while (i < numR && j < numS) {
+			if (rtuples[i].getKey(shift) < stuples[j].getKey(shift))
+				i++;
+			else if (rtuples[i].getKey(shift) > stuples[j].getKey(shift))
+				j++;
+			else {
+
+				uint64_t jj;
 				do {
-					matches++;
-					jj++;
-				} while (jj < numS && (rtuples[i].value >> shift) == (stuples[jj].value >> shift));
+					jj = j;
+
+					do {
+						if (output != NULL) {
+							output->append(rtuples[i].getRid(), stuples[jj].getRid());
+						}
+						if (aggregation != NULL) {
+							aggregation->add(rtuples[i].getRid(), stuples[jj].getRid());
+						}
+						matches++;
+						jj++;
+					} while (jj < numS && rtuples[i].getKey(shift) == stuples[jj].getKey(shift));
+
+					i++;
+
+				} while (i < numR && rtuples[i].getKey(shift) == stuples[j].getKey(shift));
 
+				j = jj;
+
+			}
+		}
+
+		if (output != NULL) {
+			output->flush();
+		}
+
+	} else {
+
+		while (i < numR && j < numS) {
+			if (rtuples[i].getKey(shift) < stuples[j].getKey(shift))
 				i++;
+			else if (rtuples[i].getKey(shift) > stuples[j].getKey(shift))
+				j++;
+			else {
+
+				uint64_t jj;
+				do {
+					jj = j;
 
-			} while (i < numR && (rtuples[i].value >> shift) == (stuples[j].value >> shift));
+					do {
+						matches++;
+						jj++;
+					} while (jj < numS && rtuples[i].getKey(shift) == stuples[jj].getKey(shift));
 
-			j = jj;
+					i++;
 
+				} while (i < numR && rtuples[i].getKey(shift) == stuples[j].getKey(shift));
+
+				j = jj;
+
+			}
 		}
+
 	}
 
 	this->matchingTuplesCount = matches;
@@ -74,10 +126,15 @@ void MergeJoinTask::execute() {
 
 }
 
-uint64_t MergeJoinTask::getNumberOfMatchingTuples() {
+template<typename TUPLE>
+uint64_t MergeJoinTask<TUPLE>::getNumberOfMatchingTuples() {
 	return this->matchingTuplesCount;
 }
 
+template class MergeJoinTask<hpcjoin::data::CompressedTuple>;
+template class MergeJoinTask<hpcjoin::data::WideCompressedTuple>;
+template class MergeJoinTask<hpcjoin::data::NarrowCompressedTuple>;
+
 } /* namespace tasks */
 } /* namespace hpcjoin */
 
@@ -12,15 +12,18 @@
 
 #include <hpcjoin/tasks/Task.h>
 #include <hpcjoin/data/CompressedTuple.h>
+#include <hpcjoin/data/ResultBuffer.h>
+#include <hpcjoin/data/AggregationTable.h>
 
 namespace hpcjoin {
 namespace tasks {
 
+template<typename TUPLE>
 class MergeJoinTask : public Task {
 
 public:
 
-	MergeJoinTask(hpcjoin::data::CompressedTuple *leftRun, uint64_t leftNumberOfElements, hpcjoin::data::CompressedTuple *rightRun, uint64_t rightNumberOfElements, uint32_t numberOfNodes);
+	MergeJoinTask(TUPLE *leftRun, uint64_t leftNumberOfElements, TUPLE *rightRun, uint64_t rightNumberOfElements, uint32_t numberOfNodes, hpcjoin::data::ResultBuffer *resultBuffer = NULL, hpcjoin::data::AggregationTable *aggregationTable = NULL);
 	~MergeJoinTask();
 
 	void execute();
@@ -33,14 +36,17 @@ protected:
 
 	uint32_t numberOfNodes;
 
-	hpcjoin::data::CompressedTuple *leftRun;
+	TUPLE *leftRun;
 	uint64_t leftNumberOfElements;
 
-	hpcjoin::data::CompressedTuple *rightRun;
+	TUPLE *rightRun;
 	uint64_t rightNumberOfElements;
 
 	uint64_t matchingTuplesCount;
 
+	hpcjoin::data::ResultBuffer *resultBuffer;
+	hpcjoin::data::AggregationTable *aggregationTable;
+
 };
 
 } /* namespace tasks */
@@ -12,6 +12,8 @@
 
 #include <hpcjoin/core/Configuration.h>
 #include <hpcjoin/utils/Debug.h>
+#include <hpcjoin/data/WideCompressedTuple.h>
+#include <hpcjoin/data/NarrowCompressedTuple.h>
 #include <hpcjoin/tasks/TwoRunsMergeTask.h>
 #include <hpcjoin/tasks/MultiRunsMergeTask.h>
 #include <hpcjoin/performance/Measurements.h>
@@ -21,27 +23,30 @@
 namespace hpcjoin {
 namespace tasks {
 
-MergeLevelTask::MergeLevelTask(uint32_t numberOfInputRuns, hpcjoin::data::CompressedTuple** inputRuns, uint64_t* inputRunSizes, hpcjoin::data::CompressedTuple* output) {
+template<typename TUPLE>
+MergeLevelTask<TUPLE>::MergeLevelTask(uint32_t numberOfInputRuns, TUPLE** inputRuns, uint64_t* inputRunSizes, TUPLE* output) {
 
 	this->numberOfInputRuns = numberOfInputRuns;
 	this->inputRuns = inputRuns;
 	this->inputRunSizes = inputRunSizes;
 	this->output = output;
-	this->outputRuns = new hpcjoin::data::CompressedTuple* [numberOfInputRuns];
+	this->outputRuns = new TUPLE* [numberOfInputRuns];
 	this->outputRunSizes = new uint64_t[numberOfInputRuns];
 	this->numberOfOutputRuns = 0;
 
 }
 
-MergeLevelTask::~MergeLevelTask() {
+template<typename TUPLE>
+MergeLevelTask<TUPLE>::~MergeLevelTask() {
 }
 
-void MergeLevelTask::execute() {
+template<typename TUPLE>
+void MergeLevelTask<TUPLE>::execute() {
 
 	hpcjoin::performance::Measurements::startMergingLevel();
 	uint32_t currentRunIndex = 0;
 	uint32_t remainingRunCount = this->numberOfInputRuns;
-	hpcjoin::data::CompressedTuple *currentOutput = this->output;
+	TUPLE *currentOutput = this->output;
 
 	while (remainingRunCount > 0) {
 		uint32_t dequeueCounter = MIN(hpcjoin::core::Configuration::MAX_MERGE_FAN_IN, remainingRunCount);
@@ -61,41 +66,47 @@ void MergeLevelTask::execute() {
 
 }
 
-hpcjoin::data::CompressedTuple** MergeLevelTask::getOutputRuns() {
+template<typename TUPLE>
+TUPLE** MergeLevelTask<TUPLE>::getOutputRuns() {
 	return this->outputRuns;
 }
 
-uint64_t* MergeLevelTask::getOutputRunSizes() {
+template<typename TUPLE>
+uint64_t* MergeLevelTask<TUPLE>::getOutputRunSizes() {
 	return this->outputRunSizes;
 }
 
-void MergeLevelTask::registerStartOfRun(hpcjoin::data::CompressedTuple* run, uint64_t size) {
+template<typename TUPLE>
+void MergeLevelTask<TUPLE>::registerStartOfRun(TUPLE* run, uint64_t size) {
 	this->outputRuns[this->numberOfOutputRuns] = run;
 	this->outputRunSizes[this->numberOfOutputRuns] = size;
 	++numberOfOutputRuns;
 }
 
-uint32_t MergeLevelTask::getNumberOfOutputRuns() {
+template<typename TUPLE>
+uint32_t MergeLevelTask<TUPLE>::getNumberOfOutputRuns() {
 	return this->numberOfOutputRuns;
 }
 
-uint64_t MergeLevelTask::MERGE_OR_COPY(hpcjoin::data::CompressedTuple** inputRuns, uint64_t* inputRunSizes, uint32_t numberOfInputRuns, hpcjoin::data::CompressedTuple* output) {
+template<typename TUPLE>
+uint64_t MergeLevelTask<TUPLE>::MERGE_OR_COPY(TUPLE** inputRuns, uint64_t* inputRunSizes, uint32_t numberOfInputRuns, TUPLE* output) {
 
 	if (numberOfInputRuns == 1) {
 
-		memcpy(output, inputRuns[0], inputRunSizes[0] * sizeof(hpcjoin::data::CompressedTuple));
+		memcpy(output, inputRuns[0], inputRunSizes[0] * sizeof(TUPLE));
 
 	} else if (numberOfInputRuns == 2 || numberOfInputRuns == 3) {
 
 		bool reduceRunRequired = (numberOfInputRuns == 3);
-		hpcjoin::data::CompressedTuple *twoRunBuffer = NULL;
+		TUPLE *twoRunBuffer = NULL;
 
 		if (reduceRunRequired) {
 			uint64_t twoRunSize = inputRunSizes[1] + inputRunSizes[2];
-			uint32_t returnValue = posix_memalign((void **) &twoRunBuffer, hpcjoin::core::Configuration::CACHELINE_SIZE_BYTES, twoRunSize * sizeof(hpcjoin::data::CompressedTuple));
+			uint32_t returnValue = posix_memalign((void **) &twoRunBuffer, hpcjoin::core::Configuration::CACHELINE_SIZE_BYTES, twoRunSize * sizeof(TUPLE));
 			JOIN_ASSERT(returnValue == 0, "MergeLevel", "Cannot allocate temporary memory of %lu elements (Error %s)", twoRunSize, strerror(errno));
+			JOIN_UNUSED(returnValue);
 
-			hpcjoin::tasks::TwoRunsMergeTask *mergeReduceTask = new hpcjoin::tasks::TwoRunsMergeTask(inputRuns[1], inputRunSizes[1], inputRuns[2], inputRunSizes[2], twoRunBuffer);
+			hpcjoin::tasks::TwoRunsMergeTask<TUPLE> *mergeReduceTask = new hpcjoin::tasks::TwoRunsMergeTask<TUPLE>(inputRuns[1], inputRunSizes[1], inputRuns[2], inputRunSizes[2], twoRunBuffer);
 			mergeReduceTask->execute();
 			delete mergeReduceTask;
 
@@ -104,7 +115,7 @@ uint64_t MergeLevelTask::MERGE_OR_COPY(hpcjoin::data::CompressedTuple** inputRun
 			numberOfInputRuns = 2;
 		}
 
-		hpcjoin::tasks::TwoRunsMergeTask *mergeTask = new hpcjoin::tasks::TwoRunsMergeTask(inputRuns[0], inputRunSizes[0], inputRuns[1], inputRunSizes[1], output);
+		hpcjoin::tasks::TwoRunsMergeTask<TUPLE> *mergeTask = new hpcjoin::tasks::TwoRunsMergeTask<TUPLE>(inputRuns[0], inputRunSizes[0], inputRuns[1], inputRunSizes[1], output);
 		mergeTask->execute();
 		delete mergeTask;
 
@@ -115,15 +126,16 @@ uint64_t MergeLevelTask::MERGE_OR_COPY(hpcjoin::data::CompressedTuple** inputRun
 	} else {
 
 		bool reduceRunRequired = (numberOfInputRuns % 2 != 0);
-		hpcjoin::data::CompressedTuple *twoRunBuffer = NULL;
+		TUPLE *twoRunBuffer = NULL;
 
 		if (reduceRunRequired) {
 			uint64_t twoRunSize = inputRunSizes[numberOfInputRuns - 1] + inputRunSizes[numberOfInputRuns - 2];
 
-			uint32_t returnValue = posix_memalign((void **) &twoRunBuffer, hpcjoin::core::Configuration::CACHELINE_SIZE_BYTES, twoRunSize * sizeof(hpcjoin::data::CompressedTuple));
+			uint32_t returnValue = posix_memalign((void **) &twoRunBuffer, hpcjoin::core::Configuration::CACHELINE_SIZE_BYTES, twoRunSize * sizeof(TUPLE));
 			JOIN_ASSERT(returnValue == 0, "MergeLevel", "Cannot allocate temporary memory of %lu elements (Error %s)", twoRunSize, strerror(errno));
+			JOIN_UNUSED(returnValue);
 
-			hpcjoin::tasks::TwoRunsMergeTask *mergeReduceTask = new hpcjoin::tasks::TwoRunsMergeTask(inputRuns[numberOfInputRuns-2], inputRunSizes[numberOfInputRuns-2], inputRuns[numberOfInputRuns-1], inputRunSizes[numberOfInputRuns-1], twoRunBuffer);
+			hpcjoin::tasks::TwoRunsMergeTask<TUPLE> *mergeReduceTask = new hpcjoin::tasks::TwoRunsMergeTask<TUPLE>(inputRuns[numberOfInputRuns-2], inputRunSizes[numberOfInputRuns-2], inputRuns[numberOfInputRuns-1], inputRunSizes[numberOfInputRuns-1], twoRunBuffer);
 			mergeReduceTask->execute();
 			delete mergeReduceTask;
 
@@ -132,7 +144,7 @@ uint64_t MergeLevelTask::MERGE_OR_COPY(hpcjoin::data::CompressedTuple** inputRun
 			numberOfInputRuns -= 1;
 		}
 
-		hpcjoin::tasks::MultiRunsMergeTask *mergeTask = new hpcjoin::tasks::MultiRunsMergeTask(inputRuns, inputRunSizes, numberOfInputRuns, output);
+		hpcjoin::tasks::MultiRunsMergeTask<TUPLE> *mergeTask = new hpcjoin::tasks::MultiRunsMergeTask<TUPLE>(inputRuns, inputRunSizes, numberOfInputRuns, output);
 		mergeTask->execute();
 		delete mergeTask;
 
@@ -151,6 +163,10 @@ uint64_t MergeLevelTask::MERGE_OR_COPY(hpcjoin::data::CompressedTuple** inputRun
 
 }
 
+template class MergeLevelTask<hpcjoin::data::CompressedTuple>;
+template class MergeLevelTask<hpcjoin::data::WideCompressedTuple>;
+template class MergeLevelTask<hpcjoin::data::NarrowCompressedTuple>;
+
 } /* namespace tasks */
 } /* namespace hpcjoin */
 
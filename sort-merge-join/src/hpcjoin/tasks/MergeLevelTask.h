@@ -16,18 +16,19 @@
 namespace hpcjoin {
 namespace tasks {
 
+template<typename TUPLE>
 class MergeLevelTask: public Task  {
 
 public:
 
-	MergeLevelTask(uint32_t numberOfInputRuns, hpcjoin::data::CompressedTuple** inputRuns, uint64_t *inputRunSizes, hpcjoin::data::CompressedTuple* output);
+	MergeLevelTask(uint32_t numberOfInputRuns, TUPLE** inputRuns, uint64_t *inputRunSizes, TUPLE* output);
 	~MergeLevelTask();
 
 	void execute();
 
 public:
 
-	hpcjoin::data::CompressedTuple** getOutputRuns();
+	TUPLE** getOutputRuns();
 	uint64_t * getOutputRunSizes();
 	uint32_t getNumberOfOutputRuns();
 
@@ -35,18 +36,18 @@ public:
 protected:
 
 	uint32_t numberOfInputRuns;
-	hpcjoin::data::CompressedTuple** inputRuns;
+	TUPLE** inputRuns;
 	uint64_t *inputRunSizes;
 
-	hpcjoin::data::CompressedTuple* output;
-	hpcjoin::data::CompressedTuple** outputRuns;
+	TUPLE* output;
+	TUPLE** outputRuns;
 	uint64_t *outputRunSizes;
 	uint32_t numberOfOutputRuns;
 
 protected:
 
-	void registerStartOfRun(hpcjoin::data::CompressedTuple *run, uint64_t size);
-	static uint64_t MERGE_OR_COPY(hpcjoin::data::CompressedTuple** inputRuns, uint64_t *inputRunSizes, uint32_t numberOfInputRuns, hpcjoin::data::CompressedTuple* output);
+	void registerStartOfRun(TUPLE *run, uint64_t size);
+	static uint64_t MERGE_OR_COPY(TUPLE** inputRuns, uint64_t *inputRunSizes, uint32_t numberOfInputRuns, TUPLE* output);
 
 };
 
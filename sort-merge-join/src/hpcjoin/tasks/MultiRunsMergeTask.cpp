@@ -12,6 +12,8 @@
 #include <hpcjoin/core/Configuration.h>
 #include <hpcjoin/utils/Debug.h>
 #include <hpcjoin/performance/Measurements.h>
+#include <hpcjoin/data/WideCompressedTuple.h>
+#include <hpcjoin/data/NarrowCompressedTuple.h>
 #include <hpcjoin/balkesen/merge/avx_multiwaymerge.h>
 
 #define L2SIZE (256*1024)
@@ -19,7 +21,8 @@
 namespace hpcjoin {
 namespace tasks {
 
-MultiRunsMergeTask::MultiRunsMergeTask(hpcjoin::data::CompressedTuple** runs, uint64_t* numberOfElements, uint32_t numberOfRuns, hpcjoin::data::CompressedTuple *output) {
+template<typename TUPLE>
+MultiRunsMergeTask<TUPLE>::MultiRunsMergeTask(TUPLE** runs, uint64_t* numberOfElements, uint32_t numberOfRuns, TUPLE *output) {
 
 	this->numberOfRuns = numberOfRuns;
 	this->runs = runs;
@@ -37,26 +40,37 @@ MultiRunsMergeTask::MultiRunsMergeTask(hpcjoin::data::CompressedTuple** runs, ui
 	this->output = output;
 	JOIN_ASSERT(((uint64_t) output) % 16 == 0, "MultiwayMerging", "Output not aligned to 16 bytes");
 
-	//int32_t returnValue = posix_memalign((void **) &output, hpcjoin::core::Configuration::CACHELINE_SIZE_BYTES, outputSize * sizeof(hpcjoin::data::CompressedTuple));
+	//int32_t returnValue = posix_memalign((void **) &output, hpcjoin::core::Configuration::CACHELINE_SIZE_BYTES, outputSize * sizeof(TUPLE));
 	//JOIN_ASSERT(returnValue == 0, "MultiwayMerging", "Cannot allocate output memory of %lu elements (Error %s)", outputSize, strerror(errno));
-	//memset(output, 0, outputSize * sizeof(hpcjoin::data::CompressedTuple));
+	//memset(output, 0, outputSize * sizeof(TUPLE));
 
 	int32_t returnValue = posix_memalign((void **) &fifo, hpcjoin::core::Configuration::CACHELINE_SIZE_BYTES, L2SIZE);
 	JOIN_ASSERT(returnValue == 0, "MultiwayMerging", "Cannot allocate fifo memory");
+	JOIN_UNUSED(returnValue);
 	memset(fifo, 0, L2SIZE);
 
-	JOIN_ASSERT(sizeof(hpcjoin::data::CompressedTuple) == sizeof(tuple_t), "MultiwayMerging", "Tupe sizes do not match");
-
 }
 
-MultiRunsMergeTask::~MultiRunsMergeTask() {
+template<typename TUPLE>
+MultiRunsMergeTask<TUPLE>::~MultiRunsMergeTask() {
 	free(fifo);
 }
 
-void MultiRunsMergeTask::execute() {
+template<typename TUPLE>
+void MultiRunsMergeTask<TUPLE>::execute() {
 	hpcjoin::performance::Measurements::startMergingTask();
 
 	JOIN_ASSERT(numberOfRuns % 2 == 0, "MultiwayMerging", "Even number of runs required");
+
+	mergeRuns();
+
+	hpcjoin::performance::Measurements::stopMergingTask(outputSize);
+}
+
+template<>
+void MultiRunsMergeTask<hpcjoin::data::CompressedTuple>::mergeRuns() {
+
+	JOIN_ASSERT(sizeof(hpcjoin::data::CompressedTuple) == sizeof(tuple_t), "MultiwayMerging", "Tupe sizes do not match");
 	JOIN_ASSERT(sizeof(tuple_t) == sizeof(uint64_t), "MultiwayMerging", "Padding has been added to tuple struct");
 	JOIN_ASSERT(sizeof(hpcjoin::data::CompressedTuple) == sizeof(uint64_t), "MultiwayMerging", "Padding has been added to compressed tuple");
 
@@ -88,17 +102,44 @@ void MultiRunsMergeTask::execute() {
 	JOIN_DEBUG("MutiwayMerging", "Merging completed");
 
 	delete chunkptrs;
-	hpcjoin::performance::Measurements::stopMergingTask(outputSize);
+
 }
 
-hpcjoin::data::CompressedTuple* MultiRunsMergeTask::getOutput() {
+template<typename TUPLE>
+void MultiRunsMergeTask<TUPLE>::mergeRuns() {
+
+	// The fan-in is bounded by MAX_MERGE_FAN_IN, the heads of all runs are scanned for the next tuple
+	uint64_t *positions = (uint64_t *) calloc(numberOfRuns, sizeof(uint64_t));
+
+	for (uint64_t i = 0; i < outputSize; ++i) {
+		uint32_t minimumRun = numberOfRuns;
+		for (uint32_t r = 0; r < numberOfRuns; ++r) {
+			if (positions[r] < numberOfElements[r] && (minimumRun == numberOfRuns || runs[r][positions[r]] < runs[minimumRun][positions[minimumRun]])) {
+				minimumRun = r;
+			}
+		}
+		output[i] = runs[minimumRun][positions[minimumRun]];
+		++(positions[minimumRun]);
+	}
+
+	free(positions);
+
+}
+
+template<typename TUPLE>
+TUPLE* MultiRunsMergeTask<TUPLE>::getOutput() {
 	return output;
 }
 
-uint64_t MultiRunsMergeTask::getOutputSize() {
+template<typename TUPLE>
+uint64_t MultiRunsMergeTask<TUPLE>::getOutputSize() {
 	return outputSize;
 }
 
+template class MultiRunsMergeTask<hpcjoin::data::CompressedTuple>;
+template class MultiRunsMergeTask<hpcjoin::data::WideCompressedTuple>;
+template class MultiRunsMergeTask<hpcjoin::data::NarrowCompressedTuple>;
+
 } /* namespace tasks */
 } /* namespace hpcjoin */
 
@@ -15,30 +15,35 @@
 namespace hpcjoin {
 namespace tasks {
 
+template<typename TUPLE>
 class MultiRunsMergeTask: public Task {
 
 public:
 
-	MultiRunsMergeTask(hpcjoin::data::CompressedTuple **runs, uint64_t *numberOfElements, uint32_t numberOfRuns, hpcjoin::data::CompressedTuple *output);
+	MultiRunsMergeTask(TUPLE **runs, uint64_t *numberOfElements, uint32_t numberOfRuns, TUPLE *output);
 	~MultiRunsMergeTask();
 
 	void execute();
 
 public:
 
-	hpcjoin::data::CompressedTuple * getOutput();
+	TUPLE * getOutput();
 	uint64_t getOutputSize();
 
 protected:
 
 	uint32_t numberOfRuns;
-	hpcjoin::data::CompressedTuple** runs;
+	TUPLE** runs;
 	uint64_t* numberOfElements;
 
-	hpcjoin::data::CompressedTuple * fifo;
-	hpcjoin::data::CompressedTuple * output;
+	TUPLE * fifo;
+	TUPLE * output;
 	uint64_t outputSize;
 
+protected:
+
+	void mergeRuns();
+
 };
 
 } /* namespace tasks */
@@ -11,30 +11,36 @@
 #include <string.h>
 #include <mpi.h>
 #include <math.h>
+#include <type_traits>
 
 #include <hpcjoin/utils/Debug.h>
 #include <hpcjoin/performance/Measurements.h>
 #include <hpcjoin/core/Configuration.h>
+#include <hpcjoin/data/WideCompressedTuple.h>
+#include <hpcjoin/data/NarrowCompressedTuple.h>
 
 #define CACHELINE_SIZE (64)
-#define TUPLES_PER_CACHELINE (CACHELINE_SIZE/sizeof(hpcjoin::data::CompressedTuple))
+#define TUPLES_PER_CACHELINE (CACHELINE_SIZE/sizeof(TUPLE))
 #define ALIGN_TO_CACHELINE(N) ((N+TUPLES_PER_CACHELINE-1) & ~(TUPLES_PER_CACHELINE-1))
 #define HASH_BIT_MODULO(KEY, MASK, NBITS) (((KEY) & (MASK)) >> (NBITS))
 
 namespace hpcjoin {
 namespace tasks {
 
-typedef union cacheline {
+template<typename TUPLE>
+union cacheline_t {
 	struct {
-		hpcjoin::data::CompressedTuple tuples[TUPLES_PER_CACHELINE];
+		TUPLE tuples[TUPLES_PER_CACHELINE];
 	} tuples;
 	struct {
-		hpcjoin::data::CompressedTuple tuples[TUPLES_PER_CACHELINE - 1];
-		uint64_t slot;
+		TUPLE tuples[TUPLES_PER_CACHELINE - 1];
+		// The slot needs to fit into the last tuple
+		typename std::conditional<(sizeof(TUPLE) < sizeof(uint64_t)), uint32_t, uint64_t>::type slot;
 	} data;
-} cacheline_t;
+};
 
-PartitionTask::PartitionTask(hpcjoin::data::Relation* innerRelation, hpcjoin::data::Relation* outerRelation, uint32_t numberOfNodes) {
+template<typename TUPLE>
+PartitionTask<TUPLE>::PartitionTask(hpcjoin::data::Relation* innerRelation, hpcjoin::data::Relation* outerRelation, uint32_t numberOfNodes) {
 
 	this->innerRelation = innerRelation;
 	this->outerRelation = outerRelation;
@@ -54,7 +60,8 @@ PartitionTask::PartitionTask(hpcjoin::data::Relation* innerRelation, hpcjoin::da
 
 }
 
-void PartitionTask::execute() {
+template<typename TUPLE>
+void PartitionTask<TUPLE>::execute() {
 
 	/**
 	 * Compute inter-node histograms
@@ -84,11 +91,12 @@ void PartitionTask::execute() {
 	this->innerLocalWriteOffsets = computeLocalWriteOffsets(this->innerHistogram, this->numberOfNodes);
 	this->outerLocalWriteOffsets = computeLocalWriteOffsets(this->outerHistogram, this->numberOfNodes);
 
-	uint64_t innerOutputSize = (this->innerRelation->getLocalSize() * sizeof(hpcjoin::data::CompressedTuple)) + (numberOfNodes * CACHELINE_SIZE);
+	uint64_t innerOutputSize = (this->innerRelation->getLocalSize() * sizeof(TUPLE)) + (numberOfNodes * CACHELINE_SIZE);
 	int32_t returnValue = posix_memalign((void **) &(this->innerPartitionOutput), CACHELINE_SIZE, innerOutputSize);
 	JOIN_ASSERT(returnValue == 0, "PartitionTask", "Could not allocate memory");
+	JOIN_UNUSED(returnValue);
 
-	uint64_t outerOutputSize = (this->outerRelation->getLocalSize() * sizeof(hpcjoin::data::CompressedTuple)) + (numberOfNodes * CACHELINE_SIZE);
+	uint64_t outerOutputSize = (this->outerRelation->getLocalSize() * sizeof(TUPLE)) + (numberOfNodes * CACHELINE_SIZE);
 	returnValue = posix_memalign((void **) &(this->outerPartitionOutput), CACHELINE_SIZE, outerOutputSize);
 	JOIN_ASSERT(returnValue == 0, "PartitionTask", "Could not allocate memory");
 
@@ -102,7 +110,8 @@ void PartitionTask::execute() {
 
 }
 
-PartitionTask::~PartitionTask() {
+template<typename TUPLE>
+PartitionTask<TUPLE>::~PartitionTask() {
 	free(this->innerPartitionOutput);
 	free(this->outerPartitionOutput);
 	delete[] this->innerHistogram;
@@ -111,7 +120,8 @@ PartitionTask::~PartitionTask() {
 	delete[] this->outerWriteOffsets;
 }
 
-uint64_t* PartitionTask::computeHistogram(hpcjoin::data::Relation* relation, uint32_t numberOfNodes) {
+template<typename TUPLE>
+uint64_t* PartitionTask<TUPLE>::computeHistogram(hpcjoin::data::Relation* relation, uint32_t numberOfNodes) {
 	uint64_t* result = new uint64_t[numberOfNodes];
 	memset(result, 0, numberOfNodes * sizeof(uint64_t));
 
@@ -127,13 +137,15 @@ uint64_t* PartitionTask::computeHistogram(hpcjoin::data::Relation* relation, uin
 	return result;
 }
 
-uint64_t PartitionTask::computeWindowSize(uint64_t* histogram, uint32_t numberOfNodes) {
+template<typename TUPLE>
+uint64_t PartitionTask<TUPLE>::computeWindowSize(uint64_t* histogram, uint32_t numberOfNodes) {
 	uint64_t result = 0;
 	MPI_Reduce_scatter_block(histogram, &result, 1, MPI_UINT64_T, MPI_SUM, MPI_COMM_WORLD);
-	return result + numberOfNodes * sizeof(hpcjoin::data::CompressedTuple); // Worst case: every node has un odd number of tuples and padding is required
+	return result + numberOfNodes * sizeof(TUPLE); // Worst case: every node has un odd number of tuples and padding is required
 }
 
-uint64_t* PartitionTask::computeWriteOffsets(uint64_t* histogram, uint32_t numberOfNodes) {
+template<typename TUPLE>
+uint64_t* PartitionTask<TUPLE>::computeWriteOffsets(uint64_t* histogram, uint32_t numberOfNodes) {
 	uint64_t* result = new uint64_t[numberOfNodes];
 	memset(result, 0, numberOfNodes * sizeof(uint64_t));
 
@@ -153,13 +165,15 @@ uint64_t* PartitionTask::computeWriteOffsets(uint64_t* histogram, uint32_t numbe
 	return result;
 }
 
-uint64_t* PartitionTask::computeIncomingData(uint64_t* histogram, uint32_t numberOfNodes) {
+template<typename TUPLE>
+uint64_t* PartitionTask<TUPLE>::computeIncomingData(uint64_t* histogram, uint32_t numberOfNodes) {
 	uint64_t* result = new uint64_t[numberOfNodes];
 	MPI_Alltoall(histogram, 1, MPI_UINT64_T, result, 1, MPI_UINT64_T, MPI_COMM_WORLD);
 	return result;
 }
 
-uint64_t* PartitionTask::computeLocalWriteOffsets(uint64_t* histogram, uint32_t numberOfNodes) {
+template<typename TUPLE>
+uint64_t* PartitionTask<TUPLE>::computeLocalWriteOffsets(uint64_t* histogram, uint32_t numberOfNodes) {
 	uint64_t* result = new uint64_t[numberOfNodes];
 	result[0] = 0;
 	for (uint32_t i = 1; i < numberOfNodes; ++i) {
@@ -168,16 +182,18 @@ uint64_t* PartitionTask::computeLocalWriteOffsets(uint64_t* histogram, uint32_t
 	return result;
 }
 
-void PartitionTask::partitionData(hpcjoin::data::Relation* relation, hpcjoin::data::CompressedTuple* outputBuffer, uint64_t* localWriteOffsets, uint32_t numberOfNodes) {
+template<typename TUPLE>
+void PartitionTask<TUPLE>::partitionData(hpcjoin::data::Relation* relation, TUPLE* outputBuffer, uint64_t* localWriteOffsets, uint32_t numberOfNodes) {
 
 	const uint64_t numberOfElements = relation->getLocalSize();
 	const hpcjoin::data::Tuple *input = relation->getData();
 	const uint32_t mask = numberOfNodes - 1;
 	const uint32_t nodeBits = log2(numberOfNodes);
 
-	cacheline_t *buffer = NULL;
-	int32_t returnValue = posix_memalign((void**) &(buffer), CACHELINE_SIZE, numberOfNodes * sizeof(cacheline_t));
+	cacheline_t<TUPLE> *buffer = NULL;
+	int32_t returnValue = posix_memalign((void**) &(buffer), CACHELINE_SIZE, numberOfNodes * sizeof(cacheline_t<TUPLE>));
 	JOIN_ASSERT(returnValue == 0, "PartitionTask", "Could not allocate memory");
+	JOIN_UNUSED(returnValue);
 
 	for (uint32_t i = 0; i < numberOfNodes; ++i) {
 		buffer[i].data.slot = localWriteOffsets[i];
@@ -188,11 +204,10 @@ void PartitionTask::partitionData(hpcjoin::data::Relation* relation, hpcjoin::da
 		JOIN_ASSERT(idx == (input[i].key % numberOfNodes), "PartitioningTask", "Key %lu assigned to partition %d", input[i].key, idx);
 
 		uint32_t slot = buffer[idx].data.slot;
-		hpcjoin::data::CompressedTuple *cacheline = (hpcjoin::data::CompressedTuple *) (buffer + idx);
+		TUPLE *cacheline = (TUPLE *) (buffer + idx);
 		uint32_t slotMod = (slot) & (TUPLES_PER_CACHELINE - 1);
 
-		//cacheline[slotMod] = input[i];
-		cacheline[slotMod].value = input[i].rid + ((input[i].key >> nodeBits) << (nodeBits + hpcjoin::core::Configuration::PAYLOAD_BITS));
+		cacheline[slotMod].pack(input[i].key, input[i].rid, nodeBits);
 
 		if (slotMod == (TUPLES_PER_CACHELINE - 1)) {
 			store((outputBuffer + slot - (TUPLES_PER_CACHELINE - 1)), cacheline);
@@ -205,17 +220,17 @@ void PartitionTask::partitionData(hpcjoin::data::Relation* relation, hpcjoin::da
 		uint32_t slot = buffer[i].data.slot;
 		uint32_t num = (slot) & (TUPLES_PER_CACHELINE - 1);
 		if (num > 0) {
-			hpcjoin::data::CompressedTuple *dest = outputBuffer + slot - num;
+			TUPLE *dest = outputBuffer + slot - num;
 			for (uint32_t j = 0; j < num; ++j) {
-				//dest[j] = buffer[i].data.tuples[j];
-				dest[j].value = buffer[i].data.tuples[j].value;
+				dest[j] = buffer[i].data.tuples[j];
 			}
 		}
 	}
 
 }
 
-void PartitionTask::store(void* to, void* from) {
+template<typename TUPLE>
+void PartitionTask<TUPLE>::store(void* to, void* from) {
 
 	JOIN_ASSERT(to != NULL, "Local Partitioning", "Stream destination should not be NULL");
 	JOIN_ASSERT(from != NULL, "Local Partitioning", "Stream source should not be NULL");
@@ -233,6 +248,10 @@ void PartitionTask::store(void* to, void* from) {
 
 }
 
+template class PartitionTask<hpcjoin::data::CompressedTuple>;
+template class PartitionTask<hpcjoin::data::WideCompressedTuple>;
+template class PartitionTask<hpcjoin::data::NarrowCompressedTuple>;
+
 } /* namespace tasks */
 } /* namespace hpcjoin */
 
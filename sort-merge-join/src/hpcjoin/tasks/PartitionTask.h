@@ -16,6 +16,7 @@
 namespace hpcjoin {
 namespace tasks {
 
+template<typename TUPLE>
 class PartitionTask : public Task {
 
 public:
@@ -41,7 +42,7 @@ protected:
 protected:
 
 	static uint64_t * computeLocalWriteOffsets(uint64_t *histogram, uint32_t numberOfNodes);
-	static void partitionData(hpcjoin::data::Relation *relation, hpcjoin::data::CompressedTuple *outputBuffer, uint64_t *localWriteOffsets, uint32_t numberOfNodes);
+	static void partitionData(hpcjoin::data::Relation *relation, TUPLE *outputBuffer, uint64_t *localWriteOffsets, uint32_t numberOfNodes);
 	static void store(void* to, void* from);
 
 public:
@@ -63,8 +64,8 @@ public:
 	uint64_t * innerLocalWriteOffsets;
 	uint64_t * outerLocalWriteOffsets;
 
-	hpcjoin::data::CompressedTuple *innerPartitionOutput;
-	hpcjoin::data::CompressedTuple *outerPartitionOutput;
+	TUPLE *innerPartitionOutput;
+	TUPLE *outerPartitionOutput;
 
 
 };
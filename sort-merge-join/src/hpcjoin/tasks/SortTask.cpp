@@ -10,36 +10,43 @@
 #include <immintrin.h>
 #include <algorithm>
 #include <stdlib.h>
+#include <string.h>
 #include <hpcjoin/utils/Debug.h>
 #include <mpi.h>
 #include <hpcjoin/core/Configuration.h>
 #include <hpcjoin/performance/Measurements.h>
+#include <hpcjoin/data/WideCompressedTuple.h>
+#include <hpcjoin/data/NarrowCompressedTuple.h>
 #include <hpcjoin/balkesen/sort/avxsort.h>
 
 
 namespace hpcjoin {
 namespace tasks {
 
-SortTask::SortTask(hpcjoin::data::CompressedTuple* tuples, uint64_t numberOfElements, hpcjoin::data::Window *window, uint32_t targetNode) {
+template<typename TUPLE>
+SortTask<TUPLE>::SortTask(TUPLE* tuples, uint64_t numberOfElements, hpcjoin::data::Window<TUPLE> *window, uint32_t targetNode) {
 
 	this->numberOfElements = numberOfElements;
 	this->input = tuples;
 	this->window = window;
 	this->targetNode = targetNode;
-	int returnValue = posix_memalign((void**) &output, hpcjoin::core::Configuration::CACHELINE_SIZE_BYTES, numberOfElements * sizeof(hpcjoin::data::CompressedTuple));
+	int returnValue = posix_memalign((void**) &output, hpcjoin::core::Configuration::CACHELINE_SIZE_BYTES, numberOfElements * sizeof(TUPLE));
 	JOIN_ASSERT(returnValue == 0, "SortTask", "Could not allocate memory for %lu compressed tuples", numberOfElements);
+	JOIN_UNUSED(returnValue);
 
 }
 
-SortTask::~SortTask() {
+template<typename TUPLE>
+SortTask<TUPLE>::~SortTask() {
 }
 
-void SortTask::execute() {
+template<typename TUPLE>
+void SortTask<TUPLE>::execute() {
 
 	hpcjoin::performance::Measurements::startSortTask();
 
 	hpcjoin::performance::Measurements::startSortingElements();
-	avxsort_tuples((tuple_t **) &input, (tuple_t **) &output, numberOfElements);
+	sortElements();
 	hpcjoin::performance::Measurements::stopSortingElements(numberOfElements);
 
 /*	uint64_t oldValue = 0;
@@ -60,6 +67,32 @@ void SortTask::execute() {
 
 }
 
+template<typename TUPLE>
+void SortTask<TUPLE>::sortElements() {
+
+	memcpy(output, input, numberOfElements * sizeof(TUPLE));
+	std::sort(output, output + numberOfElements);
+
+}
+
+template<>
+void SortTask<hpcjoin::data::CompressedTuple>::sortElements() {
+
+	avxsort_tuples((tuple_t **) &input, (tuple_t **) &output, numberOfElements);
+
+}
+
+template<>
+void SortTask<hpcjoin::data::NarrowCompressedTuple>::sortElements() {
+
+	avxsort_int32((int32_t **) &input, (int32_t **) &output, numberOfElements);
+
+}
+
+template class SortTask<hpcjoin::data::CompressedTuple>;
+template class SortTask<hpcjoin::data::WideCompressedTuple>;
+template class SortTask<hpcjoin::data::NarrowCompressedTuple>;
+
 } /* namespace tasks */
 } /* namespace hpcjoin */
 
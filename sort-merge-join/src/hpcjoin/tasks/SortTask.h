@@ -16,11 +16,12 @@
 namespace hpcjoin {
 namespace tasks {
 
+template<typename TUPLE>
 class SortTask: public Task {
 
 public:
 
-	SortTask(hpcjoin::data::CompressedTuple *tuples, uint64_t numberOfElements, hpcjoin::data::Window *window, uint32_t targetNode);
+	SortTask(TUPLE *tuples, uint64_t numberOfElements, hpcjoin::data::Window<TUPLE> *window, uint32_t targetNode);
 	~SortTask();
 
 	void execute();
@@ -28,13 +29,15 @@ public:
 protected:
 
 	uint64_t numberOfElements;
-	hpcjoin::data::CompressedTuple *input;
-	hpcjoin::data::CompressedTuple *output;
-	hpcjoin::data::Window *window;
+	TUPLE *input;
+	TUPLE *output;
+	hpcjoin::data::Window<TUPLE> *window;
 	uint32_t targetNode;
 
 protected:
 
+	void sortElements();
+
 };
 
 } /* namespace tasks */
@@ -7,10 +7,13 @@
 #include <hpcjoin/tasks/TwoRunsMergeTask.h>
 
 #include <errno.h>
+#include <algorithm>
 #include <stdlib.h>
 #include <string.h>
 #include <hpcjoin/utils/Debug.h>
 #include <hpcjoin/performance/Measurements.h>
+#include <hpcjoin/data/WideCompressedTuple.h>
+#include <hpcjoin/data/NarrowCompressedTuple.h>
 #include <hpcjoin/balkesen/merge/merge.h>
 
 #define CACHELINE_SIZE (64)
@@ -18,8 +21,9 @@
 namespace hpcjoin {
 namespace tasks {
 
-TwoRunsMergeTask::TwoRunsMergeTask(hpcjoin::data::CompressedTuple* leftRun, uint64_t leftNumberOfElements, hpcjoin::data::CompressedTuple* rightRun,
-		uint64_t rightNumberOfElements, hpcjoin::data::CompressedTuple *output) {
+template<typename TUPLE>
+TwoRunsMergeTask<TUPLE>::TwoRunsMergeTask(TUPLE* leftRun, uint64_t leftNumberOfElements, TUPLE* rightRun,
+		uint64_t rightNumberOfElements, TUPLE *output) {
 
 	this->leftRun = leftRun;
 	this->leftNumberOfElements = leftNumberOfElements;
@@ -31,19 +35,21 @@ TwoRunsMergeTask::TwoRunsMergeTask(hpcjoin::data::CompressedTuple* leftRun, uint
 	this->output = output;
 	JOIN_ASSERT(((uint64_t) output) % 16 == 0, "TwoRunMerging", "Output not aligned to 16 bytes");
 
-	//int returnValue = posix_memalign((void **) &(this->output), CACHELINE_SIZE, this->outputNumberOfElements * sizeof(hpcjoin::data::CompressedTuple));
+	//int returnValue = posix_memalign((void **) &(this->output), CACHELINE_SIZE, this->outputNumberOfElements * sizeof(TUPLE));
 	//JOIN_ASSERT(returnValue == 0, "TwoRunMerging", "Cannot allocate output memory of %lu elements (Error %s)", this->outputNumberOfElements, strerror(errno));
-	//memset(output, 0, this->outputNumberOfElements * sizeof(hpcjoin::data::CompressedTuple));
+	//memset(output, 0, this->outputNumberOfElements * sizeof(TUPLE));
 
 }
 
-TwoRunsMergeTask::~TwoRunsMergeTask() {
+template<typename TUPLE>
+TwoRunsMergeTask<TUPLE>::~TwoRunsMergeTask() {
 }
 
-void TwoRunsMergeTask::execute() {
+template<typename TUPLE>
+void TwoRunsMergeTask<TUPLE>::execute() {
 
 	hpcjoin::performance::Measurements::startMergingTask();
-	avx_merge_int64((int64_t *) leftRun, (int64_t *) rightRun, (int64_t *) output, leftNumberOfElements, rightNumberOfElements);
+	mergeRuns();
 	hpcjoin::performance::Measurements::stopMergingTask(leftNumberOfElements + rightNumberOfElements);
 
 	/*uint64_t oldValue = 0;
@@ -60,14 +66,34 @@ void TwoRunsMergeTask::execute() {
 
 }
 
-hpcjoin::data::CompressedTuple* TwoRunsMergeTask::getOutput() {
+template<typename TUPLE>
+void TwoRunsMergeTask<TUPLE>::mergeRuns() {
+
+	std::merge(leftRun, leftRun + leftNumberOfElements, rightRun, rightRun + rightNumberOfElements, output);
+
+}
+
+template<>
+void TwoRunsMergeTask<hpcjoin::data::CompressedTuple>::mergeRuns() {
+
+	avx_merge_int64((int64_t *) leftRun, (int64_t *) rightRun, (int64_t *) output, leftNumberOfElements, rightNumberOfElements);
+
+}
+
+template<typename TUPLE>
+TUPLE* TwoRunsMergeTask<TUPLE>::getOutput() {
 	return this->output;
 }
 
-uint64_t TwoRunsMergeTask::getOutputSize() {
+template<typename TUPLE>
+uint64_t TwoRunsMergeTask<TUPLE>::getOutputSize() {
 	return this->outputNumberOfElements;
 }
 
+template class TwoRunsMergeTask<hpcjoin::data::CompressedTuple>;
+template class TwoRunsMergeTask<hpcjoin::data::WideCompressedTuple>;
+template class TwoRunsMergeTask<hpcjoin::data::NarrowCompressedTuple>;
+
 } /* namespace tasks */
 } /* namespace hpcjoin */
 
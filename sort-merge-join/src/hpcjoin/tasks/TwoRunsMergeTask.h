@@ -16,31 +16,36 @@
 namespace hpcjoin {
 namespace tasks {
 
+template<typename TUPLE>
 class TwoRunsMergeTask : public Task {
 
 public:
 
-	TwoRunsMergeTask(hpcjoin::data::CompressedTuple *leftRun, uint64_t leftNumberOfElements, hpcjoin::data::CompressedTuple *rightRun, uint64_t rightNumberOfElements, hpcjoin::data::CompressedTuple *output);
+	TwoRunsMergeTask(TUPLE *leftRun, uint64_t leftNumberOfElements, TUPLE *rightRun, uint64_t rightNumberOfElements, TUPLE *output);
 	~TwoRunsMergeTask();
 
 	void execute();
 
 public:
 
-	hpcjoin::data::CompressedTuple * getOutput();
+	TUPLE * getOutput();
 	uint64_t getOutputSize();
 
 protected:
 
-	hpcjoin::data::CompressedTuple *leftRun;
+	TUPLE *leftRun;
 	uint64_t leftNumberOfElements;
 
-	hpcjoin::data::CompressedTuple *rightRun;
+	TUPLE *rightRun;
 	uint64_t rightNumberOfElements;
 
-	hpcjoin::data::CompressedTuple *output;
+	TUPLE *output;
 	uint64_t outputNumberOfElements;
 
+protected:
+
+	void mergeRuns();
+
 };
 
 } /* namespace tasks */
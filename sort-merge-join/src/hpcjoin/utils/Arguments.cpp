@@ -0,0 +1,101 @@
+/**
+ * @author  Claude Barthels <claudeb@inf.ethz.ch>
+ * (c) 2016, ETH Zurich, Systems Group
+ *
+ */
+
+#include "Arguments.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ARGUMENTS_MAX_LINE_LENGTH (4096)
+#define ARGUMENTS_SEPARATORS " \t\r\n"
+
+namespace hpcjoin {
+namespace utils {
+
+void Arguments::expand(int argc, char *argv[], int *expandedArgc, char ***expandedArgv) {
+
+	int numberOfTokens = 0;
+	for (int a = 1; a < argc - 1; ++a) {
+		if (strcmp(argv[a], ARGUMENTS_CONFIG_OPTION) == 0) {
+			numberOfTokens += countTokens(argv[a + 1]);
+		}
+	}
+
+	char **arguments = (char **) calloc(argc + numberOfTokens + 1, sizeof(char *));
+	arguments[0] = argv[0];
+
+	int numberOfArguments = 1;
+	for (int a = 1; a < argc - 1; ++a) {
+		if (strcmp(argv[a], ARGUMENTS_CONFIG_OPTION) == 0) {
+			readFile(argv[a + 1], arguments + numberOfArguments, &numberOfTokens);
+			numberOfArguments += numberOfTokens;
+		}
+	}
+	for (int a = 1; a < argc; ++a) {
+		arguments[numberOfArguments++] = argv[a];
+	}
+	arguments[numberOfArguments] = NULL;
+
+	*expandedArgc = numberOfArguments;
+	*expandedArgv = arguments;
+
+}
+
+int Arguments::countTokens(const char* fileName) {
+
+	FILE *file = fopen(fileName, "r");
+	if (file == NULL) {
+		fprintf(stderr, "Could not open configuration file %s\n", fileName);
+		exit(-1);
+	}
+
+	int numberOfTokens = 0;
+	char line[ARGUMENTS_MAX_LINE_LENGTH];
+	while (fgets(line, ARGUMENTS_MAX_LINE_LENGTH, file) != NULL) {
+		char *comment = strchr(line, '#');
+		if (comment != NULL) {
+			*comment = '\0';
+		}
+		char *context = NULL;
+		for (char *token = strtok_r(line, ARGUMENTS_SEPARATORS, &context); token != NULL; token = strtok_r(NULL, ARGUMENTS_SEPARATORS, &context)) {
+			++numberOfTokens;
+		}
+	}
+
+	fclose(file);
+	return numberOfTokens;
+
+}
+
+void Arguments::readFile(const char* fileName, char** tokens, int* numberOfTokens) {
+
+	FILE *file = fopen(fileName, "r");
+	if (file == NULL) {
+		fprintf(stderr, "Could not open configuration file %s\n", fileName);
+		exit(-1);
+	}
+
+	// The tokens are used as arguments until the end of the program
+	*numberOfTokens = 0;
+	char line[ARGUMENTS_MAX_LINE_LENGTH];
+	while (fgets(line, ARGUMENTS_MAX_LINE_LENGTH, file) != NULL) {
+		char *comment = strchr(line, '#');
+		if (comment != NULL) {
+			*comment = '\0';
+		}
+		char *context = NULL;
+		for (char *token = strtok_r(line, ARGUMENTS_SEPARATORS, &context); token != NULL; token = strtok_r(NULL, ARGUMENTS_SEPARATORS, &context)) {
+			tokens[(*numberOfTokens)++] = strdup(token);
+		}
+	}
+
+	fclose(file);
+
+}
+
+} /* namespace utils */
+} /* namespace hpcjoin */